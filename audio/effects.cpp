@@ -0,0 +1,344 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/effects.h"
+#include "common/util.h"
+
+namespace Audio {
+
+#pragma mark -
+#pragma mark --- Biquad filter ---
+#pragma mark -
+
+BiquadFilterEffect::BiquadFilterEffect(FilterType type, float frequency, float q, float gainDB) :
+	_type(type), _frequency(frequency), _q(q), _gainDB(gainDB), _sampleRate(44100), _stereo(true),
+	_b0(1.0f), _b1(0.0f), _b2(0.0f), _a1(0.0f), _a2(0.0f) {
+	reset();
+	updateCoefficients();
+}
+
+void BiquadFilterEffect::setParameters(FilterType type, float frequency, float q, float gainDB) {
+	_type = type;
+	_frequency = frequency;
+	_q = q;
+	_gainDB = gainDB;
+	updateCoefficients();
+}
+
+void BiquadFilterEffect::prepare(uint sampleRate, bool stereo) {
+	_sampleRate = sampleRate;
+	_stereo = stereo;
+	reset();
+	updateCoefficients();
+}
+
+void BiquadFilterEffect::reset() {
+	for (int i = 0; i < 2; ++i)
+		_x1[i] = _x2[i] = _y1[i] = _y2[i] = 0.0f;
+}
+
+void BiquadFilterEffect::updateCoefficients() {
+	// Keep the frequency below the Nyquist frequency
+	const float frequency = CLIP<float>(_frequency, 10.0f, _sampleRate * 0.49f);
+	const float w0 = 2.0f * (float)M_PI * frequency / _sampleRate;
+	const float cosW0 = cosf(w0);
+	const float alpha = sinf(w0) / (2.0f * MAX<float>(_q, 0.01f));
+	const float a = powf(10.0f, _gainDB / 40.0f);
+	const float sqrtA2Alpha = 2.0f * sqrtf(a) * alpha;
+
+	float b0, b1, b2, a0, a1, a2;
+	switch (_type) {
+	case kLowPass:
+		b0 = (1.0f - cosW0) / 2.0f;
+		b1 = 1.0f - cosW0;
+		b2 = (1.0f - cosW0) / 2.0f;
+		a0 = 1.0f + alpha;
+		a1 = -2.0f * cosW0;
+		a2 = 1.0f - alpha;
+		break;
+	case kHighPass:
+		b0 = (1.0f + cosW0) / 2.0f;
+		b1 = -(1.0f + cosW0);
+		b2 = (1.0f + cosW0) / 2.0f;
+		a0 = 1.0f + alpha;
+		a1 = -2.0f * cosW0;
+		a2 = 1.0f - alpha;
+		break;
+	case kPeaking:
+		b0 = 1.0f + alpha * a;
+		b1 = -2.0f * cosW0;
+		b2 = 1.0f - alpha * a;
+		a0 = 1.0f + alpha / a;
+		a1 = -2.0f * cosW0;
+		a2 = 1.0f - alpha / a;
+		break;
+	case kLowShelf:
+		b0 = a * ((a + 1.0f) - (a - 1.0f) * cosW0 + sqrtA2Alpha);
+		b1 = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cosW0);
+		b2 = a * ((a + 1.0f) - (a - 1.0f) * cosW0 - sqrtA2Alpha);
+		a0 = (a + 1.0f) + (a - 1.0f) * cosW0 + sqrtA2Alpha;
+		a1 = -2.0f * ((a - 1.0f) + (a + 1.0f) * cosW0);
+		a2 = (a + 1.0f) + (a - 1.0f) * cosW0 - sqrtA2Alpha;
+		break;
+	case kHighShelf:
+	default:
+		b0 = a * ((a + 1.0f) + (a - 1.0f) * cosW0 + sqrtA2Alpha);
+		b1 = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cosW0);
+		b2 = a * ((a + 1.0f) + (a - 1.0f) * cosW0 - sqrtA2Alpha);
+		a0 = (a + 1.0f) - (a - 1.0f) * cosW0 + sqrtA2Alpha;
+		a1 = 2.0f * ((a - 1.0f) - (a + 1.0f) * cosW0);
+		a2 = (a + 1.0f) - (a - 1.0f) * cosW0 - sqrtA2Alpha;
+		break;
+	}
+
+	_b0 = b0 / a0;
+	_b1 = b1 / a0;
+	_b2 = b2 / a0;
+	_a1 = a1 / a0;
+	_a2 = a2 / a0;
+}
+
+void BiquadFilterEffect::process(int32 *samples, uint numFrames) {
+	const int numChannels = _stereo ? 2 : 1;
+
+	for (int ch = 0; ch < numChannels; ++ch) {
+		float x1 = _x1[ch], x2 = _x2[ch], y1 = _y1[ch], y2 = _y2[ch];
+		int32 *s = samples + ch;
+
+		for (uint i = 0; i < numFrames; ++i, s += numChannels) {
+			const float x = (float)*s;
+			float y = _b0 * x + _b1 * x1 + _b2 * x2 - _a1 * y1 - _a2 * y2;
+
+			// Don't let the feedback decay into denormals after the input stops
+			if (fabsf(y) < 1e-6f)
+				y = 0.0f;
+
+			x2 = x1;
+			x1 = x;
+			y2 = y1;
+			y1 = y;
+			*s = (int32)floorf(y + 0.5f);
+		}
+
+		_x1[ch] = x1;
+		_x2[ch] = x2;
+		_y1[ch] = y1;
+		_y2[ch] = y2;
+	}
+}
+
+#pragma mark -
+#pragma mark --- Limiter ---
+#pragma mark -
+
+LimiterEffect::LimiterEffect(int32 ceiling, uint lookaheadMs, uint releaseMs) :
+	_ceiling(MAX<int32>(ceiling, 1)), _lookaheadMs(lookaheadMs), _releaseMs(releaseMs), _stereo(true),
+	_length(0), _releaseCoef(kUnityGain), _minHead(0), _minCount(0), _smoothSum(0), _gain(kUnityGain),
+	_frame(0), _pos(0) {
+}
+
+void LimiterEffect::prepare(uint sampleRate, bool stereo) {
+	_stereo = stereo;
+	_length = MAX<uint>(2, sampleRate * _lookaheadMs / 1000);
+
+	const double releaseFrames = MAX<double>(1.0, (double)sampleRate * _releaseMs / 1000.0);
+	_releaseCoef = MAX<int32>(1, (int32)((1.0 - exp(-1.0 / releaseFrames)) * kUnityGain));
+
+	_delay.resize(_length * (stereo ? 2 : 1));
+	_minValues.resize(_length);
+	_minIndices.resize(_length);
+	_smooth.resize(_length);
+	reset();
+}
+
+void LimiterEffect::reset() {
+	for (uint i = 0; i < _delay.size(); ++i)
+		_delay[i] = 0;
+	for (uint i = 0; i < _smooth.size(); ++i)
+		_smooth[i] = kUnityGain;
+
+	_smoothSum = kUnityGain * _length;
+	_minHead = _minCount = 0;
+	_gain = kUnityGain;
+	_frame = 0;
+	_pos = 0;
+}
+
+void LimiterEffect::process(int32 *samples, uint numFrames) {
+	assert(_length);
+
+	const int numChannels = _stereo ? 2 : 1;
+
+	for (uint i = 0; i < numFrames; ++i, samples += numChannels) {
+		const int32 inL = samples[0];
+		const int32 inR = _stereo ? samples[1] : inL;
+
+		// Gain this frame needs to stay below the ceiling
+		const int32 peak = MAX<int32>(ABS(inL), ABS(inR));
+		const int32 required = (peak > _ceiling) ? (int32)(((int64)_ceiling << 16) / peak) : (int32)kUnityGain;
+
+		// Minimum over the lookahead window: drop the entry that left the
+		// window, which makes room for the new one, then the entries that
+		// are no smaller than the new one
+		if (_minCount && _frame - _minIndices[_minHead] >= _length) {
+			_minHead = (_minHead + 1) % _length;
+			_minCount--;
+		}
+		while (_minCount && _minValues[(_minHead + _minCount - 1) % _length] >= required)
+			_minCount--;
+		const uint back = (_minHead + _minCount) % _length;
+		_minValues[back] = required;
+		_minIndices[back] = _frame;
+		_minCount++;
+
+		// Attack immediately, release exponentially
+		_gain = MIN<int32>(_minValues[_minHead], _gain + (int32)(((int64)(kUnityGain - _gain) * _releaseCoef) >> 16));
+
+		// Smoothing over the window keeps the gain below the required one
+		// for the frame leaving the delay line.
+		_smoothSum += _gain - _smooth[_pos];
+		_smooth[_pos] = _gain;
+		const int32 gain = _smoothSum / (int32)_length;
+
+		const uint readPos = ((_pos + 1) % _length) * numChannels;
+		const uint writePos = _pos * numChannels;
+
+		samples[0] = (int32)(((int64)_delay[readPos] * gain) >> 16);
+		_delay[writePos] = inL;
+		if (_stereo) {
+			samples[1] = (int32)(((int64)_delay[readPos + 1] * gain) >> 16);
+			_delay[writePos + 1] = inR;
+		}
+
+		_pos = (_pos + 1) % _length;
+		_frame++;
+	}
+}
+
+#pragma mark -
+#pragma mark --- Schroeder reverb ---
+#pragma mark -
+
+// Delay lengths at 44.1kHz, mutually prime to avoid coinciding echoes
+static const uint kCombLengths[] = { 1116, 1188, 1277, 1356 };
+static const uint kAllpassLengths[] = { 556, 441 };
+
+// Offset of the right channel lines, for some stereo width
+static const uint kStereoSpread = 23;
+
+SchroederReverbEffect::SchroederReverbEffect(float roomSize, float damping, float wet) :
+	_roomSize(CLIP<float>(roomSize, 0.0f, 1.0f)), _damping(CLIP<float>(damping, 0.0f, 1.0f)),
+	_wet(CLIP<float>(wet, 0.0f, 1.0f)), _stereo(true) {
+}
+
+void SchroederReverbEffect::prepare(uint sampleRate, bool stereo) {
+	_stereo = stereo;
+
+	for (int ch = 0; ch < 2; ++ch) {
+		const uint spread = ch * kStereoSpread;
+
+		for (int i = 0; i < kNumCombs; ++i)
+			_combs[ch][i].buffer.resize(MAX<uint>(1, (kCombLengths[i] + spread) * sampleRate / 44100));
+		for (int i = 0; i < kNumAllpasses; ++i)
+			_allpasses[ch][i].buffer.resize(MAX<uint>(1, (kAllpassLengths[i] + spread) * sampleRate / 44100));
+	}
+
+	reset();
+}
+
+void SchroederReverbEffect::reset() {
+	for (int ch = 0; ch < 2; ++ch) {
+		for (int i = 0; i < kNumCombs; ++i) {
+			DelayLine &line = _combs[ch][i];
+			for (uint j = 0; j < line.buffer.size(); ++j)
+				line.buffer[j] = 0.0f;
+			line.pos = 0;
+			line.store = 0.0f;
+		}
+
+		for (int i = 0; i < kNumAllpasses; ++i) {
+			DelayLine &line = _allpasses[ch][i];
+			for (uint j = 0; j < line.buffer.size(); ++j)
+				line.buffer[j] = 0.0f;
+			line.pos = 0;
+			line.store = 0.0f;
+		}
+	}
+}
+
+float SchroederReverbEffect::processChannel(float input, int channel) {
+	const float feedback = 0.7f + 0.28f * _roomSize;
+	const float damp = 0.4f * _damping;
+
+	// Keep the loop gain of the combs in check
+	input *= 0.015f;
+
+	float out = 0.0f;
+	for (int i = 0; i < kNumCombs; ++i) {
+		DelayLine &line = _combs[channel][i];
+		const float delayed = line.buffer[line.pos];
+
+		line.store = delayed * (1.0f - damp) + line.store * damp;
+		if (fabsf(line.store) < 1e-6f)
+			line.store = 0.0f;
+		line.buffer[line.pos] = input + line.store * feedback;
+		if (++line.pos >= line.buffer.size())
+			line.pos = 0;
+
+		out += delayed;
+	}
+
+	for (int i = 0; i < kNumAllpasses; ++i) {
+		DelayLine &line = _allpasses[channel][i];
+		const float delayed = line.buffer[line.pos];
+
+		line.buffer[line.pos] = out + delayed * 0.5f;
+		if (++line.pos >= line.buffer.size())
+			line.pos = 0;
+
+		out = delayed - out;
+	}
+
+	return out;
+}
+
+void SchroederReverbEffect::process(int32 *samples, uint numFrames) {
+	assert(!_combs[0][0].buffer.empty());
+
+	const float wet = _wet * 3.0f;
+
+	for (uint i = 0; i < numFrames; ++i) {
+		if (_stereo) {
+			const float inL = (float)samples[0];
+			const float inR = (float)samples[1];
+			const float mono = (inL + inR) * 0.5f;
+
+			samples[0] += (int32)(processChannel(mono, 0) * wet);
+			samples[1] += (int32)(processChannel(mono, 1) * wet);
+			samples += 2;
+		} else {
+			samples[0] += (int32)(processChannel((float)samples[0], 0) * wet);
+			samples += 1;
+		}
+	}
+}
+
+} // End of namespace Audio
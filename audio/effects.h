@@ -0,0 +1,211 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_EFFECTS_H
+#define AUDIO_EFFECTS_H
+
+#include "common/array.h"
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_effects Insert effects
+ * @ingroup audio
+ *
+ * @brief Effects the mixer can run on a channel, a sound type bus or its output.
+ * @{
+ */
+
+/**
+ * Base class for insert effects.
+ *
+ * Effects operate in place on blocks of interleaved 32-bit samples using
+ * the 16-bit sample scale; mixed blocks may exceed the 16-bit range.
+ *
+ * prepare() is called from the thread attaching the effect and is where all
+ * buffers must be allocated. process() runs on the audio thread with the
+ * mixer lock held and must neither allocate nor block. Parameters changed
+ * after the effect has been attached must be set with Mixer::mutex() held.
+ */
+class AudioEffect {
+public:
+	virtual ~AudioEffect() {}
+
+	/**
+	 * Prepare the effect for the given output format.
+	 *
+	 * @param sampleRate  Output sample rate in Hz.
+	 * @param stereo      Whether the processed blocks are interleaved stereo.
+	 */
+	virtual void prepare(uint sampleRate, bool stereo) = 0;
+
+	/**
+	 * Process a block of samples in place.
+	 *
+	 * @param samples    Interleaved samples.
+	 * @param numFrames  Number of frames (sample pairs when stereo).
+	 */
+	virtual void process(int32 *samples, uint numFrames) = 0;
+
+	/**
+	 * Clear the internal state, such as delay lines and envelopes.
+	 */
+	virtual void reset() = 0;
+};
+
+/**
+ * Second order IIR filter, with the coefficients from Robert Bristow-Johnson's
+ * "Audio EQ Cookbook". Usable as a simple one band equalizer.
+ */
+class BiquadFilterEffect : public AudioEffect {
+public:
+	enum FilterType {
+		kLowPass,
+		kHighPass,
+		kPeaking,
+		kLowShelf,
+		kHighShelf
+	};
+
+	/**
+	 * @param type       Filter response.
+	 * @param frequency  Cutoff or center frequency in Hz.
+	 * @param q          Quality factor; 0.7071 gives a flat pass band.
+	 * @param gainDB     Gain of the peaking and shelving filters, in dB.
+	 */
+	BiquadFilterEffect(FilterType type, float frequency, float q = 0.7071f, float gainDB = 0.0f);
+
+	void setParameters(FilterType type, float frequency, float q, float gainDB);
+
+	void prepare(uint sampleRate, bool stereo) override;
+	void process(int32 *samples, uint numFrames) override;
+	void reset() override;
+
+private:
+	void updateCoefficients();
+
+	FilterType _type;
+	float _frequency, _q, _gainDB;
+	uint _sampleRate;
+	bool _stereo;
+
+	float _b0, _b1, _b2, _a1, _a2;
+
+	/** Previous inputs and outputs, per channel */
+	float _x1[2], _x2[2], _y1[2], _y2[2];
+};
+
+/**
+ * Peak limiter with lookahead.
+ *
+ * The gain needed to keep every sample below the ceiling is known before the
+ * sample leaves the delay line, so the gain ramps down smoothly ahead of
+ * peaks instead of clipping them. The output is delayed by the lookahead.
+ */
+class LimiterEffect : public AudioEffect {
+public:
+	/**
+	 * @param ceiling      Highest output sample magnitude.
+	 * @param lookaheadMs  Lookahead (and output delay) in milliseconds.
+	 * @param releaseMs    Time for the gain to recover after a peak, in milliseconds.
+	 */
+	LimiterEffect(int32 ceiling = 32000, uint lookaheadMs = 5, uint releaseMs = 80);
+
+	void prepare(uint sampleRate, bool stereo) override;
+	void process(int32 *samples, uint numFrames) override;
+	void reset() override;
+
+private:
+	enum {
+		/** Unity gain, in 16.16 fixed point */
+		kUnityGain = 1 << 16
+	};
+
+	int32 _ceiling;
+	uint _lookaheadMs, _releaseMs;
+	bool _stereo;
+
+	/** Lookahead length in frames */
+	uint _length;
+
+	/** Exponential release speed, in 16.16 fixed point */
+	int32 _releaseCoef;
+
+	/** Delayed input samples */
+	Common::Array<int32> _delay;
+
+	/** Sliding window minimum of the required gain, as a monotonic ring */
+	Common::Array<int32> _minValues;
+	Common::Array<uint32> _minIndices;
+	uint _minHead, _minCount;
+
+	/** Box filter smoothing the gain */
+	Common::Array<int32> _smooth;
+	int32 _smoothSum;
+
+	int32 _gain;
+	uint32 _frame;
+	uint _pos;
+};
+
+/**
+ * Classic Schroeder reverberator: four parallel feedback comb filters
+ * followed by two allpass filters, per channel.
+ */
+class SchroederReverbEffect : public AudioEffect {
+public:
+	/**
+	 * @param roomSize  Comb feedback in the range 0 - 1; larger values ring longer.
+	 * @param damping   High frequency damping of the combs, in the range 0 - 1.
+	 * @param wet       Level of the reverberated signal, in the range 0 - 1.
+	 */
+	SchroederReverbEffect(float roomSize = 0.7f, float damping = 0.3f, float wet = 0.25f);
+
+	void prepare(uint sampleRate, bool stereo) override;
+	void process(int32 *samples, uint numFrames) override;
+	void reset() override;
+
+private:
+	enum {
+		kNumCombs = 4,
+		kNumAllpasses = 2
+	};
+
+	struct DelayLine {
+		Common::Array<float> buffer;
+		uint pos;
+		float store;
+	};
+
+	float processChannel(float input, int channel);
+
+	float _roomSize, _damping, _wet;
+	bool _stereo;
+
+	DelayLine _combs[2][kNumCombs];
+	DelayLine _allpasses[2][kNumAllpasses];
+};
+
+/** @} */
+} // End of namespace Audio
+
+#endif
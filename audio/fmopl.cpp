@@ -22,6 +22,7 @@
 #include "audio/fmopl.h"
 
 #include "audio/mixer.h"
+#include "audio/synthtrace.h"
 #ifdef USE_RETROWAVE
 #include "audio/rwopl3.h"
 #endif
@@ -67,7 +68,8 @@ enum OplEmulator {
 	kNuked = 4,
 	kOPL2LPT = 5,
 	kOPL3LPT = 6,
-	kRWOPL3 = 7
+	kRWOPL3 = 7,
+	kDOSBoxBatched = 8
 };
 
 OPL::OPL() {
@@ -80,11 +82,19 @@ OPL::OPL() {
 	_connectionFeedbackValues[2] = 0;
 }
 
+OPL::OPL(OPL *) {
+	_rhythmMode = false;
+	_connectionFeedbackValues[0] = 0;
+	_connectionFeedbackValues[1] = 0;
+	_connectionFeedbackValues[2] = 0;
+}
+
 const Config::EmulatorDescription Config::_drivers[] = {
 	{ "auto", "<default>", kAuto, kFlagOpl2 | kFlagDualOpl2 | kFlagOpl3 },
 	{ "mame", _s("MAME OPL emulator"), kMame, kFlagOpl2 },
 #ifndef DISABLE_DOSBOX_OPL
 	{ "db", _s("DOSBox OPL emulator"), kDOSBox, kFlagOpl2 | kFlagDualOpl2 | kFlagOpl3 },
+	{ "db_batched", _s("DOSBox OPL emulator (batched)"), kDOSBoxBatched, kFlagOpl2 | kFlagDualOpl2 | kFlagOpl3 },
 #endif
 #ifndef DISABLE_NUKED_OPL
 	{ "nuked", _s("Nuked OPL emulator"), kNuked, kFlagOpl2 | kFlagDualOpl2 | kFlagOpl3 },
@@ -181,29 +191,10 @@ OPL *Config::create(OplType type) {
 	return create(kAuto, type);
 }
 
-OPL *Config::create(DriverId driver, OplType type) {
-	// On invalid driver selection, we try to do some fallback detection
-	if (driver == -1) {
-		warning("Invalid OPL driver selected, trying to detect a fallback emulator");
-		driver = kAuto;
-	}
-
-	// If autodetection is selected, we search for a matching
-	// driver.
-	if (driver == kAuto) {
-		driver = detect(type);
-
-		// No emulator for the specified OPL chip could
-		// be found, thus stop here.
-		if (driver == -1) {
-			warning("No OPL emulator available for type %d", type);
-			return nullptr;
-		}
-	}
-
+static OPL *createEmulator(Config::DriverId driver, Config::OplType type) {
 	switch (driver) {
 	case kMame:
-		if (type == kOpl2)
+		if (type == Config::kOpl2)
 			return new MAME::OPL();
 		else
 			warning("MAME OPL emulator only supports OPL2 emulation");
@@ -212,6 +203,9 @@ OPL *Config::create(DriverId driver, OplType type) {
 #ifndef DISABLE_DOSBOX_OPL
 	case kDOSBox:
 		return new DOSBox::OPL(type);
+
+	case kDOSBoxBatched:
+		return new DOSBox::OPL(type, true);
 #endif
 
 #ifndef DISABLE_NUKED_OPL
@@ -226,7 +220,7 @@ OPL *Config::create(DriverId driver, OplType type) {
 
 #ifdef ENABLE_OPL2LPT
 	case kOPL2LPT:
-		if (type == kOpl2) {
+		if (type == Config::kOpl2) {
 			return OPL2LPT::create(type);
 		}
 
@@ -249,6 +243,36 @@ OPL *Config::create(DriverId driver, OplType type) {
 	}
 }
 
+OPL *Config::create(DriverId driver, OplType type) {
+	// On invalid driver selection, we try to do some fallback detection
+	if (driver == -1) {
+		warning("Invalid OPL driver selected, trying to detect a fallback emulator");
+		driver = kAuto;
+	}
+
+	// If autodetection is selected, we search for a matching
+	// driver.
+	if (driver == kAuto) {
+		driver = detect(type);
+
+		// No emulator for the specified OPL chip could
+		// be found, thus stop here.
+		if (driver == -1) {
+			warning("No OPL emulator available for type %d", type);
+			return nullptr;
+		}
+	}
+
+	OPL *opl = createEmulator(driver, type);
+
+	// Capture the register writes when requested by the --dump-synth-trace
+	// command line option
+	if (opl && ConfMan.getBool("dump_synth_trace"))
+		opl = Audio::createOPLTraceRecorder(opl, type, "dump_opl.trace");
+
+	return opl;
+}
+
 void OPL::start(TimerCallback *callback, int timerFrequency) {
 	_callback.reset(callback);
 	startCallbacks(timerFrequency);
@@ -191,6 +191,12 @@ public:
 	};
 
 protected:
+	/**
+	 * Constructor for OPL classes which forward everything to the OPL
+	 * instance they wrap, and thus aren't a separate output instance.
+	 */
+	explicit OPL(OPL *wrapped);
+
 	/**
 	 * Initializes an OPL3 chip for emulating dual OPL2.
 	 * 
@@ -279,6 +285,7 @@ public:
 
 	// AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool isStereo() const = 0;
 	int getRate() const;
 	bool endOfData() const { return false; }
 
@@ -31,6 +31,7 @@
 #include "gui/message.h"
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"
+#include "audio/synthtrace.h"
 
 const byte MidiDriver::_mt32ToGm[128] = {
 //	  0    1    2    3    4    5    6    7    8    9    A    B    C    D    E    F
@@ -391,6 +392,11 @@ MidiDriver *MidiDriver::createMidi(MidiDriver::DeviceHandle handle) {
 			musicPlugin.createInstance(&driver, handle);
 	}
 
+	// Capture everything sent to the driver when requested by the
+	// --dump-synth-trace command line option
+	if (driver && ConfMan.getBool("dump_synth_trace"))
+		driver = Audio::createMidiTraceRecorder(driver, "dump_midi.trace");
+
 	return driver;
 }
 
@@ -21,10 +21,13 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
+#include "audio/effects.h"
 #include "audio/mixer_intern.h"
+#include "audio/mixer_simd.h"
 #include "audio/rate.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
@@ -46,15 +49,28 @@ public:
 	~Channel();
 
 	/**
-	 * Mixes the channel's samples into the given buffer.
+	 * Mixes the channel's samples into the given accumulation buffer.
 	 *
-	 * @param data buffer where to mix the data
-	 * @param len  number of sample *pairs*. So a value of
-	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 * The samples are first rendered at full volume into @p scratch, then
+	 * scaled by the channel volume and added to @p data. Channels with
+	 * insert effects accumulate into @p effectScratch first, and add the
+	 * processed block to @p data.
+	 *
+	 * @param data          accumulation buffer where to mix the data
+	 * @param scratch       buffer of the same size as @p data, used to render
+	 *                      the samples of this channel
+	 * @param effectScratch buffer of the same size as @p data, used to run
+	 *                      the insert effects of this channel
+	 * @param len           number of sample *pairs*. So a value of
+	 *                      10 means that the buffer contains twice 10 sample.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int32 *data, int16 *scratch, int32 *effectScratch, uint len);
+
+	/**
+	 * Appends an insert effect to the channel, which takes ownership of it.
+	 */
+	void addEffect(AudioEffect *effect) { _effects.push_back(effect); }
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -141,9 +157,10 @@ public:
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Publishes the channel's playback timing, so that the elapsed time
+	 * can be queried without locking the mixer.
 	 */
-	Timestamp getElapsedTime();
+	void publish(ChannelSnapshot &snapshot) const;
 
 	/**
 	 * Replaces the channel's stream with a version that loops indefinitely.
@@ -171,6 +188,7 @@ private:
 	const Mixer::SoundType _type;
 	SoundHandle _handle;
 	bool _permanent;
+	bool _reverseStereo;
 	int _pauseLevel;
 	int _id;
 
@@ -190,24 +208,69 @@ private:
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
+
+	Common::Array<AudioEffect *> _effects;
 };
 
 #pragma mark -
 #pragma mark --- Mixer ---
 #pragma mark -
 
+// Initialize these to nullptr at the start
+MixAccumulateFunc mixAccumulate = nullptr;
+MixSaturateFunc mixSaturate = nullptr;
+
+void mixAccumulateGeneric(int32 *dst, const int16 *src, uint numSamples, int volL, int volR) {
+	for (uint i = 0; i + 1 < numSamples; i += 2) {
+		dst[i] += (src[i] * volL) >> 8;
+		dst[i + 1] += (src[i + 1] * volR) >> 8;
+	}
+
+	if (numSamples & 1)
+		dst[numSamples - 1] += (src[numSamples - 1] * volL) >> 8;
+}
+
+void mixSaturateGeneric(int16 *dst, const int32 *src, uint numSamples) {
+	for (uint i = 0; i < numSamples; i++)
+		dst[i] = (int16)CLIP<int32>(src[i], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
 	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_snapshots[i].handle = SoundHandle()._val;
+		_snapshots[i].sequence = 0;
+	}
+
+	// Avoid allocating from the audio thread when the block size is known
+	if (outBufSize)
+		allocateBuffers(outBufSize * (stereo ? 2 : 1));
+
+	// Let a limiter catch the peaks instead of clipping them
+	if (ConfMan.hasKey("output_limiter") && ConfMan.getBool("output_limiter"))
+		addOutputEffect(new LimiterEffect());
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	for (int i = 0; i < ARRAYSIZE(_soundTypeEffects); i++)
+		clearSoundTypeEffects((SoundType)i);
+	clearOutputEffects();
+}
+
+void MixerImpl::allocateBuffers(uint numSamples) {
+	_mixBuffer.resize(numSamples);
+	_channelBuffer.resize(numSamples);
+	_effectBuffer.resize(numSamples);
+
+	for (int i = 0; i < ARRAYSIZE(_soundTypeBuffers); i++)
+		_soundTypeBuffers[i].resize(numSamples);
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -228,6 +291,129 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+bool MixerImpl::CommandQueue::push(const ChannelCommand &cmd) {
+	const uint32 tail = _tail.load(std::memory_order_relaxed);
+	if (tail - _head.load(std::memory_order_acquire) == COMMAND_QUEUE_SIZE)
+		return false;
+
+	_commands[tail % COMMAND_QUEUE_SIZE] = cmd;
+	_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool MixerImpl::CommandQueue::pop(ChannelCommand &cmd) {
+	const uint32 head = _head.load(std::memory_order_relaxed);
+	if (head == _tail.load(std::memory_order_acquire))
+		return false;
+
+	cmd = _commands[head % COMMAND_QUEUE_SIZE];
+	_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+ChannelSnapshot *MixerImpl::getSnapshot(SoundHandle handle) {
+	ChannelSnapshot &snapshot = _snapshots[handle._val % NUM_CHANNELS];
+	return (snapshot.handle == handle._val) ? &snapshot : nullptr;
+}
+
+const ChannelSnapshot *MixerImpl::getSnapshot(SoundHandle handle) const {
+	const ChannelSnapshot &snapshot = _snapshots[handle._val % NUM_CHANNELS];
+	return (snapshot.handle == handle._val) ? &snapshot : nullptr;
+}
+
+void MixerImpl::deleteChannel(int index) {
+	_snapshots[index].handle = SoundHandle()._val;
+	delete _channels[index];
+	_channels[index] = nullptr;
+}
+
+void MixerImpl::queueCommand(ChannelCommand::Type type, uint32 handle, int32 value) {
+	ChannelCommand cmd;
+	cmd.type = type;
+	cmd.handle = handle;
+	cmd.value = value;
+
+	{
+		Common::StackLock lock(_commandMutex);
+		if (_commandQueue.push(cmd))
+			return;
+	}
+
+	// The audio thread is not keeping up (or not running at all), so catch
+	// up synchronously instead of dropping the command.
+	Common::StackLock lock(_mutex);
+	applyCommands();
+	applyCommand(cmd);
+}
+
+void MixerImpl::applyCommands() {
+	ChannelCommand cmd;
+	while (_commandQueue.pop(cmd))
+		applyCommand(cmd);
+}
+
+void MixerImpl::applyCommand(const ChannelCommand &cmd) {
+	switch (cmd.type) {
+	case ChannelCommand::kPauseAll:
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr) {
+				_channels[i]->pause(cmd.value != 0);
+				_channels[i]->publish(_snapshots[i]);
+			}
+		}
+		return;
+
+	case ChannelCommand::kPauseID:
+		// The handle field carries the sound id here
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && _channels[i]->getId() == (int)cmd.handle) {
+				_channels[i]->pause(cmd.value != 0);
+				_channels[i]->publish(_snapshots[i]);
+				return;
+			}
+		}
+		return;
+
+	case ChannelCommand::kUpdateSoundType:
+		// The handle field carries the sound type here
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == (SoundType)cmd.handle)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+
+	default:
+		break;
+	}
+
+	// Simply ignore requests for handles of sounds that already terminated
+	const int index = cmd.handle % NUM_CHANNELS;
+	Channel *chan = _channels[index];
+	if (!chan || chan->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case ChannelCommand::kSetVolume:
+		chan->setVolume((byte)cmd.value);
+		break;
+	case ChannelCommand::kSetBalance:
+		chan->setBalance((int8)cmd.value);
+		break;
+	case ChannelCommand::kSetRate:
+		chan->setRate((uint32)cmd.value);
+		break;
+	case ChannelCommand::kResetRate:
+		chan->resetRate();
+		break;
+	case ChannelCommand::kPauseHandle:
+		chan->pause(cmd.value != 0);
+		chan->publish(_snapshots[index]);
+		break;
+	default:
+		break;
+	}
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -251,6 +437,16 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	ChannelSnapshot &snapshot = _snapshots[index];
+	snapshot.id = chan->getId();
+	snapshot.type = chan->getType();
+	snapshot.volume = chan->getVolume();
+	snapshot.balance = chan->getBalance();
+	snapshot.rate = chan->getRate();
+	snapshot.nativeRate = chan->getRate();
+	chan->publish(snapshot);
+	snapshot.handle = chanHandle._val;
 }
 
 void MixerImpl::playStream(
@@ -271,6 +467,9 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+	// Apply pending commands first, they may refer to the slot we reuse
+	applyCommands();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
@@ -308,10 +507,35 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
-	//  zero the buf
-	memset(buf, 0, len);
+	// Pick up the parameter changes queued since the last block
+	applyCommands();
+
+	// If no kernels have been selected yet, detect and select
+	if (!mixAccumulate) {
+		mixAccumulate = mixAccumulateGeneric;
+		mixSaturate = mixSaturateGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			mixAccumulate = mixAccumulateNEON;
+			mixSaturate = mixSaturateNEON;
+		}
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			mixAccumulate = mixAccumulateSSE2;
+			mixSaturate = mixSaturateSSE2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			mixAccumulate = mixAccumulateAVX2;
+			mixSaturate = mixSaturateAVX2;
+		}
+#endif
+	}
 
 	// we store 16-bit samples
+	const uint numSamples = len / 2;
 	if (_stereo) {
 		assert(len % 4 == 0);
 		len >>= 2;
@@ -320,64 +544,96 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
+	// The buffers only grow, so this allocates at most a few times
+	if (_mixBuffer.size() < numSamples)
+		allocateBuffers(numSamples);
+
+	int32 *mixBuf = _mixBuffer.data();
+	memset(mixBuf, 0, numSamples * sizeof(int32));
+
+	// Sound types with insert effects are summed on their own bus first
+	int32 *typeBufs[ARRAYSIZE(_soundTypeEffects)];
+	for (int i = 0; i < ARRAYSIZE(_soundTypeEffects); i++) {
+		if (_soundTypeEffects[i].empty()) {
+			typeBufs[i] = mixBuf;
+		} else {
+			typeBufs[i] = _soundTypeBuffers[i].data();
+			memset(typeBufs[i], 0, numSamples * sizeof(int32));
+		}
+	}
+
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				deleteChannel(i);
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				tmp = _channels[i]->mix(typeBufs[_channels[i]->getType()], _channelBuffer.data(), _effectBuffer.data(), len);
+				_channels[i]->publish(_snapshots[i]);
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+	// run the bus effects and add the buses to the mix
+	for (int i = 0; i < ARRAYSIZE(_soundTypeEffects); i++) {
+		if (typeBufs[i] == mixBuf)
+			continue;
+
+		for (uint j = 0; j < _soundTypeEffects[i].size(); j++)
+			_soundTypeEffects[i][j]->process(typeBufs[i], len);
+		for (uint j = 0; j < numSamples; j++)
+			mixBuf[j] += typeBufs[i][j];
+	}
+
+	for (uint i = 0; i < _outputEffects.size(); i++)
+		_outputEffects[i]->process(mixBuf, len);
+
+	// clip the sum of all channels in one go
+	mixSaturate(buf, mixBuf, numSamples);
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+			deleteChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+			deleteChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	deleteChannel(index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(ChannelCommand::kUpdateSoundType, type, 0);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -386,67 +642,54 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSnapshot *snapshot = getSnapshot(handle);
+	if (!snapshot)
 		return;
 
-	_channels[index]->setVolume(volume);
+	snapshot->volume = volume;
+	queueCommand(ChannelCommand::kSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getVolume();
+	const ChannelSnapshot *snapshot = getSnapshot(handle);
+	return snapshot ? snapshot->volume.load() : 0;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSnapshot *snapshot = getSnapshot(handle);
+	if (!snapshot)
 		return;
 
-	_channels[index]->setBalance(balance);
+	snapshot->balance = balance;
+	queueCommand(ChannelCommand::kSetBalance, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getBalance();
+	const ChannelSnapshot *snapshot = getSnapshot(handle);
+	return snapshot ? snapshot->balance.load() : 0;
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSnapshot *snapshot = getSnapshot(handle);
+	if (!snapshot)
 		return;
 
-	_channels[index]->setRate(rate);
+	snapshot->rate = rate;
+	queueCommand(ChannelCommand::kSetRate, handle._val, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-	
-	return _channels[index]->getRate();
+	const ChannelSnapshot *snapshot = getSnapshot(handle);
+	return snapshot ? snapshot->rate.load() : 0;
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelSnapshot *snapshot = getSnapshot(handle);
+	if (!snapshot)
 		return;
-	
-	_channels[index]->resetRate();
+
+	snapshot->rate = snapshot->nativeRate.load();
+	queueCommand(ChannelCommand::kResetRate, handle._val, 0);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -454,17 +697,50 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Audio::Timestamp ts(0, _sampleRate);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return Timestamp(0, _sampleRate);
+	const ChannelSnapshot *snapshot = getSnapshot(handle);
+	if (!snapshot)
+		return ts;
 
-	return _channels[index]->getElapsedTime();
+	// Read a consistent set of values without locking out the audio thread
+	uint32 sequence, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		sequence = snapshot->sequence;
+		samplesConsumed = snapshot->samplesConsumed;
+		mixerTimeStamp = snapshot->mixerTimeStamp;
+		pauseStartTime = snapshot->pauseStartTime;
+		pauseTime = snapshot->pauseTime;
+		paused = snapshot->paused;
+	} while ((sequence & 1) || sequence != snapshot->sequence);
+
+	if (mixerTimeStamp == 0)
+		return ts;
+
+	uint32 delta;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
+	else
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
+
+	// Convert the number of samples into a time duration.
+
+	ts = ts.addFrames(samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
+	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
+	// isn't invoked at the regular intervals that I first imagined.
+
+	return ts;
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -474,71 +750,48 @@ void MixerImpl::loopChannel(SoundHandle handle) {
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
-	}
+	queueCommand(ChannelCommand::kPauseAll, 0, paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
-		}
-	}
+	queueCommand(ChannelCommand::kPauseID, id, paused);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!getSnapshot(handle))
 		return;
 
-	_channels[index]->pause(paused);
+	queueCommand(ChannelCommand::kPauseHandle, handle._val, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_snapshots[i].handle != SoundHandle()._val && _snapshots[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	const ChannelSnapshot *snapshot = getSnapshot(handle);
+	return snapshot ? snapshot->id.load() : 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return getSnapshot(handle) != nullptr;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_snapshots[i].handle != SoundHandle()._val && _snapshots[i].type == type)
 			return true;
 	return false;
 }
@@ -552,13 +805,9 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(ChannelCommand::kUpdateSoundType, type, 0);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -567,6 +816,67 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	return _soundTypeSettings[type].volume;
 }
 
+void MixerImpl::addChannelEffect(SoundHandle handle, AudioEffect *effect) {
+	assert(effect);
+
+	// Allocate outside of the lock, the audio thread never waits for this
+	effect->prepare(_sampleRate, _stereo);
+
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val) {
+		delete effect;
+		return;
+	}
+
+	_channels[index]->addEffect(effect);
+}
+
+void MixerImpl::addSoundTypeEffect(SoundType type, AudioEffect *effect) {
+	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeEffects));
+	assert(effect);
+
+	effect->prepare(_sampleRate, _stereo);
+
+	Common::StackLock lock(_mutex);
+	_soundTypeEffects[type].push_back(effect);
+}
+
+void MixerImpl::clearSoundTypeEffects(SoundType type) {
+	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeEffects));
+
+	Common::Array<AudioEffect *> effects;
+	{
+		Common::StackLock lock(_mutex);
+		SWAP(effects, _soundTypeEffects[type]);
+	}
+
+	for (uint i = 0; i < effects.size(); i++)
+		delete effects[i];
+}
+
+void MixerImpl::addOutputEffect(AudioEffect *effect) {
+	assert(effect);
+
+	effect->prepare(_sampleRate, _stereo);
+
+	Common::StackLock lock(_mutex);
+	_outputEffects.push_back(effect);
+}
+
+void MixerImpl::clearOutputEffects() {
+	Common::Array<AudioEffect *> effects;
+	{
+		Common::StackLock lock(_mutex);
+		SWAP(effects, _outputEffects);
+	}
+
+	for (uint i = 0; i < effects.size(); i++)
+		delete effects[i];
+}
+
 
 #pragma mark -
 #pragma mark --- Channel implementations ---
@@ -574,7 +884,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
-	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
+	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _reverseStereo(reverseStereo), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
@@ -586,6 +896,8 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 }
 
 Channel::~Channel() {
+	for (uint i = 0; i < _effects.size(); i++)
+		delete _effects[i];
 	delete _converter;
 }
 
@@ -670,32 +982,15 @@ void Channel::pause(bool paused) {
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
+void Channel::publish(ChannelSnapshot &snapshot) const {
+	// Odd sequence numbers mark an update in progress
+	snapshot.sequence++;
+	snapshot.samplesConsumed = _samplesConsumed;
+	snapshot.mixerTimeStamp = _mixerTimeStamp;
+	snapshot.pauseStartTime = _pauseStartTime;
+	snapshot.pauseTime = _pauseTime;
+	snapshot.paused = isPaused();
+	snapshot.sequence++;
 }
 
 void Channel::loop() {
@@ -707,7 +1002,7 @@ void Channel::loop() {
 	}
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int32 *data, int16 *scratch, int32 *effectScratch, uint len) {
 	assert(_stream);
 	assert(_converter);
 
@@ -716,8 +1011,39 @@ int Channel::mix(int16 *data, uint len) {
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
-		res = _converter->convert(*_stream, data, len, _volL, _volR);
+
+		// Render at full volume, the channel volume is applied while
+		// accumulating so that clipping only happens once for the whole mix.
+		const bool stereo = _mixer->getOutputStereo();
+		const uint numSamples = len * (stereo ? 2 : 1);
+		memset(scratch, 0, numSamples * sizeof(int16));
+		res = _converter->convert(*_stream, scratch, len, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
 		_samplesDecoded += res;
+
+		int32 *dst = data;
+		if (!_effects.empty()) {
+			// The effects always get the whole block, so that their tails
+			// keep ringing after the stream ran out of data.
+			dst = effectScratch;
+			memset(dst, 0, numSamples * sizeof(int32));
+		}
+
+		if (!stereo) {
+			const int vol = (_volL + _volR) / 2;
+			mixAccumulate(dst, scratch, res, vol, vol);
+		} else if (_reverseStereo) {
+			// The converter swapped the channels, the volumes follow them
+			mixAccumulate(dst, scratch, res * 2, _volR, _volL);
+		} else {
+			mixAccumulate(dst, scratch, res * 2, _volL, _volR);
+		}
+
+		if (!_effects.empty()) {
+			for (uint i = 0; i < _effects.size(); i++)
+				_effects[i]->process(dst, len);
+			for (uint i = 0; i < numSamples; i++)
+				data[i] += dst[i];
+		}
 	}
 
 	return res;
@@ -28,6 +28,7 @@
 
 namespace Audio {
 
+class AudioEffect;
 class AudioStream;
 class Channel;
 class Timestamp;
@@ -321,6 +322,52 @@ public:
 	 */
 	virtual int getVolumeForSoundType(SoundType type) const = 0;
 
+	/**
+	 * Attach an insert effect to a playing channel.
+	 *
+	 * Effects run in the order they were added, on the channel's samples
+	 * after its volume and balance have been applied. The mixer takes
+	 * ownership of the effect and deletes it together with the channel.
+	 * If the handle does not refer to an active channel, the effect is
+	 * deleted right away.
+	 *
+	 * @param handle  The sound to process.
+	 * @param effect  The effect to attach.
+	 */
+	virtual void addChannelEffect(SoundHandle handle, AudioEffect *effect) = 0;
+
+	/**
+	 * Attach an insert effect to the bus of a sound type.
+	 *
+	 * All channels of that type are summed before the bus effects run on
+	 * the sum. The mixer takes ownership of the effect.
+	 *
+	 * @param type    Sound type.
+	 * @param effect  The effect to attach.
+	 */
+	virtual void addSoundTypeEffect(SoundType type, AudioEffect *effect) = 0;
+
+	/**
+	 * Remove and delete all the effects attached to the bus of a sound type.
+	 *
+	 * @param type  Sound type.
+	 */
+	virtual void clearSoundTypeEffects(SoundType type) = 0;
+
+	/**
+	 * Attach an insert effect to the mixer output, which runs just before
+	 * the mix is converted to 16-bit samples. The mixer takes ownership of
+	 * the effect.
+	 *
+	 * @param effect  The effect to attach.
+	 */
+	virtual void addOutputEffect(AudioEffect *effect) = 0;
+
+	/**
+	 * Remove and delete all the effects attached to the mixer output.
+	 */
+	virtual void clearOutputEffects() = 0;
+
 	/**
 	 * Return the output sample rate of the system.
 	 *
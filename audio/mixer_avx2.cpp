@@ -0,0 +1,78 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mixer_simd.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+void mixAccumulateAVX2(int32 *dst, const int16 *src, uint numSamples, int volL, int volR) {
+	const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+
+	uint i = 0;
+	for (; i + 16 <= numSamples; i += 16) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i lo = _mm256_mullo_epi16(in, vol);
+		const __m256i hi = _mm256_mulhi_epi16(in, vol);
+
+		// The unpacks work on 128-bit lanes, put the products back in order
+		const __m256i prodLo = _mm256_unpacklo_epi16(lo, hi);
+		const __m256i prodHi = _mm256_unpackhi_epi16(lo, hi);
+		const __m256i prod0 = _mm256_permute2x128_si256(prodLo, prodHi, 0x20);
+		const __m256i prod1 = _mm256_permute2x128_si256(prodLo, prodHi, 0x31);
+
+		__m256i out0 = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i out1 = _mm256_loadu_si256((const __m256i *)(dst + i + 8));
+		out0 = _mm256_add_epi32(out0, _mm256_srai_epi32(prod0, 8));
+		out1 = _mm256_add_epi32(out1, _mm256_srai_epi32(prod1, 8));
+		_mm256_storeu_si256((__m256i *)(dst + i), out0);
+		_mm256_storeu_si256((__m256i *)(dst + i + 8), out1);
+	}
+
+	// i is even here, so the tail keeps the left/right order
+	mixAccumulateGeneric(dst + i, src + i, numSamples - i, volL, volR);
+}
+
+void mixSaturateAVX2(int16 *dst, const int32 *src, uint numSamples) {
+	uint i = 0;
+	for (; i + 16 <= numSamples; i += 16) {
+		const __m256i in0 = _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i in1 = _mm256_loadu_si256((const __m256i *)(src + i + 8));
+		const __m256i packed = _mm256_packs_epi32(in0, in1);
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+
+	mixSaturateGeneric(dst + i, src + i, numSamples - i);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
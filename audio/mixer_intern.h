@@ -23,9 +23,12 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
+#include <atomic>
+
 namespace Audio {
 
 /**
@@ -36,6 +39,31 @@ namespace Audio {
  * @{
  */
 
+/**
+ * Channel state published for queries from engine threads, so that those
+ * never have to wait for the audio thread.
+ *
+ * The parameters reflect the last value requested by the engine. The timing
+ * fields are written by the audio thread after each mix; readers retry while
+ * the sequence counter is odd or changes under them.
+ */
+struct ChannelSnapshot {
+	std::atomic<uint32> handle;
+	std::atomic<int> id;
+	std::atomic<int> type;
+	std::atomic<byte> volume;
+	std::atomic<int8> balance;
+	std::atomic<uint32> rate;
+	std::atomic<uint32> nativeRate;
+
+	std::atomic<uint32> sequence;
+	std::atomic<uint32> samplesConsumed;
+	std::atomic<uint32> mixerTimeStamp;
+	std::atomic<uint32> pauseStartTime;
+	std::atomic<uint32> pauseTime;
+	std::atomic<bool> paused;
+};
+
 /**
  * The (default) implementation of the ScummVM audio mixing subsystem.
  *
@@ -58,10 +86,54 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
+	};
+
+	/**
+	 * A channel parameter change requested by an engine thread, to be
+	 * applied by the audio thread at the start of the next mix.
+	 */
+	struct ChannelCommand {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kSetRate,
+			kResetRate,
+			kPauseHandle,
+			kPauseID,
+			kPauseAll,
+			kUpdateSoundType
+		};
+
+		Type type;
+		uint32 handle;
+		int32 value;
+	};
+
+	/**
+	 * Lock-free single-producer/single-consumer ring of channel commands.
+	 * Engine threads are serialized among themselves by _commandMutex and
+	 * the consumer always runs with _mutex held, so the audio thread never
+	 * waits on an engine thread to queue or apply a command.
+	 */
+	class CommandQueue {
+	public:
+		CommandQueue() : _head(0), _tail(0) {}
+
+		/** Returns false if the queue is full. */
+		bool push(const ChannelCommand &cmd);
+		bool pop(ChannelCommand &cmd);
+
+	private:
+		ChannelCommand _commands[COMMAND_QUEUE_SIZE];
+		std::atomic<uint32> _head;
+		std::atomic<uint32> _tail;
 	};
 
 	Common::Mutex _mutex;
+	Common::Mutex _commandMutex;
+	CommandQueue _commandQueue;
 
 	const uint _sampleRate;
 	const bool _stereo;
@@ -72,12 +144,29 @@ private:
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		std::atomic<bool> mute;
+		std::atomic<int> volume;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
+	ChannelSnapshot _snapshots[NUM_CHANNELS];
+
+	/** 32-bit accumulation block all channels are summed into */
+	Common::Array<int32> _mixBuffer;
+
+	/** Block each channel renders its own samples into before accumulation */
+	Common::Array<int16> _channelBuffer;
+
+	/** Block used by channels with insert effects, before adding them to the mix */
+	Common::Array<int32> _effectBuffer;
+
+	/** Insert effects of the sound type buses, and the buses they process */
+	Common::Array<AudioEffect *> _soundTypeEffects[4];
+	Common::Array<int32> _soundTypeBuffers[4];
+
+	/** Insert effects of the mixer output */
+	Common::Array<AudioEffect *> _outputEffects;
 
 
 public:
@@ -132,6 +221,12 @@ public:
 	virtual void setVolumeForSoundType(SoundType type, int volume);
 	virtual int getVolumeForSoundType(SoundType type) const;
 
+	virtual void addChannelEffect(SoundHandle handle, AudioEffect *effect);
+	virtual void addSoundTypeEffect(SoundType type, AudioEffect *effect);
+	virtual void clearSoundTypeEffects(SoundType type);
+	virtual void addOutputEffect(AudioEffect *effect);
+	virtual void clearOutputEffects();
+
 	virtual uint getOutputRate() const;
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
@@ -139,6 +234,23 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	/** Returns the snapshot of the channel playing @p handle, if any. */
+	ChannelSnapshot *getSnapshot(SoundHandle handle);
+	const ChannelSnapshot *getSnapshot(SoundHandle handle) const;
+
+	/** Deletes the channel in slot @p index and clears its snapshot. */
+	void deleteChannel(int index);
+
+	/** Grows the mixing blocks to hold @p numSamples samples. */
+	void allocateBuffers(uint numSamples);
+
+	void queueCommand(ChannelCommand::Type type, uint32 handle, int32 value);
+
+	/** Applies all queued commands. Must be called with _mutex held. */
+	void applyCommands();
+	void applyCommand(const ChannelCommand &cmd);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
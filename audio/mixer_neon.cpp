@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/mixer_simd.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Audio {
+
+void mixAccumulateNEON(int32 *dst, const int16 *src, uint numSamples, int volL, int volR) {
+	const int16 volArray[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	uint i = 0;
+	for (; i + 8 <= numSamples; i += 8) {
+		const int16x8_t in = vld1q_s16(src + i);
+		const int32x4_t prod0 = vshrq_n_s32(vmull_s16(vget_low_s16(in), vol), 8);
+		const int32x4_t prod1 = vshrq_n_s32(vmull_s16(vget_high_s16(in), vol), 8);
+		vst1q_s32(dst + i, vaddq_s32(vld1q_s32(dst + i), prod0));
+		vst1q_s32(dst + i + 4, vaddq_s32(vld1q_s32(dst + i + 4), prod1));
+	}
+
+	// i is even here, so the tail keeps the left/right order
+	mixAccumulateGeneric(dst + i, src + i, numSamples - i, volL, volR);
+}
+
+void mixSaturateNEON(int16 *dst, const int32 *src, uint numSamples) {
+	uint i = 0;
+	for (; i + 8 <= numSamples; i += 8) {
+		const int16x4_t out0 = vqmovn_s32(vld1q_s32(src + i));
+		const int16x4_t out1 = vqmovn_s32(vld1q_s32(src + i + 4));
+		vst1q_s16(dst + i, vcombine_s16(out0, out1));
+	}
+
+	mixSaturateGeneric(dst + i, src + i, numSamples - i);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
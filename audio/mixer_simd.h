@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_MIXER_SIMD_H
+#define AUDIO_MIXER_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * Internal mixing kernels used by MixerImpl. Channels are rendered into a
+ * 32-bit accumulation block, which is saturated to 16 bits only once, after
+ * all channels have been summed.
+ */
+
+/**
+ * Scales @p numSamples interleaved samples from @p src and adds them to
+ * @p dst. Even samples are scaled by @p volL, odd ones by @p volR; both are
+ * in the range 0 - Mixer::kMaxMixerVolume. @p dst and @p src need no
+ * particular alignment.
+ */
+typedef void (*MixAccumulateFunc)(int32 *dst, const int16 *src, uint numSamples, int volL, int volR);
+
+/**
+ * Saturates @p numSamples accumulated samples from @p src to 16 bits.
+ */
+typedef void (*MixSaturateFunc)(int16 *dst, const int32 *src, uint numSamples);
+
+/**
+ * The kernels used by the mixer. Selected on first use from the CPU
+ * features reported by OSystem, unless they have already been set.
+ */
+extern MixAccumulateFunc mixAccumulate;
+extern MixSaturateFunc mixSaturate;
+
+void mixAccumulateGeneric(int32 *dst, const int16 *src, uint numSamples, int volL, int volR);
+void mixSaturateGeneric(int16 *dst, const int32 *src, uint numSamples);
+#ifdef SCUMMVM_NEON
+void mixAccumulateNEON(int32 *dst, const int16 *src, uint numSamples, int volL, int volR);
+void mixSaturateNEON(int16 *dst, const int32 *src, uint numSamples);
+#endif
+#ifdef SCUMMVM_SSE2
+void mixAccumulateSSE2(int32 *dst, const int16 *src, uint numSamples, int volL, int volR);
+void mixSaturateSSE2(int16 *dst, const int32 *src, uint numSamples);
+#endif
+#ifdef SCUMMVM_AVX2
+void mixAccumulateAVX2(int32 *dst, const int16 *src, uint numSamples, int volL, int volR);
+void mixSaturateAVX2(int16 *dst, const int32 *src, uint numSamples);
+#endif
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mixer_simd.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Audio {
+
+void mixAccumulateSSE2(int32 *dst, const int16 *src, uint numSamples, int volL, int volR) {
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	uint i = 0;
+	for (; i + 8 <= numSamples; i += 8) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+
+		__m128i out0 = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i out1 = _mm_loadu_si128((const __m128i *)(dst + i + 4));
+		out0 = _mm_add_epi32(out0, _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 8));
+		out1 = _mm_add_epi32(out1, _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 8));
+		_mm_storeu_si128((__m128i *)(dst + i), out0);
+		_mm_storeu_si128((__m128i *)(dst + i + 4), out1);
+	}
+
+	// i is even here, so the tail keeps the left/right order
+	mixAccumulateGeneric(dst + i, src + i, numSamples - i, volL, volR);
+}
+
+void mixSaturateSSE2(int16 *dst, const int32 *src, uint numSamples) {
+	uint i = 0;
+	for (; i + 8 <= numSamples; i += 8) {
+		const __m128i in0 = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i in1 = _mm_loadu_si128((const __m128i *)(src + i + 4));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(in0, in1));
+	}
+
+	mixSaturateGeneric(dst + i, src + i, numSamples - i);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -6,6 +6,7 @@ MODULE_OBJS := \
 	audiostream.o \
 	casio.o \
 	cms.o \
+	effects.o \
 	fmopl.o \
 	mididrv.o \
 	mididrv_ms.o \
@@ -22,6 +23,8 @@ MODULE_OBJS := \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	synthtrace.o \
+	synthtrace_drivers.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -109,5 +112,24 @@ MODULE_OBJS += \
 	rwopl3.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	mixer_neon.o \
+	rate_neon.o \
+	softsynth/opl/dbopl_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	mixer_sse2.o \
+	rate_sse2.o \
+	softsynth/opl/dbopl_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	mixer_avx2.o \
+	rate_avx2.o \
+	softsynth/opl/dbopl_avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
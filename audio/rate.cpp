@@ -29,7 +29,15 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -297,7 +305,374 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
+#pragma mark -
+#pragma mark --- Polyphase converter ---
+#pragma mark -
+
+/**
+ * Windowed-sinc coefficient table for one input/output rate pair.
+ *
+ * The table holds numPhases sub-filters of kPolyphaseTaps Q15 coefficients
+ * each. Sub-filter p interpolates the input at a fractional offset of
+ * p / numPhases samples. Every sub-filter is normalized to unity DC gain.
+ */
+struct PolyphaseFilter {
+	enum {
+		/** Upper bound on the number of sub-filters kept per rate pair. */
+		kMaxPhases = 640
+	};
+
+	PolyphaseFilter(st_rate_t inputRate, st_rate_t outputRate);
+
+	st_rate_t inRate, outRate;
+
+	/** Reduced ratio: the converter advances by inStep/outStep input samples per output sample. */
+	uint32 inStep, outStep;
+	uint numPhases;
+
+	/** Maps a phase in [0, outStep) to a sub-filter index (16.16 fixed point). */
+	uint32 phaseScale;
+
+	Common::Array<int16> coeffs;
+
+	const int16 *getPhase(uint32 phase) const {
+		return &coeffs[((phase * phaseScale) >> 16) * kPolyphaseTaps];
+	}
+};
+
+static double besselI0(double x) {
+	// Power series, converges quickly for the beta values used here
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+PolyphaseFilter::PolyphaseFilter(st_rate_t inputRate, st_rate_t outputRate) : inRate(inputRate), outRate(outputRate) {
+	const uint32 div = Common::gcd<uint32>(inRate, outRate);
+	inStep = inRate / div;
+	outStep = outRate / div;
+
+	numPhases = MIN<uint32>(outStep, kMaxPhases);
+	phaseScale = (numPhases << 16) / outStep;
+	if (numPhases == outStep)
+		phaseScale = 1 << 16;
+
+	// Cut off slightly below the Nyquist frequency of the lower of both rates,
+	// measured in cycles per input sample.
+	const double cutoff = 0.5 * 0.92 * MIN<double>(1.0, (double)outRate / inRate);
+	const double beta = 7.0;
+	const double halfLength = kPolyphaseTaps / 2;
+	const double windowNorm = besselI0(beta);
+
+	coeffs.resize(numPhases * kPolyphaseTaps);
+
+	if (inStep == outStep) {
+		// Matching rates are copied through by the converter, the table is
+		// never read.
+		memset(&coeffs[0], 0, kPolyphaseTaps * sizeof(int16));
+		return;
+	}
+
+	double taps[kPolyphaseTaps];
+	for (uint p = 0; p < numPhases; ++p) {
+		const double frac = (double)p / numPhases;
+		double sum = 0.0;
+
+		for (int k = 0; k < kPolyphaseTaps; ++k) {
+			// Tap kPolyphaseTaps / 2 - 1 sits on the current input sample.
+			const double t = (k - (kPolyphaseTaps / 2 - 1)) - frac;
+			const double x = 2.0 * M_PI * cutoff * t;
+			const double sinc = (fabs(x) < 1e-9) ? 1.0 : sin(x) / x;
+			const double w = t / halfLength;
+			const double window = (fabs(w) >= 1.0) ? 0.0 : besselI0(beta * sqrt(1.0 - w * w)) / windowNorm;
+
+			taps[k] = sinc * window;
+			sum += taps[k];
+		}
+
+		int16 *dst = &coeffs[p * kPolyphaseTaps];
+		for (int k = 0; k < kPolyphaseTaps; ++k)
+			dst[k] = (int16)CLIP<double>(floor(taps[k] / sum * 32768.0 + 0.5), -32768.0, 32767.0);
+	}
+}
+
+/**
+ * Small cache of coefficient tables, so that channels using the same rate
+ * pair, or repeatedly switching between a few rates, share their tables.
+ */
+class PolyphaseFilterCache : public Common::Singleton<PolyphaseFilterCache> {
+public:
+	Common::SharedPtr<const PolyphaseFilter> getFilter(st_rate_t inRate, st_rate_t outRate) {
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _filters.size(); ++i) {
+			if (_filters[i]->inRate == inRate && _filters[i]->outRate == outRate) {
+				Common::SharedPtr<const PolyphaseFilter> filter = _filters[i];
+				// Keep the most recently used entry at the back
+				_filters.remove_at(i);
+				_filters.push_back(filter);
+				return filter;
+			}
+		}
+
+		if (_filters.size() >= kMaxEntries)
+			_filters.remove_at(0);
+
+		Common::SharedPtr<const PolyphaseFilter> filter(new PolyphaseFilter(inRate, outRate));
+		_filters.push_back(filter);
+		return filter;
+	}
+
+private:
+	friend class Common::Singleton<PolyphaseFilterCache>;
+
+	enum {
+		kMaxEntries = 16
+	};
+
+	Common::Mutex _mutex;
+	Common::Array<Common::SharedPtr<const PolyphaseFilter> > _filters;
+};
+
+// Initialize this to nullptr at the start
+FIRDotProductFunc firDotProduct = nullptr;
+
+static FIRDotProductFunc getFIRDotProduct() {
+	// If no function has been selected yet, detect and select
+	if (!firDotProduct) {
+		firDotProduct = firDotProductGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) firDotProduct = firDotProductNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) firDotProduct = firDotProductSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) firDotProduct = firDotProductAVX2;
+#endif
+	}
+	return firDotProduct;
+}
+
+int32 firDotProductGeneric(const int16 *samples, const int16 *coeffs) {
+	int32 acc = 0;
+	for (int i = 0; i < kPolyphaseTaps; ++i)
+		acc += samples[i] * coeffs[i];
+	return acc;
+}
+
+/**
+ * Band-limited converter that interpolates with a bank of windowed-sinc
+ * sub-filters. More expensive than the linear interpolation done by
+ * RateConverter_Impl, but it does not alias when upsampling the low rate
+ * digital audio used by most games.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class PolyphaseRateConverter_Impl : public RateConverter {
+private:
+	enum {
+		kReadSize = 512,
+		kHistorySize = kPolyphaseTaps + kReadSize
+	};
+
+	/** Input and output rates */
+	st_rate_t _inRate, _outRate;
+
+	Common::SharedPtr<const PolyphaseFilter> _filter;
+	FIRDotProductFunc _dotProduct;
+
+	/** Interleaved samples read from the stream */
+	st_sample_t _buffer[kReadSize];
+
+	/** Deinterleaved input history (left/right channel) */
+	st_sample_t _historyL[kHistorySize];
+	st_sample_t _historyR[kHistorySize];
+
+	/** Start of the filter window and end of the valid data inside the history */
+	int _histPos, _histEnd;
+
+	/** Fractional position between two input samples, in units of 1 / outStep */
+	uint32 _phase;
+
+	/** Whether the tail of the stream has been padded with silence already */
+	bool _tailPadded;
+
+	bool fillHistory(AudioStream &input);
+	void updateFilter();
+
+public:
+	PolyphaseRateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
+	virtual ~PolyphaseRateConverter_Impl() {}
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; updateFilter(); }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; updateFilter(); }
+
+	st_rate_t getInputRate() const override { return _inRate; }
+	st_rate_t getOutputRate() const override { return _outRate; }
+
+	bool needsDraining() const override {
+		return _histEnd - _histPos >= kPolyphaseTaps || (!_tailPadded && _histEnd - _histPos > kPolyphaseTaps / 2 - 1);
+	}
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::PolyphaseRateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+	_inRate(inputRate),
+	_outRate(outputRate),
+	_dotProduct(getFIRDotProduct()),
+	_histPos(0),
+	_histEnd(kPolyphaseTaps / 2 - 1),
+	_phase(0),
+	_tailPadded(false) {
+	// Pre-roll with silence so that the first output sample is centered
+	// on the first input sample.
+	memset(_historyL, 0, sizeof(_historyL));
+	memset(_historyR, 0, sizeof(_historyR));
+	updateFilter();
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::updateFilter() {
+	if (_filter && _filter->inRate == _inRate && _filter->outRate == _outRate)
+		return;
+
+	// Keep the relative position between two input samples
+	const uint32 oldOutStep = _filter ? _filter->outStep : 1;
+	_filter = PolyphaseFilterCache::instance().getFilter(_inRate, _outRate);
+	_phase = (uint32)(((uint64)_phase * _filter->outStep) / oldOutStep);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+bool PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::fillHistory(AudioStream &input) {
+	// Move the unconsumed part of the window to the front
+	if (_histPos > 0) {
+		const int remaining = _histEnd - _histPos;
+		memmove(_historyL, _historyL + _histPos, remaining * sizeof(st_sample_t));
+		if (inStereo)
+			memmove(_historyR, _historyR + _histPos, remaining * sizeof(st_sample_t));
+		_histEnd = remaining;
+		_histPos = 0;
+	}
+
+	const int space = MIN<int>(kHistorySize - _histEnd, kReadSize / (inStereo ? 2 : 1));
+	int count = input.readBuffer(_buffer, space * (inStereo ? 2 : 1));
+
+	if (count <= 0) {
+		// Flush the samples still sitting in the second half of the window
+		// once the stream is really over.
+		if (_tailPadded || !input.endOfStream())
+			return false;
+
+		memset(_historyL + _histEnd, 0, (kPolyphaseTaps / 2) * sizeof(st_sample_t));
+		memset(_historyR + _histEnd, 0, (kPolyphaseTaps / 2) * sizeof(st_sample_t));
+		_histEnd += kPolyphaseTaps / 2;
+		_tailPadded = true;
+		return true;
+	}
+
+	const st_sample_t *src = _buffer;
+	if (inStereo) {
+		count /= 2;
+		for (int i = 0; i < count; ++i) {
+			_historyL[_histEnd + i] = *src++;
+			_historyR[_histEnd + i] = *src++;
+		}
+	} else {
+		memcpy(_historyL + _histEnd, src, count * sizeof(st_sample_t));
+	}
+	_histEnd += count;
+	return true;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == inStereo);
+
+	const PolyphaseFilter &filter = *_filter;
+	const uint32 intStep = filter.inStep / filter.outStep;
+	const uint32 fracStep = filter.inStep % filter.outStep;
+	const bool copy = (filter.inStep == filter.outStep);
+
+	st_sample_t *outStart, *outEnd;
+	outStart = outBuffer;
+	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+
+	while (outBuffer < outEnd) {
+		// Make sure the whole filter window is available
+		while (_histEnd - _histPos < kPolyphaseTaps) {
+			if (!fillHistory(input))
+				return (outBuffer - outStart) / (outStereo ? 2 : 1);
+		}
+
+		st_sample_t inL, inR;
+		if (copy) {
+			inL = _historyL[_histPos + kPolyphaseTaps / 2 - 1];
+			inR = (inStereo ? _historyR[_histPos + kPolyphaseTaps / 2 - 1] : inL);
+		} else {
+			const int16 *coeffs = filter.getPhase(_phase);
+
+			inL = (st_sample_t)CLIP<int32>((_dotProduct(_historyL + _histPos, coeffs) + (1 << 14)) >> 15, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+			inR = (inStereo ?
+						(st_sample_t)CLIP<int32>((_dotProduct(_historyR + _histPos, coeffs) + (1 << 14)) >> 15, ST_SAMPLE_MIN, ST_SAMPLE_MAX) :
+						inL);
+		}
+
+		st_sample_t outL, outR;
+		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		if (outStereo) {
+			// Output left channel
+			clampedAdd(outBuffer[reverseStereo    ], outL);
+
+			// Output right channel
+			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+
+			outBuffer += 2;
+		} else {
+			// Output mono channel
+			clampedAdd(outBuffer[0], (outL + outR) / 2);
+
+			outBuffer += 1;
+		}
+
+		// Increment input position
+		_histPos += intStep;
+		_phase += fracStep;
+		if (_phase >= filter.outStep) {
+			_phase -= filter.outStep;
+			_histPos++;
+		}
+	}
+	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+}
+
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				return new PolyphaseRateConverter_Impl<true, true, true>(inRate, outRate);
+			else
+				return new PolyphaseRateConverter_Impl<true, true, false>(inRate, outRate);
+		} else
+			return new PolyphaseRateConverter_Impl<true, false, false>(inRate, outRate);
+	} else {
+		if (outStereo) {
+			return new PolyphaseRateConverter_Impl<false, true, false>(inRate, outRate);
+		} else
+			return new PolyphaseRateConverter_Impl<false, false, false>(inRate, outRate);
+	}
+}
+
 RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (ConfMan.get("resampler") == "polyphase")
+		return makePolyphaseRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
@@ -315,3 +690,7 @@ RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inSte
 }
 
 } // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PolyphaseFilterCache);
+}
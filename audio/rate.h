@@ -104,8 +104,21 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
+/**
+ * Create a rate converter for the given input/output configuration.
+ *
+ * The resampling algorithm is chosen through the "resampler" config key:
+ * "polyphase" selects the band-limited converter returned by
+ * makePolyphaseRateConverter(), anything else the default linear one.
+ */
 RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
 
+/**
+ * Create a windowed-sinc polyphase rate converter, regardless of the
+ * "resampler" config key.
+ */
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+
 /** @} */
 } // End of namespace Audio
 
@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * Internal helpers shared by the polyphase rate converter and its
+ * SIMD kernels. Not part of the public audio API.
+ */
+
+enum {
+	/**
+	 * Number of taps of every polyphase sub-filter. The SIMD kernels
+	 * process 16 taps per iteration, so this must be a multiple of 16.
+	 */
+	kPolyphaseTaps = 32
+};
+
+/**
+ * Computes the Q15 dot product of kPolyphaseTaps input samples with one
+ * sub-filter of the coefficient table. Neither pointer needs to be aligned.
+ */
+typedef int32 (*FIRDotProductFunc)(const int16 *samples, const int16 *coeffs);
+
+/**
+ * The kernel used by the polyphase converter. Selected on first use from the
+ * CPU features reported by OSystem, unless it has already been set.
+ */
+extern FIRDotProductFunc firDotProduct;
+
+int32 firDotProductGeneric(const int16 *samples, const int16 *coeffs);
+#ifdef SCUMMVM_NEON
+int32 firDotProductNEON(const int16 *samples, const int16 *coeffs);
+#endif
+#ifdef SCUMMVM_SSE2
+int32 firDotProductSSE2(const int16 *samples, const int16 *coeffs);
+#endif
+#ifdef SCUMMVM_AVX2
+int32 firDotProductAVX2(const int16 *samples, const int16 *coeffs);
+#endif
+
+} // End of namespace Audio
+
+#endif
@@ -37,6 +37,7 @@
 #include "common/util.h"
 #include "common/archive.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/translation.h"
 #include "common/osd_message_queue.h"
 
@@ -102,6 +103,25 @@ public:
 
 }	// end of namespace MT32Emu
 
+namespace {
+
+struct MT32RenderBatch {
+	mt32emu_parallel_job job;
+	void *jobData;
+};
+
+void runMT32RenderJob(void *param, uint index) {
+	const MT32RenderBatch *batch = (const MT32RenderBatch *)param;
+	batch->job(batch->jobData, index);
+}
+
+void MT32EMU_C_CALL runMT32RenderJobs(void *runnerData, mt32emu_parallel_job job, void *jobData, mt32emu_bit32u jobCount) {
+	MT32RenderBatch batch = { job, jobData };
+	((Common::ThreadPool *)runnerData)->run(runMT32RenderJob, &batch, jobCount);
+}
+
+} // End of anonymous namespace
+
 class MidiChannel_MT32 : public MidiChannel_MPU401 {
 	void effectLevel(byte value) override { }
 	void chorusLevel(byte value) override { }
@@ -115,6 +135,7 @@ private:
 	MT32Emu::ScummVMReportHandler _reportHandler;
 	byte *_controlData, *_pcmData;
 	Common::Mutex _mutex;
+	Common::ThreadPool *_threadPool;
 
 	int _outputRate;
 
@@ -155,6 +176,7 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_threadPool = nullptr;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -214,6 +236,19 @@ int MidiDriver_MT32::open() {
 	// Bug #6242 "AUDIO: Built-In MT-32 MUNT Produces Wrong Sounds".
 	_service.setMIDIDelayMode(MT32Emu::MIDIDelayMode_IMMEDIATE);
 
+	// Rendering the partials on several threads gives the same output, so
+	// this only trades CPU cores for a lower load on the audio thread.
+	int renderThreads = ConfMan.getInt("mt32_render_threads");
+	if (renderThreads > 1) {
+		_threadPool = new Common::ThreadPool(renderThreads);
+		if (_threadPool->getThreadCount() > 1) {
+			_service.setParallelRunner(runMT32RenderJobs, _threadPool, _threadPool->getThreadCount());
+		} else {
+			delete _threadPool;
+			_threadPool = nullptr;
+		}
+	}
+
 	// We need to report the sample rate MUNT renders at as sample rate of our
 	// AudioStream.
 	_outputRate = _service.getActualStereoOutputSamplerate();
@@ -276,6 +311,8 @@ void MidiDriver_MT32::close() {
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
+	delete _threadPool;
+	_threadPool = nullptr;
 	delete[] _controlData;
 	_controlData = nullptr;
 	delete[] _pcmData;
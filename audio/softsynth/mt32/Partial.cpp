@@ -62,6 +62,8 @@ Partial::Partial(Synth *useSynth, int usePartialIndex) :
 	ownerPart = -1;
 	poly = NULL;
 	pair = NULL;
+	deactivationOwner = NULL;
+	deferredDeactivationCount = 0;
 	switch (synth->getSelectedRendererType()) {
 	case RendererType_BIT16S:
 		la32Pair = new LA32IntPartialPair;
@@ -113,14 +115,11 @@ void Partial::deactivate() {
 		return;
 	}
 	ownerPart = -1;
-	synth->partialManager->partialDeactivated(partialIndex);
-	if (poly != NULL) {
-		poly->partialDeactivated(this);
+	if (deactivationOwner != NULL) {
+		deactivationOwner->deferredDeactivations[deactivationOwner->deferredDeactivationCount++] = this;
+	} else {
+		notifyDeactivated();
 	}
-#if MT32EMU_MONITOR_PARTIALS > 2
-	synth->printDebug("[+%lu] [Partial %d] Deactivated", sampleNum, partialIndex);
-	synth->printPartialUsage(sampleNum);
-#endif
 	if (isRingModulatingSlave()) {
 		pair->la32Pair->deactivate(LA32PartialPair::SLAVE);
 	} else {
@@ -135,6 +134,37 @@ void Partial::deactivate() {
 	}
 }
 
+void Partial::notifyDeactivated() {
+	synth->partialManager->partialDeactivated(partialIndex);
+	if (poly != NULL) {
+		poly->partialDeactivated(this);
+	}
+#if MT32EMU_MONITOR_PARTIALS > 2
+	synth->printDebug("[+%lu] [Partial %d] Deactivated", sampleNum, partialIndex);
+	synth->printPartialUsage(sampleNum);
+#endif
+}
+
+void Partial::deferDeactivations() {
+	deactivationOwner = this;
+	if (hasRingModulatingSlave()) {
+		pair->deactivationOwner = this;
+	}
+}
+
+void Partial::commitDeactivations() {
+	deactivationOwner = NULL;
+	if (hasRingModulatingSlave()) {
+		pair->deactivationOwner = NULL;
+	}
+	for (unsigned int i = 0; i < deferredDeactivationCount; i++) {
+		Partial *deactivatedPartial = deferredDeactivations[i];
+		deactivatedPartial->deactivationOwner = NULL;
+		deactivatedPartial->notifyDeactivated();
+	}
+	deferredDeactivationCount = 0;
+}
+
 void Partial::startPartial(const Part *part, Poly *usePoly, const PatchCache *usePatchCache, const MemParams::RhythmTemp *rhythmTemp, Partial *pairPartial) {
 	if (usePoly == NULL || usePatchCache == NULL) {
 		synth->printDebug("[Partial %d] *** Error: Starting partial for owner %d, usePoly=%s, usePatchCache=%s", partialIndex, ownerPart, usePoly == NULL ? "*** NULL ***" : "OK", usePatchCache == NULL ? "*** NULL ***" : "OK");
@@ -369,6 +399,32 @@ bool Partial::doProduceOutput(Sample *leftBuf, Sample *rightBuf, Bit32u length,
 	return true;
 }
 
+void Partial::produceSample(IntSampleEx &left, IntSampleEx &right, LA32IntPartialPair *la32IntPair) {
+	IntSampleEx sample = la32IntPair->nextOutSample();
+	left = (sample * leftPanValue) >> 13;
+	right = (sample * rightPanValue) >> 13;
+}
+
+void Partial::produceSample(FloatSample &left, FloatSample &right, LA32FloatPartialPair *la32FloatPair) {
+	FloatSample sample = la32FloatPair->nextOutSample();
+	left = (sample * leftPanValue) / 14.0f;
+	right = (sample * rightPanValue) / 14.0f;
+}
+
+template <class Sample, class LA32PairImpl>
+Bit32u Partial::doProduceUnmixedOutput(Sample *leftBuf, Sample *rightBuf, Bit32u length, LA32PairImpl *la32PairImpl) {
+	if (!canProduceOutput()) return 0;
+	alreadyOutputed = true;
+
+	for (sampleNum = 0; sampleNum < length; sampleNum++) {
+		if (!generateNextSample(la32PairImpl)) break;
+		produceSample(leftBuf[sampleNum], rightBuf[sampleNum], la32PairImpl);
+	}
+	Bit32u producedLength = sampleNum;
+	sampleNum = 0;
+	return producedLength;
+}
+
 bool Partial::produceOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length) {
 	if (floatMode) {
 		synth->printDebug("Partial: Invalid call to produceOutput()! Renderer = %d\n", synth->getSelectedRendererType());
@@ -385,6 +441,22 @@ bool Partial::produceOutput(FloatSample *leftBuf, FloatSample *rightBuf, Bit32u
 	return doProduceOutput(leftBuf, rightBuf, length, static_cast<LA32FloatPartialPair *>(la32Pair));
 }
 
+Bit32u Partial::produceUnmixedOutput(IntSampleEx *leftBuf, IntSampleEx *rightBuf, Bit32u length) {
+	if (floatMode) {
+		synth->printDebug("Partial: Invalid call to produceUnmixedOutput()! Renderer = %d\n", synth->getSelectedRendererType());
+		return 0;
+	}
+	return doProduceUnmixedOutput(leftBuf, rightBuf, length, static_cast<LA32IntPartialPair *>(la32Pair));
+}
+
+Bit32u Partial::produceUnmixedOutput(FloatSample *leftBuf, FloatSample *rightBuf, Bit32u length) {
+	if (!floatMode) {
+		synth->printDebug("Partial: Invalid call to produceUnmixedOutput()! Renderer = %d\n", synth->getSelectedRendererType());
+		return 0;
+	}
+	return doProduceUnmixedOutput(leftBuf, rightBuf, length, static_cast<LA32FloatPartialPair *>(la32Pair));
+}
+
 bool Partial::shouldReverb() {
 	if (!isActive()) {
 		return false;
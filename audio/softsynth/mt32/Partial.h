@@ -80,6 +80,16 @@ private:
 	const PatchCache *patchCache;
 	PatchCache cachebackup;
 
+	// While the partial is rendered on a worker thread, deactivation only updates the state of the partial
+	// (and of its pair). Notifying the PartialManager and the Poly is postponed until the owner (the partial
+	// being rendered) commits it on the rendering thread. See RendererImpl::produceStreamsParallel().
+	Partial *deactivationOwner;
+	// Partials deactivated meanwhile, in order. Only the partial itself and its ring modulating slave may end up here.
+	Partial *deferredDeactivations[2];
+	unsigned int deferredDeactivationCount;
+
+	void notifyDeactivated();
+
 	Bit32u getAmpValue();
 	Bit32u getCutoffValue();
 
@@ -90,6 +100,10 @@ private:
 	bool generateNextSample(LA32PairImpl *la32PairImpl);
 	void produceAndMixSample(IntSample *&leftBuf, IntSample *&rightBuf, LA32IntPartialPair *la32IntPair);
 	void produceAndMixSample(FloatSample *&leftBuf, FloatSample *&rightBuf, LA32FloatPartialPair *la32FloatPair);
+	template <class Sample, class LA32PairImpl>
+	Bit32u doProduceUnmixedOutput(Sample *leftBuf, Sample *rightBuf, Bit32u length, LA32PairImpl *la32PairImpl);
+	void produceSample(IntSampleEx &left, IntSampleEx &right, LA32IntPartialPair *la32IntPair);
+	void produceSample(FloatSample &left, FloatSample &right, LA32FloatPartialPair *la32FloatPair);
 
 public:
 	bool alreadyOutputed;
@@ -124,6 +138,17 @@ public:
 	// made from combining this single partial with its pair, if it has one.
 	bool produceOutput(IntSample *leftBuf, IntSample *rightBuf, Bit32u length);
 	bool produceOutput(FloatSample *leftBuf, FloatSample *rightBuf, Bit32u length);
+
+	// These functions store the contribution of this partial to each output sample instead of mixing it,
+	// so that the output of several partials can be rendered concurrently and mixed afterwards
+	// with exactly the same result as produceOutput(). Returns the number of samples stored.
+	Bit32u produceUnmixedOutput(IntSampleEx *leftBuf, IntSampleEx *rightBuf, Bit32u length);
+	Bit32u produceUnmixedOutput(FloatSample *leftBuf, FloatSample *rightBuf, Bit32u length);
+
+	// Makes the deactivation of this partial and of its ring modulating slave deferred until commitDeactivations().
+	void deferDeactivations();
+	// Notifies about the partials deactivated since deferDeactivations(), in the order of deactivation.
+	void commitDeactivations();
 }; // class Partial
 
 } // namespace MT32Emu
@@ -262,6 +262,13 @@ const Partial *PartialManager::getPartial(unsigned int partialNum) const {
 	return partialTable[partialNum];
 }
 
+Partial *PartialManager::getPartial(unsigned int partialNum) {
+	if (partialNum > synth->getPartialCount() - 1) {
+		return NULL;
+	}
+	return partialTable[partialNum];
+}
+
 Poly *PartialManager::assignPolyToPart(Part *part) {
 	if (firstFreePolyIndex < synth->getPartialCount()) {
 		Poly *poly = freePolys[firstFreePolyIndex];
@@ -57,6 +57,7 @@ public:
 	bool shouldReverb(int i);
 	void clearAlreadyOutputed();
 	const Partial *getPartial(unsigned int partialNum) const;
+	Partial *getPartial(unsigned int partialNum);
 	Poly *assignPolyToPart(Part *part);
 	void polyFreed(Poly *poly);
 	void partialDeactivated(int partialIndex);
@@ -178,6 +178,12 @@ protected:
 
 	void updateDisplayState();
 
+	Bit32u getParallelThreadCount() const {
+		return synth.getParallelThreadCount();
+	}
+
+	void runParallel(ParallelJob job, void *jobData, Bit32u jobCount);
+
 public:
 	Renderer(Synth &useSynth) : synth(useSynth) {}
 
@@ -189,6 +195,29 @@ public:
 	virtual void renderStreams(const DACOutputStreams<FloatSample> &streams, Bit32u len) = 0;
 };
 
+// Type of the samples produced by Partial::produceUnmixedOutput(), and how they are mixed into the output
+// to get the same result as Partial::produceOutput().
+template <class Sample>
+struct PartialOutput;
+
+template <>
+struct PartialOutput<IntSample> {
+	typedef IntSampleEx Sample;
+
+	static inline IntSample mix(IntSample buffer, IntSampleEx partialSample) {
+		return Synth::clipSampleEx(IntSampleEx(buffer) + partialSample);
+	}
+};
+
+template <>
+struct PartialOutput<FloatSample> {
+	typedef FloatSample Sample;
+
+	static inline FloatSample mix(FloatSample buffer, FloatSample partialSample) {
+		return buffer + partialSample;
+	}
+};
+
 template <class Sample>
 class RendererImpl : public Renderer {
 	// These buffers are used for building the output streams as they are found at the DAC entrance.
@@ -207,12 +236,46 @@ class RendererImpl : public Renderer {
 		return buffers;
 	}
 
+	typedef typename PartialOutput<Sample>::Sample PartialSample;
+
+	// These are used for rendering the partials in parallel, see produceParallelOutput().
+	// The arrays are indexed by the position of a partial in the list of partials to render, and allocated on first use.
+	Bit32u *renderPartials;
+	Bit32u *renderPartialJobs;
+	bool *renderPartialReverb;
+	Bit32u *partialOutputLengths;
+	PartialSample *partialOutputs;
+	const Poly **renderPolys;
+	Bit32u renderPartialCount;
+	Bit32u renderLength;
+
+	void allocateParallelBuffers();
+	void produceParallelOutput(Sample *nonReverbLeft, Sample *nonReverbRight, Sample *reverbDryLeft, Sample *reverbDryRight, Bit32u len);
+	static void renderPartialsJob(void *jobData, Bit32u jobIndex);
+
 public:
 	RendererImpl(Synth &useSynth) :
 		Renderer(useSynth),
-		tmpBuffers(createTmpBuffers())
+		tmpBuffers(createTmpBuffers()),
+		renderPartials(NULL),
+		renderPartialJobs(NULL),
+		renderPartialReverb(NULL),
+		partialOutputLengths(NULL),
+		partialOutputs(NULL),
+		renderPolys(NULL),
+		renderPartialCount(0),
+		renderLength(0)
 	{}
 
+	~RendererImpl() {
+		delete[] renderPartials;
+		delete[] renderPartialJobs;
+		delete[] renderPartialReverb;
+		delete[] partialOutputLengths;
+		delete[] partialOutputs;
+		delete[] renderPolys;
+	}
+
 	void render(IntSample *stereoStream, Bit32u len);
 	void render(FloatSample *stereoStream, Bit32u len);
 	void renderStreams(const DACOutputStreams<IntSample> &streams, Bit32u len);
@@ -255,8 +318,18 @@ public:
 
 	ReportHandler2 defaultReportHandler;
 	ReportHandler2 *reportHandler2;
+
+	ParallelRunner parallelRunner;
+	void *parallelRunnerData;
+	Bit32u parallelThreadCount;
+
+	Bit32u pitchJitterSeed;
 };
 
+void Renderer::runParallel(ParallelJob job, void *jobData, Bit32u jobCount) {
+	synth.extensions.parallelRunner(synth.extensions.parallelRunnerData, job, jobData, jobCount);
+}
+
 Bit32u Synth::getLibraryVersionInt() {
 	return MT32EMU_CURRENT_VERSION_INT;
 }
@@ -332,6 +405,7 @@ Synth::Synth(ReportHandler *useReportHandler) :
 	renderedSampleCount = 0;
 	extensions.display = NULL;
 	extensions.oldMT32DisplayFeatures = false;
+	setParallelRunner(NULL, NULL, 0);
 }
 
 Synth::~Synth() {
@@ -724,6 +798,7 @@ bool Synth::open(const ROMImage &controlROMImage, const ROMImage &pcmROMImage, B
 	partialCount = usePartialCount;
 	abortingPoly = NULL;
 	extensions.abortingPartIx = 0;
+	extensions.pitchJitterSeed = 0;
 
 	// This is to help detect bugs
 	memset(&mt32ram, '?', sizeof(mt32ram));
@@ -2138,6 +2213,21 @@ RendererType Synth::getSelectedRendererType() const {
 	return extensions.selectedRendererType;
 }
 
+void Synth::setParallelRunner(ParallelRunner runner, void *runnerData, Bit32u threadCount) {
+	extensions.parallelRunner = runner;
+	extensions.parallelRunnerData = runnerData;
+	extensions.parallelThreadCount = (runner == NULL || threadCount < 2) ? 1 : threadCount;
+}
+
+Bit32u Synth::getParallelThreadCount() const {
+	return extensions.parallelThreadCount;
+}
+
+Bit32u Synth::nextPitchJitterSeed() {
+	extensions.pitchJitterSeed = extensions.pitchJitterSeed * 1103515245 + 12345;
+	return extensions.pitchJitterSeed >> 16;
+}
+
 Bit32u Synth::getStereoOutputSampleRate() const {
 	return (analog == NULL) ? SAMPLE_RATE : analog->getOutputSampleRate();
 }
@@ -2463,6 +2553,91 @@ void RendererImpl<FloatSample>::convertSamplesToOutput(FloatSample *buffer, Bit3
 	}
 }
 
+template <class Sample>
+void RendererImpl<Sample>::allocateParallelBuffers() {
+	const Bit32u partialCount = synth.getPartialCount();
+	renderPartials = new Bit32u[partialCount];
+	renderPartialJobs = new Bit32u[partialCount];
+	renderPartialReverb = new bool[partialCount];
+	partialOutputLengths = new Bit32u[partialCount];
+	partialOutputs = new PartialSample[2 * MAX_SAMPLES_PER_RUN * partialCount];
+	renderPolys = new const Poly *[partialCount];
+}
+
+template <class Sample>
+void RendererImpl<Sample>::renderPartialsJob(void *jobData, Bit32u jobIndex) {
+	RendererImpl<Sample> &renderer = *static_cast<RendererImpl<Sample> *>(jobData);
+	for (Bit32u i = 0; i < renderer.renderPartialCount; i++) {
+		if (renderer.renderPartialJobs[i] != jobIndex) continue;
+		Partial *partial = renderer.getPartialManager().getPartial(renderer.renderPartials[i]);
+		PartialSample *left = renderer.partialOutputs + 2 * MAX_SAMPLES_PER_RUN * i;
+		PartialSample *right = left + MAX_SAMPLES_PER_RUN;
+		renderer.partialOutputLengths[i] = partial->produceUnmixedOutput(left, right, renderer.renderLength);
+	}
+}
+
+// Renders the partials in several jobs, each of them into a buffer of its own. The results are then mixed
+// in the order of the partial indices, just like the serial renderer does, so that the output is identical.
+// Everything a partial may touch besides its own state while rendering belongs to its poly, thus the partials
+// of a poly are rendered in the same job, in order. The changes that deactivation makes to the shared state
+// are postponed and replayed in the order they would have occurred when rendering serially.
+template <class Sample>
+void RendererImpl<Sample>::produceParallelOutput(Sample *nonReverbLeft, Sample *nonReverbRight, Sample *reverbDryLeft, Sample *reverbDryRight, Bit32u len) {
+	if (partialOutputs == NULL) {
+		allocateParallelBuffers();
+	}
+
+	PartialManager &partialManager = getPartialManager();
+	const Bit32u threadCount = getParallelThreadCount();
+	Bit32u polyCount = 0;
+	renderPartialCount = 0;
+	for (Bit32u partialIx = 0; partialIx < synth.getPartialCount(); partialIx++) {
+		Partial *partial = partialManager.getPartial(partialIx);
+		// Ring modulating slaves are rendered by their masters
+		if (!partial->isActive() || partial->isRingModulatingSlave()) continue;
+		const Poly *poly = partial->getPoly();
+		Bit32u polyIx = 0;
+		while (polyIx < polyCount && renderPolys[polyIx] != poly) polyIx++;
+		if (polyIx == polyCount) {
+			renderPolys[polyCount++] = poly;
+		}
+		renderPartials[renderPartialCount] = partialIx;
+		renderPartialJobs[renderPartialCount] = polyIx % threadCount;
+		renderPartialReverb[renderPartialCount] = partialManager.shouldReverb(partialIx);
+		renderPartialCount++;
+	}
+
+	if (polyCount < 2) {
+		// Nothing to split
+		for (Bit32u i = 0; i < renderPartialCount; i++) {
+			if (renderPartialReverb[i]) {
+				partialManager.produceOutput(renderPartials[i], reverbDryLeft, reverbDryRight, len);
+			} else {
+				partialManager.produceOutput(renderPartials[i], nonReverbLeft, nonReverbRight, len);
+			}
+		}
+		return;
+	}
+
+	for (Bit32u i = 0; i < renderPartialCount; i++) {
+		partialManager.getPartial(renderPartials[i])->deferDeactivations();
+	}
+	renderLength = len;
+	runParallel(renderPartialsJob, this, polyCount < threadCount ? polyCount : threadCount);
+
+	for (Bit32u i = 0; i < renderPartialCount; i++) {
+		Sample *left = renderPartialReverb[i] ? reverbDryLeft : nonReverbLeft;
+		Sample *right = renderPartialReverb[i] ? reverbDryRight : nonReverbRight;
+		const PartialSample *partialLeft = partialOutputs + 2 * MAX_SAMPLES_PER_RUN * i;
+		const PartialSample *partialRight = partialLeft + MAX_SAMPLES_PER_RUN;
+		for (Bit32u sampleIx = 0; sampleIx < partialOutputLengths[i]; sampleIx++) {
+			left[sampleIx] = PartialOutput<Sample>::mix(left[sampleIx], partialLeft[sampleIx]);
+			right[sampleIx] = PartialOutput<Sample>::mix(right[sampleIx], partialRight[sampleIx]);
+		}
+		partialManager.getPartial(renderPartials[i])->commitDeactivations();
+	}
+}
+
 template <class Sample>
 void RendererImpl<Sample>::produceStreams(const DACOutputStreams<Sample> &streams, Bit32u len) {
 	if (isActivated()) {
@@ -2477,11 +2652,15 @@ void RendererImpl<Sample>::produceStreams(const DACOutputStreams<Sample> &stream
 		Synth::muteSampleBuffer(reverbDryLeft, len);
 		Synth::muteSampleBuffer(reverbDryRight, len);
 
-		for (unsigned int i = 0; i < synth.getPartialCount(); i++) {
-			if (getPartialManager().shouldReverb(i)) {
-				getPartialManager().produceOutput(i, reverbDryLeft, reverbDryRight, len);
-			} else {
-				getPartialManager().produceOutput(i, nonReverbLeft, nonReverbRight, len);
+		if (getParallelThreadCount() > 1) {
+			produceParallelOutput(nonReverbLeft, nonReverbRight, reverbDryLeft, reverbDryRight, len);
+		} else {
+			for (unsigned int i = 0; i < synth.getPartialCount(); i++) {
+				if (getPartialManager().shouldReverb(i)) {
+					getPartialManager().produceOutput(i, reverbDryLeft, reverbDryRight, len);
+				} else {
+					getPartialManager().produceOutput(i, nonReverbLeft, nonReverbRight, len);
+				}
 			}
 		}
 
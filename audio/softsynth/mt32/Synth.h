@@ -128,6 +128,14 @@ public:
 	virtual void onMidiMessageLEDStateUpdated(bool /* ledState */) {}
 };
 
+// Callback running a single job of a batch submitted to a ParallelRunner.
+typedef void (*ParallelJob)(void *jobData, Bit32u jobIndex);
+
+// Callback for the client to supply a way to run jobs on multiple threads, used to render partials in parallel.
+// Must invoke job(jobData, jobIndex) for each jobIndex in range 0..jobCount-1, possibly concurrently,
+// and only return when all of them are completed.
+typedef void (*ParallelRunner)(void *runnerData, ParallelJob job, void *jobData, Bit32u jobCount);
+
 class Synth {
 friend class DefaultMidiStreamParser;
 friend class Display;
@@ -256,6 +264,10 @@ private:
 	void resetMasterTunePitchDelta();
 	Bit32s getMasterTunePitchDelta() const;
 
+	// Returns the seed for the pitch timer jitter of a starting partial. The sequence restarts when the synth is opened,
+	// so the output only depends on the MIDI input.
+	Bit32u nextPitchJitterSeed();
+
 public:
 	static inline Bit16s clipSampleEx(Bit32s sampleEx) {
 		// Clamp values above 32767 to 32767, and values below -32768 to -32768
@@ -509,6 +521,14 @@ public:
 	// See RendererType for details.
 	MT32EMU_EXPORT RendererType getSelectedRendererType() const;
 
+	// Sets a runner used to render the active partials on multiple threads. The partials are split among up to
+	// threadCount jobs per rendered block, and the output is exactly the same as when rendered on a single thread.
+	// Passing a NULL runner or threadCount below 2 makes the partials render on the calling thread (the default).
+	// The runner is only invoked from the rendering thread. It must be synchronised with the rendering thread.
+	MT32EMU_EXPORT void setParallelRunner(ParallelRunner runner, void *runnerData, Bit32u threadCount);
+	// Returns the maximum number of jobs the partials are split into per rendered block, 1 if rendering on a single thread.
+	MT32EMU_EXPORT Bit32u getParallelThreadCount() const;
+
 	// Returns actual sample rate used in emulation of stereo analog circuitry of hardware units.
 	// See comment for render() below.
 	MT32EMU_EXPORT Bit32u getStereoOutputSampleRate() const;
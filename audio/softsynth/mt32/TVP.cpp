@@ -171,6 +171,7 @@ void TVP::reset(const Part *usePart, const TimbreParam::PartialParam *usePartial
 	// FIXME: We're using a per-TVP timer instead of a system-wide one for convenience.
 	timeElapsed = 0;
 	processTimerIncrement = 0;
+	jitterSeed = partial->getSynth()->nextPitchJitterSeed();
 
 	basePitch = calcBasePitch(partial, partialParam, patchTemp, key, partial->getSynth()->controlROMFeatures);
 	currentPitchOffset = calcTargetPitchOffsetWithoutLFO(partialParam, 0, velocity);
@@ -327,7 +328,8 @@ Bit16u TVP::nextPitch() {
 	if (counter == 0) {
 		timeElapsed = (timeElapsed + processTimerIncrement) & 0x00FFFFFF;
 		// This roughly emulates pitch deviations observed on real units when playing a single partial that uses TVP/LFO.
-		counter = NOMINAL_PROCESS_TIMER_PERIOD_SAMPLES + (rand() & 3);
+		jitterSeed = jitterSeed * 1664525 + 1013904223;
+		counter = NOMINAL_PROCESS_TIMER_PERIOD_SAMPLES + ((jitterSeed >> 16) & 3);
 		processTimerIncrement = (processTimerTicksPerSampleX16 * counter) >> 4;
 		process();
 	}
@@ -40,6 +40,10 @@ private:
 	int processTimerIncrement;
 	int counter;
 	Bit32u timeElapsed;
+	// State of the generator of the timer period jitter. Each TVP draws from its own sequence
+	// so that partials can be rendered in any order, or concurrently, with the same result.
+	// It is seeded from Synth::nextPitchJitterSeed() when the partial starts.
+	Bit32u jitterSeed;
 
 	int phase;
 	Bit32u basePitch;
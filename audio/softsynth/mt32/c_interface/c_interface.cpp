@@ -43,7 +43,7 @@ static mt32emu_service_version MT32EMU_C_CALL getSynthVersionID(mt32emu_service_
 	return MT32EMU_SERVICE_VERSION_CURRENT;
 }
 
-static const mt32emu_service_i_v6 SERVICE_VTABLE = {
+static const mt32emu_service_i_v7 SERVICE_VTABLE = {
 	getSynthVersionID,
 	mt32emu_get_supported_report_handler_version,
 	mt32emu_get_supported_midi_receiver_version,
@@ -136,7 +136,8 @@ static const mt32emu_service_i_v6 SERVICE_VTABLE = {
 	mt32emu_set_part_volume_override,
 	mt32emu_get_part_volume_override,
 	mt32emu_get_sound_group_name,
-	mt32emu_get_sound_name
+	mt32emu_get_sound_name,
+	mt32emu_set_parallel_runner
 };
 
 } // namespace MT32Emu
@@ -150,6 +151,8 @@ struct mt32emu_data {
 	Bit32u partialCount;
 	AnalogOutputMode analogOutputMode;
 	SamplerateConversionState *srcState;
+	mt32emu_parallel_runner parallelRunner;
+	void *parallelRunnerData;
 };
 
 // Internal C++ utility stuff
@@ -458,6 +461,23 @@ static mt32emu_return_code createFileStream(const char *filename, FileStream *&f
 	return rc;
 }
 
+struct ParallelJobBatch {
+	ParallelJob job;
+	void *jobData;
+};
+
+static void MT32EMU_C_CALL runParallelJob(void *batchData, mt32emu_bit32u jobIndex) {
+	const ParallelJobBatch *batch = static_cast<const ParallelJobBatch *>(batchData);
+	batch->job(batch->jobData, jobIndex);
+}
+
+// Adapts the C++ ParallelRunner callback to the one supplied via the C interface.
+static void runParallelJobs(void *runnerData, ParallelJob job, void *jobData, Bit32u jobCount) {
+	const mt32emu_data *data = static_cast<const mt32emu_data *>(runnerData);
+	ParallelJobBatch batch = { job, jobData };
+	data->parallelRunner(data->parallelRunnerData, runParallelJob, &batch, jobCount);
+}
+
 } // namespace MT32Emu
 
 // C-visible implementation
@@ -466,7 +486,7 @@ extern "C" {
 
 mt32emu_service_i MT32EMU_C_CALL mt32emu_get_service_i() {
 	mt32emu_service_i i;
-	i.v6 = &SERVICE_VTABLE;
+	i.v7 = &SERVICE_VTABLE;
 	return i;
 }
 
@@ -561,6 +581,9 @@ mt32emu_context MT32EMU_C_CALL mt32emu_create_context(mt32emu_report_handler_i r
 	data->srcState->srcQuality = SamplerateConversionQuality_GOOD;
 	data->srcState->src = NULL;
 
+	data->parallelRunner = NULL;
+	data->parallelRunnerData = NULL;
+
 	return data;
 }
 
@@ -955,6 +978,12 @@ mt32emu_boolean MT32EMU_C_CALL mt32emu_get_sound_name(mt32emu_const_context cont
 	return context->synth->getSoundName(sound_name, timbre_group, timbre_number) ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE;
 }
 
+void MT32EMU_C_CALL mt32emu_set_parallel_runner(mt32emu_context context, mt32emu_parallel_runner runner, void *runner_data, mt32emu_bit32u thread_count) {
+	context->parallelRunner = runner;
+	context->parallelRunnerData = runner_data;
+	context->synth->setParallelRunner(runner == NULL ? NULL : runParallelJobs, context, thread_count);
+}
+
 void MT32EMU_C_CALL mt32emu_read_memory(mt32emu_const_context context, mt32emu_bit32u addr, mt32emu_bit32u len, mt32emu_bit8u *data) {
 	context->synth->readMemory(addr, len, data);
 }
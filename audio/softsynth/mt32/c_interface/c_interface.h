@@ -600,6 +600,14 @@ MT32EMU_EXPORT_V(2.7) mt32emu_boolean MT32EMU_C_CALL mt32emu_get_sound_group_nam
  */
 MT32EMU_EXPORT_V(2.7) mt32emu_boolean MT32EMU_C_CALL mt32emu_get_sound_name(mt32emu_const_context context, char *sound_name, mt32emu_bit8u timbreGroup, mt32emu_bit8u timbreNumber);
 
+/**
+ * Sets a runner used to render the active partials on multiple threads. The partials are split among up to
+ * thread_count jobs per rendered block, and the output is exactly the same as when rendered on a single thread.
+ * Passing a NULL runner or thread_count below 2 makes the partials render on the calling thread (the default).
+ * The runner is only invoked from the rendering thread. This function must be synchronised with the rendering thread.
+ */
+MT32EMU_EXPORT_V(2.7) void MT32EMU_C_CALL mt32emu_set_parallel_runner(mt32emu_context context, mt32emu_parallel_runner runner, void *runner_data, mt32emu_bit32u thread_count);
+
 /** Stores internal state of emulated synth into an array provided (as it would be acquired from hardware). */
 MT32EMU_EXPORT void MT32EMU_C_CALL mt32emu_read_memory(mt32emu_const_context context, mt32emu_bit32u addr, mt32emu_bit32u len, mt32emu_bit8u *data);
 
@@ -112,6 +112,16 @@ typedef struct {
 	float *reverbWetRight;
 } mt32emu_dac_output_float_streams;
 
+/** Callback running a single job of a batch submitted to a parallel runner. */
+typedef void (MT32EMU_C_CALL *mt32emu_parallel_job)(void *job_data, mt32emu_bit32u job_index);
+
+/**
+ * Callback for running jobs on multiple threads, used to render partials in parallel.
+ * Must invoke job(job_data, job_index) for each job_index in range 0..job_count-1, possibly concurrently,
+ * and only return when all of them are completed.
+ */
+typedef void (MT32EMU_C_CALL *mt32emu_parallel_runner)(void *runner_data, mt32emu_parallel_job job, void *job_data, mt32emu_bit32u job_count);
+
 /* === Interface handling === */
 
 /** Report handler interface versions */
@@ -136,7 +146,8 @@ typedef enum {
 	MT32EMU_SERVICE_VERSION_4 = 4,
 	MT32EMU_SERVICE_VERSION_5 = 5,
 	MT32EMU_SERVICE_VERSION_6 = 6,
-	MT32EMU_SERVICE_VERSION_CURRENT = MT32EMU_SERVICE_VERSION_6
+	MT32EMU_SERVICE_VERSION_7 = 7,
+	MT32EMU_SERVICE_VERSION_CURRENT = MT32EMU_SERVICE_VERSION_7
 } mt32emu_service_version;
 
 /* === Report Handler Interface === */
@@ -370,6 +381,9 @@ typedef union mt32emu_service_i mt32emu_service_i;
 	mt32emu_boolean (MT32EMU_C_CALL *getSoundGroupName)(mt32emu_const_context context, char *sound_group_name, mt32emu_bit8u timbre_group, mt32emu_bit8u timbre_number); \
 	mt32emu_boolean (MT32EMU_C_CALL *getSoundName)(mt32emu_const_context context, char *sound_name, mt32emu_bit8u timbre_group, mt32emu_bit8u timbre_number);
 
+#define MT32EMU_SERVICE_I_V7 \
+	void (MT32EMU_C_CALL *setParallelRunner)(mt32emu_context context, mt32emu_parallel_runner runner, void *runner_data, mt32emu_bit32u thread_count);
+
 typedef struct {
 	MT32EMU_SERVICE_I_V0
 } mt32emu_service_i_v0;
@@ -419,6 +433,17 @@ typedef struct {
 	MT32EMU_SERVICE_I_V6
 } mt32emu_service_i_v6;
 
+typedef struct {
+	MT32EMU_SERVICE_I_V0
+	MT32EMU_SERVICE_I_V1
+	MT32EMU_SERVICE_I_V2
+	MT32EMU_SERVICE_I_V3
+	MT32EMU_SERVICE_I_V4
+	MT32EMU_SERVICE_I_V5
+	MT32EMU_SERVICE_I_V6
+	MT32EMU_SERVICE_I_V7
+} mt32emu_service_i_v7;
+
 /**
  * Extensible interface for all the library services.
  * Union intended to view an interface of any subsequent version as any parent interface not requiring a cast.
@@ -432,6 +457,7 @@ union mt32emu_service_i {
 	const mt32emu_service_i_v4 *v4;
 	const mt32emu_service_i_v5 *v5;
 	const mt32emu_service_i_v6 *v6;
+	const mt32emu_service_i_v7 *v7;
 };
 
 #undef MT32EMU_SERVICE_I_V0
@@ -441,5 +467,6 @@ union mt32emu_service_i {
 #undef MT32EMU_SERVICE_I_V4
 #undef MT32EMU_SERVICE_I_V5
 #undef MT32EMU_SERVICE_I_V6
+#undef MT32EMU_SERVICE_I_V7
 
 #endif /* #ifndef MT32EMU_C_TYPES_H */
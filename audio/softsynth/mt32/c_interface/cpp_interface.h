@@ -121,6 +121,7 @@ mt32emu_service_i mt32emu_get_service_i();
 #define mt32emu_get_patch_name i.v0->getPatchName
 #define mt32emu_get_sound_group_name iV6()->getSoundGroupName
 #define mt32emu_get_sound_name iV6()->getSoundName
+#define mt32emu_set_parallel_runner iV7()->setParallelRunner
 #define mt32emu_read_memory i.v0->readMemory
 #define mt32emu_get_display_state iV5()->getDisplayState
 #define mt32emu_set_main_display_mode iV5()->setMainDisplayMode
@@ -326,6 +327,8 @@ public:
 	bool getSoundName(char *soundName, Bit8u timbreGroup, Bit8u timbreNumber) { return mt32emu_get_sound_name(c, soundName, timbreGroup, timbreNumber) != MT32EMU_BOOL_FALSE; }
 	void readMemory(Bit32u addr, Bit32u len, Bit8u *data) { mt32emu_read_memory(c, addr, len, data); }
 
+	void setParallelRunner(mt32emu_parallel_runner runner, void *runner_data, Bit32u thread_count) { mt32emu_set_parallel_runner(c, runner, runner_data, thread_count); }
+
 	bool getDisplayState(char *target_buffer, const bool narrow_lcd) { return mt32emu_get_display_state(c, target_buffer, narrow_lcd ? MT32EMU_BOOL_TRUE : MT32EMU_BOOL_FALSE) != MT32EMU_BOOL_FALSE; }
 	void setMainDisplayMode() { mt32emu_set_main_display_mode(c); }
 
@@ -346,6 +349,7 @@ private:
 	const mt32emu_service_i_v4 *iV4() { return (getVersionID() < MT32EMU_SERVICE_VERSION_4) ? NULL : i.v4; }
 	const mt32emu_service_i_v5 *iV5() { return (getVersionID() < MT32EMU_SERVICE_VERSION_5) ? NULL : i.v5; }
 	const mt32emu_service_i_v6 *iV6() { return (getVersionID() < MT32EMU_SERVICE_VERSION_6) ? NULL : i.v6; }
+	const mt32emu_service_i_v7 *iV7() { return (getVersionID() < MT32EMU_SERVICE_VERSION_7) ? NULL : i.v7; }
 #endif
 
 	Service(const Service &);            // prevent copy-construction
@@ -580,6 +584,7 @@ static mt32emu_midi_receiver_i getMidiReceiverThunk() {
 #undef mt32emu_get_patch_name
 #undef mt32emu_get_sound_group_name
 #undef mt32emu_get_sound_name
+#undef mt32emu_set_parallel_runner
 #undef mt32emu_read_memory
 #undef mt32emu_get_display_state
 #undef mt32emu_set_main_display_mode
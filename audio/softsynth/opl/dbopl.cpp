@@ -598,6 +598,87 @@ INLINE Bits Operator::GetSample( Bits modulation ) {
 	}
 }
 
+/*
+	Batched render mode
+*/
+
+void Operator::GenerateEnvelope( const Chip* chip, Bitu samples, Bit32u* output ) {
+	Bitu i = 0;
+	while ( i < samples ) {
+		Bit32u add;
+		Bit32s limit;
+		switch ( state ) {
+		case OFF:
+			for ( ; i < samples; i++ )
+				output[i] = currentLevel + ENV_MAX;
+			return;
+		case SUSTAIN:
+			if ( reg20 & MASK_SUSTAIN ) {
+				for ( ; i < samples; i++ )
+					output[i] = currentLevel + volume;
+				return;
+			}
+			add = releaseAdd;
+			limit = ENV_MAX;
+			break;
+		case RELEASE:
+			add = releaseAdd;
+			limit = ENV_MAX;
+			break;
+		case DECAY:
+			add = decayAdd;
+			limit = sustainLevel;
+			break;
+		default:
+			//The attack curve isn't linear, step it like the regular handler
+			output[i++] = ForwardVolume();
+			continue;
+		}
+		//Until the volume reaches the limit the envelope is a plain ramp
+		Bitu run = samples - i;
+		if ( volume >= limit ) {
+			run = 0;
+		} else if ( add ) {
+			uint64 distance = ( (uint64)( limit - volume ) << RATE_SH ) - rateIndex;
+			uint64 steps = ( distance - 1 ) / add;
+			//Keep the rate counter of the ramp within 32 bits
+			uint64 maxSteps = ( 0xffffffffU - rateIndex ) / add;
+			if ( steps > maxSteps )
+				steps = maxSteps;
+			if ( steps < run )
+				run = (Bitu)steps;
+		}
+		if ( !run ) {
+			//Let the regular handler take care of the state change
+			output[i++] = ForwardVolume();
+			continue;
+		}
+		chip->rampHandler( output + i, rateIndex, add, RATE_SH, currentLevel + volume, run );
+		Bit32u end = rateIndex + run * add;
+		volume += end >> RATE_SH;
+		rateIndex = end & RATE_MASK;
+		i += run;
+	}
+}
+
+void Operator::GeneratePhase( const Chip* chip, Bitu samples, Bit32u* output ) {
+	chip->rampHandler( output, waveIndex, waveCurrent, WAVE_SH, 0, samples );
+	waveIndex += samples * waveCurrent;
+}
+
+INLINE Bits Operator::GetBatchSample( Bitu vol, Bitu index, Bits modulation ) {
+	if ( ENV_SILENT( vol ) )
+		return 0;
+	return GetWave( index + modulation, vol );
+}
+
+void RampGeneric( Bit32u* output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count ) {
+	for ( Bitu i = 0; i < count; i++ ) {
+		start += step;
+		output[i] = bias + ( start >> shift );
+	}
+}
+
 Operator::Operator() {
 	chanData = 0;
 	freqMul = 0;
@@ -617,6 +698,7 @@ Operator::Operator() {
 	currentLevel = ENV_MAX;
 	totalLevel = ENV_MAX;
 	volume = ENV_MAX;
+	rateIndex = 0;
 	releaseAdd = 0;
 }
 
@@ -918,6 +1000,11 @@ Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 		Op( 4 )->Prepare( chip );
 		Op( 5 )->Prepare( chip );
 	}
+	//The percussion channels keep being generated sample by sample
+	if ( chip->batchMode && mode != sm2Percussion && mode != sm3Percussion ) {
+		BatchTemplate< mode >( chip, samples, output );
+		return ( mode > sm4Start ) ? ( this + 2 ) : ( this + 1 );
+	}
 	for ( Bitu i = 0; i < samples; i++ ) {
 		//Early out for percussion handlers
 		if ( mode == sm2Percussion ) {
@@ -1025,6 +1112,61 @@ Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 	return nullptr;
 }
 
+template<SynthMode mode>
+void Channel::BatchTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
+	const Bitu ops = ( mode > sm4Start ) ? 4 : 2;
+	while ( samples > 0 ) {
+		Bit32u todo = samples;
+		if ( todo > BATCH_SAMPLES )
+			todo = BATCH_SAMPLES;
+		//The envelope and phase of an operator don't depend on the others, so run them for the whole block
+		for ( Bitu o = 0; o < ops; o++ ) {
+			Op( o )->GenerateEnvelope( chip, todo, chip->batchVolume[o] );
+			Op( o )->GeneratePhase( chip, todo, chip->batchIndex[o] );
+		}
+#define BATCH_SAMPLE( _OP_, _MOD_ ) Op( _OP_ )->GetBatchSample( chip->batchVolume[_OP_][i], chip->batchIndex[_OP_][i], _MOD_ )
+		for ( Bitu i = 0; i < todo; i++ ) {
+			Bit32s mod = (Bit32u)((old[0] + old[1])) >> feedback;
+			old[0] = old[1];
+			old[1] = BATCH_SAMPLE( 0, mod );
+			Bit32s sample = 0;
+			Bit32s out0 = old[0];
+			if ( mode == sm2AM || mode == sm3AM ) {
+				sample = out0 + BATCH_SAMPLE( 1, 0 );
+			} else if ( mode == sm2FM || mode == sm3FM ) {
+				sample = BATCH_SAMPLE( 1, out0 );
+			} else if ( mode == sm3FMFM ) {
+				Bits next = BATCH_SAMPLE( 1, out0 );
+				next = BATCH_SAMPLE( 2, next );
+				sample = BATCH_SAMPLE( 3, next );
+			} else if ( mode == sm3AMFM ) {
+				sample = out0;
+				Bits next = BATCH_SAMPLE( 1, 0 );
+				next = BATCH_SAMPLE( 2, next );
+				sample += BATCH_SAMPLE( 3, next );
+			} else if ( mode == sm3FMAM ) {
+				sample = BATCH_SAMPLE( 1, out0 );
+				Bits next = BATCH_SAMPLE( 2, 0 );
+				sample += BATCH_SAMPLE( 3, next );
+			} else if ( mode == sm3AMAM ) {
+				sample = out0;
+				Bits next = BATCH_SAMPLE( 1, 0 );
+				sample += BATCH_SAMPLE( 2, next );
+				sample += BATCH_SAMPLE( 3, 0 );
+			}
+			if ( mode == sm2AM || mode == sm2FM ) {
+				output[ i ] += sample;
+			} else {
+				output[ i * 2 + 0 ] += sample & maskLeft;
+				output[ i * 2 + 1 ] += sample & maskRight;
+			}
+		}
+#undef BATCH_SAMPLE
+		samples -= todo;
+		output += ( mode == sm2AM || mode == sm2FM ) ? todo : todo * 2;
+	}
+}
+
 /*
 	Chip
 */
@@ -1035,6 +1177,8 @@ Chip::Chip() {
 	regBD = 0;
 	reg104 = 0;
 	opl3Active = 0;
+	batchMode = false;
+	rampHandler = &RampGeneric;
 }
 
 INLINE Bit32u Chip::ForwardNoise() {
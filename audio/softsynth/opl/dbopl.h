@@ -68,6 +68,8 @@ typedef Bits ( DB_FASTCALL *WaveHandler) ( Bitu i, Bitu volume );
 
 typedef Bits ( DBOPL::Operator::*VolumeHandler) ( );
 typedef Channel* ( DBOPL::Channel::*SynthHandler) ( Chip* chip, Bit32u samples, Bit32s* output );
+//Fill output with bias + ( ( start + ( i + 1 ) * step ) >> shift ), wrapping at 32 bits
+typedef void ( *RampHandler ) ( Bit32u* output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count );
 
 //Different synth modes that can generate blocks of data
 typedef enum {
@@ -91,6 +93,11 @@ enum {
 	SHIFT_KEYCODE = 24
 };
 
+//Maximum amount of samples the batched render mode handles in one pass
+enum {
+	BATCH_SAMPLES = 128
+};
+
 struct Operator {
 public:
 	//Masks for operator 20 values
@@ -178,6 +185,11 @@ public:
 
 	Bits GetSample( Bits modulation );
 	Bits GetWave( Bitu index, Bitu vol );
+
+	//Batched render mode, advance the envelope or the phase over a whole block
+	void GenerateEnvelope( const Chip* chip, Bitu samples, Bit32u* output );
+	void GeneratePhase( const Chip* chip, Bitu samples, Bit32u* output );
+	Bits GetBatchSample( Bitu vol, Bitu index, Bits modulation );
 public:
 	Operator();
 };
@@ -215,6 +227,9 @@ struct Channel {
 	//Generate blocks of data in specific modes
 	template<SynthMode mode>
 	Channel* BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output );
+	//Same output as BlockTemplate, with the operator envelopes and phases generated in blocks
+	template<SynthMode mode>
+	void BatchTemplate( Chip* chip, Bit32u samples, Bit32s* output );
 	Channel();
 };
 
@@ -254,6 +269,14 @@ struct Chip {
 	//0 or -1 when enabled
 	Bit8s opl3Active;
 
+	//Generate the envelopes and phases of the operators a block at a time
+	bool batchMode;
+	//Ramp generator used by the batched render mode
+	RampHandler rampHandler;
+	//Envelope levels and wave indices of up to 4 operators for the batched render mode
+	Bit32u batchVolume[4][BATCH_SAMPLES];
+	Bit32u batchIndex[4][BATCH_SAMPLES];
+
 	//Return the maximum amount of samples before and LFO change
 	Bit32u ForwardLFO( Bit32u samples );
 	Bit32u ForwardNoise();
@@ -274,6 +297,17 @@ struct Chip {
 
 void InitTables();
 
+void RampGeneric( Bit32u* output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count );
+#ifdef SCUMMVM_NEON
+void RampNEON( Bit32u* output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count );
+#endif
+#ifdef SCUMMVM_SSE2
+void RampSSE2( Bit32u* output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count );
+#endif
+#ifdef SCUMMVM_AVX2
+void RampAVX2( Bit32u* output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count );
+#endif
+
 }		//Namespace
 } // End of namespace DOSBox
 } // End of namespace OPL
@@ -0,0 +1,62 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/softsynth/opl/dbopl.h"
+
+#ifndef DISABLE_DOSBOX_OPL
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace OPL {
+namespace DOSBox {
+namespace DBOPL {
+
+void RampAVX2(Bit32u *output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count) {
+	__m256i pos = _mm256_add_epi32(_mm256_set1_epi32(start), _mm256_mullo_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8)));
+	const __m256i inc = _mm256_set1_epi32(step * 8);
+	const __m128i sh = _mm_cvtsi32_si128(shift);
+	const __m256i base = _mm256_set1_epi32(bias);
+
+	Bitu i = 0;
+	for (; i + 8 <= count; i += 8) {
+		_mm256_storeu_si256((__m256i *)(output + i), _mm256_add_epi32(base, _mm256_srl_epi32(pos, sh)));
+		pos = _mm256_add_epi32(pos, inc);
+	}
+
+	RampGeneric(output + i, start + i * step, step, shift, bias, count - i);
+}
+
+} // End of namespace DBOPL
+} // End of namespace DOSBox
+} // End of namespace OPL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // !DISABLE_DOSBOX_OPL
@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SCUMMVM_NEON) && !defined(DISABLE_DOSBOX_OPL)
+
+#include "audio/softsynth/opl/dbopl.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace OPL {
+namespace DOSBox {
+namespace DBOPL {
+
+void RampNEON(Bit32u *output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count) {
+	const Bit32u posArray[4] = { start + step, start + step * 2, start + step * 3, start + step * 4 };
+	uint32x4_t pos = vld1q_u32(posArray);
+	const uint32x4_t inc = vdupq_n_u32(step * 4);
+	const int32x4_t sh = vdupq_n_s32(-(int32)shift);
+	const uint32x4_t base = vdupq_n_u32(bias);
+
+	Bitu i = 0;
+	for (; i + 4 <= count; i += 4) {
+		vst1q_u32(output + i, vaddq_u32(base, vshlq_u32(pos, sh)));
+		pos = vaddq_u32(pos, inc);
+	}
+
+	RampGeneric(output + i, start + i * step, step, shift, bias, count - i);
+}
+
+} // End of namespace DBOPL
+} // End of namespace DOSBox
+} // End of namespace OPL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON && !DISABLE_DOSBOX_OPL
@@ -0,0 +1,66 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/softsynth/opl/dbopl.h"
+
+#ifndef DISABLE_DOSBOX_OPL
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace OPL {
+namespace DOSBox {
+namespace DBOPL {
+
+void RampSSE2(Bit32u *output, Bit32u start, Bit32u step, Bit32u shift, Bit32u bias, Bitu count) {
+	__m128i pos = _mm_set_epi32(start + step * 4, start + step * 3, start + step * 2, start + step);
+	const __m128i inc = _mm_set1_epi32(step * 4);
+	const __m128i sh = _mm_cvtsi32_si128(shift);
+	const __m128i base = _mm_set1_epi32(bias);
+
+	Bitu i = 0;
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_si128((__m128i *)(output + i), _mm_add_epi32(base, _mm_srl_epi32(pos, sh)));
+		pos = _mm_add_epi32(pos, inc);
+	}
+
+	RampGeneric(output + i, start + i * step, step, shift, bias, count - i);
+}
+
+} // End of namespace DBOPL
+} // End of namespace DOSBox
+} // End of namespace OPL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // !DISABLE_DOSBOX_OPL
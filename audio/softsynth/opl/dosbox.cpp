@@ -148,7 +148,7 @@ uint8 Chip::read() {
 	return ret;
 }
 
-OPL::OPL(Config::OplType type) : _type(type), _rate(0), _emulator(nullptr) {
+OPL::OPL(Config::OplType type, bool batched) : _type(type), _batched(batched), _rate(0), _emulator(nullptr) {
 }
 
 OPL::~OPL() {
@@ -175,6 +175,22 @@ bool OPL::init() {
 	_rate = g_system->getMixer()->getOutputRate();
 	_emulator->Setup(_rate);
 
+	if (_batched) {
+		_emulator->batchMode = true;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			_emulator->rampHandler = &DBOPL::RampNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			_emulator->rampHandler = &DBOPL::RampSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			_emulator->rampHandler = &DBOPL::RampAVX2;
+#endif
+	}
+
 	if (_type == Config::kDualOpl2) {
 		// Setup opl3 mode in the hander
 		_emulator->WriteReg(0x105, 1);
@@ -71,6 +71,7 @@ struct Chip;
 class OPL : public ::OPL::EmulatedOPL {
 private:
 	Config::OplType _type;
+	bool _batched;
 	uint _rate;
 
 	DBOPL::Chip *_emulator;
@@ -83,7 +84,12 @@ private:
 	void free();
 	void dualWrite(uint8 index, uint8 reg, uint8 val);
 public:
-	OPL(Config::OplType type);
+	/**
+	 * @param type     The OPL chip to emulate.
+	 * @param batched  Generate the operator envelopes and phases a block at
+	 *                 a time. The output is the same as in the regular mode.
+	 */
+	OPL(Config::OplType type, bool batched = false);
 	~OPL();
 
 	bool init();
@@ -0,0 +1,416 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/synthtrace.h"
+
+#include "common/endian.h"
+#include "common/file.h"
+#include "common/stream.h"
+#include "common/textconsole.h"
+
+namespace Audio {
+
+namespace {
+
+enum {
+	kTraceVersion = 1
+};
+
+enum TraceOpcode {
+	kOpMidiSend = 0x00,
+	kOpMidiSysEx = 0x01,
+	kOpMidiStopAllNotes = 0x02,
+	kOpMidiBaseTempo = 0x03,
+
+	kOpOPLWrite = 0x10,
+	kOpOPLWriteReg = 0x11,
+	kOpOPLReset = 0x12,
+	kOpOPLCallbackFrequency = 0x13
+};
+
+/** Number of data bytes following a MIDI status byte in the trace */
+uint midiDataLength(byte status) {
+	return ((status & 0xE0) == 0xC0) ? 1 : 2;
+}
+
+} // End of anonymous namespace
+
+// Trace writer
+
+SynthTraceWriter::SynthTraceWriter(SynthTraceDevice device, OPL::Config::OplType oplType) :
+	_device(device), _oplType(oplType), _tick(0), _lastTick(0) {
+}
+
+void SynthTraceWriter::tick() {
+	Common::StackLock lock(_mutex);
+	++_tick;
+}
+
+void SynthTraceWriter::startCommand(byte opcode) {
+	writeVarLength(_tick - _lastTick);
+	_lastTick = _tick;
+	_data.push_back(opcode);
+}
+
+void SynthTraceWriter::writeVarLength(uint32 value) {
+	byte buffer[5];
+	int length = 0;
+	do {
+		buffer[length++] = value & 0x7F;
+		value >>= 7;
+	} while (value);
+
+	// Most significant group first, with the high bit set on all but the last byte
+	while (length > 1)
+		_data.push_back(buffer[--length] | 0x80);
+	_data.push_back(buffer[0]);
+}
+
+void SynthTraceWriter::midiSend(uint32 b) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpMidiSend);
+	const byte status = b & 0xFF;
+	_data.push_back(status);
+	_data.push_back((b >> 8) & 0xFF);
+	if (midiDataLength(status) > 1)
+		_data.push_back((b >> 16) & 0xFF);
+}
+
+void SynthTraceWriter::midiSysEx(const byte *msg, uint16 length) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpMidiSysEx);
+	writeVarLength(length);
+	for (uint16 i = 0; i < length; ++i)
+		_data.push_back(msg[i]);
+}
+
+void SynthTraceWriter::midiStopAllNotes(bool stopSustainedNotes) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpMidiStopAllNotes);
+	_data.push_back(stopSustainedNotes ? 1 : 0);
+}
+
+void SynthTraceWriter::midiBaseTempo(uint32 tempo) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpMidiBaseTempo);
+	writeVarLength(tempo);
+}
+
+void SynthTraceWriter::oplWrite(int a, int v) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpOPLWrite);
+	_data.push_back(a & 0xFF);
+	_data.push_back((a >> 8) & 0xFF);
+	_data.push_back(v & 0xFF);
+}
+
+void SynthTraceWriter::oplWriteReg(int r, int v) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpOPLWriteReg);
+	_data.push_back(r & 0xFF);
+	_data.push_back((r >> 8) & 0xFF);
+	_data.push_back(v & 0xFF);
+}
+
+void SynthTraceWriter::oplReset() {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpOPLReset);
+}
+
+void SynthTraceWriter::oplCallbackFrequency(int frequency) {
+	Common::StackLock lock(_mutex);
+	startCommand(kOpOPLCallbackFrequency);
+	writeVarLength(frequency);
+}
+
+bool SynthTraceWriter::save(Common::WriteStream &stream) {
+	Common::StackLock lock(_mutex);
+	stream.writeUint32BE(MKTAG('S', 'T', 'R', 'C'));
+	stream.writeByte(kTraceVersion);
+	stream.writeByte(_device);
+	stream.writeByte(_oplType);
+	stream.write(_data.data(), _data.size());
+	return !stream.err();
+}
+
+bool SynthTraceWriter::save(const Common::Path &filename) {
+	Common::DumpFile file;
+	if (!file.open(filename)) {
+		warning("Could not open '%s' for writing the synthesizer trace", filename.toString(Common::Path::kNativeSeparator).c_str());
+		return false;
+	}
+
+	bool result = save(file);
+	file.finalize();
+	file.close();
+	return result;
+}
+
+// Trace player
+
+SynthTracePlayer::SynthTracePlayer() :
+	_device(kSynthTraceMidi), _oplType(OPL::Config::kOpl2), _error(false), _length(0) {
+	rewind();
+}
+
+bool SynthTracePlayer::load(Common::ReadStream &stream) {
+	_data.clear();
+	_length = 0;
+
+	if (stream.readUint32BE() != MKTAG('S', 'T', 'R', 'C') || stream.readByte() != kTraceVersion)
+		return false;
+	_device = (SynthTraceDevice)stream.readByte();
+	_oplType = (OPL::Config::OplType)stream.readByte();
+	if (stream.err() || stream.eos() || _device > kSynthTraceOPL || _oplType > OPL::Config::kOpl3)
+		return false;
+
+	byte buffer[4096];
+	while (!stream.eos()) {
+		uint32 size = stream.read(buffer, sizeof(buffer));
+		if (stream.err())
+			return false;
+		for (uint32 i = 0; i < size; ++i)
+			_data.push_back(buffer[i]);
+	}
+
+	// Go through the whole trace once, to validate it and find its length
+	rewind();
+	while (!isFinished()) {
+		readDelta();
+		_deltaRead = false;
+		if (!playCommand(nullptr, nullptr) || _error) {
+			_data.clear();
+			rewind();
+			return false;
+		}
+	}
+	_length = (_device == kSynthTraceMidi) ? _commandTime : _commandTick;
+
+	rewind();
+	return true;
+}
+
+void SynthTracePlayer::rewind() {
+	_error = false;
+	_pos = 0;
+	_deltaRead = false;
+	_commandTick = 0;
+	_commandTime = 0;
+	_playTick = 0;
+	_tempo = 0;
+	_frequency = OPL::OPL::kDefaultCallbackFrequency;
+}
+
+byte SynthTracePlayer::readByte() {
+	if (_pos >= _data.size()) {
+		_error = true;
+		return 0;
+	}
+	return _data[_pos++];
+}
+
+uint32 SynthTracePlayer::readVarLength() {
+	uint32 value = 0;
+	for (int i = 0; i < 5; ++i) {
+		const byte b = readByte();
+		value = (value << 7) | (b & 0x7F);
+		if (!(b & 0x80))
+			break;
+	}
+	return value;
+}
+
+void SynthTracePlayer::readDelta() {
+	if (_deltaRead || isFinished())
+		return;
+
+	const uint32 delta = readVarLength();
+	_commandTick += delta;
+	_commandTime += (uint64)delta * _tempo;
+	_deltaRead = true;
+}
+
+bool SynthTracePlayer::playCommand(MidiDriver_BASE *driver, OPL::OPL *opl) {
+	const byte opcode = readByte();
+
+	switch (opcode) {
+	case kOpMidiSend: {
+		const byte status = readByte();
+		uint32 b = status | (readByte() << 8);
+		if (midiDataLength(status) > 1)
+			b |= readByte() << 16;
+		if (driver)
+			driver->send(b);
+		break;
+	}
+
+	case kOpMidiSysEx: {
+		const uint32 length = readVarLength();
+		if (length > _data.size() - MIN<uint>(_pos, _data.size())) {
+			_error = true;
+			return false;
+		}
+		if (driver)
+			driver->sysEx(&_data[_pos], length);
+		_pos += length;
+		break;
+	}
+
+	case kOpMidiStopAllNotes: {
+		const bool stopSustainedNotes = readByte() != 0;
+		if (driver)
+			driver->stopAllNotes(stopSustainedNotes);
+		break;
+	}
+
+	case kOpMidiBaseTempo:
+		_tempo = readVarLength();
+		break;
+
+	case kOpOPLWrite:
+	case kOpOPLWriteReg: {
+		int address = readByte();
+		address |= readByte() << 8;
+		const int value = readByte();
+		if (opl) {
+			if (opcode == kOpOPLWrite)
+				opl->write(address, value);
+			else
+				opl->writeReg(address, value);
+		}
+		break;
+	}
+
+	case kOpOPLReset:
+		if (opl)
+			opl->reset();
+		break;
+
+	case kOpOPLCallbackFrequency:
+		_frequency = readVarLength();
+		if (!_frequency) {
+			_error = true;
+			return false;
+		}
+		if (opl)
+			opl->setCallbackFrequency(_frequency);
+		break;
+
+	default:
+		return false;
+	}
+
+	return !_error;
+}
+
+void SynthTracePlayer::playMidi(MidiDriver_BASE *driver, uint64 time) {
+	while (!isFinished()) {
+		readDelta();
+		if (_commandTime > time)
+			break;
+		_deltaRead = false;
+		if (!playCommand(driver, nullptr))
+			break;
+	}
+}
+
+void SynthTracePlayer::playOPLTick(OPL::OPL *opl) {
+	while (!isFinished()) {
+		readDelta();
+		if (_commandTick > _playTick)
+			break;
+		_deltaRead = false;
+		if (!playCommand(nullptr, opl))
+			break;
+	}
+	++_playTick;
+}
+
+// Recorders
+
+namespace {
+
+class TraceRecorderOPL : public OPL::OPL {
+public:
+	TraceRecorderOPL(::OPL::OPL *opl, ::OPL::Config::OplType type, const Common::Path &filename) :
+		::OPL::OPL(opl), _opl(opl), _filename(filename), _writer(kSynthTraceOPL, type) {
+	}
+
+	~TraceRecorderOPL() override {
+		stop();
+		delete _opl;
+		if (!_writer.empty())
+			_writer.save(_filename);
+	}
+
+	bool init() override { return _opl->init(); }
+
+	void reset() override {
+		_writer.oplReset();
+		_opl->reset();
+	}
+
+	void write(int a, int v) override {
+		_writer.oplWrite(a, v);
+		_opl->write(a, v);
+	}
+
+	byte read(int a) override { return _opl->read(a); }
+
+	void writeReg(int r, int v) override {
+		_writer.oplWriteReg(r, v);
+		_opl->writeReg(r, v);
+	}
+
+	void setCallbackFrequency(int timerFrequency) override {
+		_writer.oplCallbackFrequency(timerFrequency);
+		_opl->setCallbackFrequency(timerFrequency);
+	}
+
+protected:
+	void startCallbacks(int timerFrequency) override {
+		_writer.oplCallbackFrequency(timerFrequency);
+		_opl->start(new Common::Functor0Mem<void, TraceRecorderOPL>(this, &TraceRecorderOPL::onTimer), timerFrequency);
+	}
+
+	void stopCallbacks() override {
+		_opl->stop();
+	}
+
+private:
+	void onTimer() {
+		_writer.tick();
+		if (_callback && _callback->isValid())
+			(*_callback)();
+	}
+
+	::OPL::OPL *_opl;
+	Common::Path _filename;
+	SynthTraceWriter _writer;
+};
+
+} // End of anonymous namespace
+
+OPL::OPL *createOPLTraceRecorder(OPL::OPL *opl, OPL::Config::OplType type, const Common::Path &filename) {
+	return new TraceRecorderOPL(opl, type, filename);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,217 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_SYNTHTRACE_H
+#define AUDIO_SYNTHTRACE_H
+
+#include "audio/fmopl.h"
+#include "audio/mididrv.h"
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/path.h"
+
+namespace Common {
+class ReadStream;
+class WriteStream;
+}
+
+namespace Audio {
+
+/**
+ * @defgroup audio_synthtrace Synthesizer traces
+ * @ingroup audio
+ *
+ * @brief Capture and offline replay of the commands sent to MIDI drivers and OPL chips.
+ * @{
+ */
+
+/**
+ * The device a synthesizer trace was captured from.
+ */
+enum SynthTraceDevice {
+	kSynthTraceMidi = 0,
+	kSynthTraceOPL = 1
+};
+
+/**
+ * Records the commands sent to a MIDI driver or an OPL chip in a compact
+ * binary trace.
+ *
+ * Commands are stamped with the number of timer ticks the device has seen.
+ * Each command starts with the number of ticks since the previous command,
+ * stored as a MIDI style variable length value, followed by an opcode and
+ * its operands. The MIDI base tempo and the OPL callback frequency are part
+ * of the trace, so it can be replayed on a device with a different timer.
+ *
+ * Commands and ticks may be added from different threads.
+ */
+class SynthTraceWriter {
+public:
+	SynthTraceWriter(SynthTraceDevice device, OPL::Config::OplType oplType = OPL::Config::kOpl2);
+
+	bool empty() const { return _data.empty(); }
+
+	/**
+	 * Advance the time by one timer tick of the device.
+	 */
+	void tick();
+
+	void midiSend(uint32 b);
+	void midiSysEx(const byte *msg, uint16 length);
+	void midiStopAllNotes(bool stopSustainedNotes);
+	void midiBaseTempo(uint32 tempo);
+
+	void oplWrite(int a, int v);
+	void oplWriteReg(int r, int v);
+	void oplReset();
+	void oplCallbackFrequency(int frequency);
+
+	/**
+	 * Write the trace, including its header, to the stream.
+	 */
+	bool save(Common::WriteStream &stream);
+
+	/**
+	 * Write the trace to a dump file.
+	 */
+	bool save(const Common::Path &filename);
+
+private:
+	void startCommand(byte opcode);
+	void writeVarLength(uint32 value);
+
+	Common::Mutex _mutex;
+	SynthTraceDevice _device;
+	OPL::Config::OplType _oplType;
+	uint32 _tick;
+	uint32 _lastTick;
+	Common::Array<byte> _data;
+};
+
+/**
+ * Plays a trace written by SynthTraceWriter back to a device, with no
+ * real-time pacing; the caller decides how fast time passes.
+ */
+class SynthTracePlayer {
+public:
+	SynthTracePlayer();
+
+	/**
+	 * Load a trace. Returns false if the stream doesn't hold a valid trace.
+	 */
+	bool load(Common::ReadStream &stream);
+
+	SynthTraceDevice getDevice() const { return _device; }
+	OPL::Config::OplType getOplType() const { return _oplType; }
+
+	/**
+	 * The OPL callback frequency at the current position of the trace.
+	 */
+	int getCallbackFrequency() const { return _frequency; }
+
+	/**
+	 * The length of the trace, in microseconds for MIDI and in callback
+	 * ticks for OPL.
+	 */
+	uint64 getLength() const { return _length; }
+
+	bool isFinished() const { return _pos >= _data.size(); }
+
+	/**
+	 * Send all MIDI commands recorded up to the given time, in microseconds
+	 * since the start of the trace.
+	 */
+	void playMidi(MidiDriver_BASE *driver, uint64 time);
+
+	/**
+	 * Send the OPL commands recorded for the next callback tick. The first
+	 * call plays the commands sent before the callbacks were started.
+	 */
+	void playOPLTick(OPL::OPL *opl);
+
+	/**
+	 * Start again from the beginning of the trace.
+	 */
+	void rewind();
+
+private:
+	byte readByte();
+	uint32 readVarLength();
+	void readDelta();
+	bool playCommand(MidiDriver_BASE *driver, OPL::OPL *opl);
+
+	SynthTraceDevice _device;
+	OPL::Config::OplType _oplType;
+	Common::Array<byte> _data;
+	bool _error;
+
+	/** Read position, and whether the tick delta of the next command has been read */
+	uint _pos;
+	bool _deltaRead;
+
+	/** Tick and time of the next command */
+	uint32 _commandTick;
+	uint64 _commandTime;
+
+	/** Next OPL tick to play */
+	uint32 _playTick;
+
+	uint32 _tempo;
+	int _frequency;
+	uint64 _length;
+};
+
+/**
+ * Wrap a MIDI driver so that everything sent to it is captured into the file
+ * given. The trace is written when the driver is closed. Messages sent through
+ * MidiChannel objects allocated from the driver are not captured.
+ *
+ * The returned driver takes ownership of the wrapped one.
+ */
+MidiDriver *createMidiTraceRecorder(MidiDriver *driver, const Common::Path &filename);
+
+/**
+ * Wrap an OPL chip so that everything written to it is captured into the file
+ * given. The trace is written when the chip is deleted.
+ *
+ * The returned chip takes ownership of the wrapped one.
+ */
+OPL::OPL *createOPLTraceRecorder(OPL::OPL *opl, OPL::Config::OplType type, const Common::Path &filename);
+
+/**
+ * Replay a trace file as fast as possible and print the rendering speed.
+ *
+ * MIDI traces are played on the device selected by the music_driver setting,
+ * OPL traces on the emulator selected by the opl_driver setting. When an
+ * output file is given, the audio rendered by emulated devices is written to
+ * it as a WAVE file. MIDI drivers which don't render through an AudioStream of
+ * their own, such as the OPL based ones, are only sent the commands; replay
+ * the OPL trace captured alongside instead.
+ *
+ * @return  true if the trace could be replayed.
+ */
+bool replaySynthTrace(const Common::Path &filename, const Common::Path &output);
+
+/** @} */
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,352 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/synthtrace.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+// The parts of the synthesizer trace support which need the MIDI driver
+// plugins, kept apart so that the trace format can be used without them.
+
+namespace Audio {
+
+// MIDI recorder
+
+namespace {
+
+class MidiDriver_TraceRecorder : public MidiDriver {
+public:
+	MidiDriver_TraceRecorder(MidiDriver *driver, const Common::Path &filename) :
+		_driver(driver), _filename(filename), _writer(kSynthTraceMidi),
+		_timerProc(nullptr), _timerParam(nullptr) {
+	}
+
+	~MidiDriver_TraceRecorder() override {
+		delete _driver;
+		if (!_writer.empty())
+			_writer.save(_filename);
+	}
+
+	int open() override {
+		int result = _driver->open();
+		if (!result)
+			_writer.midiBaseTempo(_driver->getBaseTempo());
+		return result;
+	}
+
+	bool isOpen() const override { return _driver->isOpen(); }
+
+	void close() override {
+		_driver->close();
+		if (!_writer.empty())
+			_writer.save(_filename);
+	}
+
+	uint32 property(int prop, uint32 param) override { return _driver->property(prop, param); }
+
+	void send(uint32 b) override {
+		_writer.midiSend(b);
+		_driver->send(b);
+	}
+
+	void send(int8 source, uint32 b) override {
+		_writer.midiSend(b);
+		_driver->send(source, b);
+	}
+
+	void sysEx(const byte *msg, uint16 length) override {
+		_writer.midiSysEx(msg, length);
+		_driver->sysEx(msg, length);
+	}
+
+	uint16 sysExNoDelay(const byte *msg, uint16 length) override {
+		_writer.midiSysEx(msg, length);
+		return _driver->sysExNoDelay(msg, length);
+	}
+
+	void metaEvent(byte type, byte *data, uint16 length) override { _driver->metaEvent(type, data, length); }
+	void metaEvent(int8 source, byte type, byte *data, uint16 length) override { _driver->metaEvent(source, type, data, length); }
+
+	void stopAllNotes(bool stopSustainedNotes) override {
+		_writer.midiStopAllNotes(stopSustainedNotes);
+		_driver->stopAllNotes(stopSustainedNotes);
+	}
+
+	bool isReady(int8 source) override { return _driver->isReady(source); }
+
+	void setTimerCallback(void *timerParam, Common::TimerManager::TimerProc timerProc) override {
+		_timerParam = timerParam;
+		_timerProc = timerProc;
+		_driver->setTimerCallback(this, timerProc ? &onTimer : nullptr);
+	}
+
+	uint32 getBaseTempo() override { return _driver->getBaseTempo(); }
+
+	MidiChannel *allocateChannel() override { return _driver->allocateChannel(); }
+	MidiChannel *getPercussionChannel() override { return _driver->getPercussionChannel(); }
+
+	void setEngineSoundFont(Common::SeekableReadStream *soundFontData) override { _driver->setEngineSoundFont(soundFontData); }
+	bool acceptsSoundFontData() override { return _driver->acceptsSoundFontData(); }
+
+private:
+	static void onTimer(void *refCon) {
+		MidiDriver_TraceRecorder *recorder = (MidiDriver_TraceRecorder *)refCon;
+		recorder->_writer.tick();
+		if (recorder->_timerProc)
+			recorder->_timerProc(recorder->_timerParam);
+	}
+
+	MidiDriver *_driver;
+	Common::Path _filename;
+	SynthTraceWriter _writer;
+	Common::TimerManager::TimerProc _timerProc;
+	void *_timerParam;
+};
+
+} // End of anonymous namespace
+
+MidiDriver *createMidiTraceRecorder(MidiDriver *driver, const Common::Path &filename) {
+	return new MidiDriver_TraceRecorder(driver, filename);
+}
+
+// Replay
+
+namespace {
+
+/** Audio rendered after the end of the trace, in seconds, so that released notes can fade out */
+const int kTailLength = 1;
+
+struct ReplayOutput {
+	Common::Array<int16> samples;
+	bool keep;
+	int rate;
+	bool stereo;
+	uint64 frames;
+
+	ReplayOutput(bool keepSamples) : keep(keepSamples), rate(0), stereo(false), frames(0) {}
+
+	void add(const int16 *buffer, uint numFrames) {
+		const uint numSamples = numFrames * (stereo ? 2 : 1);
+		if (keep) {
+			for (uint i = 0; i < numSamples; ++i)
+				samples.push_back(buffer[i]);
+		}
+		frames += numFrames;
+	}
+
+	bool writeWAVE(const Common::Path &filename) const {
+		Common::DumpFile file;
+		if (!file.open(filename)) {
+			warning("Could not open '%s' for writing", filename.toString(Common::Path::kNativeSeparator).c_str());
+			return false;
+		}
+
+		const uint channels = stereo ? 2 : 1;
+		const uint32 dataSize = samples.size() * 2;
+		file.writeUint32BE(MKTAG('R', 'I', 'F', 'F'));
+		file.writeUint32LE(36 + dataSize);
+		file.writeUint32BE(MKTAG('W', 'A', 'V', 'E'));
+		file.writeUint32BE(MKTAG('f', 'm', 't', ' '));
+		file.writeUint32LE(16);
+		file.writeUint16LE(1);
+		file.writeUint16LE(channels);
+		file.writeUint32LE(rate);
+		file.writeUint32LE(rate * channels * 2);
+		file.writeUint16LE(channels * 2);
+		file.writeUint16LE(16);
+		file.writeUint32BE(MKTAG('d', 'a', 't', 'a'));
+		file.writeUint32LE(dataSize);
+		for (uint i = 0; i < samples.size(); ++i)
+			file.writeSint16LE(samples[i]);
+		file.finalize();
+		file.close();
+		return true;
+	}
+};
+
+bool replayOPL(SynthTracePlayer &player, ReplayOutput &output) {
+	OPL::OPL *opl = OPL::Config::create(player.getOplType());
+	if (!opl || !opl->init()) {
+		warning("Could not create an OPL emulator for the trace");
+		delete opl;
+		return false;
+	}
+
+	// The writes done before the callbacks were started
+	player.playOPLTick(opl);
+
+	OPL::EmulatedOPL *emulated = dynamic_cast<OPL::EmulatedOPL *>(opl);
+	if (!emulated) {
+		// Real hardware, send everything as fast as possible
+		while (!player.isFinished())
+			player.playOPLTick(opl);
+		delete opl;
+		return true;
+	}
+
+	// readBuffer() splits its output at callback ticks, which needs a
+	// callback frequency even though no callback is installed
+	opl->setCallbackFrequency(player.getCallbackFrequency());
+
+	output.rate = emulated->getRate();
+	output.stereo = emulated->isStereo();
+	const uint channels = output.stereo ? 2 : 1;
+
+	// Play the commands at the same sample positions as EmulatedOPL::readBuffer()
+	// ran the callbacks while the trace was captured
+	int16 buffer[2048];
+	int nextTick = 0;
+	int tailFrames = output.rate * kTailLength;
+	while (!player.isFinished() || tailFrames > 0) {
+		const int frequency = player.getCallbackFrequency();
+		nextTick += ((output.rate / frequency) << 16) + ((output.rate % frequency) << 16) / frequency;
+
+		int frames = nextTick >> 16;
+		nextTick -= frames << 16;
+		if (player.isFinished())
+			tailFrames -= frames;
+
+		while (frames > 0) {
+			const int step = MIN<int>(frames, ARRAYSIZE(buffer) / channels);
+			emulated->readBuffer(buffer, step * channels);
+			output.add(buffer, step);
+			frames -= step;
+		}
+
+		player.playOPLTick(opl);
+	}
+
+	delete opl;
+	return true;
+}
+
+struct MidiReplayState {
+	SynthTracePlayer *player;
+	MidiDriver *driver;
+	uint64 time;
+};
+
+void midiReplayTimer(void *refCon) {
+	MidiReplayState *state = (MidiReplayState *)refCon;
+	state->time += state->driver->getBaseTempo();
+	state->player->playMidi(state->driver, state->time);
+}
+
+bool replayMidi(SynthTracePlayer &player, ReplayOutput &output) {
+	const int flags = MDT_MIDI | MDT_ADLIB | (ConfMan.getBool("native_mt32") ? MDT_PREFER_MT32 : MDT_PREFER_GM);
+	MidiDriver *driver = MidiDriver::createMidi(MidiDriver::detectDevice(flags));
+	if (!driver) {
+		warning("Could not create a MIDI driver for the trace");
+		return false;
+	}
+
+	// Emulated drivers add themselves to the mixer when opened. Keep the mixer
+	// from playing them, the replay renders them itself.
+	Audio::Mixer *mixer = g_system->getMixer();
+	{
+		Common::StackLock lock(mixer->mutex());
+		if (driver->open()) {
+			warning("Could not open the MIDI driver for the trace");
+			delete driver;
+			return false;
+		}
+		mixer->pauseAll(true);
+	}
+
+	MidiReplayState state = { &player, driver, 0 };
+	player.playMidi(driver, 0);
+
+	Audio::AudioStream *stream = dynamic_cast<Audio::AudioStream *>(driver);
+	if (!stream) {
+		// Real hardware, send everything as fast as possible
+		while (!player.isFinished())
+			midiReplayTimer(&state);
+	} else {
+		output.rate = stream->getRate();
+		output.stereo = stream->isStereo();
+		const uint channels = output.stereo ? 2 : 1;
+
+		driver->setTimerCallback(&state, &midiReplayTimer);
+
+		int16 buffer[2048];
+		const uint step = ARRAYSIZE(buffer) / channels;
+		int tailFrames = output.rate * kTailLength;
+		while (!player.isFinished() || tailFrames > 0) {
+			stream->readBuffer(buffer, step * channels);
+			output.add(buffer, step);
+			if (player.isFinished())
+				tailFrames -= step;
+		}
+
+		driver->setTimerCallback(nullptr, nullptr);
+	}
+
+	driver->close();
+	delete driver;
+	mixer->pauseAll(false);
+	return true;
+}
+
+} // End of anonymous namespace
+
+bool replaySynthTrace(const Common::Path &filename, const Common::Path &output) {
+	Common::File file;
+	if (!file.open(Common::FSNode(filename))) {
+		warning("Could not open the synthesizer trace '%s'", filename.toString(Common::Path::kNativeSeparator).c_str());
+		return false;
+	}
+
+	SynthTracePlayer player;
+	if (!player.load(file)) {
+		warning("'%s' is not a valid synthesizer trace", filename.toString(Common::Path::kNativeSeparator).c_str());
+		return false;
+	}
+
+	ReplayOutput rendered(!output.empty());
+	const uint32 start = g_system->getMillis();
+	const bool result = (player.getDevice() == kSynthTraceOPL) ? replayOPL(player, rendered) : replayMidi(player, rendered);
+	const uint32 elapsed = MAX<uint32>(g_system->getMillis() - start, 1);
+	if (!result)
+		return false;
+
+	if (rendered.rate) {
+		debug("Rendered %llu samples at %d Hz in %u ms: %.0f samples per second, %.2f times real time",
+			(unsigned long long)rendered.frames, rendered.rate, elapsed,
+			rendered.frames * 1000.0 / elapsed, rendered.frames * 1000.0 / elapsed / rendered.rate);
+		if (!output.empty())
+			rendered.writeWAVE(output);
+	} else {
+		debug("Sent the trace to the device in %u ms", elapsed);
+	}
+
+	return true;
+}
+
+} // End of namespace Audio
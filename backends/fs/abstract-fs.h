@@ -41,6 +41,7 @@ typedef Common::Array<AbstractFSNode *>	AbstractFSList;
 class AbstractFSNode {
 protected:
 	friend class Common::FSNode;
+	friend class Common::FSDirectory;
 	typedef Common::FSNode::ListMode ListMode;
 
 	/**
@@ -62,6 +63,27 @@ protected:
 	 */
 	virtual AbstractFSNode *getChild(const Common::String &name) const = 0;
 
+	/**
+	 * Returns the child node with the given name, whose type is already known
+	 * (e.g. from a directory index), without checking the file system again.
+	 *
+	 * @note By default, this method calls getChild().
+	 *
+	 * @param name        String containing the name of the child.
+	 * @param isDirectory Whether the child is a directory.
+	 */
+	virtual AbstractFSNode *getKnownChild(const Common::String &name, bool isDirectory) const { return getChild(name); }
+
+	/**
+	 * Returns a copy of this node which shares no data with it, not even the
+	 * buffers of its strings, without checking the file system again. Each
+	 * copy can then be used by another thread.
+	 *
+	 * @note By default, this method returns 0, and the node is created again
+	 * from its path.
+	 */
+	virtual AbstractFSNode *clone() const { return nullptr; }
+
 	/**
 	 * The parent node of this directory.
 	 * The parent of the root is the root itself.
@@ -118,6 +140,35 @@ public:
 	 */
 	virtual bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const = 0;
 
+	/**
+	 * Get the time of the last modification of this node. For a directory,
+	 * it changes when a child is added, removed or renamed.
+	 *
+	 * @param time Receives the time, in an implementation defined unit.
+	 *
+	 * @return true if successful, false if the time is not available.
+	 */
+	virtual bool getModificationTime(int64 &time) const { return false; }
+
+	/**
+	 * Get the current time, in the unit of getModificationTime(). A node
+	 * changed at the same time may still change without its time changing.
+	 *
+	 * @param time Receives the time.
+	 *
+	 * @return true if successful, false if the time is not available.
+	 */
+	virtual bool getCurrentTime(int64 &time) const { return false; }
+
+	/**
+	 * Get the size of the file referred by this node, without opening it.
+	 *
+	 * @param size Receives the size, in bytes.
+	 *
+	 * @return true if successful, false if the size is not available.
+	 */
+	virtual bool getFileSize(int64 &size) const { return false; }
+
 	/**
 	 * Returns a human readable path string.
 	 *
@@ -122,6 +122,24 @@ AbstractFSNode *DrivePOSIXFilesystemNode::getChild(const Common::String &n) cons
 	return child;
 }
 
+AbstractFSNode *DrivePOSIXFilesystemNode::getKnownChild(const Common::String &n, bool isDirectory) const {
+	return getChildWithKnownType(n, isDirectory);
+}
+
+AbstractFSNode *DrivePOSIXFilesystemNode::clone() const {
+	DrivePOSIXFilesystemNode *node = new DrivePOSIXFilesystemNode(*this);
+	node->unshareStrings();
+	return node;
+}
+
+bool DrivePOSIXFilesystemNode::getModificationTime(int64 &time) const {
+	// The pseudo root lists the drives, it is not a real directory
+	if (_isPseudoRoot)
+		return false;
+
+	return POSIXFilesystemNode::getModificationTime(time);
+}
+
 bool DrivePOSIXFilesystemNode::getChildren(AbstractFSList &list, AbstractFSNode::ListMode mode, bool hidden) const {
 	assert(_isDirectory);
 
@@ -68,7 +68,10 @@ public:
 	Common::SeekableReadStream *createReadStream() override;
 	Common::SeekableWriteStream *createWriteStream() override;
 	AbstractFSNode *getChild(const Common::String &n) const override;
+	AbstractFSNode *getKnownChild(const Common::String &n, bool isDirectory) const override;
+	AbstractFSNode *clone() const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
+	bool getModificationTime(int64 &time) const override;
 	AbstractFSNode *getParent() const override;
 
 protected:
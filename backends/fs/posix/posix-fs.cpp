@@ -33,6 +33,7 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mappedstream.h"
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -48,6 +49,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 
 #ifdef __OS2__
@@ -137,6 +139,60 @@ AbstractFSNode *POSIXFilesystemNode::getChild(const Common::String &n) const {
 	return makeNode(newPath);
 }
 
+void POSIXFilesystemNode::unshareStrings() {
+	_displayName = Common::String(_displayName.c_str());
+	_path = Common::String(_path.c_str());
+}
+
+AbstractFSNode *POSIXFilesystemNode::getKnownChild(const Common::String &n, bool isDirectory) const {
+	assert(!_path.empty());
+	assert(_isDirectory);
+
+	// Make sure the string contains no slashes
+	assert(!n.contains('/'));
+
+	// Like getChildren(), start with a clone of this node, but do not stat()
+	// the child
+	POSIXFilesystemNode *entry = new POSIXFilesystemNode(*this);
+	entry->_displayName = n;
+	if (_path.lastChar() != '/')
+		entry->_path += '/';
+	entry->_path += n;
+	entry->_isValid = true;
+	entry->_isDirectory = isDirectory;
+
+	return entry;
+}
+
+AbstractFSNode *POSIXFilesystemNode::clone() const {
+	POSIXFilesystemNode *node = new POSIXFilesystemNode(*this);
+	node->unshareStrings();
+	return node;
+}
+
+bool POSIXFilesystemNode::getModificationTime(int64 &time) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0)
+		return false;
+
+	time = st.st_mtime;
+	return true;
+}
+
+bool POSIXFilesystemNode::getCurrentTime(int64 &time) const {
+	time = ::time(nullptr);
+	return true;
+}
+
+bool POSIXFilesystemNode::getFileSize(int64 &size) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	return true;
+}
+
 bool POSIXFilesystemNode::getChildren(AbstractFSList &myList, ListMode mode, bool hidden) const {
 	assert(_isDirectory);
 
@@ -265,7 +321,20 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 	return makeNode(Common::String(start, end));
 }
 
+#ifdef HAS_MMAP
+/** Files from this size on are read through a memory mapping */
+static const int64 kMappedStreamMinSize = 256 * 1024;
+#endif
+
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#ifdef HAS_MMAP
+	// Big files are mapped, as engines often seek around in them. Small
+	// ones are usually read in one go, and do not need the mapping.
+	PosixMappedReadStream *mappedStream = PosixMappedReadStream::makeFromPath(getPath(), kMappedStreamMinSize);
+	if (mappedStream)
+		return mappedStream;
+#endif
+
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
@@ -62,7 +62,12 @@ public:
 	bool isWritable() const override;
 
 	AbstractFSNode *getChild(const Common::String &n) const override;
+	AbstractFSNode *getKnownChild(const Common::String &n, bool isDirectory) const override;
+	AbstractFSNode *clone() const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
+	bool getModificationTime(int64 &time) const override;
+	bool getCurrentTime(int64 &time) const override;
+	bool getFileSize(int64 &size) const override;
 	AbstractFSNode *getParent() const override;
 
 	Common::SeekableReadStream *createReadStream() override;
@@ -75,6 +80,12 @@ protected:
 	 * Tests and sets the _isValid and _isDirectory flags, using the stat() function.
 	 */
 	virtual void setFlags();
+
+	/**
+	 * Copies the strings from their characters, so that they do not share
+	 * their buffers with the node this one was copied from.
+	 */
+	void unshareStrings();
 };
 
 namespace Posix {
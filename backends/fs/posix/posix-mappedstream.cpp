@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mappedstream.h"
+
+#ifdef HAS_MMAP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PosixMappedReadStream *PosixMappedReadStream::makeFromPath(const Common::String &path, int64 minSize) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	// Streams sizes are 32-bit, bigger files keep going through stdio
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size < minSize || st.st_size <= 0 || st.st_size > 0xFFFFFFFFLL) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps a reference to the file
+	close(fd);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMappedReadStream((const byte *)data, st.st_size);
+}
+
+PosixMappedReadStream::PosixMappedReadStream(const byte *data, uint32 size) :
+		_data(data), _size(size), _pos(0), _eos(false) {
+}
+
+PosixMappedReadStream::~PosixMappedReadStream() {
+	munmap(const_cast<byte *>(_data), _size);
+}
+
+bool PosixMappedReadStream::seek(int64 offs, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offs += _size;
+		break;
+	case SEEK_CUR:
+		offs += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	// Like fseek(), seeking past the end is allowed, but not before the start
+	if (offs < 0)
+		return false;
+
+	_pos = offs;
+	_eos = false;
+	return true;
+}
+
+uint32 PosixMappedReadStream::read(void *dataPtr, uint32 dataSize) {
+	// Past the end, there is nothing to copy from the mapping
+	if (_pos >= _size) {
+		if (dataSize > 0)
+			_eos = true;
+		return 0;
+	}
+
+	// Read at most as many bytes as are still available...
+	const uint32 available = _size - _pos;
+	if (dataSize > available) {
+		dataSize = available;
+		_eos = true;
+	}
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+const byte *PosixMappedReadStream::getContiguousData(uint32 dataSize) {
+	if (_pos > _size || dataSize > _size - _pos)
+		return nullptr;
+
+	const byte *data = _data + _pos;
+	_pos += dataSize;
+
+	return data;
+}
+
+#endif // HAS_MMAP
@@ -0,0 +1,82 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMAPPEDSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMAPPEDSTREAM_H
+
+#include "common/scummsys.h"
+
+#ifdef HAS_MMAP
+
+#include "common/noncopyable.h"
+#include "common/span.h"
+#include "common/str.h"
+#include "common/stream.h"
+
+/**
+ * A read-only file stream backed by a memory mapping of the whole file.
+ *
+ * Reads are plain copies from the mapping, and seeks do not need a system
+ * call, which helps engines seeking around in big resource files. The
+ * mapped data can also be accessed in place with getSpan().
+ */
+class PosixMappedReadStream final : public Common::SeekableReadStream, public Common::NonCopyable {
+public:
+	/**
+	 * Map the file at the given path.
+	 *
+	 * @param path    The path of the file.
+	 * @param minSize Files smaller than this are not mapped.
+	 * @return The new stream, or nullptr if the file is too small or could
+	 *         not be mapped. The file should then be opened with stdio.
+	 */
+	static PosixMappedReadStream *makeFromPath(const Common::String &path, int64 minSize);
+
+	~PosixMappedReadStream() override;
+
+	bool err() const override { return false; }
+	void clearErr() override {}
+	bool eos() const override { return _eos; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offs, int whence = SEEK_SET) override;
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+	const byte *getContiguousData(uint32 dataSize) override;
+
+	/**
+	 * Return the whole content of the file. It stays valid as long as the
+	 * stream exists.
+	 */
+	Common::Span<const byte> getSpan() const { return Common::Span<const byte>(_data, _size); }
+
+private:
+	PosixMappedReadStream(const byte *data, uint32 size);
+
+	const byte *_data;
+	uint32 _size;
+	int64 _pos;
+	bool _eos;
+};
+
+#endif // HAS_MMAP
+
+#endif
@@ -33,22 +33,23 @@
 
 #include "graphics/blit.h"
 
-#ifdef USE_SCALERS
-#include "graphics/scalerplugin.h"
-#endif
-
 namespace OpenGL {
 
+uint64 GLTexture::_uploadedBytes = 0;
+
 GLTexture::GLTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
 	  _texCoords(), _glFilter(GL_NEAREST),
-	  _glTexture(0) {
+	  _glTexture(0), _pixelBuffers(), _nextPixelBuffer(0) {
 	create();
 }
 
 GLTexture::~GLTexture() {
 	GL_CALL_SAFE(glDeleteTextures, (1, &_glTexture));
+	if (_pixelBuffers[0]) {
+		GL_CALL_SAFE(glDeleteBuffers, (kPixelBufferCount, _pixelBuffers));
+	}
 }
 
 void GLTexture::enableLinearFiltering(bool enable) {
@@ -113,6 +114,11 @@ void GLTexture::setWrapMode(WrapMode wrapMode) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+	if (_pixelBuffers[0]) {
+		GL_CALL(glDeleteBuffers(kPixelBufferCount, _pixelBuffers));
+		memset(_pixelBuffers, 0, sizeof(_pixelBuffers));
+	}
 }
 
 void GLTexture::create() {
@@ -199,26 +205,79 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	// Set the texture on the active texture unit.
 	bind();
 
-	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
-	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+
+#if !USE_FORCED_GLES
+	const uint rowSize = area.width() * bytesPerPixel;
+
+	if (OpenGLContext.pixelBufferObjectSupported) {
+		// Copy the area into the next pixel buffer object, and let the GPU
+		// upload it from there. Respecifying the storage of the buffer lets
+		// the driver hand out new memory when the GPU still reads the old one.
+		if (!_pixelBuffers[0]) {
+			GL_CALL(glGenBuffers(kPixelBufferCount, _pixelBuffers));
+		}
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[_nextPixelBuffer]));
+		_nextPixelBuffer = (_nextPixelBuffer + 1) % kPixelBufferCount;
+
+		// The rows of an area narrower than the surface are packed in the
+		// mapped buffer
+		bool packed = false;
+#if !USE_FORCED_GLES2
+		if ((int)rowSize != src.pitch && OpenGLContext.mapBufferRangeSupported) {
+			const uint size = rowSize * area.height();
+			GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+			byte *dst;
+			GL_ASSIGN(dst, (byte *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+			if (dst) {
+				for (int y = area.top; y < area.bottom; ++y) {
+					memcpy(dst, src.getBasePtr(area.left, y), rowSize);
+					dst += rowSize;
+				}
+				GL_ASSIGN(packed, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+			}
+		}
+#endif
+
+		if (packed) {
+			GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+			                        _glFormat, _glType, nullptr));
+		} else {
+			// Otherwise the rows are copied in one block, with the pitch of
+			// the surface, from the first pixel of the area to the last one
+			const uint size = src.pitch * (area.height() - 1) + rowSize;
+			GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, src.getBasePtr(area.left, area.top), GL_STREAM_DRAW));
+			GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / bytesPerPixel));
+			GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+			                        _glFormat, _glType, nullptr));
+			GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		}
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+		_uploadedBytes += Graphics::DirtyRegion::getUploadSize(area, bytesPerPixel);
+		return;
+	}
+
+	if (OpenGLContext.unpackSubImageSupported) {
+		// Upload the area itself, giving the pitch of the surface.
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                        _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+
+		_uploadedBytes += Graphics::DirtyRegion::getUploadSize(area, bytesPerPixel);
+		return;
+	}
+#endif
+
+	// Without a way to give the pitch of the data to glTexSubImage2D, as
+	// with OpenGL ES 1.0, the whole texture lines of the area are updated.
+	// Copying the area to a temporary buffer would work too, but it is more
+	// complicated, and uploading each line by itself is much slower.
 	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
 	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+	_uploadedBytes += Graphics::DirtyRegion::getUploadSize(area, bytesPerPixel, src.w);
 }
 
 //
@@ -226,7 +285,7 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _dirtyRegion(kMaxDirtyAreas, kDirtyAreaMergeCost) {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -266,24 +325,8 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 	addDirtyArea(r);
 }
 
-void Surface::addDirtyArea(const Common::Rect &r) {
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
-	}
-}
-
-Common::Rect Surface::getDirtyArea() const {
-	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
-	} else {
-		return _dirtyArea;
-	}
+Common::Array<Common::Rect> Surface::getDirtyAreas() const {
+	return _dirtyRegion.getUploadPlan(Common::Rect(getWidth(), getHeight()));
 }
 
 //
@@ -343,12 +386,16 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		updateGLTextureArea(dirtyAreas[i]);
+	}
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
-void Texture::updateGLTexture(Common::Rect &dirtyArea) {
+void Texture::updateGLTextureArea(Common::Rect dirtyArea) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
@@ -379,9 +426,6 @@ void Texture::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
 }
 
 FakeTexture::FakeTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -463,12 +507,15 @@ void FakeTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
 
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
 	Texture::updateGLTexture();
@@ -520,25 +567,28 @@ void TextureRGB555::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
-	const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
+		const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint16 color = *src++;
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
-		}
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
 
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -562,136 +612,32 @@ void TextureRGBA8888Swap::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+	for (uint i = 0; i < dirtyAreas.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyAreas[i];
 
-	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
+		uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
 
-	const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
+		const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint32 color = *src++;
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint32 color = *src++;
 
-			*dst++ = SWAP_BYTES_32(color);
-		}
+				*dst++ = SWAP_BYTES_32(color);
+			}
 
-		src = (const uint32 *)((const byte *)src + srcAdd);
-		dst = (uint32 *)((byte *)dst + dstAdd);
+			src = (const uint32 *)((const byte *)src + srcAdd);
+			dst = (uint32 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
 	Texture::updateGLTexture();
 }
 
-#ifdef USE_SCALERS
-
-ScaledTexture::ScaledTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
-	: FakeTexture(glIntFormat, glFormat, glType, format, fakeFormat), _convData(nullptr), _scaler(nullptr), _scalerIndex(0), _scaleFactor(1), _extraPixels(0) {
-}
-
-ScaledTexture::~ScaledTexture() {
-	delete _scaler;
-
-	if (_convData) {
-		_convData->free();
-		delete _convData;
-	}
-}
-
-void ScaledTexture::allocate(uint width, uint height) {
-	Texture::allocate(width * _scaleFactor, height * _scaleFactor);
-
-	// We only need to reinitialize our surface when the output size
-	// changed.
-	if (width != (uint)_rgbData.w || height != (uint)_rgbData.h) {
-		_rgbData.create(width, height, _fakeFormat);
-	}
-
-	if (_format != _fakeFormat || _extraPixels != 0) {
-		if (!_convData)
-			_convData = new Graphics::Surface();
-
-		_convData->create(width + (_extraPixels * 2), height + (_extraPixels * 2), _format);
-	} else if (_convData) {
-		_convData->free();
-		delete _convData;
-		_convData = nullptr;
-	}
-}
-
-void ScaledTexture::updateGLTexture() {
-	if (!isDirty()) {
-		return;
-	}
-
-	// Convert color space.
-	Graphics::Surface *outSurf = Texture::getSurface();
-
-	Common::Rect dirtyArea = getDirtyArea();
-
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
-
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
-
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
-
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
-
-		src = dst;
-		srcPitch = dstPitch;
-	}
-
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
-
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
-
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
-
-	// Do generic handling of updating the texture.
-	Texture::updateGLTexture(dirtyArea);
-}
-
-void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
-	const PluginList &scalerPlugins = ScalerMan.getPlugins();
-	const ScalerPluginObject &scalerPlugin = scalerPlugins[scalerIndex]->get<ScalerPluginObject>();
-
-	// If the scalerIndex has changed, change scaler plugins
-	if (_scaler && scalerIndex != _scalerIndex) {
-		delete _scaler;
-		_scaler = nullptr;
-	}
-
-	if (!_scaler) {
-		_scaler = scalerPlugin.createInstance(_format);
-	}
-	_scaler->setFactor(scaleFactor);
-
-	_scalerIndex = scalerIndex;
-	_scaleFactor = _scaler->getFactor();
-	_extraPixels = scalerPlugin.extraPixels();
-}
-#endif
-
 #if !USE_FORCED_GLES
 
 // _clut8Texture needs 8 bits internal precision, otherwise graphics glitches
@@ -828,7 +774,10 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		const Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+		for (uint i = 0; i < dirtyAreas.size(); ++i) {
+			_clut8Texture.updateArea(dirtyAreas[i], _clut8Data);
+		}
 		clearDirty();
 	}
 
@@ -25,9 +25,11 @@
 #include "graphics/opengl/system_headers.h"
 #include "graphics/opengl/context.h"
 
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 class Scaler;
@@ -107,6 +109,9 @@ public:
 	/**
 	 * Copy image data to the texture.
 	 *
+	 * When the context has pixel buffer objects, the data goes through them,
+	 * so that the upload does not wait for the GPU.
+	 *
 	 * @param area     The area to update.
 	 * @param src      Surface for the whole texture containing the pixel data
 	 *                 to upload. Only the area described by area will be
@@ -114,6 +119,17 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Query the number of bytes uploaded to all textures since the last
+	 * call to resetUploadedBytes().
+	 */
+	static uint64 getUploadedBytes() { return _uploadedBytes; }
+
+	/**
+	 * Reset the count of bytes uploaded to textures.
+	 */
+	static void resetUploadedBytes() { _uploadedBytes = 0; }
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -158,6 +174,16 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	/**
+	 * Pixel buffer objects used in turn for the uploads, so that the data of
+	 * an upload is not written into a buffer the GPU still reads from.
+	 */
+	static const uint kPixelBufferCount = 3;
+	GLuint _pixelBuffers[kPixelBufferCount];
+	uint _nextPixelBuffer;
+
+	static uint64 _uploadedBytes;
 };
 
 /**
@@ -223,8 +249,8 @@ public:
 	void fill(uint32 color);
 	void fill(const Common::Rect &r, uint32 color);
 
-	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	void flagDirty() { _dirtyRegion.markAll(); }
+	virtual bool isDirty() const { return !_dirtyRegion.isEmpty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -264,13 +290,28 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _dirtyRegion.clear(); }
 
-	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+	void addDirtyArea(const Common::Rect &r) { _dirtyRegion.addRect(r); }
+
+	/**
+	 * @return The dirty areas to upload, which do not overlap.
+	 */
+	Common::Array<Common::Rect> getDirtyAreas() const;
 private:
-	bool _allDirty;
-	Common::Rect _dirtyArea;
+	/**
+	 * The maximum number of dirty areas. Past it, the new areas are merged
+	 * with the ones the least grown by them.
+	 */
+	static const uint kMaxDirtyAreas = 8;
+
+	/**
+	 * Number of pixels an upload costs on its own. Two dirty areas are
+	 * merged when their bounding box is not larger than them by more.
+	 */
+	static const int kDirtyAreaMergeCost = 64 * 64;
+
+	Graphics::DirtyRegion _dirtyRegion;
 };
 
 /**
@@ -314,7 +355,11 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
-	void updateGLTexture(Common::Rect &dirtyArea);
+	/**
+	 * Upload a dirty area of the texture data. This does not clear the dirty
+	 * areas.
+	 */
+	void updateGLTextureArea(Common::Rect dirtyArea);
 
 private:
 	GLTexture _glTexture;
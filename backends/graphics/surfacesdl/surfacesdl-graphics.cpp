@@ -125,6 +125,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_useOldSrc(false), _isHwPalette(false),
 	_overlayscreen(nullptr), _tmpscreen2(nullptr),
 	_screenChangeCount(0),
+	_dirtyRegion(NUM_DIRTY_RECT, DIRTY_RECT_MERGE_COST), _numDirtyRects(0),
 	_mouseSurface(nullptr), _mouseScaler(nullptr),
 	_mouseOrigSurface(nullptr), _cursorDontScale(false), _cursorPaletteDisabled(true),
 	_currentShakeXOffset(0), _currentShakeYOffset(0),
@@ -683,6 +684,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scaler = _scalerPlugin->createInstance(format);
+		_scaler->setThreadPool(ScalerMan.getThreadPool());
 
 		if (_mouseScaler != nullptr) {
 			delete _mouseScaler;
@@ -1309,6 +1311,17 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_isInOverlayPalette = _overlayVisible;
 	}
 
+	// Lay the dirty region out for the scalers
+	_numDirtyRects = 0;
+	for (const Common::Rect &rect : _dirtyRegion.getRects()) {
+		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+
+		r->x = rect.left;
+		r->y = rect.top;
+		r->w = rect.width();
+		r->h = rect.height();
+	}
+
 	// In case of double buferring partially good version may be on another page,
 	// so we need to fully redraw
 	if (_isDoubleBuf && _numDirtyRects)
@@ -1522,6 +1535,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	// Set up the old scale factor
 	_scaler->setFactor(oldScaleFactor);
 
+	_dirtyRegion.clear();
 	_numDirtyRects = 0;
 	_forceRedraw = false;
 	_cursorNeedsRedraw = false;
@@ -1728,11 +1742,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceRedraw = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!inOverlay && !realCoordinates) {
@@ -1783,14 +1792,10 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
-
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
-	}
+	// Past NUM_DIRTY_RECT, the dirty region merges the rects rather than
+	// redrawing the whole screen
+	if (w > 0 && h > 0)
+		_dirtyRegion.addRect(Common::Rect(x, y, x + w, y + h));
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() const {
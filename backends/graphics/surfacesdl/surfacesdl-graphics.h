@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -343,13 +344,18 @@ protected:
 
 	enum {
 		NUM_DIRTY_RECT = 100,
+		// Number of pixels scaling a dirty rect costs on its own
+		DIRTY_RECT_MERGE_COST = 16 * 16,
 		MAX_SCALING = 3
 	};
 
 	// Dirty rect management
+	// The dirty rects of a frame are merged into the dirty region, then
+	// laid out in the list when the screen is updated.
 	// When double-buffering we need to redraw both updates from
 	// current frame and previous frame. For convenience we copy
 	// them here before traversing the list.
+	Graphics::DirtyRegion _dirtyRegion;
 	SDL_Rect _dirtyRectList[2 * NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
@@ -285,6 +285,31 @@ Common::Path OSystem_POSIX::getDefaultDLCsPath() {
 	return Common::Path(prefix).join(dlcsPath);
 }
 
+Common::Path OSystem_POSIX::getDefaultCachePath() {
+	Common::String cachePath;
+
+	// On POSIX systems we follow the XDG Base Directory Specification for
+	// where to store files. The version we based our code upon can be found
+	// over here: https://specifications.freedesktop.org/basedir-spec/basedir-spec-0.8.html
+	const char *prefix = getenv("XDG_CACHE_HOME");
+	if (prefix == nullptr || !*prefix) {
+		prefix = getenv("HOME");
+		if (prefix == nullptr) {
+			return Common::Path();
+		}
+
+		cachePath = ".cache/";
+	}
+
+	cachePath += "scummvm/cache";
+
+	if (!Posix::assureDirectoryExists(cachePath, prefix)) {
+		return Common::Path();
+	}
+
+	return Common::Path(prefix).join(cachePath);
+}
+
 Common::Path OSystem_POSIX::getScreenshotsPath() {
 	// If the user has configured a screenshots path, use it
 	const Common::Path path = OSystem_SDL::getScreenshotsPath();
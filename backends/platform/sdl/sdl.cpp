@@ -333,6 +333,7 @@ void OSystem_SDL::initBackend() {
 
 	ConfMan.registerDefault("iconspath", this->getDefaultIconsPath());
 	ConfMan.registerDefault("dlcspath", this->getDefaultDLCsPath());
+	ConfMan.registerDefault("cachepath", this->getDefaultCachePath());
 
 	_inited = true;
 
@@ -810,6 +811,11 @@ Common::Path OSystem_SDL::getDefaultDLCsPath() {
 	return path;
 }
 
+// Not specified in base class
+Common::Path OSystem_SDL::getDefaultCachePath() {
+	return ConfMan.getPath("cachepath");
+}
+
 //Not specified in base class
 Common::Path OSystem_SDL::getScreenshotsPath() {
 	return ConfMan.getPath("screenshotpath");
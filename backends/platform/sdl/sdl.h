@@ -94,6 +94,7 @@ public:
 	// Default paths
 	virtual Common::Path getDefaultIconsPath();
 	virtual Common::Path getDefaultDLCsPath();
+	virtual Common::Path getDefaultCachePath();
 	virtual Common::Path getScreenshotsPath();
 
 #if defined(USE_OPENGL_GAME) || defined(USE_OPENGL_SHADERS)
@@ -37,6 +37,7 @@
 #include "common/archive.h"
 #include "common/config-manager.h"
 #include "common/compression/deflate.h"
+#include "common/compression/lz4.h"
 
 #include <errno.h>	// for removeSavefile()
 
@@ -129,6 +130,17 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 	}
 }
 
+/**
+ * Wrap a saved game in the compression picked by the savegame_compression
+ * setting. LZ4 is several times faster to write than gzip, for somewhat
+ * bigger files. Both are detected when loading.
+ */
+static Common::WriteStream *wrapSaveWriteStream(Common::WriteStream *stream) {
+	if (ConfMan.get("savegame_compression") == "lz4")
+		return Common::wrapLZ4WriteStream(stream);
+	return Common::wrapCompressedWriteStream(stream);
+}
+
 Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
 	// Assure the savefile name cache is up-to-date.
 	const Common::Path savePathName = getSavePath();
@@ -165,7 +177,7 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	Common::SeekableWriteStream *const sf = fileNode.createWriteStream();
 	if (!sf)
 		return nullptr;
-	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? Common::wrapCompressedWriteStream(sf) : sf);
+	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? wrapSaveWriteStream(sf) : sf);
 
 	// Add file to cache now that it exists.
 	_saveFileCache[filename] = Common::FSNode(fileNode.getPath());
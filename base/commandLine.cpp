@@ -168,6 +168,12 @@ static const char HELP_STRING4[] =
 	"  --native-mt32            True Roland MT-32 (disable GM emulation)\n"
 	"  --dump-midi              Dumps MIDI events to 'dump.mid', until quitting from game\n"
 	"                           (if file already exists, it will be overwritten)\n"
+	"  --dump-synth-trace       Records the commands sent to MIDI drivers and OPL chips\n"
+	"                           to 'dump_midi.trace' and 'dump_opl.trace'\n"
+	"  --replay-synth-trace=FILE Replays a synthesizer trace as fast as possible with\n"
+	"                           the selected music and OPL drivers, and prints the speed\n"
+	"  --synth-trace-output=FILE Writes the audio rendered by --replay-synth-trace to a\n"
+	"                           WAVE file\n"
 	"  --enable-gs              Enable Roland GS mode for MIDI playback\n"
 	"  --output-channels=CHANNELS Select output channel count (e.g. 2 for stereo)\n"
 	"  --output-rate=RATE       Select output sample rate in Hz (e.g. 22050)\n"
@@ -298,6 +304,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("stretch_mode", "default");
 	ConfMan.registerDefault("scaler", "default");
 	ConfMan.registerDefault("scale_factor", -1);
+	ConfMan.registerDefault("scaler_threads", 0);
+	ConfMan.registerDefault("detection_threads", 0);
+	ConfMan.registerDefault("tinygl_threads", 0);
 	ConfMan.registerDefault("shader", Common::Path("default", Common::Path::kNoSeparator));
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("dirtyrects", true);
@@ -316,13 +325,17 @@ void registerDefaults() {
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
 	ConfMan.registerDefault("dump_midi", false);
+	ConfMan.registerDefault("dump_synth_trace", false);
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
+	ConfMan.registerDefault("mt32_render_threads", 0);
 	ConfMan.registerDefault("gm_device", "auto");
 	ConfMan.registerDefault("opl2lpt_parport", "null");
+	ConfMan.registerDefault("resampler", "default");
+	ConfMan.registerDefault("output_limiter", false);
 
 	ConfMan.registerDefault("cdrom", 0);
 
@@ -341,6 +354,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("dump_scripts", false);
 	ConfMan.registerDefault("save_slot", -1);
 	ConfMan.registerDefault("autosave_period", 5 * 60); // By default, trigger autosave every 5 minutes
+	ConfMan.registerDefault("savegame_compression", "gzip");
 	ConfMan.registerDefault("engine_speed", 60); // FPS limit for 3D games
 
 #if defined(ENABLE_SCUMM) || defined(ENABLE_SWORD2)
@@ -881,6 +895,21 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("dump-midi")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("dump-synth-trace")
+			END_OPTION
+
+			DO_LONG_OPTION("replay-synth-trace")
+				Common::FSNode path(option);
+				if (!path.exists()) {
+					usage("Non-existent synthesizer trace '%s'", option);
+				} else if (!path.isReadable()) {
+					usage("Non-readable synthesizer trace '%s'", option);
+				}
+			END_OPTION
+
+			DO_LONG_OPTION("synth-trace-output")
+			END_OPTION
+
 			DO_LONG_OPTION_BOOL("enable-gs")
 			END_OPTION
 
@@ -59,6 +59,7 @@
 
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
+#include "audio/synthtrace.h"
 
 #include "graphics/cursorman.h"
 #include "graphics/fontman.h"
@@ -548,6 +549,11 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		ConfMan.registerDefault("dump_midi", true);
 	}
 
+	if (settings.contains("dump-synth-trace")) {
+		// Store this command line setting in ConfMan, since all transient settings are destroyed
+		ConfMan.registerDefault("dump_synth_trace", true);
+	}
+
 #ifdef USE_OPENGL
 	if (settings.contains("last_window_width")) {
 		ConfMan.setInt("last_window_width", atoi(settings["last_window_width"].c_str()));
@@ -747,9 +753,16 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 			extensionSupportString[neonSupport].c_str());
 	}
 
-	// Unless a game was specified, show the launcher dialog
-	if (nullptr == ConfMan.getActiveDomain())
+	if (settings.contains("replay-synth-trace")) {
+		// Benchmark mode: render a synthesizer trace, then quit without
+		// starting the launcher or a game
+		Audio::replaySynthTrace(Common::Path(settings["replay-synth-trace"], Common::Path::kNativeSeparator),
+			Common::Path(settings.getValOrDefault("synth-trace-output"), Common::Path::kNativeSeparator));
+		ConfMan.setActiveDomain("");
+	} else if (nullptr == ConfMan.getActiveDomain()) {
+		// Unless a game was specified, show the launcher dialog
 		launcherDialog();
+	}
 
 	// FIXME: We're now looping the launcher. This, of course, doesn't
 	// work as well as it should. In theory everything should be destroyed
@@ -25,10 +25,9 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/config-manager.h"
-
-#ifdef DYNAMIC_MODULES
 #include "common/fs.h"
-#endif
+#include "common/system.h"
+#include "common/threadpool.h"
 
 #include "base/detection/detection.h"
 
@@ -658,6 +657,13 @@ namespace Common {
 DECLARE_SINGLETON(EngineManager);
 }
 
+EngineManager::EngineManager() : _detectionPool(nullptr), _detectionPoolCreated(false) {
+}
+
+EngineManager::~EngineManager() {
+	delete _detectionPool;
+}
+
 /**
  * This function works for both cached and uncached PluginManagers.
  * For the cached version, most of the logic here will short circuit.
@@ -714,10 +720,67 @@ QualifiedGameList EngineManager::findGameInLoadedPlugins(const Common::String &g
 	return results;
 }
 
+Common::ThreadPool *EngineManager::getDetectionThreadPool() {
+	if (!_detectionPoolCreated) {
+		_detectionPoolCreated = true;
+
+		int threads = ConfMan.getInt("detection_threads");
+		if (threads >= 0 && threads != 1 && Common::ThreadPool::getHardwareThreadCount() > 1)
+			_detectionPool = new Common::ThreadPool(threads);
+	}
+
+	return _detectionPool;
+}
+
+namespace {
+
+struct ParallelDetection {
+	const PluginList *plugins;
+	/** A clone of the files for each task, as shared nodes are not thread-safe */
+	Common::Array<Common::FSList> fslists;
+	uint32 skipADFlags;
+	bool skipIncomplete;
+	Common::Array<bool> *started;
+};
+
+/** Task @p index starts the detection of every fslists.size()-th plugin */
+void runParallelDetection(void *param, uint index) {
+	ParallelDetection *detection = (ParallelDetection *)param;
+	const PluginList &plugins = *detection->plugins;
+
+	for (uint i = index; i < plugins.size(); i += detection->fslists.size()) {
+		MetaEngineDetection &metaEngine = plugins[i]->get<MetaEngineDetection>();
+		(*detection->started)[i] = metaEngine.startDetectGames(detection->fslists[index], detection->skipADFlags, detection->skipIncomplete);
+	}
+}
+
+} // End of anonymous namespace
+
+void EngineManager::startDetectGames(Common::ThreadPool *pool, const PluginList &plugins, const Common::FSList &fslist,
+                                     uint32 skipADFlags, bool skipIncomplete, Common::Array<bool> &started) {
+	ParallelDetection detection;
+	detection.plugins = &plugins;
+	detection.fslists.resize(MIN<uint>(pool->getThreadCount(), plugins.size()));
+	detection.skipADFlags = skipADFlags;
+	detection.skipIncomplete = skipIncomplete;
+	detection.started = &started;
+
+	// The reference counts of nodes and strings are not atomic, so each task
+	// only uses nodes and strings which no other thread holds. The clones
+	// copy the nodes without checking the file system again.
+	for (uint i = 0; i < detection.fslists.size(); ++i) {
+		detection.fslists[i].reserve(fslist.size());
+		for (Common::FSList::const_iterator file = fslist.begin(); file != fslist.end(); ++file)
+			detection.fslists[i].push_back(file->clone());
+	}
+
+	ADCacheMan.prepareParallelDetection();
+	pool->run(runParallelDetection, &detection, detection.fslists.size());
+}
+
 DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
 	DetectedGames candidates;
 	PluginList plugins;
-	PluginList::const_iterator iter;
 
 	// MetaEngines are always loaded into memory, so, get them and
 	// run detection for all of them.
@@ -726,13 +789,24 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Clear md5 cache before each detection starts, just in case.
 	ADCacheMan.clear();
 
+	// The engines which support it match the files against their detection
+	// tables on the thread pool first. Each task only uses its own copies of
+	// the nodes and strings, as their reference counts are not atomic. The
+	// pool waits for the backend, which makes the allocation of these
+	// reference counts thread-safe.
+	Common::Array<bool> started(plugins.size(), false);
+	Common::ThreadPool *pool = g_system->backendInitialized() ? getDetectionThreadPool() : nullptr;
+	if (pool && plugins.size() > 1 && !fslist.empty())
+		startDetectGames(pool, plugins, fslist, skipADFlags, skipIncomplete, started);
+
 	// Iterate over all known games and for each check if it might be
-	// the game in the presented directory.
-	for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-		MetaEngineDetection &metaEngine = (*iter)->get<MetaEngineDetection>();
+	// the game in the presented directory. The results are merged in the
+	// order of the plugins, whichever thread found them.
+	for (uint p = 0; p < plugins.size(); ++p) {
+		MetaEngineDetection &metaEngine = plugins[p]->get<MetaEngineDetection>();
 		// set the debug flags
 		DebugMan.addAllDebugChannels(metaEngine.getDebugChannels());
-		DetectedGames engineCandidates = metaEngine.detectGames(fslist, skipADFlags, skipIncomplete);
+		DetectedGames engineCandidates = started[p] ? metaEngine.finishDetectGames(fslist) : metaEngine.detectGames(fslist, skipADFlags, skipIncomplete);
 
 		for (uint i = 0; i < engineCandidates.size(); i++) {
 			engineCandidates[i].path = fslist.begin()->getParent().getPath();
@@ -743,6 +817,7 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
+	ADCacheMan.flush();
 
 	return DetectionResults(candidates);
 }
@@ -1015,6 +1090,25 @@ namespace Common {
 DECLARE_SINGLETON(ScalerManager);
 }
 
+ScalerManager::ScalerManager() : _threadPool(nullptr), _threadPoolCreated(false) {
+}
+
+ScalerManager::~ScalerManager() {
+	delete _threadPool;
+}
+
+Common::ThreadPool *ScalerManager::getThreadPool() {
+	if (!_threadPoolCreated) {
+		_threadPoolCreated = true;
+
+		int threads = ConfMan.getInt("scaler_threads");
+		if (threads > 1)
+			_threadPool = new Common::ThreadPool(threads);
+	}
+
+	return _threadPool;
+}
+
 const PluginList &ScalerManager::getPlugins() const {
 	return PluginManager::instance().getPlugins(PLUGIN_TYPE_SCALER);
 }
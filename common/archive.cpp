@@ -25,6 +25,7 @@
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
+#include "common/prefetcher.h"
 #include "common/punycode.h"
 #include "common/debug.h"
 
@@ -254,6 +255,14 @@ uint MemcachingCaseInsensitiveArchive::CacheKey_Hash::operator()(const CacheKey
 	return static_cast<uint>(x.path.hashIgnoreCase() * 1000003u) ^ static_cast<uint>(x.altStreamType);
 };
 
+SearchSet::SearchSet() : _ignoreClashes(false), _prefetcher(nullptr), _prefetchCacheSize(ArchivePrefetcher::kDefaultMaxCachedSize) {
+}
+
+SearchSet::~SearchSet() {
+	clear();
+	delete _prefetcher;
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
@@ -288,6 +297,10 @@ void SearchSet::insert(const Node &node) {
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
 	if (find(name) == _list.end()) {
+		// The new archive may hide members which were prefetched
+		if (_prefetcher)
+			_prefetcher->clear();
+
 		Node node(priority, name, archive, autoFree);
 		insert(node);
 	} else {
@@ -371,6 +384,8 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 void SearchSet::remove(const String &name) {
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		if (_prefetcher)
+			_prefetcher->clear();
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
@@ -391,6 +406,9 @@ Archive *SearchSet::getArchive(const String &name) const {
 }
 
 void SearchSet::clear() {
+	if (_prefetcher)
+		_prefetcher->clear();
+
 	for (ArchiveNodeList::iterator i = _list.begin(); i != _list.end(); ++i) {
 		if (i->_autoFree)
 			delete i->_arc;
@@ -409,6 +427,9 @@ void SearchSet::setPriority(const String &name, int priority) {
 	if (priority == it->_priority)
 		return;
 
+	if (_prefetcher)
+		_prefetcher->clear();
+
 	Node node(*it);
 	_list.erase(it);
 	node._priority = priority;
@@ -510,6 +531,12 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	if (_prefetcher) {
+		SeekableReadStream *stream = _prefetcher->take(path);
+		if (stream)
+			return stream;
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
@@ -553,6 +580,37 @@ SeekableReadStream *SearchSet::createReadStreamForMemberNext(const Path &path, c
 	return nullptr;
 }
 
+void SearchSet::prefetch(const Path &path) const {
+	if (path.empty())
+		return;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (!it->_arc->hasFile(path))
+			continue;
+
+		if (it->_arc->canReadMembersInBackground()) {
+			if (!_prefetcher)
+				_prefetcher = new ArchivePrefetcher(_prefetchCacheSize);
+			_prefetcher->prefetch(it->_arc, path);
+		} else {
+			it->_arc->prefetch(path);
+		}
+		return;
+	}
+}
+
+void SearchSet::waitForPrefetches() const {
+	if (_prefetcher)
+		_prefetcher->wait();
+}
+
+void SearchSet::setPrefetchCacheSize(uint32 maxSize) {
+	_prefetchCacheSize = maxSize;
+	if (_prefetcher)
+		_prefetcher->setMaxCachedSize(maxSize);
+}
+
 SearchManager::SearchManager() {
 	clear(); // Force a reset
 }
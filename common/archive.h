@@ -44,6 +44,7 @@ namespace Common {
  */
 
 class ArchiveMember;
+class ArchivePrefetcher;
 class FSNode;
 class SeekableReadStream;
 
@@ -202,6 +203,23 @@ public:
 		return createReadStreamForMember(path);
 	}
 
+	/**
+	 * Hint that the member with the specified name is going to be opened
+	 * soon, so that it can be read ahead of time. The default implementation
+	 * does nothing.
+	 */
+	virtual void prefetch(const Path &path) const {}
+
+	/**
+	 * Check if the streams created by createReadStreamForMember() can be
+	 * read on another thread, while the archive is used and while other
+	 * streams of the archive are read. The streams are still opened and
+	 * deleted on the thread using the archive. Archives reading all their
+	 * members from one shared stream must return false, which is the
+	 * default.
+	 */
+	virtual bool canReadMembersInBackground() const { return false; }
+
 	/**
 	 * Dump all files from the archive to the given directory
 	 */
@@ -329,9 +347,16 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	/** Created by the first prefetch */
+	mutable ArchivePrefetcher *_prefetcher;
+	uint32 _prefetchCacheSize;
+
+	SearchSet(const SearchSet &);
+	SearchSet &operator=(const SearchSet &);
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
-	virtual ~SearchSet() { clear(); }
+	SearchSet();
+	virtual ~SearchSet();
 
 	/**
 	 * Add a new archive to the searchable set.
@@ -450,6 +475,27 @@ public:
 	 */
 	SeekableReadStream *createReadStreamForMemberNext(const Path &path, const Archive *starting) const override;
 
+	/**
+	 * Read a member ahead of time from the first archive containing it. If
+	 * that archive can be read in the background, the member is opened
+	 * right away, read by a worker thread and kept in memory until
+	 * createReadStreamForMember() opens it. Otherwise, the hint is passed
+	 * on to the archive.
+	 *
+	 * Adding, removing or reordering archives drops the prefetched members.
+	 */
+	void prefetch(const Path &path) const override;
+
+	/**
+	 * Wait until the members queued by prefetch() are read.
+	 */
+	void waitForPrefetches() const;
+
+	/**
+	 * Change the limit of the size of the prefetched members kept in memory.
+	 */
+	void setPrefetchCacheSize(uint32 maxSize);
+
 	/**
 	 * Ignore clashes when adding directories. For more details, see the corresponding parameter
 	 * in @ref FSDirectory documentation.
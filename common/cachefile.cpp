@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/cachefile.h"
+#include "common/crc.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+SeekableReadStream *loadCacheFile(const FSNode &file, uint32 tag, uint32 version) {
+	if (!file.exists())
+		return nullptr;
+
+	ScopedPtr<SeekableReadStream> in(file.createReadStream());
+	if (!in || in->readUint32BE() != tag || in->readUint32LE() != version)
+		return nullptr;
+
+	const uint32 size = in->readUint32LE();
+	const uint32 checksum = in->readUint32LE();
+	if (in->eos() || in->err() || size > in->size() - in->pos()) {
+		warning("Ignoring truncated cache file '%s'", file.getPath().toString(Path::kNativeSeparator).c_str());
+		return nullptr;
+	}
+
+	byte *data = (byte *)malloc(size);
+	if (!data)
+		return nullptr;
+	if (in->read(data, size) != size || CRC32().crcFast(data, size) != checksum) {
+		warning("Ignoring damaged cache file '%s'", file.getPath().toString(Path::kNativeSeparator).c_str());
+		free(data);
+		return nullptr;
+	}
+
+	return new MemoryReadStream(data, size, DisposeAfterUse::YES);
+}
+
+bool saveCacheFile(const FSNode &file, uint32 tag, uint32 version, const byte *data, uint32 size) {
+	ScopedPtr<SeekableWriteStream> out(file.createWriteStream());
+	if (out) {
+		out->writeUint32BE(tag);
+		out->writeUint32LE(version);
+		out->writeUint32LE(size);
+		out->writeUint32LE(CRC32().crcFast(data, size));
+		out->write(data, size);
+		if (out->flush() && !out->err())
+			return true;
+	}
+
+	warning("Could not save cache file '%s'", file.getPath().toString(Path::kNativeSeparator).c_str());
+	return false;
+}
+
+} // End of namespace Common
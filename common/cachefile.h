@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_CACHEFILE_H
+#define COMMON_CACHEFILE_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_cachefile Cache files
+ * @ingroup common
+ *
+ * @brief API for the files kept in the cache directory.
+ *
+ * A cache file holds a tag, a version, and data covered by a checksum, so
+ * that a damaged file is ignored rather than giving wrong results.
+ *
+ * @{
+ */
+
+class FSNode;
+class SeekableReadStream;
+
+/**
+ * Read the data of a file saved with saveCacheFile().
+ *
+ * @param file		the file to read
+ * @param tag		the tag identifying the kind of file
+ * @param version	the version of the data, files of other versions are ignored
+ * @return a stream over the data, or nullptr if the file is missing, of
+ *         another kind or version, or damaged
+ */
+SeekableReadStream *loadCacheFile(const FSNode &file, uint32 tag, uint32 version);
+
+/**
+ * Save data to be read back with loadCacheFile().
+ *
+ * @return true on success, false if the file could not be written
+ */
+bool saveCacheFile(const FSNode &file, uint32 tag, uint32 version, const byte *data, uint32 size);
+
+/**
+ * Whether a cache entry, saved with the modification time of a file or
+ * directory and the time it was read (see FSNode::getCurrentTime()), still
+ * describes it. The entry is only trusted if the object was changed before
+ * it was read, as it can change again in the same second without getting
+ * a new time.
+ *
+ * @param time		the current modification time of the object
+ * @param entryTime	the modification time saved in the entry
+ * @param readTime	the time the object was read
+ */
+inline bool isCacheEntryCurrent(int64 time, int64 entryTime, int64 readTime) {
+	return time == entryTime && time < readTime;
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -348,7 +348,7 @@ ClickteamInstaller* ClickteamInstaller::open(Common::SeekableReadStream *stream,
 
 ClickteamInstaller* ClickteamInstaller::openPatch(Common::SeekableReadStream *stream, bool verifyOriginal, bool verifyAllowSkip,
 						  Common::Archive *reference, DisposeAfterUse::Flag dispose) {
-	Common::HashMap<Common::Path, ClickteamFileDescriptor, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> files;
+	FileMap files;
 	HashMap<uint16, Common::SharedPtr<ClickteamTag>> tags;
 	uint32 crc_xor;
 
@@ -435,10 +435,10 @@ ClickteamInstaller* ClickteamInstaller::openPatch(Common::SeekableReadStream *st
 		return nullptr;
 
 	if (verifyOriginal && reference) {
-		for (Common::HashMap<Common::Path, ClickteamFileDescriptor, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo>::iterator i = files.begin(), end = files.end();
+		for (FileMap::iterator i = files.begin(), end = files.end();
 		     i != end; ++i) {
 			if (i->_value._isPatchFile) {
-				Common::ScopedPtr<Common::SeekableReadStream> refStream(reference->createReadStreamForMember(i->_key));
+				Common::ScopedPtr<Common::SeekableReadStream> refStream(reference->createReadStreamForMember(i->_key.getPath()));
 				if (!refStream) {
 					if (verifyAllowSkip) {
 						i->_value._isReferenceMissing = true;
@@ -446,14 +446,14 @@ ClickteamInstaller* ClickteamInstaller::openPatch(Common::SeekableReadStream *st
 					}
 					return nullptr;
 				}
-				if (findPatchIdx(i->_value, refStream.get(), i->_key, crc_xor, false) == -1)
+				if (findPatchIdx(i->_value, refStream.get(), i->_key.getPath(), crc_xor, false) == -1)
 					return nullptr;
 			}
 		}
 	}
 
 	if (!reference) {
-		for (Common::HashMap<Common::Path, ClickteamFileDescriptor, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo>::iterator i = files.begin(), end = files.end();
+		for (FileMap::iterator i = files.begin(), end = files.end();
 		     i != end; ++i) {
 			if (i->_value._isPatchFile) {
 				i->_value._isReferenceMissing = true;
@@ -471,10 +471,10 @@ bool ClickteamInstaller::hasFile(const Path &path) const {
 int ClickteamInstaller::listMembers(ArchiveMemberList &list) const {
 	int members = 0;
 
-	for (Common::HashMap<Common::Path, ClickteamFileDescriptor, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo>::const_iterator i = _files.begin(), end = _files.end();
+	for (FileMap::const_iterator i = _files.begin(), end = _files.end();
 	     i != end; ++i) {
 		if (!i->_value._isReferenceMissing) {
-			list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key, *this)));
+			list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key.getPath(), *this)));
 			++members;
 		}
 	}
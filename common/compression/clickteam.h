@@ -97,7 +97,9 @@ private:
 		ClickteamFileDescriptor() : _fileDataOffset(0), _fileDescriptorOffset(0), _compressedSize(0), _uncompressedSize(0) {}
 	};
 
-	ClickteamInstaller(const Common::HashMap<Common::Path, ClickteamFileDescriptor, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> &files,
+	typedef Common::HashMap<Common::IgnoreCasePathKey, ClickteamFileDescriptor, Common::PathKey::Hash, Common::PathKey::EqualTo> FileMap;
+
+	ClickteamInstaller(const FileMap &files,
 			   const Common::HashMap<uint16, Common::SharedPtr<ClickteamTag>> &tags,
 			   uint32 crcXor, uint32 block3Offset, uint32 block3Size, Common::SeekableReadStream *stream,
 			   Common::Archive *reference,
@@ -108,7 +110,7 @@ private:
 
 	static int findPatchIdx(const ClickteamFileDescriptor &desc, Common::SeekableReadStream *refStream, const Common::Path &fileName,
 				uint32 crcXor, bool doWarn);
-	Common::HashMap<Common::Path, ClickteamFileDescriptor, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> _files;
+	FileMap _files;
 	Common::HashMap<uint16, Common::SharedPtr<ClickteamTag>> _tags;
 	Common::DisposablePtr<Common::SeekableReadStream> _stream;
 	uint32 _crcXor, _block3Offset/*, _block3Size*/;
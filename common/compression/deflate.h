@@ -121,6 +121,9 @@ static inline bool inflateClickteam(byte *dst, uint  dstLen, const byte *src, ui
  * returned wrapped, unless there is no ZLIB support, then NULL is returned
  * and the old stream is destroyed.
  *
+ * Data starting with an LZ4 frame is decompressed with wrapLZ4ReadStream(),
+ * with or without ZLIB support.
+ *
  * Certain GZip-formats don't supply an easily readable length, if you
  * still need the length carried along with the stream, and you know
  * the decompressed length at wrap-time, then it can be supplied as knownSize
@@ -645,7 +645,7 @@ private:
 	static Common::String normalizePath(const Common::Path &path);
 
 	Common::Array<Common::SharedPtr<ArchiveItem> > _items;
-	Common::HashMap<Common::Path, uint, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> _pathToItemIndex;
+	Common::HashMap<Common::IgnoreCasePathKey, uint, Common::PathKey::Hash, Common::PathKey::EqualTo> _pathToItemIndex;
 
 	Common::SeekableReadStream *_stream;
 };
@@ -855,7 +855,7 @@ int PackageArchive::listMatchingMembers(Common::ArchiveMemberList &list, const C
 }
 
 const Common::ArchiveMemberPtr PackageArchive::getMember(const Common::Path &path) const {
-	Common::HashMap<Common::Path, uint, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo>::const_iterator it = _pathToItemIndex.find(path);
+	Common::HashMap<Common::IgnoreCasePathKey, uint, Common::PathKey::Hash, Common::PathKey::EqualTo>::const_iterator it = _pathToItemIndex.find(path);
 	if (it == _pathToItemIndex.end())
 		return nullptr;
 
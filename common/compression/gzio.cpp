@@ -40,6 +40,7 @@
 #include "common/ptr.h"
 #include "common/memstream.h"
 #include "common/compression/deflate.h"
+#include "common/compression/lz4.h"
 
 
 /* Compression methods (see algorithm.doc) */
@@ -1336,6 +1337,10 @@ SeekableReadStream* wrapCompressedReadStream(Common::SeekableReadStream *parent,
 		return nullptr;
 	}
 
+	// Saves may also be written by wrapLZ4WriteStream()
+	if (isLZ4Stream(parent))
+		return wrapLZ4ReadStream(parent, disposeParent);
+
 	uint16 header = parent->readUint16BE();
 	bool isCompressed = (header == 0x1F8B ||
 			     ((header & 0x0F00) == 0x0800 &&
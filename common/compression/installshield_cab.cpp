@@ -123,7 +123,7 @@ private:
 	};
 
 	int _version;
-	typedef HashMap<Path, FileEntry, Path::IgnoreCase_Hash, Path::IgnoreCase_EqualTo> FileMap;
+	typedef HashMap<IgnoreCasePathKey, FileEntry, PathKey::Hash, PathKey::EqualTo> FileMap;
 	FileMap _map;
 	Path _baseName;
 	Common::Array<VolumeHeader> _volumeHeaders;
@@ -338,7 +338,7 @@ bool InstallShieldCabinet::hasFile(const Path &path) const {
 
 int InstallShieldCabinet::listMembers(ArchiveMemberList &list) const {
 	for (FileMap::const_iterator it = _map.begin(); it != _map.end(); it++)
-		list.push_back(getMember(it->_key));
+		list.push_back(getMember(it->_key.getPath()));
 
 	return _map.size();
 }
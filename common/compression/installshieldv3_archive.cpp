@@ -79,7 +79,7 @@ bool InstallShieldV3::hasFile(const Common::Path &path) const {
 
 int InstallShieldV3::listMembers(Common::ArchiveMemberList &list) const {
 	for (FileMap::const_iterator it = _map.begin(); it != _map.end(); it++)
-		list.push_back(getMember(it->_key));
+		list.push_back(getMember(it->_key.getPath()));
 
 	return _map.size();
 }
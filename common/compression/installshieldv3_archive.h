@@ -61,7 +61,7 @@ private:
 
 	Common::SeekableReadStream *_stream;
 
-	typedef Common::HashMap<Path, FileEntry, Path::IgnoreCase_Hash, Path::IgnoreCase_EqualTo> FileMap;
+	typedef Common::HashMap<IgnoreCasePathKey, FileEntry, PathKey::Hash, PathKey::EqualTo> FileMap;
 	FileMap _map;
 };
 
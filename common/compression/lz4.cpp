@@ -0,0 +1,566 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The frame and block formats are described in the LZ4 documentation:
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+
+#include "common/compression/lz4.h"
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+
+namespace Common {
+
+namespace {
+
+enum {
+	kMinMatch = 4,
+	/** The last 5 bytes of a block are always literals */
+	kLastLiterals = 5,
+	/** The last match starts at least 12 bytes before the end of a block */
+	kMatchFindLimit = 12,
+	kMaxOffset = 65535,
+
+	kHashBits = 12,
+
+	/** Block size written by LZ4WriteStream */
+	kBlockSize = 64 * 1024,
+	kBlockSizeId = 4,
+
+	kFlagVersion = 0x40,
+	kFlagBlockIndependence = 0x20,
+	kFlagBlockChecksum = 0x10,
+	kFlagContentSize = 0x08,
+	kFlagContentChecksum = 0x04,
+	kFlagDictId = 0x01,
+
+	kBlockUncompressed = 0x80000000
+};
+
+/** xxHash32, the checksum of LZ4 frames */
+class XXH32 {
+public:
+	XXH32() : _totalSize(0), _bufferSize(0) {
+		_acc[0] = kPrime1 + kPrime2;
+		_acc[1] = kPrime2;
+		_acc[2] = 0;
+		_acc[3] = 0 - kPrime1;
+	}
+
+	void update(const byte *data, uint32 size) {
+		_totalSize += size;
+
+		if (_bufferSize + size < 16) {
+			memcpy(_buffer + _bufferSize, data, size);
+			_bufferSize += size;
+			return;
+		}
+
+		if (_bufferSize) {
+			const uint32 fill = 16 - _bufferSize;
+			memcpy(_buffer + _bufferSize, data, fill);
+			processStripe(_buffer);
+			data += fill;
+			size -= fill;
+			_bufferSize = 0;
+		}
+
+		for (; size >= 16; data += 16, size -= 16)
+			processStripe(data);
+
+		memcpy(_buffer, data, size);
+		_bufferSize = size;
+	}
+
+	uint32 digest() const {
+		uint32 h;
+		if (_totalSize >= 16)
+			h = rotl(_acc[0], 1) + rotl(_acc[1], 7) + rotl(_acc[2], 12) + rotl(_acc[3], 18);
+		else
+			h = kPrime5;
+		h += (uint32)_totalSize;
+
+		uint32 i = 0;
+		for (; i + 4 <= _bufferSize; i += 4)
+			h = rotl(h + READ_LE_UINT32(_buffer + i) * kPrime3, 17) * kPrime4;
+		for (; i < _bufferSize; ++i)
+			h = rotl(h + _buffer[i] * kPrime5, 11) * kPrime1;
+
+		h ^= h >> 15;
+		h *= kPrime2;
+		h ^= h >> 13;
+		h *= kPrime3;
+		h ^= h >> 16;
+		return h;
+	}
+
+	static uint32 hash(const byte *data, uint32 size) {
+		XXH32 xxh;
+		xxh.update(data, size);
+		return xxh.digest();
+	}
+
+private:
+	static const uint32 kPrime1 = 2654435761U;
+	static const uint32 kPrime2 = 2246822519U;
+	static const uint32 kPrime3 = 3266489917U;
+	static const uint32 kPrime4 = 668265263U;
+	static const uint32 kPrime5 = 374761393U;
+
+	static uint32 rotl(uint32 x, int r) {
+		return (x << r) | (x >> (32 - r));
+	}
+
+	static uint32 accumulate(uint32 acc, uint32 input) {
+		return rotl(acc + input * kPrime2, 13) * kPrime1;
+	}
+
+	void processStripe(const byte *data) {
+		for (int i = 0; i < 4; ++i)
+			_acc[i] = accumulate(_acc[i], READ_LE_UINT32(data + 4 * i));
+	}
+
+	uint32 _acc[4];
+	uint64 _totalSize;
+	byte _buffer[16];
+	uint32 _bufferSize;
+};
+
+/** Append an LZ4 length continuation, for lengths of 15 and more. */
+inline byte *writeLength(byte *op, uint32 length) {
+	for (; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = (byte)length;
+	return op;
+}
+
+/** Append a sequence, checking that it fits in the output first. */
+inline byte *writeSequence(byte *op, const byte *opEnd, const byte *literals, uint32 literalLength, uint32 offset, uint32 matchLength) {
+	// Token, literal length, literals, offset and match length
+	if ((uint32)(opEnd - op) < 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1)
+		return nullptr;
+
+	byte *token = op++;
+	if (literalLength >= 15) {
+		*token = 15 << 4;
+		op = writeLength(op, literalLength - 15);
+	} else {
+		*token = literalLength << 4;
+	}
+	memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	if (!matchLength)
+		return op;
+
+	WRITE_LE_UINT16(op, offset);
+	op += 2;
+	matchLength -= kMinMatch;
+	if (matchLength >= 15) {
+		*token |= 15;
+		op = writeLength(op, matchLength - 15);
+	} else {
+		*token |= matchLength;
+	}
+	return op;
+}
+
+inline uint32 hashPosition(const byte *p) {
+	return (READ_UINT32(p) * 2654435761U) >> (32 - kHashBits);
+}
+
+/**
+ * Compress one block with a greedy match finder.
+ *
+ * @param table  Hash table of 1 << kHashBits entries, clobbered.
+ * @return The compressed size, or 0 if the block does not get smaller.
+ */
+uint32 compressBlock(const byte *src, uint32 srcSize, byte *dst, uint32 dstCapacity, uint32 *table) {
+	byte *op = dst;
+	const byte *const opEnd = dst + dstCapacity;
+	uint32 anchor = 0;
+
+	if (srcSize > kMatchFindLimit) {
+		const uint32 matchFindLimit = srcSize - kMatchFindLimit;
+		const uint32 matchLimit = srcSize - kLastLiterals;
+
+		memset(table, 0, sizeof(uint32) << kHashBits);
+		uint32 ip = 1;
+		while (ip < matchFindLimit) {
+			const uint32 h = hashPosition(src + ip);
+			uint32 candidate = table[h];
+			table[h] = ip;
+
+			if (candidate >= ip || ip - candidate > kMaxOffset || READ_UINT32(src + candidate) != READ_UINT32(src + ip)) {
+				// Move faster through data which does not compress
+				ip += 1 + ((ip - anchor) >> 6);
+				continue;
+			}
+
+			while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1]) {
+				--ip;
+				--candidate;
+			}
+
+			uint32 length = kMinMatch;
+			while (ip + length < matchLimit && src[candidate + length] == src[ip + length])
+				++length;
+
+			op = writeSequence(op, opEnd, src + anchor, ip - anchor, ip - candidate, length);
+			if (!op)
+				return 0;
+
+			ip += length;
+			anchor = ip;
+			if (ip < matchFindLimit)
+				table[hashPosition(src + ip - 2)] = ip - 2;
+		}
+	}
+
+	op = writeSequence(op, opEnd, src + anchor, srcSize - anchor, 0, 0);
+	if (!op || op - dst >= (int)srcSize)
+		return 0;
+	return op - dst;
+}
+
+/**
+ * Decompress one block.
+ *
+ * @param window  Start of the data which matches may refer to. It is the
+ *                start of the block with independent blocks.
+ * @return The decompressed size, or -1 if the block is invalid.
+ */
+int32 decompressBlock(const byte *src, uint32 srcSize, byte *dst, uint32 dstCapacity, const byte *window) {
+	const byte *ip = src;
+	const byte *const ipEnd = src + srcSize;
+	byte *op = dst;
+	const byte *const opEnd = dst + dstCapacity;
+
+	while (ip < ipEnd) {
+		const byte token = *ip++;
+
+		uint32 literalLength = token >> 4;
+		if (literalLength == 15) {
+			byte b;
+			do {
+				if (ip == ipEnd)
+					return -1;
+				b = *ip++;
+				literalLength += b;
+			} while (b == 255);
+		}
+		if (literalLength > (uint32)(ipEnd - ip) || literalLength > (uint32)(opEnd - op))
+			return -1;
+		memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// The last sequence has no match
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return -1;
+		const uint32 offset = READ_LE_UINT16(ip);
+		ip += 2;
+		if (offset == 0 || offset > (uint32)(op - window))
+			return -1;
+
+		uint32 matchLength = token & 15;
+		if (matchLength == 15) {
+			byte b;
+			do {
+				if (ip == ipEnd)
+					return -1;
+				b = *ip++;
+				matchLength += b;
+			} while (b == 255);
+		}
+		matchLength += kMinMatch;
+		if (matchLength > (uint32)(opEnd - op))
+			return -1;
+
+		const byte *match = op - offset;
+		if (offset >= matchLength) {
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		} else {
+			// Overlapping copy, repeating the last bytes
+			while (matchLength--)
+				*op++ = *match++;
+		}
+	}
+
+	return op - dst;
+}
+
+class LZ4WriteStream : public WriteStream {
+public:
+	LZ4WriteStream(WriteStream *w) : _wrapped(w), _pos(0), _bufferSize(0), _err(false), _finalized(false) {
+		assert(w != nullptr);
+
+		byte header[7];
+		WRITE_LE_UINT32(header, kLZ4FrameMagic);
+		header[4] = kFlagVersion | kFlagBlockIndependence | kFlagContentChecksum;
+		header[5] = kBlockSizeId << 4;
+		header[6] = (XXH32::hash(header + 4, 2) >> 8) & 0xFF;
+		writeWrapped(header, sizeof(header));
+	}
+
+	~LZ4WriteStream() {
+		finalize();
+	}
+
+	bool err() const override {
+		return _err || _wrapped->err();
+	}
+
+	void clearErr() override {
+		_wrapped->clearErr();
+	}
+
+	void finalize() override {
+		if (_finalized)
+			return;
+		_finalized = true;
+
+		if (_bufferSize)
+			writeBlock();
+
+		byte footer[8];
+		WRITE_LE_UINT32(footer, 0);
+		WRITE_LE_UINT32(footer + 4, _checksum.digest());
+		writeWrapped(footer, sizeof(footer));
+
+		_wrapped->finalize();
+	}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) override {
+		if (err() || _finalized)
+			return 0;
+
+		const byte *data = (const byte *)dataPtr;
+		uint32 left = dataSize;
+		while (left) {
+			const uint32 size = MIN<uint32>(left, kBlockSize - _bufferSize);
+			memcpy(_buffer + _bufferSize, data, size);
+			_bufferSize += size;
+			data += size;
+			left -= size;
+
+			if (_bufferSize == kBlockSize && !writeBlock())
+				break;
+		}
+
+		_pos += dataSize - left;
+		return dataSize - left;
+	}
+
+	int64 pos() const override { return _pos; }
+
+private:
+	bool writeWrapped(const byte *data, uint32 size) {
+		if (!_err && _wrapped->write(data, size) != size)
+			_err = true;
+		return !_err;
+	}
+
+	bool writeBlock() {
+		_checksum.update(_buffer, _bufferSize);
+
+		uint32 size = compressBlock(_buffer, _bufferSize, _compressed + 4, kBlockSize, _table);
+		const byte *data = _compressed + 4;
+		if (!size) {
+			WRITE_LE_UINT32(_compressed, _bufferSize | kBlockUncompressed);
+			writeWrapped(_compressed, 4);
+			data = _buffer;
+			size = _bufferSize;
+		} else {
+			WRITE_LE_UINT32(_compressed, size);
+			size += 4;
+			data = _compressed;
+		}
+
+		_bufferSize = 0;
+		return writeWrapped(data, size);
+	}
+
+	ScopedPtr<WriteStream> _wrapped;
+	uint32 _pos;
+	XXH32 _checksum;
+
+	byte _buffer[kBlockSize];
+	uint32 _bufferSize;
+	/** Size of the block, followed by its compressed data */
+	byte _compressed[4 + kBlockSize];
+	uint32 _table[1 << kHashBits];
+
+	bool _err;
+	bool _finalized;
+};
+
+/** Read the given number of bytes in place if possible, or into @p buffer. */
+const byte *readData(SeekableReadStream *stream, uint32 size, Array<byte> &buffer) {
+	const byte *data = stream->getContiguousData(size);
+	if (data)
+		return data;
+
+	buffer.resize(size);
+	if (stream->read(buffer.data(), size) != size)
+		return nullptr;
+	return buffer.data();
+}
+
+SeekableReadStream *decompressFrame(SeekableReadStream *stream) {
+	byte descriptor[14];
+	if (stream->readUint32LE() != kLZ4FrameMagic || stream->read(descriptor, 2) != 2)
+		return nullptr;
+
+	const byte flags = descriptor[0];
+	if ((flags & 0xC0) != kFlagVersion || (flags & (kFlagDictId | 0x02)) || (descriptor[1] & 0x8F))
+		return nullptr;
+
+	const uint blockSizeId = descriptor[1] >> 4;
+	if (blockSizeId < 4)
+		return nullptr;
+	const uint32 maxBlockSize = 1 << (2 * blockSizeId + 8);
+
+	uint32 descriptorSize = 2;
+	uint64 contentSize = 0;
+	if (flags & kFlagContentSize) {
+		if (stream->read(descriptor + 2, 8) != 8)
+			return nullptr;
+		contentSize = READ_LE_UINT64(descriptor + 2);
+		descriptorSize += 8;
+	}
+	if (stream->readByte() != ((XXH32::hash(descriptor, descriptorSize) >> 8) & 0xFF) || stream->err())
+		return nullptr;
+
+	// A block cannot grow more than 255 times when decompressed, which
+	// limits how much a broken content size can make us allocate
+	uint32 capacity = maxBlockSize;
+	if (contentSize > capacity && contentSize < MIN<uint64>(255 * (uint64)stream->size(), 0x7FFFFFFF))
+		capacity = (uint32)contentSize;
+
+	byte *output = (byte *)malloc(capacity);
+	uint32 outputSize = 0;
+	XXH32 checksum;
+	Array<byte> buffer;
+	bool valid = output != nullptr;
+
+	while (valid) {
+		const uint32 blockHeader = stream->readUint32LE();
+		if (stream->eos() || stream->err()) {
+			valid = false;
+			break;
+		}
+		if (blockHeader == 0)
+			break;
+
+		const uint32 size = blockHeader & ~kBlockUncompressed;
+		if (size > maxBlockSize) {
+			valid = false;
+			break;
+		}
+
+		if (capacity - outputSize < maxBlockSize) {
+			capacity = MAX<uint32>(capacity * 2, outputSize + maxBlockSize);
+			byte *newOutput = (byte *)realloc(output, capacity);
+			if (!newOutput) {
+				valid = false;
+				break;
+			}
+			output = newOutput;
+		}
+
+		const byte *data = readData(stream, size, buffer);
+		if (!data) {
+			valid = false;
+			break;
+		}
+		if ((flags & kFlagBlockChecksum) && stream->readUint32LE() != XXH32::hash(data, size)) {
+			valid = false;
+			break;
+		}
+
+		byte *const block = output + outputSize;
+		if (blockHeader & kBlockUncompressed) {
+			memcpy(block, data, size);
+			outputSize += size;
+		} else {
+			const byte *window = (flags & kFlagBlockIndependence) ? block : output;
+			const int32 decompressed = decompressBlock(data, size, block, maxBlockSize, window);
+			if (decompressed < 0) {
+				valid = false;
+				break;
+			}
+			outputSize += decompressed;
+		}
+
+		if (flags & kFlagContentChecksum)
+			checksum.update(block, output + outputSize - block);
+	}
+
+	if (valid && (flags & kFlagContentSize) && contentSize != outputSize)
+		valid = false;
+	if (valid && (flags & kFlagContentChecksum) && stream->readUint32LE() != checksum.digest())
+		valid = false;
+	if (valid && stream->err())
+		valid = false;
+
+	if (!valid) {
+		free(output);
+		return nullptr;
+	}
+	return new MemoryReadStream(output, outputSize, DisposeAfterUse::YES);
+}
+
+} // End of anonymous namespace
+
+bool isLZ4Stream(SeekableReadStream *stream) {
+	if (!stream || stream->size() - stream->pos() < 4)
+		return false;
+
+	const uint32 magic = stream->readUint32LE();
+	stream->seek(-4, SEEK_CUR);
+	return magic == kLZ4FrameMagic;
+}
+
+SeekableReadStream *wrapLZ4ReadStream(SeekableReadStream *toBeWrapped, DisposeAfterUse::Flag disposeParent) {
+	if (!toBeWrapped)
+		return nullptr;
+
+	SeekableReadStream *stream = decompressFrame(toBeWrapped);
+	if (disposeParent == DisposeAfterUse::YES)
+		delete toBeWrapped;
+	return stream;
+}
+
+WriteStream *wrapLZ4WriteStream(WriteStream *toBeWrapped) {
+	if (!toBeWrapped)
+		return nullptr;
+	return new LZ4WriteStream(toBeWrapped);
+}
+
+} // End of namespace Common
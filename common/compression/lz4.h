@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_LZ4_H
+#define COMMON_LZ4_H
+
+#include "common/scummsys.h"
+#include "common/types.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_lz4 LZ4
+ * @ingroup common
+ *
+ * @brief API for LZ4 frame compression.
+ *
+ * @details The LZ4 frame format trades some compression ratio for much
+ *          faster compression than deflate. It is used for the saved games
+ *          when the savegame_compression setting is "lz4". Both directions
+ *          are implemented here, so they do not depend on any library.
+ * @{
+ */
+
+class SeekableReadStream;
+class WriteStream;
+
+/** First four bytes of an LZ4 frame, read as little endian */
+static const uint32 kLZ4FrameMagic = 0x184D2204;
+
+/**
+ * Check if the stream starts with an LZ4 frame. The position of the stream
+ * is restored.
+ */
+bool isLZ4Stream(SeekableReadStream *stream);
+
+/**
+ * Take an arbitrary SeekableReadStream holding an LZ4 frame, and return a
+ * stream over the decompressed contents. The whole frame is decompressed
+ * at once, as saved games are read from start to end anyway.
+ *
+ * Blocks in both the independent and the linked mode are supported, as
+ * well as the block and content checksums. Frames using a dictionary are
+ * not.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @return The decompressed stream, or nullptr if the frame is invalid.
+ */
+SeekableReadStream *wrapLZ4ReadStream(SeekableReadStream *toBeWrapped,
+		DisposeAfterUse::Flag disposeParent = DisposeAfterUse::YES);
+
+/**
+ * Take an arbitrary WriteStream and wrap it in a custom stream which
+ * compresses the data into an LZ4 frame, with independent blocks of 64 KB
+ * and a content checksum. The created stream also becomes responsible for
+ * freeing the passed stream.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ */
+WriteStream *wrapLZ4WriteStream(WriteStream *toBeWrapped);
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -82,10 +82,10 @@ private:
 
 	Common::SeekableReadStream *_stream;
 
-	typedef Common::HashMap<Common::Path, FileEntry, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> FileMap;
+	typedef Common::HashMap<Common::IgnoreCasePathKey, FileEntry, Common::PathKey::Hash, Common::PathKey::EqualTo> FileMap;
 	FileMap _map;
 
-	typedef Common::HashMap<Common::Path, Common::MacFinderInfoData, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> MetadataMap;
+	typedef Common::HashMap<Common::IgnoreCasePathKey, Common::MacFinderInfoData, Common::PathKey::Hash, Common::PathKey::EqualTo> MetadataMap;
 	MetadataMap _metadataMap;
 
 	bool _flattenTree;
@@ -286,7 +286,7 @@ bool StuffItArchive::hasFile(const Common::Path &path) const {
 
 int StuffItArchive::listMembers(Common::ArchiveMemberList &list) const {
 	for (FileMap::const_iterator it = _map.begin(); it != _map.end(); it++)
-		list.push_back(getMember(it->_key));
+		list.push_back(getMember(it->_key.getPath()));
 
 	return _map.size();
 }
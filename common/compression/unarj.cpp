@@ -697,7 +697,7 @@ struct ArjFileChunk {
 	ArjFileChunk(ArjHeader* header, uint volume) : _header(header), _volume(volume) {}
 };
 
-typedef HashMap<Path, Array<ArjFileChunk>, Path::IgnoreCase_Hash, Path::IgnoreCase_EqualTo> ArjHeadersMap;
+typedef HashMap<IgnoreCasePathKey, Array<ArjFileChunk>, PathKey::Hash, PathKey::EqualTo> ArjHeadersMap;
 
 class ArjArchive : public MemcachingCaseInsensitiveArchive {
 	ArjHeadersMap _headers;
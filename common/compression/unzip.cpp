@@ -98,6 +98,8 @@ typedef Byte Bytef;
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/ptr.h"
+#include "common/substream.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -318,13 +320,14 @@ typedef struct {
 	unz_file_info_internal cur_file_info_internal;	/* private info about it*/
 } cached_file_in_zip;
 
-typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCase_Hash,
-	Common::Path::IgnoreCase_EqualTo> ZipHash;
+typedef Common::HashMap<Common::IgnoreCasePathKey, cached_file_in_zip, Common::PathKey::Hash,
+	Common::PathKey::EqualTo> ZipHash;
 
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owner of _stream, shared with the streamed members */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +462,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -510,7 +514,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -600,7 +603,6 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1021,6 +1023,152 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 
 namespace Common {
 
+namespace {
+
+/**
+ * A stored member of a ZIP archive, read directly from the archive file.
+ */
+class ZipStoredMemberStream : public SafeSeekableSubReadStream {
+public:
+	ZipStoredMemberStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 end) :
+		SafeSeekableSubReadStream(archiveStream.get(), begin, end), _archiveStream(archiveStream) {}
+
+private:
+	SharedPtr<SeekableReadStream> _archiveStream;
+};
+
+/**
+ * A deflated member of a ZIP archive, inflated while it is read.
+ *
+ * The last inflated windows are kept, so that going back a little does not
+ * restart the decompression from the start of the member.
+ */
+class ZipDeflatedMemberStream : public SeekableReadStream {
+public:
+	ZipDeflatedMemberStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 compressedSize, uint32 size);
+
+	bool err() const override { return _err; }
+	void clearErr() override { _err = false; }
+	bool eos() const override { return _eos; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offs, int whence = SEEK_SET) override;
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+private:
+	enum {
+		kWindowSize = 64 * 1024,
+		kWindowCount = 4
+	};
+
+	struct Window {
+		uint32 start;
+		uint32 size;
+		uint32 lastUse;
+		Array<byte> data;
+
+		Window() : start(0), size(0), lastUse(0) {}
+	};
+
+	const Window *getWindow(uint32 start);
+
+	// Declared first, so that it outlives the inflater reading from it
+	SharedPtr<SeekableReadStream> _archiveStream;
+	ScopedPtr<SeekableReadStream> _inflater;
+	Window _windows[kWindowCount];
+	uint32 _useCount;
+
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+};
+
+ZipDeflatedMemberStream::ZipDeflatedMemberStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 compressedSize, uint32 size) :
+		_archiveStream(archiveStream), _useCount(0), _size(size), _pos(0), _eos(false), _err(false) {
+	_inflater.reset(wrapDeflateReadStream(new SafeSeekableSubReadStream(archiveStream.get(), begin, begin + compressedSize), DisposeAfterUse::YES, size));
+}
+
+const ZipDeflatedMemberStream::Window *ZipDeflatedMemberStream::getWindow(uint32 start) {
+	++_useCount;
+
+	Window *oldest = &_windows[0];
+	for (int i = 0; i < kWindowCount; ++i) {
+		Window &window = _windows[i];
+		if (window.size && window.start == start) {
+			window.lastUse = _useCount;
+			return &window;
+		}
+		if (window.lastUse < oldest->lastUse)
+			oldest = &window;
+	}
+
+	if (!_inflater)
+		return nullptr;
+
+	// The inflater only has to restart from the start of the member when
+	// the window is before its current position
+	const uint32 size = MIN<uint32>(kWindowSize, _size - start);
+	oldest->data.resize(size);
+	oldest->size = 0;
+	if (!_inflater->seek(start) || _inflater->read(oldest->data.data(), size) != size)
+		return nullptr;
+
+	oldest->start = start;
+	oldest->size = size;
+	oldest->lastUse = _useCount;
+	return oldest;
+}
+
+bool ZipDeflatedMemberStream::seek(int64 offs, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offs += _size;
+		break;
+	case SEEK_CUR:
+		offs += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offs < 0 || offs > _size)
+		return false;
+
+	_pos = offs;
+	_eos = false;
+	return true;
+}
+
+uint32 ZipDeflatedMemberStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 total = 0;
+
+	while (total < dataSize) {
+		if (_pos >= _size) {
+			_eos = true;
+			break;
+		}
+
+		const Window *window = getWindow(_pos - _pos % kWindowSize);
+		if (!window) {
+			_err = true;
+			break;
+		}
+
+		const uint32 offset = _pos - window->start;
+		const uint32 count = MIN<uint32>(dataSize - total, window->size - offset);
+		memcpy(dst + total, window->data.data() + offset, count);
+		total += count;
+		_pos += count;
+	}
+
+	return total;
+}
+
+} // End of anonymous namespace
 
 class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	unzFile _zipFile;
@@ -1043,6 +1191,16 @@ public:
 	Common::Path translatePath(const Common::Path &path) const override {
 		return _flattenTree ? path.getLastComponent() : path;
 	}
+
+private:
+	/** Members from this size on are streamed */
+	static const uint32 kStreamingMinSize = 512 * 1024;
+
+	/**
+	 * Create a stream reading the current member directly from the archive
+	 * file, if it is big enough to be worth it.
+	 */
+	SeekableReadStream *createMemberStream() const;
 };
 
 /*
@@ -1092,7 +1250,7 @@ int ZipArchive::listMembers(ArchiveMemberList &list) const {
 	const unz_s *const archive = (const unz_s *)_zipFile;
 	for (ZipHash::const_iterator i = archive->_hash.begin(), end = archive->_hash.end();
 	     i != end; ++i) {
-		list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key, *this)));
+		list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key.getPath(), *this)));
 		++members;
 	}
 
@@ -1109,6 +1267,12 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+	// Big members are streamed rather than kept in memory
+	SeekableReadStream *stream = createMemberStream();
+	if (stream)
+		return Common::SharedArchiveContents::bypass(stream);
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
@@ -1116,6 +1280,31 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path
 #endif
 }
 
+SeekableReadStream *ZipArchive::createMemberStream() const {
+	unz_s *const s = (unz_s *)_zipFile;
+	const unz_file_info &info = s->cur_file_info;
+	if (!s->current_file_ok || info.uncompressed_size < kStreamingMinSize)
+		return nullptr;
+
+	uInt iSizeVar;
+	uLong offset_local_extrafield;
+	uInt size_local_extrafield;
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar, &offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
+		return nullptr;
+
+	// The CRC of streamed members is not checked, as they may never be read
+	// in full
+	const uint32 begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	switch (info.compression_method) {
+	case 0: // Store
+		return new ZipStoredMemberStream(s->_streamRef, begin, begin + info.uncompressed_size);
+	case Z_DEFLATED:
+		return new ZipDeflatedMemberStream(s->_streamRef, begin, info.compressed_size, info.uncompressed_size);
+	default:
+		return nullptr;
+	}
+}
+
 Archive *makeZipArchive(const Path &name, bool flattenTree) {
 	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree);
 }
@@ -32,6 +32,7 @@
 #endif
 
 #include "common/compression/deflate.h"
+#include "common/compression/lz4.h"
 
 #include "common/ptr.h"
 #include "common/util.h"
@@ -395,6 +396,10 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, Di
 		return nullptr;
 	}
 
+	// Saves may also be written by wrapLZ4WriteStream()
+	if (isLZ4Stream(toBeWrapped))
+		return wrapLZ4ReadStream(toBeWrapped, disposeParent);
+
 	uint16 header = toBeWrapped->readUint16BE();
 	bool isCompressed = (header == 0x1F8B ||
 			     ((header & 0x0F00) == 0x0800 &&
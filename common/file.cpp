@@ -142,6 +142,11 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+const byte *File::getContiguousData(uint32 len) {
+	assert(_handle);
+	return _handle->getContiguousData(len);
+}
+
 
 DumpFile::DumpFile() : _handle(nullptr) {
 }
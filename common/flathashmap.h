@@ -0,0 +1,542 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The layout of the control bytes and the probing in this file follow the
+// "Swiss table" design of Abseil.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/endian.h"
+#include "common/hashmap.h"
+#include "common/math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLATHASHMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Open addressing hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table storing its nodes inline.
+ *
+ * @{
+ */
+
+/**
+ * A group of control bytes of a FlatHashMap.
+ *
+ * Each slot of the map has one control byte: kEmpty, kDeleted, or the low 7
+ * bits of the hash of the key stored in the slot. A lookup compares a whole
+ * group of control bytes at once, and only compares the keys of the slots
+ * whose byte matches.
+ *
+ * The matches are returned as a mask with one bit per slot of the group.
+ */
+struct FlatHashMapGroup {
+	enum {
+		kEmpty = -128,
+		kDeleted = -2,
+#ifdef FLATHASHMAP_SSE2
+		kWidth = 16
+#else
+		kWidth = 8
+#endif
+	};
+
+	/** Index of the lowest slot in a non-zero mask. */
+	static uint lowestSlot(uint32 mask) {
+		return intLog2(mask & (~mask + 1));
+	}
+
+#ifdef FLATHASHMAP_SSE2
+	__m128i _ctrl;
+
+	explicit FlatHashMapGroup(const int8 *ctrl) : _ctrl(_mm_loadu_si128((const __m128i *)ctrl)) {}
+
+	uint32 match(int8 h2) const {
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+	}
+
+	uint32 matchEmpty() const {
+		return match(kEmpty);
+	}
+
+	uint32 matchEmptyOrDeleted() const {
+		// Only the full slots have the sign bit cleared
+		return _mm_movemask_epi8(_ctrl);
+	}
+#else
+	uint64 _ctrl;
+
+	explicit FlatHashMapGroup(const int8 *ctrl) : _ctrl(READ_LE_UINT64(ctrl)) {}
+
+	/** Gather the high bit of each byte into the low 8 bits. */
+	static uint32 toMask(uint64 bytes) {
+		return (uint32)(((bytes >> 7) * 0x0102040810204080ULL) >> 56);
+	}
+
+	uint32 match(int8 h2) const {
+		// This may report a slot right above a real match by mistake, which
+		// only costs a key comparison.
+		const uint64 lsbs = 0x0101010101010101ULL;
+		const uint64 x = _ctrl ^ (lsbs * (uint8)h2);
+		return toMask((x - lsbs) & ~x & (lsbs << 7));
+	}
+
+	uint32 matchEmpty() const {
+		// kEmpty is the only control byte with the high bit set and bit 1 cleared
+		return toMask(_ctrl & (~_ctrl << 6) & 0x8080808080808080ULL);
+	}
+
+	uint32 matchEmptyOrDeleted() const {
+		return toMask(_ctrl & 0x8080808080808080ULL);
+	}
+#endif
+};
+
+/**
+ * FlatHashMap<Key,Val> maps objects of type Key to objects of type Val, like
+ * HashMap, and offers the same interface.
+ *
+ * Unlike HashMap, the nodes are stored in the table itself, next to a small
+ * array of control bytes which lets a lookup skip the slots which cannot hold
+ * the key. This makes lookups much friendlier to the cache, and saves one
+ * allocation per node.
+ *
+ * @note The nodes move when the table grows: pointers and references to
+ *       values, as well as iterators, are invalidated by any insertion.
+ *       Use HashMap when they must outlive it.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+	typedef FlatHashMapGroup Group;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The table is rehashed when the full and deleted slots take more
+		// than 7/8 of it.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	static const size_type NONE_FOUND = (size_type)-1;
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	int8 *_ctrl;		///< Control bytes, one per slot
+	Node *_slots;		///< Raw storage for the nodes, only the full slots are constructed
+	size_type _capacity;	///< Number of slots; a power of two, and a multiple of the group width
+	size_type _size;
+	size_type _deleted;	///< Number of slots marked as kDeleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Mix the hash, as the hash functions are often weak in the low bits. */
+	uint32 hashOf(const Key &key) const {
+		uint32 hash = (uint32)_hash(key) * 0x9E3779B1u;
+		return hash ^ (hash >> 15);
+	}
+
+	static int8 h2(uint32 hash) { return hash & 0x7F; }
+
+	void allocStorage(size_type capacity) {
+		_capacity = capacity;
+		_ctrl = (int8 *)malloc(capacity);
+		_slots = (Node *)malloc(capacity * sizeof(Node));
+		assert(_ctrl != nullptr && _slots != nullptr);
+		memset(_ctrl, Group::kEmpty, capacity);
+		_size = 0;
+		_deleted = 0;
+	}
+
+	void freeStorage() {
+		for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+			if (_ctrl[ctr] >= 0)
+				_slots[ctr].~Node();
+		}
+		free(_ctrl);
+		free(_slots);
+	}
+
+	size_type lookup(const Key &key, uint32 hash) const;
+	size_type findFreeSlot(uint32 hash) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+	void assign(const FHM_t &map);
+	void eraseSlot(size_type ctr);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx < _hashmap->_capacity);
+			assert(_hashmap->_ctrl[_idx] >= 0);
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextFull(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	/** Index of the first full slot starting at @p ctr, or NONE_FOUND. */
+	size_type nextFull(size_type ctr) const {
+		for (; ctr < _capacity; ++ctr) {
+			if (_ctrl[ctr] >= 0)
+				return ctr;
+		}
+		return NONE_FOUND;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap() : _defaultVal() {
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	}
+
+	FlatHashMap(const FHM_t &map) : _defaultVal() {
+		assign(map);
+	}
+
+	~FlatHashMap() {
+		freeStorage();
+	}
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		freeStorage();
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const {
+		return lookup(key, hashOf(key)) != NONE_FOUND;
+	}
+
+	Val &operator[](const Key &key) { return getOrCreateVal(key); }
+	const Val &operator[](const Key &key) const { return getVal(key); }
+
+	Val &getOrCreateVal(const Key &key) {
+		// The storage may move while inserting, so look it up afterwards
+		const size_type ctr = lookupAndCreateIfMissing(key);
+		return _slots[ctr]._value;
+	}
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+
+	const Val &getValOrDefault(const Key &key) const {
+		return getValOrDefault(key, _defaultVal);
+	}
+
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const {
+		const size_type ctr = lookup(key, hashOf(key));
+		return ctr != NONE_FOUND ? _slots[ctr]._value : defaultVal;
+	}
+
+	bool tryGetVal(const Key &key, Val &out) const {
+		const size_type ctr = lookup(key, hashOf(key));
+		if (ctr == NONE_FOUND)
+			return false;
+		out = _slots[ctr]._value;
+		return true;
+	}
+
+	void setVal(const Key &key, const Val &val) {
+		const size_type ctr = lookupAndCreateIfMissing(key);
+		_slots[ctr]._value = val;
+	}
+
+	void clear(bool shrinkArray = false);
+
+	void erase(iterator entry) {
+		// Check whether we have a valid iterator
+		assert(entry._hashmap == this);
+		eraseSlot(entry._idx);
+	}
+
+	void erase(const Key &key) {
+		const size_type ctr = lookup(key, hashOf(key));
+		if (ctr != NONE_FOUND)
+			eraseSlot(ctr);
+	}
+
+	size_type size() const { return _size; }
+
+	/** Return true if hashmap is empty. */
+	bool empty() const { return _size == 0; }
+
+	iterator begin() { return iterator(nextFull(0), this); }
+	iterator end() { return iterator(NONE_FOUND, this); }
+	const_iterator begin() const { return const_iterator(nextFull(0), this); }
+	const_iterator end() const { return const_iterator(NONE_FOUND, this); }
+
+	iterator find(const Key &key) {
+		return iterator(lookup(key, hashOf(key)), this);
+	}
+
+	const_iterator find(const Key &key) const {
+		return const_iterator(lookup(key, hashOf(key)), this);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage is *not* freed here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._capacity);
+	memcpy(_ctrl, map._ctrl, _capacity);
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (_ctrl[ctr] >= 0)
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _capacity > FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (_ctrl[ctr] >= 0)
+			_slots[ctr].~Node();
+	}
+	memset(_ctrl, Group::kEmpty, _capacity);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Probe the groups of the table in triangular order, which visits each of
+ * them once as the number of groups is a power of two.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key, uint32 hash) const {
+	const size_type groupMask = _capacity / Group::kWidth - 1;
+	size_type group = (hash >> 7) & groupMask;
+	for (size_type step = 1; ; ++step) {
+		const size_type base = group * Group::kWidth;
+		const Group g(_ctrl + base);
+		for (uint32 mask = g.match(h2(hash)); mask; mask &= mask - 1) {
+			const size_type ctr = base + Group::lowestSlot(mask);
+			if (_equal(_slots[ctr]._key, key))
+				return ctr;
+		}
+
+		// The key would have been stored in this group if it was there
+		if (g.matchEmpty())
+			return NONE_FOUND;
+
+		assert(step <= groupMask);
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(uint32 hash) const {
+	const size_type groupMask = _capacity / Group::kWidth - 1;
+	size_type group = (hash >> 7) & groupMask;
+	for (size_type step = 1; ; ++step) {
+		const size_type base = group * Group::kWidth;
+		const uint32 mask = Group(_ctrl + base).matchEmptyOrDeleted();
+		if (mask)
+			return base + Group::lowestSlot(mask);
+
+		assert(step <= groupMask);
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const uint32 hash = hashOf(key);
+	size_type ctr = lookup(key, hash);
+	if (ctr != NONE_FOUND)
+		return ctr;
+
+	// Keep the load factor below a certain threshold, deleted slots are also
+	// counted. Rehash at the same capacity when they are mostly deleted.
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > _capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		rehash(_deleted > _size ? _capacity : _capacity * 2);
+
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == Group::kDeleted)
+		_deleted--;
+	_ctrl[ctr] = h2(hash);
+	new ((void *)&_slots[ctr]) Node(key);
+	_size++;
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	int8 *oldCtrl = _ctrl;
+	Node *oldSlots = _slots;
+	const size_type oldCapacity = _capacity;
+#ifndef NDEBUG
+	const size_type oldSize = _size;
+#endif
+
+	allocStorage(newCapacity);
+	for (size_type ctr = 0; ctr < oldCapacity; ++ctr) {
+		if (oldCtrl[ctr] < 0)
+			continue;
+
+		// No key exists twice in the old table, so there is no need to
+		// compare them.
+		Node &node = oldSlots[ctr];
+		const uint32 hash = hashOf(node._key);
+		const size_type idx = findFreeSlot(hash);
+		_ctrl[idx] = h2(hash);
+		new ((void *)&_slots[idx]) Node(node);
+		node.~Node();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == oldSize);
+
+	free(oldCtrl);
+	free(oldSlots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type ctr) {
+	assert(ctr < _capacity && _ctrl[ctr] >= 0);
+	_slots[ctr].~Node();
+
+	// The lookups stop at the first group with an empty slot, so the slot
+	// can only be emptied if its group already stopped them.
+	const size_type base = ctr & ~(size_type)(Group::kWidth - 1);
+	if (Group(_ctrl + base).matchEmpty()) {
+		_ctrl[ctr] = Group::kEmpty;
+	} else {
+		_ctrl[ctr] = Group::kDeleted;
+		_deleted++;
+	}
+	_size--;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	const size_type ctr = lookup(key, hashOf(key));
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	const size_type ctr = lookup(key, hashOf(key));
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
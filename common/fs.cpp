@@ -20,7 +20,12 @@
  */
 
 #include "common/system.h"
+#include "common/cachefile.h"
+#include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/hash-str.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
 #include "common/punycode.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
@@ -203,6 +208,18 @@ FSNode FSNode::getParent() const {
 	}
 }
 
+FSNode FSNode::clone() const {
+	if (_realNode == nullptr)
+		return FSNode();
+
+	AbstractFSNode *node = _realNode->clone();
+	if (node)
+		return FSNode(node);
+
+	const String path = _realNode->getPath();
+	return FSNode(Path(path.c_str(), Common::Path::kNativeSeparator));
+}
+
 Path FSNode::getPath() const {
 	assert(_realNode);
 	return Path(_realNode->getPath(), Common::Path::kNativeSeparator);
@@ -233,6 +250,18 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getModificationTime(int64 &time) const {
+	return _realNode && _realNode->getModificationTime(time);
+}
+
+bool FSNode::getCurrentTime(int64 &time) const {
+	return _realNode && _realNode->getCurrentTime(time);
+}
+
+bool FSNode::getFileSize(int64 &size) const {
+	return _realNode && _realNode->getFileSize(size);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -328,13 +357,14 @@ FSNode FSDirectory::getFSNode() const {
 	return _node;
 }
 
-FSNode *FSDirectory::lookupCache(NodeCache &cache, const Path &name) const {
+FSNode *FSDirectory::lookupCache(NodeCache &cache, const PathKey &name) const {
 	// make caching as lazy as possible
-	if (!name.empty()) {
+	if (!name.getPath().empty()) {
 		ensureCached();
 
-		if (cache.contains(name))
-			return &cache[name];
+		NodeCache::iterator it = cache.find(name);
+		if (it != cache.end())
+			return &it->_value;
 	}
 
 	return nullptr;
@@ -423,42 +453,194 @@ FSDirectory *FSDirectory::getSubDirectory(const Path &prefix, const Path &name,
 	return new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
 }
 
-void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const {
+/**
+ * The listings of the directories below a root directory, saved in the cache
+ * directory so that they do not have to be read again from the file system.
+ *
+ * A listing is used as long as the modification time of its directory did
+ * not change, and is older than the time the listing was read. A directory
+ * changed in the same second as it was read may have changed again in that
+ * second without changing its time.
+ *
+ * The indexes are kept in a fixed number of files, picked from a hash of
+ * the root path. The index of a root replaces the one of another root
+ * which has the same file, so that the cache directory does not grow with
+ * every directory ever scanned.
+ */
+class FSDirectory::Index {
+public:
+	struct Entry {
+		String name;
+		bool isDirectory;
+	};
+
+	explicit Index(const FSNode &root);
+
+	/** Return the listing of the given directory, or nullptr if it is unknown or outdated */
+	const Array<Entry> *getEntries(const String &path, int64 time) const;
+	void setEntries(const String &path, int64 time, int64 readTime, const Array<Entry> &entries);
+
+	/** Save the index if a listing changed */
+	void save();
+
+private:
+	enum {
+		kVersion = 3,
+		kMaxIndexFiles = 32
+	};
+
+	struct Listing {
+		int64 time;
+		int64 readTime;
+		Array<Entry> entries;
+	};
+
+	typedef HashMap<String, Listing> ListingMap;
+
+	String _rootPath;
+	FSNode _file;
+	ListingMap _listings;
+	bool _changed;
+};
+
+FSDirectory::Index::Index(const FSNode &root) : _changed(false) {
+	_rootPath = root.getPath().toString(Path::kNativeSeparator);
+
+	const String fileName = String::format("fsindex-%02u.dat", hashit(_rootPath.c_str()) % kMaxIndexFiles);
+	_file = FSNode(ConfMan.getPath("cachepath")).getChild(fileName);
+	if (!_file._realNode)
+		return;
+
+	ScopedPtr<SeekableReadStream> in(loadCacheFile(_file, MKTAG('F', 'S', 'I', 'X'), kVersion));
+	// Another root may use the same file
+	if (!in || in->readString() != _rootPath)
+		return;
+
+	const uint32 listingCount = in->readUint32LE();
+	for (uint32 i = 0; i < listingCount && !in->eos(); ++i) {
+		const String path = in->readString();
+		Listing &listing = _listings[path];
+		listing.time = in->readSint64LE();
+		listing.readTime = in->readSint64LE();
+		listing.entries.resize(in->readUint32LE());
+		for (uint32 j = 0; j < listing.entries.size() && !in->eos(); ++j) {
+			listing.entries[j].isDirectory = in->readByte() != 0;
+			listing.entries[j].name = in->readString();
+		}
+	}
+
+	if (in->eos())
+		_listings.clear();
+}
+
+const Array<FSDirectory::Index::Entry> *FSDirectory::Index::getEntries(const String &path, int64 time) const {
+	ListingMap::const_iterator it = _listings.find(path);
+	if (it == _listings.end() || !isCacheEntryCurrent(time, it->_value.time, it->_value.readTime))
+		return nullptr;
+
+	return &it->_value.entries;
+}
+
+void FSDirectory::Index::setEntries(const String &path, int64 time, int64 readTime, const Array<Entry> &entries) {
+	Listing &listing = _listings[path];
+	listing.time = time;
+	listing.readTime = readTime;
+	listing.entries = entries;
+	_changed = true;
+}
+
+void FSDirectory::Index::save() {
+	if (!_changed || !_file._realNode)
+		return;
+
+	MemoryWriteStreamDynamic data(DisposeAfterUse::YES);
+	data.writeString(_rootPath);
+	data.writeByte(0);
+
+	data.writeUint32LE(_listings.size());
+	for (ListingMap::const_iterator it = _listings.begin(); it != _listings.end(); ++it) {
+		data.writeString(it->_key);
+		data.writeByte(0);
+		data.writeSint64LE(it->_value.time);
+		data.writeSint64LE(it->_value.readTime);
+		data.writeUint32LE(it->_value.entries.size());
+		for (uint i = 0; i < it->_value.entries.size(); ++i) {
+			const Entry &entry = it->_value.entries[i];
+			data.writeByte(entry.isDirectory ? 1 : 0);
+			data.writeString(entry.name);
+			data.writeByte(0);
+		}
+	}
+
+	saveCacheFile(_file, MKTAG('F', 'S', 'I', 'X'), kVersion, data.getData(), data.size());
+	_changed = false;
+}
+
+bool FSDirectory::listDirectory(const FSNode &node, FSList &list, Index *index) const {
+	int64 time, readTime;
+	if (!index || !node._realNode || !node._realNode->getModificationTime(time) || !node._realNode->getCurrentTime(readTime))
+		return node.getChildren(list, FSNode::kListAll);
+
+	const String path = node._realNode->getPath();
+	const Array<Index::Entry> *entries = index->getEntries(path, time);
+	if (entries) {
+		for (uint i = 0; i < entries->size(); ++i) {
+			AbstractFSNode *child = node._realNode->getKnownChild((*entries)[i].name, (*entries)[i].isDirectory);
+			if (child)
+				list.push_back(FSNode(child));
+		}
+		return true;
+	}
+
+	if (!node.getChildren(list, FSNode::kListAll))
+		return false;
+
+	Array<Index::Entry> newEntries(list.size());
+	for (uint i = 0; i < list.size(); ++i) {
+		newEntries[i].name = list[i].getRealName();
+		newEntries[i].isDirectory = list[i].isDirectory();
+	}
+	index->setEntries(path, time, readTime, newEntries);
+	return true;
+}
+
+void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix, Index *index) const {
 	if (depth <= 0)
 		return;
 
 	FSList list;
-	node.getChildren(list, FSNode::kListAll);
+	listDirectory(node, list, index);
 
 	FSList::iterator it = list.begin();
 	for ( ; it != list.end(); ++it) {
 		Path name = prefix.appendComponent(it->getRealName());
+		const PathKey key(name);
 
 		// since the hashmap is case insensitive, we need to check for clashes when caching
 		if (it->isDirectory()) {
-			if (!_flat && _subDirCache.contains(name)) {
+			if (!_flat && _subDirCache.contains(key)) {
 				// Always warn in this case as it's when there are 2 directories at the same place with different case
 				// That means a problem in user installation as lookups are always done case insensitive
 				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'",
 				        Common::toPrintable(name.toString(Common::Path::kNativeSeparator)).c_str());
 			} else {
-				if (_subDirCache.contains(name)) {
+				if (_subDirCache.contains(key)) {
 					if (!_ignoreClashes) {
 						warning("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'",
 						        Common::toPrintable(name.toString(Common::Path::kNativeSeparator)).c_str());
 					}
 				}
-				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : name);
-				_subDirCache[name] = *it;
+				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : name, index);
+				_subDirCache[key] = *it;
 			}
 		} else {
-			if (_fileCache.contains(name)) {
+			if (_fileCache.contains(key)) {
 				if (!_ignoreClashes) {
 					warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'",
 					        Common::toPrintable(name.toString(Common::Path::kNativeSeparator)).c_str());
 				}
 			} else
-				_fileCache[name] = *it;
+				_fileCache[key] = *it;
 		}
 	}
 
@@ -467,7 +649,16 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& pr
 void FSDirectory::ensureCached() const  {
 	if (_cached)
 		return;
-	cacheDirectoryRecursive(_node, _depth, _prefix);
+
+	// Only whole trees are worth indexing, single directories are listed
+	// quickly enough
+	if (_depth > 1 && !ConfMan.getPath("cachepath").empty()) {
+		Index index(_node);
+		cacheDirectoryRecursive(_node, _depth, _prefix, &index);
+		index.save();
+	} else {
+		cacheDirectoryRecursive(_node, _depth, _prefix, nullptr);
+	}
 	_cached = true;
 }
 
@@ -480,15 +671,15 @@ int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const Path &patter
 
 	int matches = 0;
 	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it) {
-		if (it->_key.matchPattern(pattern)) {
-			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+		if (it->_key.getPath().matchPattern(pattern)) {
+			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key.getPath(), it->_value)));
 			matches++;
 		}
 	}
 	if (_includeDirectories) {
 		for (NodeCache::const_iterator it = _subDirCache.begin(); it != _subDirCache.end(); ++it) {
-			if (it->_key.matchPattern(pattern)) {
-				list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+			if (it->_key.getPath().matchPattern(pattern)) {
+				list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key.getPath(), it->_value)));
 				matches++;
 			}
 		}
@@ -506,13 +697,13 @@ int FSDirectory::listMembers(ArchiveMemberList &list) const {
 
 	int files = 0;
 	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it) {
-		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key.getPath(), it->_value)));
 		++files;
 	}
 
 	if (_includeDirectories) {
 		for (NodeCache::const_iterator it = _subDirCache.begin(); it != _subDirCache.end(); ++it) {
-			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key.getPath(), it->_value)));
 			++files;
 		}
 	}
@@ -24,6 +24,7 @@
 
 #include "common/array.h"
 #include "common/archive.h"
+#include "common/flathashmap.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
 #include "common/ptr.h"
@@ -209,6 +210,14 @@ public:
 	 */
 	FSNode getParent() const;
 
+	/**
+	 * Create a copy of this node which shares no data with it. Unlike the
+	 * copies of an FSNode, which share the same node, each clone can be
+	 * used by another thread. The file system is not checked again when the
+	 * backend supports it.
+	 */
+	FSNode clone() const;
+
 	/**
 	 * Indicate whether the node refers to a directory or not.
 	 *
@@ -252,6 +261,31 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Get the time of the last modification of the object referred by this
+	 * node. The unit of the time depends on the file system, so it is only
+	 * meaningful when compared with another time of the same node.
+	 *
+	 * @return True if successful, false if the time is not available.
+	 */
+	bool getModificationTime(int64 &time) const;
+
+	/**
+	 * Get the current time, in the unit of getModificationTime(). An object
+	 * changed at this time may change again without its time changing, so
+	 * what was read from it can only be trusted once its time is older.
+	 *
+	 * @return True if successful, false if the time is not available.
+	 */
+	bool getCurrentTime(int64 &time) const;
+
+	/**
+	 * Get the size of the file referred by this node, without opening it.
+	 *
+	 * @return True if successful, false if the size is not available.
+	 */
+	bool getFileSize(int64 &size) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -344,16 +378,24 @@ class FSDirectory : public Archive {
 	void setPrefix(const Path &prefix);
 
 	// Caches are case insensitive, clashes are dealt with when creating
-	// Key is stored in lowercase.
-	typedef HashMap<Path, FSNode, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> NodeCache;
+	// The keys keep their folded identifier, so that lookups do not fold
+	// the cached paths again.
+	// The nodes are stored inline, so they move when the caches grow.
+	typedef FlatHashMap<PathKey, FSNode, PathKey::Hash, PathKey::EqualTo> NodeCache;
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable bool _cached;
 
 	// look for a match
-	FSNode *lookupCache(NodeCache &cache, const Path &name) const;
+	FSNode *lookupCache(NodeCache &cache, const PathKey &name) const;
+
+	// Persistent index of the directory listings, kept in the cache directory
+	class Index;
 
 	// cache management
-	void cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const;
+	void cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix, Index *index) const;
+
+	// list a directory, through the index when it is up to date
+	bool listDirectory(const FSNode &node, FSList &list, Index *index) const;
 
 	// fill cache if not already cached
 	void ensureCached() const;
@@ -443,6 +485,11 @@ public:
 	 * for success.
 	 */
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, AltStreamType altStreamType) const override;
+
+	/**
+	 * Each member is read through its own file, so it can be read on any thread.
+	 */
+	bool canReadMembersInBackground() const override { return true; }
 };
 
 /** @} */
@@ -27,6 +27,7 @@
 #include "common/fs.h"
 #include "common/macresman.h"
 #include "common/md5.h"
+#include "common/span.h"
 #include "common/substream.h"
 #include "common/textconsole.h"
 #include "common/archive.h"
@@ -876,6 +877,25 @@ String MacResManager::getResName(uint32 typeID, uint16 resID) const {
 }
 
 SeekableReadStream *MacResManager::getResource(uint32 typeID, uint16 resID) {
+	uint32 len = seekToResource(typeID, resID);
+
+	// Ignore resources with 0 length
+	if (!len)
+		return nullptr;
+
+	return _stream->readStream(len);
+}
+
+Span<const byte> MacResManager::getResourceView(uint32 typeID, uint16 resID) {
+	uint32 len = seekToResource(typeID, resID);
+
+	if (!len)
+		return Span<const byte>();
+
+	return _stream->tryGetContiguousView(len);
+}
+
+uint32 MacResManager::seekToResource(uint32 typeID, uint16 resID) {
 	int typeNum = -1;
 	int resNum = -1;
 
@@ -886,7 +906,7 @@ SeekableReadStream *MacResManager::getResource(uint32 typeID, uint16 resID) {
 		}
 
 	if (typeNum == -1)
-		return nullptr;
+		return 0;
 
 	for (int i = 0; i < _resTypes[typeNum].items; i++)
 		if (_resLists[typeNum][i].id == resID) {
@@ -895,16 +915,10 @@ SeekableReadStream *MacResManager::getResource(uint32 typeID, uint16 resID) {
 		}
 
 	if (resNum == -1)
-		return nullptr;
+		return 0;
 
 	_stream->seek(_dataOffset + _resLists[typeNum][resNum].dataOffset);
-	uint32 len = _stream->readUint32BE();
-
-	// Ignore resources with 0 length
-	if (!len)
-		return nullptr;
-
-	return _stream->readStream(len);
+	return _stream->readUint32BE();
 }
 
 SeekableReadStream *MacResManager::getResource(const String &fileName) {
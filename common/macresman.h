@@ -53,6 +53,8 @@ namespace Common {
  * @{
  */
 
+template<typename ValueType> class Span;
+
 typedef Array<uint16> MacResIDArray;
 typedef Array<uint32> MacResTagArray;
 
@@ -214,6 +216,17 @@ public:
 	 */
 	SeekableReadStream *getResource(uint32 typeID, uint16 resID);
 
+	/**
+	 * Read resource from the MacBinary file without copying it
+	 * @note The data is only available when the resource fork is held in
+	 *       memory or mapped, and stays valid until the fork is closed
+	 * @param typeID FourCC of the type
+	 * @param resID Resource ID to fetch
+	 * @return Span over the resource data, empty if the resource is missing,
+	 *         empty or not held in memory
+	 */
+	Span<const byte> getResourceView(uint32 typeID, uint16 resID);
+
 	/**
 	 * Read resource from the MacBinary file
 	 * @note This will take the first resource that matches this name, regardless of type
@@ -342,6 +355,12 @@ private:
 
 	void readMap();
 
+	/**
+	 * Seek to the data of a resource
+	 * @return Length of the resource, 0 if it is missing
+	 */
+	uint32 seekToResource(uint32 typeID, uint16 resID);
+
 	struct ResMap {
 		uint16 resAttr;
 		uint16 typeOffset;
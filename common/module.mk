@@ -3,6 +3,7 @@ MODULE := common
 MODULE_OBJS := \
 	archive.o \
 	btea.o \
+	cachefile.o \
 	concatstream.o \
 	config-manager.o \
 	coroutines.o \
@@ -24,6 +25,7 @@ MODULE_OBJS := \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
+	prefetcher.o \
 	punycode.o \
 	random.o \
 	rational.o \
@@ -37,6 +39,7 @@ MODULE_OBJS := \
 	system.o \
 	textconsole.o \
 	text-to-speech.o \
+	threadpool.o \
 	tokenizer.o \
 	translation.o \
 	unicode-bidi.o \
@@ -285,6 +285,12 @@ Path Path::extract(const char *begin, const char *end) const {
 	return ret;
 }
 
+Path Path::clone() const {
+	Path path;
+	path._str = String(_str.c_str());
+	return path;
+}
+
 String Path::toString(char separator) const {
 	// toString should never be called with \x00 separator
 	assert(separator != kNoSeparator);
@@ -1018,6 +1024,46 @@ static String getIdentifierComponent(const String &in) {
 	return part;
 }
 
+String Path::getIdentifierIgnoreCaseAndMac() const {
+	// Without escaping nor punycode, the components need no decoding and
+	// the whole string can be folded at once
+	if (!isEscaped() && !strstr(_str.c_str(), "xn--")) {
+		String ret(_str);
+		ret.toLowercase();
+		return ret;
+	}
+
+	String ret;
+	reduceComponents<String &>(
+		[](String &value, const String &in, bool last) -> String & {
+			value += getIdentifierComponent(in);
+			if (!last) {
+				value += SEPARATOR;
+			}
+			return value;
+		}, ret);
+	ret.toLowercase();
+	return ret;
+}
+
+PathKey::PathKey(const Path &path) :
+	_path(path), _identifier(path.getIdentifierIgnoreCaseAndMac()), _hash(hashit(_identifier.c_str())) {
+}
+
+PathKey::PathKey(const Path &path, const String &identifier) :
+	_path(path), _identifier(identifier), _hash(hashit(_identifier.c_str())) {
+}
+
+static String getIdentifierIgnoreCase(const String &str) {
+	String identifier(str);
+	identifier.toLowercase();
+	return identifier;
+}
+
+IgnoreCasePathKey::IgnoreCasePathKey(const Path &path) :
+	PathKey(path, getIdentifierIgnoreCase(path._str)) {
+}
+
 uint Path::hash() const {
 	return hashit(_str.c_str());
 }
@@ -53,6 +53,8 @@ class Path {
 #ifdef CXXTEST_RUNNING
 	friend class ::PathTestSuite;
 #endif
+	friend class PathKey;
+	friend class IgnoreCasePathKey;
 
 private:
 #ifndef RELEASE_BUILD
@@ -181,6 +183,12 @@ private:
 	 */
 	const char *getSuffix(const Common::Path &other) const;
 
+	/**
+	 * Returns the components of the path, as compared by
+	 * equalsIgnoreCaseAndMac, lowercased and joined with SEPARATOR
+	 */
+	String getIdentifierIgnoreCaseAndMac() const;
+
 public:
 	/**
 	 * A separator to use when building path conataining only base names
@@ -242,6 +250,12 @@ public:
 	/** Construct a copy of the given path. */
 	Path(const Path &path) : _str(path._str) { }
 
+	/**
+	 * Create a copy of this path which does not share its buffer with it.
+	 * Unlike the copies of a path, the clone can be handed to another thread.
+	 */
+	Path clone() const;
+
 	/**
 	 * Construct a new path from the given NULL-terminated C string.
 	 *
@@ -562,6 +576,62 @@ public:
 	static Path fromConfig(const String &value);
 };
 
+/**
+ * A path along with its identifier for the case-insensitive and Mac
+ * lookups, and the hash of this identifier.
+ *
+ * Both are computed once when the key is built, so a hash map keyed by
+ * PathKey compares hashes and plain strings, where one keyed by Path with
+ * Path::IgnoreCaseAndMac_Hash folds both paths on every probe.
+ * A key is built implicitly from a Path when looking it up.
+ */
+class PathKey {
+public:
+	PathKey() : _hash(0) {}
+	PathKey(const Path &path);
+
+	/** The path the key was built from, with its original case. */
+	const Path &getPath() const { return _path; }
+
+	/** The case-folded and Mac-normalized identifier of the path. */
+	const String &getIdentifier() const { return _identifier; }
+
+	uint hash() const { return _hash; }
+
+	bool operator==(const PathKey &x) const {
+		return _hash == x._hash && _identifier == x._identifier;
+	}
+
+	bool operator!=(const PathKey &x) const { return !(*this == x); }
+
+	struct EqualTo {
+		bool operator()(const PathKey &x, const PathKey &y) const { return x == y; }
+	};
+
+	struct Hash {
+		uint operator()(const PathKey &x) const { return x._hash; }
+	};
+
+protected:
+	PathKey(const Path &path, const String &identifier);
+
+private:
+	Path _path;
+	String _identifier;
+	uint _hash;
+};
+
+/**
+ * A PathKey which only folds the case of the path, as Path::IgnoreCase_Hash
+ * does. The archives use it for their members, whose names are matched
+ * as they are stored, without the Mac normalization.
+ */
+class IgnoreCasePathKey : public PathKey {
+public:
+	IgnoreCasePathKey() {}
+	IgnoreCasePathKey(const Path &path);
+};
+
 /** @} */
 
 } // End of namespace Common
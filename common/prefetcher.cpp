@@ -0,0 +1,398 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/prefetcher.h"
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/path.h"
+
+#ifdef USE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Common {
+
+struct ArchivePrefetcher::State {
+	enum Status {
+		kQueued,
+		kReading,
+		kReady
+	};
+
+	struct Entry {
+		uint32 id;
+		/** A clone of the path given to prefetch(), so that the worker may destroy the entry */
+		Path path;
+		/** The member opened by prefetch(), only used by the worker while reading */
+		SeekableReadStream *stream;
+		Status status;
+		/** Set when the entry is dropped while the worker reads it. The worker erases it when done. */
+		bool dropped;
+		byte *data;
+		uint32 size;
+	};
+
+	typedef List<Entry> EntryList;
+
+	/** Entries from the oldest to the newest */
+	EntryList entries;
+	uint32 nextId;
+	uint32 cachedSize;
+	uint32 maxCachedSize;
+
+	/**
+	 * The streams the worker is done with. They are deleted by the thread
+	 * which opened them, as they may share data with the archive.
+	 */
+	Array<SeekableReadStream *> doneStreams;
+
+#ifdef USE_THREADS
+	/** Protects the entries, the sizes and the streams to delete */
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable finished;
+
+	std::thread worker;
+	bool quit;
+#endif
+
+	EntryList::iterator find(const Path &path) {
+		EntryList::iterator it = entries.begin();
+		for (; it != entries.end(); ++it) {
+			if (!it->dropped && it->path.equalsIgnoreCaseAndMac(path))
+				break;
+		}
+		return it;
+	}
+
+	EntryList::iterator findId(uint32 id) {
+		EntryList::iterator it = entries.begin();
+		for (; it != entries.end(); ++it) {
+			if (it->id == id)
+				break;
+		}
+		return it;
+	}
+
+	bool isBusy() const {
+		for (EntryList::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+			if (it->status == kReading)
+				return true;
+		}
+		return false;
+	}
+
+	bool hasPending() const {
+		for (EntryList::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+			if (it->status != kReady)
+				return true;
+		}
+		return false;
+	}
+
+	void release(Entry &entry) {
+		if (entry.stream) {
+			doneStreams.push_back(entry.stream);
+			entry.stream = nullptr;
+		}
+	}
+
+	void erase(EntryList::iterator it) {
+		if (it->status == kReady || it->status == kReading)
+			cachedSize -= it->size;
+		release(*it);
+		free(it->data);
+		entries.erase(it);
+	}
+
+	/** Drop the oldest cached entries until the cache fits in its limit. */
+	void evict() {
+		EntryList::iterator it = entries.begin();
+		while (cachedSize > maxCachedSize && it != entries.end()) {
+			if (it->status == kReady) {
+				cachedSize -= it->size;
+				free(it->data);
+				it = entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	/** Delete the streams the worker is done with. Only the thread using the prefetcher may call this. */
+	void deleteDoneStreams() {
+		for (uint i = 0; i < doneStreams.size(); ++i)
+			delete doneStreams[i];
+		doneStreams.clear();
+	}
+
+	/**
+	 * Check the size of an opened entry, and reserve it in the cache.
+	 *
+	 * @return False if the entry does not fit in the cache.
+	 */
+	bool reserve(Entry &entry) {
+		const int64 size = entry.stream->size();
+		if (size < 0 || size > (int64)maxCachedSize)
+			return false;
+
+		entry.size = (uint32)size;
+		entry.status = kReading;
+		cachedSize += entry.size;
+		evict();
+		return true;
+	}
+
+	static byte *read(SeekableReadStream *stream, uint32 size) {
+		byte *data = (byte *)malloc(size ? size : 1);
+		if (data && stream->read(data, size) != size) {
+			free(data);
+			data = nullptr;
+		}
+		return data;
+	}
+
+#ifdef USE_THREADS
+	/**
+	 * Read the queued entries. The worker never calls the archives, and only
+	 * uses the streams opened for it and the paths cloned for it, so it
+	 * shares no reference counted object with the other threads.
+	 */
+	void workerMain() {
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			EntryList::iterator it;
+			wakeUp.wait(lock, [this, &it] {
+				if (quit)
+					return true;
+				for (it = entries.begin(); it != entries.end(); ++it) {
+					if (it->status == kQueued)
+						return true;
+				}
+				return false;
+			});
+			if (quit)
+				return;
+
+			if (!reserve(*it)) {
+				erase(it);
+				finished.notify_all();
+				continue;
+			}
+
+			SeekableReadStream *stream = it->stream;
+			const uint32 size = it->size;
+			lock.unlock();
+			byte *data = read(stream, size);
+			lock.lock();
+
+			it->data = data;
+			it->status = kReady;
+			release(*it);
+			if (!data || it->dropped)
+				erase(it);
+			finished.notify_all();
+		}
+	}
+#endif
+};
+
+#ifdef USE_THREADS
+
+ArchivePrefetcher::ArchivePrefetcher(uint32 maxCachedSize) : _state(new State()) {
+	_state->nextId = 0;
+	_state->cachedSize = 0;
+	_state->maxCachedSize = maxCachedSize;
+	_state->quit = false;
+}
+
+ArchivePrefetcher::~ArchivePrefetcher() {
+	{
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		_state->quit = true;
+	}
+	_state->wakeUp.notify_all();
+	if (_state->worker.joinable())
+		_state->worker.join();
+
+	while (!_state->entries.empty())
+		_state->erase(_state->entries.begin());
+	_state->deleteDoneStreams();
+	delete _state;
+}
+
+void ArchivePrefetcher::setMaxCachedSize(uint32 maxCachedSize) {
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	_state->maxCachedSize = maxCachedSize;
+	_state->evict();
+}
+
+void ArchivePrefetcher::prefetch(const Archive *archive, const Path &path) {
+	std::unique_lock<std::mutex> lock(_state->mutex);
+	_state->deleteDoneStreams();
+	if (_state->find(path) != _state->entries.end())
+		return;
+
+	// The member is opened on this thread, as the archive shares its nodes
+	// and paths with it
+	lock.unlock();
+	SeekableReadStream *stream = archive->createReadStreamForMember(path);
+	if (!stream)
+		return;
+	lock.lock();
+
+	// The copies of the clone made here are destroyed with the lock held
+	State::Entry entry = { _state->nextId++, path.clone(), stream, State::kQueued, false, nullptr, 0 };
+	_state->entries.push_back(entry);
+
+	// The worker is only started once there is something to read
+	if (!_state->worker.joinable())
+		_state->worker = std::thread(&State::workerMain, _state);
+	_state->wakeUp.notify_one();
+}
+
+SeekableReadStream *ArchivePrefetcher::take(const Path &path) {
+	std::unique_lock<std::mutex> lock(_state->mutex);
+	_state->deleteDoneStreams();
+	State::EntryList::iterator it = _state->find(path);
+	if (it == _state->entries.end())
+		return nullptr;
+
+	switch (it->status) {
+	case State::kQueued: {
+		// Reading the opened member right away is faster than waiting for
+		// the members queued before it
+		SeekableReadStream *stream = it->stream;
+		_state->entries.erase(it);
+		return stream;
+	}
+	case State::kReading: {
+		// The worker erases the entry if reading fails
+		const uint32 id = it->id;
+		_state->finished.wait(lock, [this, id] {
+			State::EntryList::iterator entry = _state->findId(id);
+			return entry == _state->entries.end() || entry->status == State::kReady;
+		});
+		it = _state->findId(id);
+		if (it == _state->entries.end())
+			return nullptr;
+		break;
+	}
+	default:
+		break;
+	}
+
+	SeekableReadStream *stream = new MemoryReadStream(it->data, it->size, DisposeAfterUse::YES);
+	_state->cachedSize -= it->size;
+	_state->entries.erase(it);
+	return stream;
+}
+
+void ArchivePrefetcher::wait() {
+	std::unique_lock<std::mutex> lock(_state->mutex);
+	_state->finished.wait(lock, [this] { return !_state->hasPending(); });
+	_state->deleteDoneStreams();
+}
+
+void ArchivePrefetcher::clear() {
+	std::unique_lock<std::mutex> lock(_state->mutex);
+	State::EntryList::iterator it = _state->entries.begin();
+	while (it != _state->entries.end()) {
+		State::EntryList::iterator next = it;
+		++next;
+		if (it->status == State::kReading)
+			it->dropped = true;
+		else
+			_state->erase(it);
+		it = next;
+	}
+	_state->finished.wait(lock, [this] { return !_state->isBusy(); });
+	_state->deleteDoneStreams();
+}
+
+#else
+
+ArchivePrefetcher::ArchivePrefetcher(uint32 maxCachedSize) : _state(new State()) {
+	_state->nextId = 0;
+	_state->cachedSize = 0;
+	_state->maxCachedSize = maxCachedSize;
+}
+
+ArchivePrefetcher::~ArchivePrefetcher() {
+	clear();
+	delete _state;
+}
+
+void ArchivePrefetcher::setMaxCachedSize(uint32 maxCachedSize) {
+	_state->maxCachedSize = maxCachedSize;
+	_state->evict();
+}
+
+void ArchivePrefetcher::prefetch(const Archive *archive, const Path &path) {
+	if (_state->find(path) != _state->entries.end())
+		return;
+
+	SeekableReadStream *stream = archive->createReadStreamForMember(path);
+	if (!stream)
+		return;
+
+	State::Entry entry = { _state->nextId++, path, stream, State::kQueued, false, nullptr, 0 };
+	if (_state->reserve(entry)) {
+		entry.data = State::read(stream, entry.size);
+		if (entry.data) {
+			entry.status = State::kReady;
+			entry.stream = nullptr;
+			_state->entries.push_back(entry);
+		} else {
+			_state->cachedSize -= entry.size;
+		}
+	}
+	delete stream;
+}
+
+SeekableReadStream *ArchivePrefetcher::take(const Path &path) {
+	State::EntryList::iterator it = _state->find(path);
+	if (it == _state->entries.end())
+		return nullptr;
+
+	SeekableReadStream *stream = new MemoryReadStream(it->data, it->size, DisposeAfterUse::YES);
+	_state->cachedSize -= it->size;
+	_state->entries.erase(it);
+	return stream;
+}
+
+void ArchivePrefetcher::wait() {
+}
+
+void ArchivePrefetcher::clear() {
+	while (!_state->entries.empty())
+		_state->erase(_state->entries.begin());
+}
+
+#endif
+
+} // End of namespace Common
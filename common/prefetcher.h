@@ -0,0 +1,118 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PREFETCHER_H
+#define COMMON_PREFETCHER_H
+
+#include "common/noncopyable.h"
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_prefetcher Archive prefetcher
+ * @ingroup common
+ *
+ * @brief Reading archive members ahead of time.
+ * @{
+ */
+
+class Archive;
+class Path;
+class SeekableReadStream;
+
+/**
+ * Reads archive members on a background thread, and keeps their contents
+ * in memory until they are opened.
+ *
+ * The members are opened and their streams deleted on the thread using the
+ * prefetcher, as the archives share their nodes and paths with it. The
+ * worker only reads the opened streams into memory, so only the members of
+ * archives which return true from Archive::canReadMembersInBackground() may
+ * be prefetched.
+ *
+ * The contents waiting to be opened are kept within a size limit, the oldest
+ * ones being dropped first.
+ *
+ * When ScummVM is built without thread support (USE_THREADS is not defined),
+ * the members are read when they are queued.
+ */
+class ArchivePrefetcher : NonCopyable {
+public:
+	/** Default limit of the size of the contents kept in memory */
+	static const uint32 kDefaultMaxCachedSize = 32 * 1024 * 1024;
+
+	explicit ArchivePrefetcher(uint32 maxCachedSize = kDefaultMaxCachedSize);
+
+	/**
+	 * Wait for the member being read, if any, and drop everything.
+	 */
+	~ArchivePrefetcher();
+
+	/**
+	 * Change the limit of the size of the contents kept in memory. The
+	 * members bigger than the limit are not prefetched.
+	 */
+	void setMaxCachedSize(uint32 maxCachedSize);
+
+	/**
+	 * Open a member and queue reading it. Nothing is done if the member is
+	 * already queued or cached.
+	 *
+	 * @param archive  Archive to read the member from. It must stay alive
+	 *                 until the member is taken or clear() is called.
+	 * @param path     Path of the member in the archive.
+	 */
+	void prefetch(const Archive *archive, const Path &path);
+
+	/**
+	 * Take the contents of a member out of the cache. If the member is being
+	 * read, this waits until it is done. A member still waiting in the queue
+	 * is taken out of it, and its opened stream is returned, as reading it
+	 * right away is faster than waiting for the members queued before it.
+	 *
+	 * @return A stream over the contents, or nullptr if the member must be
+	 *         opened from its archive.
+	 */
+	SeekableReadStream *take(const Path &path);
+
+	/**
+	 * Wait until all the queued members are read.
+	 */
+	void wait();
+
+	/**
+	 * Drop the queued and cached members, and wait for the member being
+	 * read, if any. Afterwards, the archives are not used anymore.
+	 */
+	void clear();
+
+private:
+	struct State;
+
+	State *_state;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
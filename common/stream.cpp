@@ -22,6 +22,7 @@
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/memstream.h"
+#include "common/span.h"
 #include "common/substream.h"
 #include "common/str.h"
 
@@ -124,6 +125,17 @@ uint32 MemoryReadStream::read(void *dataPtr, uint32 dataSize) {
 	return dataSize;
 }
 
+const byte *MemoryReadStream::getContiguousData(uint32 dataSize) {
+	if (dataSize > _size - _pos)
+		return nullptr;
+
+	const byte *data = _ptr;
+	_ptr += dataSize;
+	_pos += dataSize;
+
+	return data;
+}
+
 bool MemoryReadStream::seek(int64 offs, int whence) {
 	// Pre-Condition
 	assert(_pos <= _size);
@@ -287,6 +299,24 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getContiguousData(uint32 dataSize) {
+	if (dataSize > _end - _pos)
+		return nullptr;
+
+	const byte *data = _parentStream->getContiguousData(dataSize);
+	if (data)
+		_pos += dataSize;
+
+	return data;
+}
+
+const byte *SafeSeekableSubReadStream::getContiguousData(uint32 dataSize) {
+	// Make sure the parent stream is at the right position
+	seek(0, SEEK_CUR);
+
+	return SeekableSubReadStream::getContiguousData(dataSize);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -294,6 +324,11 @@ uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return SeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+Span<const byte> SeekableReadStream::tryGetContiguousView(uint32 dataSize) {
+	const byte *data = getContiguousData(dataSize);
+	return data ? Span<const byte>(data, dataSize) : Span<const byte>();
+}
+
 void SeekableReadStream::hexdump(int len, int bytesPerLine, int startOffset) {
 	uint pos_ = pos();
 	uint size_ = size();
@@ -603,4 +638,9 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+const byte *SafeMutexedSeekableSubReadStream::getContiguousData(uint32 dataSize) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::getContiguousData(dataSize);
+}
+
 } // End of namespace Common
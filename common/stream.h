@@ -41,6 +41,7 @@ namespace Common {
 
 class ReadStream;
 class SeekableReadStream;
+template<typename ValueType> class Span;
 
 /**
  * Virtual base class for both ReadStream and WriteStream.
@@ -792,6 +793,28 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Get the next @p size bytes of the stream in place, without copying
+	 * them, when the stream keeps its data in memory.
+	 *
+	 * On success, the stream position moves past these bytes, as with read().
+	 * The data stays valid as long as the stream exists.
+	 *
+	 * @return Pointer to the data, or nullptr if the data is not in memory or
+	 *         fewer than @p size bytes are left. The position is then unchanged.
+	 */
+	virtual const byte *getContiguousData(uint32 size) { return nullptr; }
+
+	/**
+	 * Same as getContiguousData(), returning a span of the data.
+	 *
+	 * Decoders can use it to parse a resource in place, and fall back to
+	 * read() when the span is empty.
+	 *
+	 * @note Include common/span.h to use the span.
+	 */
+	Span<const byte> tryGetContiguousView(uint32 size);
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -982,6 +1005,7 @@ public:
 	int64 pos() const override { return _parentStream->pos(); }
 	int64 size() const override { return _parentStream->size(); }
 	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+	const byte *getContiguousData(uint32 dataSize) override { return _parentStream->getContiguousData(dataSize); }
 };
 
 /** @} */
@@ -86,6 +86,8 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+
+	const byte *getContiguousData(uint32 dataSize) override;
 };
 
 /**
@@ -132,6 +134,7 @@ public:
 	}
 
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	const byte *getContiguousData(uint32 dataSize) override;
 };
 
 /**
@@ -148,6 +151,7 @@ public:
 		: SafeSeekableSubReadStream(parentStream, begin, end, disposeParentStream), _mutex(mutex) {
 	}
 	uint32 read(void *dataPtr, uint32 dataSize) override;
+	const byte *getContiguousData(uint32 dataSize) override;
 protected:
 	Common::Mutex &_mutex;
 };
@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/threadpool.h"
+
+#ifdef USE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace Common {
+
+#ifdef USE_THREADS
+
+struct ThreadPool::State {
+	/** Serializes the batches */
+	std::mutex runMutex;
+
+	/** Protects everything below */
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable finished;
+
+	TaskProc proc;
+	void *param;
+	uint count;
+
+	/** Next task to hand out, and number of tasks not done yet */
+	uint next;
+	uint pending;
+
+	/** Incremented for each batch, so that workers can tell a new batch from a spurious wake up */
+	uint batch;
+	bool quit;
+
+	std::vector<std::thread> workers;
+
+	/** Run the tasks left in the current batch. The lock is held on entry and on return. */
+	void runTasks(std::unique_lock<std::mutex> &lock) {
+		while (next < count) {
+			const uint index = next++;
+			lock.unlock();
+			proc(param, index);
+			lock.lock();
+			if (--pending == 0)
+				finished.notify_all();
+		}
+	}
+
+	void workerMain() {
+		std::unique_lock<std::mutex> lock(mutex);
+		uint lastBatch = batch;
+		for (;;) {
+			wakeUp.wait(lock, [this, lastBatch] { return quit || batch != lastBatch; });
+			if (quit)
+				return;
+			lastBatch = batch;
+			runTasks(lock);
+		}
+	}
+};
+
+ThreadPool::ThreadPool(uint numThreads) : _state(nullptr) {
+	_threadCount = numThreads ? numThreads : getHardwareThreadCount();
+	if (_threadCount <= 1) {
+		_threadCount = 1;
+		return;
+	}
+
+	_state = new State();
+	_state->proc = nullptr;
+	_state->param = nullptr;
+	_state->count = 0;
+	_state->next = 0;
+	_state->pending = 0;
+	_state->batch = 0;
+	_state->quit = false;
+
+	// The thread calling run() takes part as well
+	for (uint i = 1; i < _threadCount; ++i)
+		_state->workers.push_back(std::thread(&State::workerMain, _state));
+}
+
+ThreadPool::~ThreadPool() {
+	if (!_state)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		_state->quit = true;
+	}
+	_state->wakeUp.notify_all();
+	for (std::thread &worker : _state->workers)
+		worker.join();
+	delete _state;
+}
+
+uint ThreadPool::getHardwareThreadCount() {
+	const uint count = std::thread::hardware_concurrency();
+	return count ? count : 1;
+}
+
+void ThreadPool::run(TaskProc proc, void *param, uint count) {
+	if (!_state || count <= 1) {
+		for (uint i = 0; i < count; ++i)
+			proc(param, i);
+		return;
+	}
+
+	std::lock_guard<std::mutex> batchLock(_state->runMutex);
+	std::unique_lock<std::mutex> lock(_state->mutex);
+	_state->proc = proc;
+	_state->param = param;
+	_state->count = count;
+	_state->next = 0;
+	_state->pending = count;
+	++_state->batch;
+	_state->wakeUp.notify_all();
+
+	_state->runTasks(lock);
+	_state->finished.wait(lock, [this] { return _state->pending == 0; });
+}
+
+#else
+
+struct ThreadPool::State {
+};
+
+ThreadPool::ThreadPool(uint numThreads) : _state(nullptr), _threadCount(1) {
+}
+
+ThreadPool::~ThreadPool() {
+}
+
+uint ThreadPool::getHardwareThreadCount() {
+	return 1;
+}
+
+void ThreadPool::run(TaskProc proc, void *param, uint count) {
+	for (uint i = 0; i < count; ++i)
+		proc(param, i);
+}
+
+#endif
+
+} // End of namespace Common
@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/noncopyable.h"
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief Running batches of independent tasks on worker threads.
+ * @{
+ */
+
+/**
+ * A fixed set of worker threads running the tasks of a batch in parallel.
+ *
+ * run() hands out the tasks of a batch to the workers and to the calling
+ * thread, and returns once all of them are done. Batches submitted from
+ * several threads run one after the other.
+ *
+ * When ScummVM is built without thread support (USE_THREADS is not defined),
+ * all the tasks run on the calling thread, in order.
+ */
+class ThreadPool : NonCopyable {
+public:
+	/**
+	 * Function running one task of a batch.
+	 *
+	 * @param param  The parameter given to run().
+	 * @param index  Index of the task in the batch.
+	 */
+	typedef void (*TaskProc)(void *param, uint index);
+
+	/**
+	 * @param numThreads  Number of threads running the tasks, including the
+	 *                    caller of run(). 0 picks one per hardware thread.
+	 */
+	explicit ThreadPool(uint numThreads = 0);
+	~ThreadPool();
+
+	/**
+	 * Number of threads running the tasks, including the caller of run().
+	 */
+	uint getThreadCount() const { return _threadCount; }
+
+	/**
+	 * Number of threads the hardware can run at the same time, or 1 when it
+	 * is unknown or there is no thread support.
+	 */
+	static uint getHardwareThreadCount();
+
+	/**
+	 * Run proc(param, index) for each index from 0 to count - 1, and wait
+	 * until all of them are done. The tasks may run in any order.
+	 */
+	void run(TaskProc proc, void *param, uint count);
+
+private:
+	struct State;
+
+	State *_state;
+	uint _threadCount;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
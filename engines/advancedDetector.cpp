@@ -244,20 +244,37 @@ bool AdvancedMetaEngineDetection::cleanupPirated(ADDetectedGames &matched) const
 }
 
 DetectedGames AdvancedMetaEngineDetection::detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
-	FileMap allFiles;
+	startDetectGames(fslist, skipADFlags, skipIncomplete);
+	return finishDetectGames(fslist);
+}
+
+bool AdvancedMetaEngineDetection::startDetectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
+	_pendingFiles.clear();
+	_pendingMatches.clear();
 
 	if (fslist.empty())
-		return DetectedGames();
+		return true;
 
 	// Sometimes this method is called directly, so we have to build the maps, especially
 	// the _directoryGlobsMap
 	preprocessDescriptions();
 
 	// Compose a hashmap of all files in fslist.
-	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+	composeFileHashMap(_pendingFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
 
 	// Run the detector on this
-	ADDetectedGames matches = detectGame(fslist.begin()->getParent(), allFiles, Common::UNK_LANG, Common::kPlatformUnknown, "", skipADFlags, skipIncomplete);
+	_pendingMatches = detectGame(fslist.begin()->getParent(), _pendingFiles, Common::UNK_LANG, Common::kPlatformUnknown, "", skipADFlags, skipIncomplete);
+	return true;
+}
+
+DetectedGames AdvancedMetaEngineDetection::finishDetectGames(const Common::FSList &fslist) {
+	const FileMap allFiles = _pendingFiles;
+	ADDetectedGames matches;
+	matches.swap(_pendingMatches);
+	_pendingFiles.clear();
+
+	if (fslist.empty())
+		return DetectedGames();
 
 	cleanupPirated(matches);
 
@@ -413,6 +430,7 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.flush();
 
 	// If the GUI options were updated, we catch this here and update them in the users config
 	// file transparently.
@@ -511,13 +529,6 @@ void AdvancedMetaEngineDetection::composeFileHashMap(FileMap &allFiles, const Co
 	}
 }
 
-/* Singleton Cache Storage for MD5 */
-
-namespace Common {
-	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
-}
-
-
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
 	if (fileEntry && fileEntry->md5 && strchr(fileEntry->md5, ':')) {
@@ -581,6 +592,41 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
+/**
+ * Find the file on disk which is hashed for the given name, and the key of
+ * its properties in the persistent cache.
+ *
+ * The forks of Mac files may come from several files on disk, so they are
+ * not cached across runs.
+ */
+static bool getPersistentKey(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, Common::FSNode &node, Common::String &key) {
+	if (md5prop & (kMD5MacResFork | kMD5MacDataFork))
+		return false;
+
+	Common::String member;
+	if (md5prop & kMD5Archive) {
+		Common::StringTokenizer tok(fname.toString(), ":");
+		member = tok.nextToken();
+		const Common::Path archiveName(tok.nextToken());
+		member += ':';
+		member += tok.nextToken();
+
+		if (!allFiles.tryGetVal(archiveName, node))
+			return false;
+	} else if (!allFiles.tryGetVal(fname, node)) {
+		return false;
+	}
+
+	key = md5PropToCachePrefix(md5prop);
+	key += ':';
+	key += node.getPath().toString(Common::Path::kNativeSeparator);
+	key += ':';
+	key += member;
+	key += ':';
+	key += Common::String::format("%d", md5Bytes);
+	return true;
+}
+
 bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
@@ -588,19 +634,30 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5
 		hashname += ':';
 		hashname += Common::String::format("%d", _md5Bytes);
 
-	if (ADCacheMan.containsMD5(hashname)) {
-		fileProps.md5 = ADCacheMan.getMD5(hashname);
-		fileProps.size = ADCacheMan.getSize(hashname);
+	if (ADCacheMan.getCachedProperties(hashname, fileProps))
 		return true;
-	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+	Common::FSNode node;
+	Common::String persistentKey;
+	const bool persistent = getPersistentKey(_md5Bytes, allFiles, md5prop, fname, node, persistentKey);
 
-	if (res) {
-		ADCacheMan.setMD5(hashname, fileProps.md5);
-		ADCacheMan.setSize(hashname, fileProps.size);
+	bool res = persistent && ADCacheMan.getPersistentProperties(persistentKey, node, fileProps);
+	if (!res) {
+		if (md5prop & kMD5Archive) {
+			// The archives are shared by all engines
+			AdvancedDetectorCacheManager::Lock lock;
+			res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+		} else {
+			res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+		}
+
+		if (res && persistent)
+			ADCacheMan.setPersistentProperties(persistentKey, node, fileProps);
 	}
 
+	if (res)
+		ADCacheMan.setCachedProperties(hashname, fileProps);
+
 	return res;
 }
 
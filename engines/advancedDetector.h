@@ -32,6 +32,7 @@
 namespace Common {
 class Error;
 class FSList;
+class Mutex;
 }
 /**
  * @defgroup engines_advdetector Advanced Detector
@@ -384,6 +385,15 @@ public:
 	 */
 	DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) override;
 
+	/**
+	 * Match the files against the detection tables. This is the part of
+	 * detectGames() which does not depend on the engine's fallbackDetect().
+	 */
+	bool startDetectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) override;
+
+	/** Drop the pirated copies and run the fallback detection, if needed */
+	DetectedGames finishDetectGames(const Common::FSList &fslist) override;
+
 	/**
 	 * A generic createInstance.
 	 *
@@ -430,6 +440,10 @@ private:
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _globsMap;
 	bool _hashMapsInited;
 
+	/** Files and matches found by startDetectGames(), for finishDetectGames() */
+	FileMap _pendingFiles;
+	ADDetectedGames _pendingMatches;
+
 protected:
 	/**
 	 * Detect games in the specified directory.
@@ -572,6 +586,10 @@ protected:
 
 /**
  * Singleton Cache Storage for Computed MD5s and Open Archives
+ *
+ * The MD5s of files are also kept in the cache directory across runs. They
+ * are used again as long as the size and the modification time of the file
+ * do not change.
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -612,10 +630,44 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look for the properties of a file in the persistent cache.
+	 *
+	 * @param key  Identifies the part of the file that is hashed, and how.
+	 * @param node The file on disk whose size and time validate the entry.
+	 */
+	bool getPersistentProperties(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps);
+	void setPersistentProperties(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps);
+
+	/**
+	 * Look for the properties of a file computed since the cache was cleared.
+	 * Unlike getMD5() and getSize(), this can be used by several threads.
+	 */
+	bool getCachedProperties(const Common::String &fname, FileProperties &fileProps);
+	void setCachedProperties(const Common::String &fname, const FileProperties &fileProps);
+
+	/**
+	 * Allow several threads to run the detection at the same time, until the
+	 * cache is destroyed. Must be called before they start.
+	 */
+	void prepareParallelDetection();
+
+	/** Keeps the cache locked while it may be used by several threads */
+	class Lock : Common::NonCopyable {
+	public:
+		Lock();
+		~Lock();
+	};
+
+	/** Save the persistent cache if properties were added since it was loaded */
+	void flush();
+
+	AdvancedDetectorCacheManager() : persistentLoaded(false), persistentEnabled(false), persistentChanged(false), mutex(nullptr) {
 		clear();
 	}
 
+	~AdvancedDetectorCacheManager();
+
 	void clearArchives() {
 		for (auto &entry : archiveHashMap) {
 			delete entry._value;
@@ -638,6 +690,29 @@ private:
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	struct PersistentEntry {
+		int64 time;
+		int64 hashTime;
+		int64 fileSize;
+		FileProperties props;
+	};
+
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentHashMap;
+
+	enum {
+		kPersistentVersion = 3
+	};
+
+	void loadPersistent();
+
+	PersistentHashMap persistentHashMap;
+	Common::FSNode persistentFile;
+	bool persistentLoaded;
+	bool persistentEnabled;
+	bool persistentChanged;
+
+	Common::Mutex *mutex;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -0,0 +1,169 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/cachefile.h"
+#include "common/config-manager.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/textconsole.h"
+#include "engines/advancedDetector.h"
+
+/* Singleton Cache Storage for MD5 */
+
+namespace Common {
+	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
+}
+
+AdvancedDetectorCacheManager::~AdvancedDetectorCacheManager() {
+	delete mutex;
+}
+
+AdvancedDetectorCacheManager::Lock::Lock() {
+	if (ADCacheMan.mutex)
+		ADCacheMan.mutex->lock();
+}
+
+AdvancedDetectorCacheManager::Lock::~Lock() {
+	if (ADCacheMan.mutex)
+		ADCacheMan.mutex->unlock();
+}
+
+void AdvancedDetectorCacheManager::prepareParallelDetection() {
+	if (!mutex)
+		mutex = new Common::Mutex();
+
+	// Load it now, as the configuration must only be read by the main thread
+	loadPersistent();
+}
+
+// Strings share their buffers when they are copied, so the strings going in
+// and out of the cache are copied from scratch, while the cache is locked.
+
+bool AdvancedDetectorCacheManager::getCachedProperties(const Common::String &fname, FileProperties &fileProps) {
+	Lock lock;
+	if (!containsMD5(fname))
+		return false;
+
+	fileProps.md5 = Common::String(getMD5(fname).c_str());
+	fileProps.size = getSize(fname);
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setCachedProperties(const Common::String &fname, const FileProperties &fileProps) {
+	Lock lock;
+	setMD5(Common::String(fname.c_str()), Common::String(fileProps.md5.c_str()));
+	setSize(Common::String(fname.c_str()), fileProps.size);
+}
+
+bool AdvancedDetectorCacheManager::getPersistentProperties(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps) {
+	int64 time, fileSize;
+	if (!node.getModificationTime(time) || !node.getFileSize(fileSize))
+		return false;
+
+	Lock lock;
+	loadPersistent();
+
+	PersistentHashMap::const_iterator it = persistentHashMap.find(key);
+	if (it == persistentHashMap.end())
+		return false;
+	if (!Common::isCacheEntryCurrent(time, it->_value.time, it->_value.hashTime) || it->_value.fileSize != fileSize)
+		return false;
+
+	fileProps.size = it->_value.props.size;
+	fileProps.md5 = Common::String(it->_value.props.md5.c_str());
+	fileProps.md5prop = it->_value.props.md5prop;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setPersistentProperties(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps) {
+	int64 time, hashTime, fileSize;
+	if (!node.getModificationTime(time) || !node.getCurrentTime(hashTime) || !node.getFileSize(fileSize))
+		return;
+
+	Lock lock;
+	loadPersistent();
+	if (!persistentEnabled)
+		return;
+
+	PersistentEntry &entry = persistentHashMap[Common::String(key.c_str())];
+	entry.time = time;
+	entry.hashTime = hashTime;
+	entry.fileSize = fileSize;
+	entry.props.size = fileProps.size;
+	entry.props.md5 = Common::String(fileProps.md5.c_str());
+	entry.props.md5prop = fileProps.md5prop;
+	persistentChanged = true;
+}
+
+void AdvancedDetectorCacheManager::loadPersistent() {
+	if (persistentLoaded)
+		return;
+	persistentLoaded = true;
+
+	const Common::Path cachePath = ConfMan.getPath("cachepath");
+	if (cachePath.empty())
+		return;
+
+	persistentFile = Common::FSNode(cachePath).getChild("detection-md5.dat");
+	persistentEnabled = true;
+
+	Common::ScopedPtr<Common::SeekableReadStream> in(Common::loadCacheFile(persistentFile, MKTAG('A', 'D', 'M', '5'), kPersistentVersion));
+	if (!in)
+		return;
+
+	const uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && !in->eos(); ++i) {
+		const Common::String key = in->readString();
+		PersistentEntry &entry = persistentHashMap[key];
+		entry.time = in->readSint64LE();
+		entry.hashTime = in->readSint64LE();
+		entry.fileSize = in->readSint64LE();
+		entry.props.size = in->readSint64LE();
+		entry.props.md5prop = (MD5Properties)in->readUint32LE();
+		entry.props.md5 = in->readString();
+	}
+
+	if (in->eos())
+		persistentHashMap.clear();
+}
+
+void AdvancedDetectorCacheManager::flush() {
+	if (!persistentChanged)
+		return;
+	persistentChanged = false;
+
+	Common::MemoryWriteStreamDynamic data(DisposeAfterUse::YES);
+	data.writeUint32LE(persistentHashMap.size());
+	for (PersistentHashMap::const_iterator it = persistentHashMap.begin(); it != persistentHashMap.end(); ++it) {
+		data.writeString(it->_key);
+		data.writeByte(0);
+		data.writeSint64LE(it->_value.time);
+		data.writeSint64LE(it->_value.hashTime);
+		data.writeSint64LE(it->_value.fileSize);
+		data.writeSint64LE(it->_value.props.size);
+		data.writeUint32LE(it->_value.props.md5prop);
+		data.writeString(it->_value.props.md5);
+		data.writeByte(0);
+	}
+
+	Common::saveCacheFile(persistentFile, MKTAG('A', 'D', 'M', '5'), kPersistentVersion, data.getData(), data.size());
+}
@@ -94,6 +94,11 @@ public:
 
 	DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) override;
 
+	// The detection is customized in detectGames()
+	bool startDetectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) override {
+		return false;
+	}
+
 	ADDetectedGame fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist, ADDetectedGameExtraInfo **extra = nullptr) const override;
 };
 
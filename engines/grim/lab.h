@@ -56,6 +56,8 @@ public:
 	int listMembers(Common::ArchiveMemberList &list) const override;
 	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override;
 	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override;
+	// The members are either copied out of the kept stream or read through their own file
+	bool canReadMembersInBackground() const override { return true; }
 
 private:
 	void parseGrimFileTable(Common::File *_f);
@@ -40,6 +40,7 @@ class Keymap;
 class FSList;
 class OutSaveFile;
 class String;
+class ThreadPool;
 
 typedef SeekableReadStream InSaveFile;
 }
@@ -162,6 +163,26 @@ public:
 	 */
 	virtual DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags = 0, bool skipIncomplete = false) = 0;
 
+	/**
+	 * Start the detection of games in the given files, in a way that can run
+	 * on another thread at the same time as the detection of other engines.
+	 * The detection is then completed on the main thread by finishDetectGames().
+	 *
+	 * The nodes of @p fslist are not shared with other threads.
+	 *
+	 * @return False if the engine does not support this, in which case
+	 *         detectGames() is used instead.
+	 */
+	virtual bool startDetectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) { return false; }
+
+	/**
+	 * Complete the detection started by startDetectGames(), and return the
+	 * games found, like detectGames() does.
+	 *
+	 * @param fslist The files given to EngineManager::detectGames().
+	 */
+	virtual DetectedGames finishDetectGames(const Common::FSList &fslist) { return DetectedGames(); }
+
 	/** Returns the number of bytes used for MD5-based detection, or 0 if not supported. */
 	virtual uint getMD5Bytes() const = 0;
 
@@ -570,6 +591,15 @@ public:
  * Singleton class that manages all engine plugins.
  */
 class EngineManager : public Common::Singleton<EngineManager> {
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+
+	EngineManager();
+	~EngineManager();
+
+	Common::ThreadPool *_detectionPool;
+	bool _detectionPoolCreated;
+
 public:
 	/**
 	 * Given a list of FSNodes in a given directory, detect a set of games contained within.
@@ -622,6 +652,17 @@ private:
 
 	/** Use heuristics to complete a target lacking an engine ID. */
 	void upgradeTargetForEngineId(const Common::String &target) const;
+
+	/**
+	 * Return the thread pool the engines detect games on, according to the
+	 * detection_threads setting. Returns nullptr when the engines should run
+	 * one after the other on the calling thread.
+	 */
+	Common::ThreadPool *getDetectionThreadPool();
+
+	/** Start the detection of the engines which support it on the thread pool */
+	void startDetectGames(Common::ThreadPool *pool, const PluginList &plugins, const Common::FSList &fslist,
+	                      uint32 skipADFlags, bool skipIncomplete, Common::Array<bool> &started);
 };
 
 /** Convenience shortcut for accessing the engine manager. */
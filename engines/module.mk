@@ -3,6 +3,7 @@ MODULE := engines
 MODULE_OBJS := \
 	achievements.o \
 	advancedDetector.o \
+	advancedDetectorCache.o \
 	dialogs.o \
 	engine.o \
 	game.o \
@@ -95,6 +95,7 @@ void TinyGLRenderer::init() {
 
 	_context = TinyGL::createContext(kOriginalWidth, kOriginalHeight, g_system->getScreenFormat(), 512, true, ConfMan.getBool("dirtyrects"));
 	TinyGL::setContext(_context);
+	TinyGL::setRenderThreadCount(ConfMan.getInt("tinygl_threads"));
 
 	tglMatrixMode(TGL_PROJECTION);
 	tglLoadIdentity();
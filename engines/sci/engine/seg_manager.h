@@ -23,6 +23,7 @@
 #define SCI_ENGINE_SEG_MANAGER_H
 
 #include "common/scummsys.h"
+#include "common/flathashmap.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
 #include "sci/engine/vm.h"
@@ -464,7 +465,7 @@ private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
-	Common::HashMap<int, SegmentId> _scriptSegMap;
+	Common::FlatHashMap<int, SegmentId> _scriptSegMap;
 
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
@@ -30,6 +30,7 @@
 #ifdef ENABLE_SCI32
 #include "common/compression/installshield_cab.h"
 #include "common/memstream.h"
+#include "common/span.h"
 #endif
 
 #include "sci/engine/workarounds.h"
@@ -449,8 +450,15 @@ void MacResourceForkResourceSource::loadResource(ResourceManager *resMan, Resour
 		// Plain resource handling
 		Common::Array<uint32> tagArray = resTypeToMacTags(type);
 
-		for (uint32 i = 0; i < tagArray.size() && !stream; i++)
-			stream = _macResMan->getResource(tagArray[i], res->getNumber());
+		for (uint32 i = 0; i < tagArray.size() && !stream; i++) {
+			// Decompress straight from the resource fork when it is in memory,
+			// as the resource data gets copied anyway
+			Common::Span<const byte> view = _macResMan->getResourceView(tagArray[i], res->getNumber());
+			if (view)
+				stream = new Common::MemoryReadStream(view.data(), view.size());
+			else
+				stream = _macResMan->getResource(tagArray[i], res->getNumber());
+		}
 	}
 
 	if (stream)
@@ -0,0 +1,209 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/blit/blit-convert.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+namespace {
+
+/** Shift counts of the components, in the form _mm256_srl_epi32() and _mm256_sll_epi32() take */
+struct ShiftsAVX2 {
+	__m128i src[4];
+	__m128i dst[4];
+
+	ShiftsAVX2(const CrossBlitChannels &ch, int srcAdjust0, int srcAdjust1, int srcAdjust2) {
+		src[0] = _mm_cvtsi32_si128(ch.srcShift[0] + srcAdjust0);
+		src[1] = _mm_cvtsi32_si128(ch.srcShift[1] + srcAdjust1);
+		src[2] = _mm_cvtsi32_si128(ch.srcShift[2] + srcAdjust2);
+		src[3] = _mm_cvtsi32_si128(ch.srcShift[3]);
+		for (int i = 0; i < 4; ++i)
+			dst[i] = _mm_cvtsi32_si128(ch.dstShift[i]);
+	}
+};
+
+static FORCEINLINE __m256i extract(__m256i in, __m128i srcShift, __m256i bits, __m128i dstShift) {
+	return _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(in, srcShift), bits), dstShift);
+}
+
+/** Pack the low 16 bits of the 8 lanes, in order */
+static FORCEINLINE __m128i packLow16(__m256i in) {
+	in = _mm256_srai_epi32(_mm256_slli_epi32(in, 16), 16);
+	return _mm_packs_epi32(_mm256_castsi256_si128(in), _mm256_extracti128_si256(in, 1));
+}
+
+/** Lanes of the pixels which must not be written, from 8 source pixels in 32-bit lanes starting at x */
+template<int mode>
+static FORCEINLINE __m256i skip32(__m256i in, const byte *mask, uint x, const CrossBlitArgs &args) {
+	if (mode == kCrossBlitPlain)
+		return _mm256_setzero_si256();
+	if (mode == kCrossBlitKey)
+		return _mm256_cmpeq_epi32(in, _mm256_set1_epi32(args.key));
+	const __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(mask + x)));
+	return _mm256_cmpeq_epi32(m, _mm256_setzero_si256());
+}
+
+template<int mode>
+static FORCEINLINE void store32(byte *dst, __m256i value, __m256i skip) {
+	if (mode != kCrossBlitPlain)
+		value = _mm256_blendv_epi8(value, _mm256_loadu_si256((const __m256i *)dst), skip);
+	_mm256_storeu_si256((__m256i *)dst, value);
+}
+
+template<int mode>
+static FORCEINLINE void store16(byte *dst, __m128i value, __m256i skip) {
+	if (mode != kCrossBlitPlain)
+		value = _mm_blendv_epi8(value, _mm_loadu_si128((const __m128i *)dst), packLow16(skip));
+	_mm_storeu_si128((__m128i *)dst, value);
+}
+
+template<int mode>
+struct Convert32To32RowAVX2 {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		const ShiftsAVX2 shifts(ch, 0, 0, 0);
+		const __m256i bits = _mm256_set1_epi32(0xFF);
+		const __m256i fill = _mm256_set1_epi32(ch.dstFill);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m256i in = _mm256_loadu_si256((const __m256i *)(src + x * 4));
+			__m256i out = _mm256_or_si256(fill, extract(in, shifts.src[0], bits, shifts.dst[0]));
+			out = _mm256_or_si256(out, extract(in, shifts.src[1], bits, shifts.dst[1]));
+			out = _mm256_or_si256(out, extract(in, shifts.src[2], bits, shifts.dst[2]));
+			if (ch.copyAlpha)
+				out = _mm256_or_si256(out, extract(in, shifts.src[3], bits, shifts.dst[3]));
+
+			store32<mode>(dst + x * 4, out, skip32<mode>(in, mask, x, args));
+		}
+
+		crossBlitPixels<CrossBlitConvert32To32, uint32, uint32, mode>(dst + x * 4, src + x * 4, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Convert16To32RowAVX2 {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const ShiftsAVX2 shifts(args.channels, 0, 0, 0);
+		const __m256i fill = _mm256_set1_epi32(args.channels.dstFill);
+		const __m256i bits5 = _mm256_set1_epi32(0x1F);
+		const __m256i bits6 = _mm256_set1_epi32(0x3F);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m256i in = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + x * 2)));
+			__m256i r = _mm256_and_si256(_mm256_srl_epi32(in, shifts.src[0]), bits5);
+			__m256i g = _mm256_and_si256(_mm256_srl_epi32(in, shifts.src[1]), bits6);
+			__m256i b = _mm256_and_si256(_mm256_srl_epi32(in, shifts.src[2]), bits5);
+			r = _mm256_or_si256(_mm256_slli_epi32(r, 3), _mm256_srli_epi32(r, 2));
+			g = _mm256_or_si256(_mm256_slli_epi32(g, 2), _mm256_srli_epi32(g, 4));
+			b = _mm256_or_si256(_mm256_slli_epi32(b, 3), _mm256_srli_epi32(b, 2));
+			__m256i out = _mm256_or_si256(fill, _mm256_sll_epi32(r, shifts.dst[0]));
+			out = _mm256_or_si256(out, _mm256_sll_epi32(g, shifts.dst[1]));
+			out = _mm256_or_si256(out, _mm256_sll_epi32(b, shifts.dst[2]));
+
+			store32<mode>(dst + x * 4, out, skip32<mode>(in, mask, x, args));
+		}
+
+		crossBlitPixels<CrossBlitConvert16To32, uint16, uint32, mode>(dst + x * 4, src + x * 2, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Convert32To16RowAVX2 {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const ShiftsAVX2 shifts(args.channels, 3, 2, 3);
+		const __m256i bits5 = _mm256_set1_epi32(0x1F);
+		const __m256i bits6 = _mm256_set1_epi32(0x3F);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m256i in = _mm256_loadu_si256((const __m256i *)(src + x * 4));
+			__m256i out = extract(in, shifts.src[0], bits5, shifts.dst[0]);
+			out = _mm256_or_si256(out, extract(in, shifts.src[1], bits6, shifts.dst[1]));
+			out = _mm256_or_si256(out, extract(in, shifts.src[2], bits5, shifts.dst[2]));
+
+			store16<mode>(dst + x * 2, packLow16(out), skip32<mode>(in, mask, x, args));
+		}
+
+		crossBlitPixels<CrossBlitConvert32To16, uint32, uint16, mode>(dst + x * 2, src + x * 4, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Map8To32RowAVX2 {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m256i in = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + x)));
+			const __m256i out = _mm256_i32gather_epi32((const int *)args.map, in, 4);
+			store32<mode>(dst + x * 4, out, skip32<mode>(in, mask, x, args));
+		}
+
+		crossBlitPixels<CrossBlitMap, uint8, uint32, mode>(dst + x * 4, src + x, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Map8To16RowAVX2 {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m256i in = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + x)));
+			const __m256i out = _mm256_i32gather_epi32((const int *)args.map, in, 4);
+			store16<mode>(dst + x * 2, packLow16(out), skip32<mode>(in, mask, x, args));
+		}
+
+		crossBlitPixels<CrossBlitMap, uint8, uint16, mode>(dst + x * 2, src + x, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<template<int> class Row>
+void setupKernels(CrossBlitFunc *funcs) {
+	funcs[kCrossBlitPlain] = crossBlitRows<Row<kCrossBlitPlain> >;
+	funcs[kCrossBlitKey] = crossBlitRows<Row<kCrossBlitKey> >;
+	funcs[kCrossBlitMask] = crossBlitRows<Row<kCrossBlitMask> >;
+}
+
+} // End of anonymous namespace
+
+void setupCrossBlitKernelsAVX2(CrossBlitKernels &kernels) {
+	setupKernels<Convert32To32RowAVX2>(kernels.convert32To32);
+	setupKernels<Convert16To32RowAVX2>(kernels.convert16To32);
+	setupKernels<Convert32To16RowAVX2>(kernels.convert32To16);
+	setupKernels<Map8To16RowAVX2>(kernels.map8To16);
+	setupKernels<Map8To32RowAVX2>(kernels.map8To32);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,206 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/blit/blit-convert.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Graphics {
+
+namespace {
+
+/** Shift counts of the components, in the form vshlq_u32() takes: negative to shift right */
+struct ShiftsNEON {
+	int32x4_t src[4];
+	int32x4_t dst[4];
+
+	ShiftsNEON(const CrossBlitChannels &ch, int srcAdjust0, int srcAdjust1, int srcAdjust2) {
+		src[0] = vdupq_n_s32(-(ch.srcShift[0] + srcAdjust0));
+		src[1] = vdupq_n_s32(-(ch.srcShift[1] + srcAdjust1));
+		src[2] = vdupq_n_s32(-(ch.srcShift[2] + srcAdjust2));
+		src[3] = vdupq_n_s32(-(int)ch.srcShift[3]);
+		for (int i = 0; i < 4; ++i)
+			dst[i] = vdupq_n_s32(ch.dstShift[i]);
+	}
+};
+
+static inline uint32x4_t extract(uint32x4_t in, int32x4_t srcShift, uint32x4_t bits, int32x4_t dstShift) {
+	return vshlq_u32(vandq_u32(vshlq_u32(in, srcShift), bits), dstShift);
+}
+
+/** Lanes of the pixels which must not be written, for 8 pixels starting at x */
+template<int mode>
+static inline void skip32(uint32x4_t inLo, uint32x4_t inHi, const byte *mask, uint x, const CrossBlitArgs &args,
+						  uint32x4_t &skipLo, uint32x4_t &skipHi) {
+	if (mode == kCrossBlitKey) {
+		const uint32x4_t key = vdupq_n_u32(args.key);
+		skipLo = vceqq_u32(inLo, key);
+		skipHi = vceqq_u32(inHi, key);
+	} else if (mode == kCrossBlitMask) {
+		const uint16x8_t m = vmovl_u8(vld1_u8(mask + x));
+		skipLo = vceqq_u32(vmovl_u16(vget_low_u16(m)), vdupq_n_u32(0));
+		skipHi = vceqq_u32(vmovl_u16(vget_high_u16(m)), vdupq_n_u32(0));
+	} else {
+		skipLo = skipHi = vdupq_n_u32(0);
+	}
+}
+
+template<int mode>
+static inline void store32(byte *dst, uint32x4_t value, uint32x4_t skip) {
+	if (mode != kCrossBlitPlain)
+		value = vbslq_u32(skip, vld1q_u32((const uint32_t *)dst), value);
+	vst1q_u32((uint32_t *)dst, value);
+}
+
+template<int mode>
+struct Convert32To32RowNEON {
+	static inline uint32x4_t convert(uint32x4_t in, const CrossBlitChannels &ch, const ShiftsNEON &shifts) {
+		const uint32x4_t bits = vdupq_n_u32(0xFF);
+		uint32x4_t out = vorrq_u32(vdupq_n_u32(ch.dstFill), extract(in, shifts.src[0], bits, shifts.dst[0]));
+		out = vorrq_u32(out, extract(in, shifts.src[1], bits, shifts.dst[1]));
+		out = vorrq_u32(out, extract(in, shifts.src[2], bits, shifts.dst[2]));
+		if (ch.copyAlpha)
+			out = vorrq_u32(out, extract(in, shifts.src[3], bits, shifts.dst[3]));
+		return out;
+	}
+
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		const ShiftsNEON shifts(ch, 0, 0, 0);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const uint32x4_t lo = vld1q_u32((const uint32_t *)(src + x * 4));
+			const uint32x4_t hi = vld1q_u32((const uint32_t *)(src + x * 4 + 16));
+			uint32x4_t skipLo, skipHi;
+			skip32<mode>(lo, hi, mask, x, args, skipLo, skipHi);
+
+			store32<mode>(dst + x * 4, convert(lo, ch, shifts), skipLo);
+			store32<mode>(dst + x * 4 + 16, convert(hi, ch, shifts), skipHi);
+		}
+
+		crossBlitPixels<CrossBlitConvert32To32, uint32, uint32, mode>(dst + x * 4, src + x * 4, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Convert16To32RowNEON {
+	static inline uint32x4_t convert(uint32x4_t in, const CrossBlitChannels &ch, const ShiftsNEON &shifts) {
+		uint32x4_t r = vandq_u32(vshlq_u32(in, shifts.src[0]), vdupq_n_u32(0x1F));
+		uint32x4_t g = vandq_u32(vshlq_u32(in, shifts.src[1]), vdupq_n_u32(0x3F));
+		uint32x4_t b = vandq_u32(vshlq_u32(in, shifts.src[2]), vdupq_n_u32(0x1F));
+		r = vorrq_u32(vshlq_n_u32(r, 3), vshrq_n_u32(r, 2));
+		g = vorrq_u32(vshlq_n_u32(g, 2), vshrq_n_u32(g, 4));
+		b = vorrq_u32(vshlq_n_u32(b, 3), vshrq_n_u32(b, 2));
+		uint32x4_t out = vorrq_u32(vdupq_n_u32(ch.dstFill), vshlq_u32(r, shifts.dst[0]));
+		out = vorrq_u32(out, vshlq_u32(g, shifts.dst[1]));
+		return vorrq_u32(out, vshlq_u32(b, shifts.dst[2]));
+	}
+
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		const ShiftsNEON shifts(ch, 0, 0, 0);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const uint16x8_t in = vld1q_u16((const uint16_t *)(src + x * 2));
+			const uint32x4_t lo = vmovl_u16(vget_low_u16(in));
+			const uint32x4_t hi = vmovl_u16(vget_high_u16(in));
+			uint32x4_t skipLo, skipHi;
+			skip32<mode>(lo, hi, mask, x, args, skipLo, skipHi);
+
+			store32<mode>(dst + x * 4, convert(lo, ch, shifts), skipLo);
+			store32<mode>(dst + x * 4 + 16, convert(hi, ch, shifts), skipHi);
+		}
+
+		crossBlitPixels<CrossBlitConvert16To32, uint16, uint32, mode>(dst + x * 4, src + x * 2, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Convert32To16RowNEON {
+	static inline uint16x4_t convert(uint32x4_t in, const ShiftsNEON &shifts) {
+		const uint32x4_t bits5 = vdupq_n_u32(0x1F);
+		const uint32x4_t bits6 = vdupq_n_u32(0x3F);
+		uint32x4_t out = extract(in, shifts.src[0], bits5, shifts.dst[0]);
+		out = vorrq_u32(out, extract(in, shifts.src[1], bits6, shifts.dst[1]));
+		out = vorrq_u32(out, extract(in, shifts.src[2], bits5, shifts.dst[2]));
+		return vmovn_u32(out);
+	}
+
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const ShiftsNEON shifts(args.channels, 3, 2, 3);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const uint32x4_t lo = vld1q_u32((const uint32_t *)(src + x * 4));
+			const uint32x4_t hi = vld1q_u32((const uint32_t *)(src + x * 4 + 16));
+			uint16x8_t out = vcombine_u16(convert(lo, shifts), convert(hi, shifts));
+
+			if (mode != kCrossBlitPlain) {
+				uint32x4_t skipLo, skipHi;
+				skip32<mode>(lo, hi, mask, x, args, skipLo, skipHi);
+				const uint16x8_t skip = vcombine_u16(vmovn_u32(skipLo), vmovn_u32(skipHi));
+				out = vbslq_u16(skip, vld1q_u16((const uint16_t *)(dst + x * 2)), out);
+			}
+			vst1q_u16((uint16_t *)(dst + x * 2), out);
+		}
+
+		crossBlitPixels<CrossBlitConvert32To16, uint32, uint16, mode>(dst + x * 2, src + x * 4, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<template<int> class Row>
+void setupKernels(CrossBlitFunc *funcs) {
+	funcs[kCrossBlitPlain] = crossBlitRows<Row<kCrossBlitPlain> >;
+	funcs[kCrossBlitKey] = crossBlitRows<Row<kCrossBlitKey> >;
+	funcs[kCrossBlitMask] = crossBlitRows<Row<kCrossBlitMask> >;
+}
+
+} // End of anonymous namespace
+
+// NEON has no gather instruction, so the palette lookups keep the generic kernels
+void setupCrossBlitKernelsNEON(CrossBlitKernels &kernels) {
+	setupKernels<Convert32To32RowNEON>(kernels.convert32To32);
+	setupKernels<Convert16To32RowNEON>(kernels.convert16To32);
+	setupKernels<Convert32To16RowNEON>(kernels.convert32To16);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,200 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/endian.h"
+
+#include "graphics/blit/blit-convert.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+namespace {
+
+/** Shift counts of the components, in the form _mm_srl_epi32() and _mm_sll_epi32() take */
+struct ShiftsSSE2 {
+	__m128i src[4];
+	__m128i dst[4];
+
+	ShiftsSSE2(const CrossBlitChannels &ch, int srcAdjust0, int srcAdjust1, int srcAdjust2) {
+		src[0] = _mm_cvtsi32_si128(ch.srcShift[0] + srcAdjust0);
+		src[1] = _mm_cvtsi32_si128(ch.srcShift[1] + srcAdjust1);
+		src[2] = _mm_cvtsi32_si128(ch.srcShift[2] + srcAdjust2);
+		src[3] = _mm_cvtsi32_si128(ch.srcShift[3]);
+		for (int i = 0; i < 4; ++i)
+			dst[i] = _mm_cvtsi32_si128(ch.dstShift[i]);
+	}
+};
+
+static FORCEINLINE __m128i extract(__m128i in, __m128i srcShift, __m128i bits, __m128i dstShift) {
+	return _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(in, srcShift), bits), dstShift);
+}
+
+/** Sign extend the low 16 bits of each lane, so that _mm_packs_epi32() keeps them as they are */
+static FORCEINLINE __m128i packLow16(__m128i lo, __m128i hi) {
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+/** Lanes of the pixels which must not be written, from 4 source pixels in 32-bit lanes starting at x */
+template<int mode>
+static FORCEINLINE __m128i skip32(__m128i in, const byte *mask, uint x, const CrossBlitArgs &args) {
+	if (mode == kCrossBlitPlain)
+		return _mm_setzero_si128();
+	if (mode == kCrossBlitKey)
+		return _mm_cmpeq_epi32(in, _mm_set1_epi32(args.key));
+	const __m128i m8 = _mm_cvtsi32_si128(READ_UINT32(mask + x));
+	const __m128i m16 = _mm_unpacklo_epi8(m8, _mm_setzero_si128());
+	return _mm_cmpeq_epi32(_mm_unpacklo_epi16(m16, _mm_setzero_si128()), _mm_setzero_si128());
+}
+
+template<int mode>
+static FORCEINLINE void store(byte *dst, __m128i value, __m128i skip) {
+	if (mode != kCrossBlitPlain) {
+		const __m128i old = _mm_loadu_si128((const __m128i *)dst);
+		value = _mm_or_si128(_mm_and_si128(skip, old), _mm_andnot_si128(skip, value));
+	}
+	_mm_storeu_si128((__m128i *)dst, value);
+}
+
+template<int mode>
+struct Convert32To32RowSSE2 {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		const ShiftsSSE2 shifts(ch, 0, 0, 0);
+		const __m128i bits = _mm_set1_epi32(0xFF);
+		const __m128i fill = _mm_set1_epi32(ch.dstFill);
+
+		uint x = 0;
+		for (; x + 4 <= args.w; x += 4) {
+			const __m128i in = _mm_loadu_si128((const __m128i *)(src + x * 4));
+			__m128i out = _mm_or_si128(fill, extract(in, shifts.src[0], bits, shifts.dst[0]));
+			out = _mm_or_si128(out, extract(in, shifts.src[1], bits, shifts.dst[1]));
+			out = _mm_or_si128(out, extract(in, shifts.src[2], bits, shifts.dst[2]));
+			if (ch.copyAlpha)
+				out = _mm_or_si128(out, extract(in, shifts.src[3], bits, shifts.dst[3]));
+
+			store<mode>(dst + x * 4, out, skip32<mode>(in, mask, x, args));
+		}
+
+		crossBlitPixels<CrossBlitConvert32To32, uint32, uint32, mode>(dst + x * 4, src + x * 4, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Convert16To32RowSSE2 {
+	static FORCEINLINE __m128i convert(__m128i in, const ShiftsSSE2 &shifts, __m128i fill) {
+		const __m128i bits5 = _mm_set1_epi32(0x1F);
+		const __m128i bits6 = _mm_set1_epi32(0x3F);
+		__m128i r = _mm_and_si128(_mm_srl_epi32(in, shifts.src[0]), bits5);
+		__m128i g = _mm_and_si128(_mm_srl_epi32(in, shifts.src[1]), bits6);
+		__m128i b = _mm_and_si128(_mm_srl_epi32(in, shifts.src[2]), bits5);
+		r = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+		g = _mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4));
+		b = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+		__m128i out = _mm_or_si128(fill, _mm_sll_epi32(r, shifts.dst[0]));
+		out = _mm_or_si128(out, _mm_sll_epi32(g, shifts.dst[1]));
+		return _mm_or_si128(out, _mm_sll_epi32(b, shifts.dst[2]));
+	}
+
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const ShiftsSSE2 shifts(args.channels, 0, 0, 0);
+		const __m128i fill = _mm_set1_epi32(args.channels.dstFill);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m128i in = _mm_loadu_si128((const __m128i *)(src + x * 2));
+			const __m128i lo = _mm_unpacklo_epi16(in, _mm_setzero_si128());
+			const __m128i hi = _mm_unpackhi_epi16(in, _mm_setzero_si128());
+
+			store<mode>(dst + x * 4, convert(lo, shifts, fill), skip32<mode>(lo, mask, x, args));
+			store<mode>(dst + x * 4 + 16, convert(hi, shifts, fill), skip32<mode>(hi, mask, x + 4, args));
+		}
+
+		crossBlitPixels<CrossBlitConvert16To32, uint16, uint32, mode>(dst + x * 4, src + x * 2, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<int mode>
+struct Convert32To16RowSSE2 {
+	static FORCEINLINE __m128i convert(__m128i in, const ShiftsSSE2 &shifts) {
+		const __m128i bits5 = _mm_set1_epi32(0x1F);
+		const __m128i bits6 = _mm_set1_epi32(0x3F);
+		__m128i out = extract(in, shifts.src[0], bits5, shifts.dst[0]);
+		out = _mm_or_si128(out, extract(in, shifts.src[1], bits6, shifts.dst[1]));
+		return _mm_or_si128(out, extract(in, shifts.src[2], bits5, shifts.dst[2]));
+	}
+
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		const ShiftsSSE2 shifts(args.channels, 3, 2, 3);
+
+		uint x = 0;
+		for (; x + 8 <= args.w; x += 8) {
+			const __m128i lo = _mm_loadu_si128((const __m128i *)(src + x * 4));
+			const __m128i hi = _mm_loadu_si128((const __m128i *)(src + x * 4 + 16));
+			const __m128i out = packLow16(convert(lo, shifts), convert(hi, shifts));
+
+			__m128i skip = _mm_setzero_si128();
+			if (mode == kCrossBlitKey) {
+				skip = _mm_packs_epi32(skip32<mode>(lo, mask, x, args), skip32<mode>(hi, mask, x + 4, args));
+			} else if (mode == kCrossBlitMask) {
+				const __m128i m8 = _mm_loadl_epi64((const __m128i *)(mask + x));
+				skip = _mm_cmpeq_epi16(_mm_unpacklo_epi8(m8, _mm_setzero_si128()), _mm_setzero_si128());
+			}
+			store<mode>(dst + x * 2, out, skip);
+		}
+
+		crossBlitPixels<CrossBlitConvert32To16, uint32, uint16, mode>(dst + x * 2, src + x * 4, mask ? mask + x : nullptr, args.w - x, args);
+	}
+};
+
+template<template<int> class Row>
+void setupKernels(CrossBlitFunc *funcs) {
+	funcs[kCrossBlitPlain] = crossBlitRows<Row<kCrossBlitPlain> >;
+	funcs[kCrossBlitKey] = crossBlitRows<Row<kCrossBlitKey> >;
+	funcs[kCrossBlitMask] = crossBlitRows<Row<kCrossBlitMask> >;
+}
+
+} // End of anonymous namespace
+
+// SSE2 has no gather instruction, so the palette lookups keep the generic kernels
+void setupCrossBlitKernelsSSE2(CrossBlitKernels &kernels) {
+	setupKernels<Convert32To32RowSSE2>(kernels.convert32To32);
+	setupKernels<Convert16To32RowSSE2>(kernels.convert16To32);
+	setupKernels<Convert32To16RowSSE2>(kernels.convert32To16);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,191 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+#include "graphics/blit/blit-convert.h"
+
+namespace Graphics {
+
+namespace {
+
+template<class Convert, typename SrcColor, typename DstColor, int mode>
+struct GenericRow {
+	static void row(byte *dst, const byte *src, const byte *mask, const CrossBlitArgs &args) {
+		crossBlitPixels<Convert, SrcColor, DstColor, mode>(dst, src, mask, args.w, args);
+	}
+};
+
+template<class Convert, typename SrcColor, typename DstColor>
+void setupGeneric(CrossBlitFunc *funcs) {
+	funcs[kCrossBlitPlain] = crossBlitRows<GenericRow<Convert, SrcColor, DstColor, kCrossBlitPlain> >;
+	funcs[kCrossBlitKey] = crossBlitRows<GenericRow<Convert, SrcColor, DstColor, kCrossBlitKey> >;
+	funcs[kCrossBlitMask] = crossBlitRows<GenericRow<Convert, SrcColor, DstColor, kCrossBlitMask> >;
+}
+
+CrossBlitKernels selectCrossBlitKernels() {
+	CrossBlitKernels kernels;
+	setupCrossBlitKernelsGeneric(kernels);
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		setupCrossBlitKernelsNEON(kernels);
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		setupCrossBlitKernelsSSE2(kernels);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		setupCrossBlitKernelsAVX2(kernels);
+#endif
+	return kernels;
+}
+
+/** 32bpp, with 8 bits for red, green and blue, and either 8 or no bits of alpha */
+bool is8888(const PixelFormat &format) {
+	return format.bytesPerPixel == 4 && format.rBits() == 8 && format.gBits() == 8 && format.bBits() == 8
+		&& (format.aBits() == 8 || format.aBits() == 0);
+}
+
+/** 16bpp, with 5 bits for red, 6 for green and 5 for blue, and no alpha */
+bool is565(const PixelFormat &format) {
+	return format.bytesPerPixel == 2 && format.rBits() == 5 && format.gBits() == 6 && format.bBits() == 5
+		&& format.aBits() == 0;
+}
+
+bool overlaps(const CrossBlitArgs &args, uint dstBytesPerPixel, uint srcBytesPerPixel) {
+	const byte *dstEnd = args.dst + (args.h - 1) * args.dstPitch + args.w * dstBytesPerPixel;
+	const byte *srcEnd = args.src + (args.h - 1) * args.srcPitch + args.w * srcBytesPerPixel;
+	return args.dst < srcEnd && args.src < dstEnd;
+}
+
+void initArgs(CrossBlitArgs &args, byte *dst, const byte *src, const byte *mask,
+			  const uint dstPitch, const uint srcPitch, const uint maskPitch,
+			  const uint w, const uint h, const CrossBlitMode mode, const uint32 key) {
+	memset(&args, 0, sizeof(args));
+	args.dst = dst;
+	args.src = src;
+	args.mask = (mode == kCrossBlitMask) ? mask : nullptr;
+	args.dstPitch = dstPitch;
+	args.srcPitch = srcPitch;
+	args.maskPitch = maskPitch;
+	args.w = w;
+	args.h = h;
+	args.key = key;
+}
+
+} // End of anonymous namespace
+
+void setupCrossBlitKernelsGeneric(CrossBlitKernels &kernels) {
+	setupGeneric<CrossBlitConvert32To32, uint32, uint32>(kernels.convert32To32);
+	setupGeneric<CrossBlitConvert16To32, uint16, uint32>(kernels.convert16To32);
+	setupGeneric<CrossBlitConvert32To16, uint32, uint16>(kernels.convert32To16);
+	setupGeneric<CrossBlitMap, uint8, uint16>(kernels.map8To16);
+	setupGeneric<CrossBlitMap, uint8, uint32>(kernels.map8To32);
+}
+
+const CrossBlitKernels &getCrossBlitKernels() {
+	// Without an OSystem, the CPU features are unknown, so stick to the
+	// generic kernels until there is one
+	if (!g_system) {
+		static CrossBlitKernels generic;
+		static bool initialized = false;
+		if (!initialized) {
+			setupCrossBlitKernelsGeneric(generic);
+			initialized = true;
+		}
+		return generic;
+	}
+
+	static const CrossBlitKernels kernels = selectCrossBlitKernels();
+	return kernels;
+}
+
+bool crossBlitKernel(byte *dst, const byte *src, const byte *mask,
+					 const uint dstPitch, const uint srcPitch, const uint maskPitch,
+					 const uint w, const uint h,
+					 const PixelFormat &dstFmt, const PixelFormat &srcFmt,
+					 const CrossBlitMode mode, const uint32 key) {
+	if (!is8888(dstFmt) && !is565(dstFmt))
+		return false;
+	if (!is8888(srcFmt) && !is565(srcFmt))
+		return false;
+	if (is565(srcFmt) && is565(dstFmt))
+		return false;
+
+	if (!w || !h)
+		return true;
+
+	CrossBlitArgs args;
+	initArgs(args, dst, src, mask, dstPitch, srcPitch, maskPitch, w, h, mode, key);
+	if (overlaps(args, dstFmt.bytesPerPixel, srcFmt.bytesPerPixel))
+		return false;
+
+	const CrossBlitKernels &kernels = getCrossBlitKernels();
+	const CrossBlitFunc *funcs;
+	if (is565(srcFmt))
+		funcs = kernels.convert16To32;
+	else if (is565(dstFmt))
+		funcs = kernels.convert32To16;
+	else
+		funcs = kernels.convert32To32;
+
+	CrossBlitChannels &ch = args.channels;
+	ch.srcShift[0] = srcFmt.rShift;
+	ch.srcShift[1] = srcFmt.gShift;
+	ch.srcShift[2] = srcFmt.bShift;
+	ch.srcShift[3] = srcFmt.aShift;
+	ch.dstShift[0] = dstFmt.rShift;
+	ch.dstShift[1] = dstFmt.gShift;
+	ch.dstShift[2] = dstFmt.bShift;
+	ch.dstShift[3] = dstFmt.aShift;
+
+	// A source without alpha is opaque, and a destination without alpha drops it
+	ch.copyAlpha = srcFmt.aBits() == 8 && dstFmt.aBits() == 8;
+	ch.dstFill = (srcFmt.aBits() == 0 && dstFmt.aBits() == 8) ? (0xFFu << dstFmt.aShift) : 0;
+
+	funcs[mode](args);
+	return true;
+}
+
+bool crossBlitMapKernel(byte *dst, const byte *src, const byte *mask,
+						const uint dstPitch, const uint srcPitch, const uint maskPitch,
+						const uint w, const uint h,
+						const uint bytesPerPixel, const uint32 *map,
+						const CrossBlitMode mode, const uint32 key) {
+	if (bytesPerPixel != 2 && bytesPerPixel != 4)
+		return false;
+
+	if (!w || !h)
+		return true;
+
+	CrossBlitArgs args;
+	initArgs(args, dst, src, mask, dstPitch, srcPitch, maskPitch, w, h, mode, key);
+	if (overlaps(args, bytesPerPixel, 1))
+		return false;
+
+	const CrossBlitKernels &kernels = getCrossBlitKernels();
+	const CrossBlitFunc *funcs = (bytesPerPixel == 2) ? kernels.map8To16 : kernels.map8To32;
+	args.map = map;
+	funcs[mode](args);
+	return true;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,220 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_CONVERT_H
+#define GRAPHICS_BLIT_CONVERT_H
+
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * Internal kernels used by crossBlit(), crossKeyBlit(), crossMaskBlit() and
+ * their *Map variants for the most common conversions:
+ *
+ * - 32bpp to 32bpp, with 8 bits per component and an optional alpha
+ *   component (e.g. ARGB8888 to ABGR8888 or XRGB8888),
+ * - 16bpp with 5, 6 and 5 bits per component (RGB565 or BGR565) to 32bpp
+ *   with 8 bits per component, and the other way around,
+ * - palette lookups from 8bpp to 16bpp or 32bpp.
+ *
+ * The kernels produce exactly the same pixels as the generic conversion
+ * through PixelFormat. They are only used when the source and destination
+ * don't overlap.
+ */
+
+enum CrossBlitMode {
+	kCrossBlitPlain = 0,
+	kCrossBlitKey = 1,
+	kCrossBlitMask = 2,
+
+	kCrossBlitModeCount = 3
+};
+
+/**
+ * Component positions of a conversion between formats with a fixed number of
+ * bits per component. The components are in the order red, green, blue and
+ * alpha.
+ */
+struct CrossBlitChannels {
+	/** Position of the lowest bit of each component in the source and destination */
+	uint8 srcShift[4];
+	uint8 dstShift[4];
+
+	/** Whether the alpha component is copied from the source */
+	bool copyAlpha;
+
+	/** Bits set in all destination pixels, for an opaque alpha component */
+	uint32 dstFill;
+};
+
+struct CrossBlitArgs {
+	byte *dst;
+	const byte *src;
+	const byte *mask;
+	uint dstPitch, srcPitch, maskPitch;
+	uint w, h;
+
+	/** Source color which isn't copied, for kCrossBlitKey */
+	uint32 key;
+
+	/** Set for the format conversions */
+	CrossBlitChannels channels;
+
+	/** Set for the palette lookups */
+	const uint32 *map;
+};
+
+typedef void (*CrossBlitFunc)(const CrossBlitArgs &args);
+
+/**
+ * A set of kernels, indexed by CrossBlitMode.
+ */
+struct CrossBlitKernels {
+	CrossBlitFunc convert32To32[kCrossBlitModeCount];
+	CrossBlitFunc convert16To32[kCrossBlitModeCount];
+	CrossBlitFunc convert32To16[kCrossBlitModeCount];
+	CrossBlitFunc map8To16[kCrossBlitModeCount];
+	CrossBlitFunc map8To32[kCrossBlitModeCount];
+};
+
+/**
+ * Fill the kernel set with the kernels of an instruction set. The SIMD
+ * variants only replace the kernels they implement, so the generic ones
+ * must be set up first.
+ */
+void setupCrossBlitKernelsGeneric(CrossBlitKernels &kernels);
+#ifdef SCUMMVM_NEON
+void setupCrossBlitKernelsNEON(CrossBlitKernels &kernels);
+#endif
+#ifdef SCUMMVM_SSE2
+void setupCrossBlitKernelsSSE2(CrossBlitKernels &kernels);
+#endif
+#ifdef SCUMMVM_AVX2
+void setupCrossBlitKernelsAVX2(CrossBlitKernels &kernels);
+#endif
+
+/**
+ * The kernels for the CPU ScummVM is running on, selected on first use from
+ * the CPU features reported by OSystem.
+ */
+const CrossBlitKernels &getCrossBlitKernels();
+
+/**
+ * Try to convert a rect with one of the kernels. Returns false, without
+ * touching the destination, if none of them handles the conversion.
+ */
+bool crossBlitKernel(byte *dst, const byte *src, const byte *mask,
+					 const uint dstPitch, const uint srcPitch, const uint maskPitch,
+					 const uint w, const uint h,
+					 const PixelFormat &dstFmt, const PixelFormat &srcFmt,
+					 const CrossBlitMode mode, const uint32 key);
+bool crossBlitMapKernel(byte *dst, const byte *src, const byte *mask,
+						const uint dstPitch, const uint srcPitch, const uint maskPitch,
+						const uint w, const uint h,
+						const uint bytesPerPixel, const uint32 *map,
+						const CrossBlitMode mode, const uint32 key);
+
+/**
+ * Per pixel conversions, used by the generic kernels and for the pixels left
+ * over at the end of the rows by the SIMD ones.
+ */
+struct CrossBlitConvert32To32 {
+	static inline uint32 convert(uint32 color, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		uint32 result = ch.dstFill;
+		result |= ((color >> ch.srcShift[0]) & 0xFF) << ch.dstShift[0];
+		result |= ((color >> ch.srcShift[1]) & 0xFF) << ch.dstShift[1];
+		result |= ((color >> ch.srcShift[2]) & 0xFF) << ch.dstShift[2];
+		if (ch.copyAlpha)
+			result |= ((color >> ch.srcShift[3]) & 0xFF) << ch.dstShift[3];
+		return result;
+	}
+};
+
+struct CrossBlitConvert16To32 {
+	static inline uint32 convert(uint32 color, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		const uint32 r = (color >> ch.srcShift[0]) & 0x1F;
+		const uint32 g = (color >> ch.srcShift[1]) & 0x3F;
+		const uint32 b = (color >> ch.srcShift[2]) & 0x1F;
+		return ch.dstFill |
+		       (((r << 3) | (r >> 2)) << ch.dstShift[0]) |
+		       (((g << 2) | (g >> 4)) << ch.dstShift[1]) |
+		       (((b << 3) | (b >> 2)) << ch.dstShift[2]);
+	}
+};
+
+struct CrossBlitConvert32To16 {
+	static inline uint32 convert(uint32 color, const CrossBlitArgs &args) {
+		const CrossBlitChannels &ch = args.channels;
+		return (((color >> (ch.srcShift[0] + 3)) & 0x1F) << ch.dstShift[0]) |
+		       (((color >> (ch.srcShift[1] + 2)) & 0x3F) << ch.dstShift[1]) |
+		       (((color >> (ch.srcShift[2] + 3)) & 0x1F) << ch.dstShift[2]);
+	}
+};
+
+struct CrossBlitMap {
+	static inline uint32 convert(uint32 color, const CrossBlitArgs &args) {
+		return args.map[color];
+	}
+};
+
+/**
+ * Convert @p count pixels of a row, one at a time.
+ */
+template<class Convert, typename SrcColor, typename DstColor, int mode>
+inline void crossBlitPixels(byte *dst, const byte *src, const byte *mask, uint count, const CrossBlitArgs &args) {
+	const SrcColor *in = (const SrcColor *)src;
+	DstColor *out = (DstColor *)dst;
+
+	for (uint x = 0; x < count; ++x) {
+		const uint32 color = in[x];
+		if (mode == kCrossBlitKey && color == args.key)
+			continue;
+		if (mode == kCrossBlitMask && !mask[x])
+			continue;
+		out[x] = (DstColor)Convert::convert(color, args);
+	}
+}
+
+/**
+ * Run Row::row(dst, src, mask, args) on each row of the rect. The mask is
+ * nullptr unless the mode is kCrossBlitMask.
+ */
+template<class Row>
+inline void crossBlitRows(const CrossBlitArgs &args) {
+	byte *dst = args.dst;
+	const byte *src = args.src;
+	const byte *mask = args.mask;
+
+	for (uint y = 0; y < args.h; ++y) {
+		Row::row(dst, src, mask, args);
+		dst += args.dstPitch;
+		src += args.srcPitch;
+		if (mask)
+			mask += args.maskPitch;
+	}
+}
+
+} // End of namespace Graphics
+
+#endif
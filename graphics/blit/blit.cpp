@@ -20,6 +20,7 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-convert.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
 
@@ -281,6 +282,9 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	if (crossBlitKernel(dst, src, nullptr, dstPitch, srcPitch, 0, w, h, dstFmt, srcFmt, kCrossBlitPlain, 0))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -353,6 +357,9 @@ bool crossKeyBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	if (crossBlitKernel(dst, src, nullptr, dstPitch, srcPitch, 0, w, h, dstFmt, srcFmt, kCrossBlitKey, key))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -425,6 +432,9 @@ bool crossMaskBlit(byte *dst, const byte *src, const byte *mask,
 		return true;
 	}
 
+	if (crossBlitKernel(dst, src, mask, dstPitch, srcPitch, maskPitch, w, h, dstFmt, srcFmt, kCrossBlitMask, 0))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta  = (srcPitch  - w * srcFmt.bytesPerPixel);
 	const uint dstDelta  = (dstPitch  - w * dstFmt.bytesPerPixel);
@@ -491,6 +501,9 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if (!bytesPerPixel)
 		return false;
 
+	if (crossBlitMapKernel(dst, src, nullptr, dstPitch, srcPitch, 0, w, h, bytesPerPixel, map, kCrossBlitPlain, 0))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
@@ -539,6 +552,9 @@ bool crossKeyBlitMap(byte *dst, const byte *src,
 	if (!bytesPerPixel)
 		return false;
 
+	if (crossBlitMapKernel(dst, src, nullptr, dstPitch, srcPitch, 0, w, h, bytesPerPixel, map, kCrossBlitKey, key))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
@@ -587,6 +603,9 @@ bool crossMaskBlitMap(byte *dst, const byte *src, const byte *mask,
 	if (!bytesPerPixel)
 		return false;
 
+	if (crossBlitMapKernel(dst, src, mask, dstPitch, srcPitch, maskPitch, w, h, bytesPerPixel, map, kCrossBlitMask, 0))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta  = (srcPitch  - w);
 	const uint dstDelta  = (dstPitch  - w * bytesPerPixel);
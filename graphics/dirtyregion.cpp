@@ -0,0 +1,197 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/dirtyregion.h"
+
+namespace Graphics {
+
+static int getRectArea(const Common::Rect &r) {
+	return r.width() * r.height();
+}
+
+DirtyRegion::DirtyRegion(uint maxRects, int mergeCost)
+	: _maxRects(MAX<uint>(maxRects, 1)), _mergeCost(mergeCost), _allDirty(false) {
+}
+
+void DirtyRegion::addRect(const Common::Rect &r) {
+	if (r.isEmpty() || _allDirty) {
+		return;
+	}
+
+	// Merge the new rectangle with the ones which overlap it, or which are
+	// close enough. The merged rectangle may reach other rectangles, so
+	// these are checked again.
+	Common::Rect area = r;
+	for (uint i = 0; i < _rects.size();) {
+		const Common::Rect &other = _rects[i];
+		Common::Rect merged = area;
+		merged.extend(other);
+
+		if (area.intersects(other) || getRectArea(merged) - getRectArea(area) - getRectArea(other) <= _mergeCost) {
+			area = merged;
+			_rects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_rects.size() >= _maxRects) {
+		uint best = 0;
+		int bestGrowth = 0;
+		for (uint i = 0; i < _rects.size(); ++i) {
+			Common::Rect merged = area;
+			merged.extend(_rects[i]);
+
+			const int growth = getRectArea(merged) - getRectArea(_rects[i]);
+			if (i == 0 || growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
+
+		area.extend(_rects[best]);
+		_rects.remove_at(best);
+		addRect(area);
+		return;
+	}
+
+	_rects.push_back(area);
+}
+
+void DirtyRegion::markAll() {
+	_allDirty = true;
+	_rects.clear();
+}
+
+void DirtyRegion::clear() {
+	_allDirty = false;
+	_rects.clear();
+}
+
+Common::Rect DirtyRegion::getBoundingBox() const {
+	Common::Rect box;
+	for (uint i = 0; i < _rects.size(); ++i) {
+		if (i == 0) {
+			box = _rects[i];
+		} else {
+			box.extend(_rects[i]);
+		}
+	}
+	return box;
+}
+
+uint DirtyRegion::getArea() const {
+	uint area = 0;
+	for (uint i = 0; i < _rects.size(); ++i) {
+		area += getRectArea(_rects[i]);
+	}
+	return area;
+}
+
+bool DirtyRegion::isTileDirty(int column, int row, int tileWidth, int tileHeight) const {
+	if (_allDirty) {
+		return true;
+	}
+
+	const Common::Rect tile(column * tileWidth, row * tileHeight, (column + 1) * tileWidth, (row + 1) * tileHeight);
+	for (uint i = 0; i < _rects.size(); ++i) {
+		if (tile.intersects(_rects[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void DirtyRegion::getDirtyTiles(int tileWidth, int tileHeight, uint columns, uint rows, Common::BitArray &tiles) const {
+	tiles.clear();
+
+	if (_allDirty) {
+		for (uint i = 0; i < columns * rows; ++i) {
+			tiles.set(i);
+		}
+		return;
+	}
+
+	// Each rectangle sets the tiles it covers, rather than each tile
+	// looking for a rectangle
+	for (uint i = 0; i < _rects.size(); ++i) {
+		const Common::Rect &r = _rects[i];
+		const uint left = MAX<int>(r.left, 0) / tileWidth;
+		const uint top = MAX<int>(r.top, 0) / tileHeight;
+		const uint right = MIN<uint>((MAX<int>(r.right, 1) - 1) / tileWidth + 1, columns);
+		const uint bottom = MIN<uint>((MAX<int>(r.bottom, 1) - 1) / tileHeight + 1, rows);
+
+		for (uint y = top; y < bottom; ++y) {
+			for (uint x = left; x < right; ++x) {
+				tiles.set(y * columns + x);
+			}
+		}
+	}
+}
+
+Common::Array<Common::Rect> DirtyRegion::getUploadPlan(const Common::Rect &bounds) const {
+	Common::Array<Common::Rect> plan;
+	if (_allDirty) {
+		plan.push_back(bounds);
+		return plan;
+	}
+
+	Common::Rect box;
+	int area = 0;
+	for (uint i = 0; i < _rects.size(); ++i) {
+		Common::Rect r = _rects[i];
+		r.clip(bounds);
+		if (r.isEmpty()) {
+			continue;
+		}
+
+		if (plan.empty()) {
+			box = r;
+		} else {
+			box.extend(r);
+		}
+		area += getRectArea(r);
+		plan.push_back(r);
+	}
+
+	// Clipping may leave the rectangles close enough that updating their
+	// bounding box at once is cheaper
+	if (plan.size() > 1 && getRectArea(box) - area <= _mergeCost * (int)(plan.size() - 1)) {
+		plan.clear();
+		plan.push_back(box);
+	}
+	return plan;
+}
+
+uint DirtyRegion::getUploadSize(const Common::Rect &r, uint bytesPerPixel, uint lineWidth) {
+	return (lineWidth ? lineWidth : r.width()) * r.height() * bytesPerPixel;
+}
+
+uint DirtyRegion::getUploadSize(const Common::Array<Common::Rect> &plan, uint bytesPerPixel, uint lineWidth) {
+	uint size = 0;
+	for (uint i = 0; i < plan.size(); ++i) {
+		size += getUploadSize(plan[i], bytesPerPixel, lineWidth);
+	}
+	return size;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTYREGION_H
+#define GRAPHICS_DIRTYREGION_H
+
+#include "common/array.h"
+#include "common/bitarray.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * The changed areas of a surface, kept as a bounded set of rectangles
+ * which do not overlap.
+ *
+ * A new rectangle is merged with the ones it overlaps, and with the ones
+ * close enough that their bounding box is not larger than both of them
+ * by more than the merge cost, the number of pixels an update costs on
+ * its own. Past the maximum number of rectangles, the new one is merged
+ * with the rectangle it grows the least.
+ */
+class DirtyRegion {
+public:
+	DirtyRegion(uint maxRects = 8, int mergeCost = 64 * 64);
+
+	/**
+	 * Add a changed rectangle. Empty rectangles are ignored.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Mark the whole surface as changed, until the next call to clear().
+	 */
+	void markAll();
+
+	void clear();
+
+	bool isEmpty() const { return !_allDirty && _rects.empty(); }
+	bool isAllDirty() const { return _allDirty; }
+
+	/**
+	 * @return The changed rectangles, which do not overlap. They are
+	 *         meaningless when the whole surface is marked.
+	 */
+	const Common::Array<Common::Rect> &getRects() const { return _rects; }
+
+	/**
+	 * @return The bounding box of the changed rectangles.
+	 */
+	Common::Rect getBoundingBox() const;
+
+	/**
+	 * @return The number of changed pixels, not counting the whole surface
+	 *         being marked.
+	 */
+	uint getArea() const;
+
+	/**
+	 * Whether a tile of a grid starting at (0, 0) has changed pixels.
+	 */
+	bool isTileDirty(int column, int row, int tileWidth, int tileHeight) const;
+
+	/**
+	 * Set the bits of the changed tiles of a grid starting at (0, 0), with
+	 * the bit of a tile at row * columns + column.
+	 *
+	 * @param tiles A bit array of at least columns * rows bits, which is
+	 *              cleared first.
+	 */
+	void getDirtyTiles(int tileWidth, int tileHeight, uint columns, uint rows, Common::BitArray &tiles) const;
+
+	/**
+	 * The rectangles to update within bounds: the changed rectangles, their
+	 * bounding box when it costs less to update at once, or the bounds
+	 * themselves when the whole surface is marked.
+	 */
+	Common::Array<Common::Rect> getUploadPlan(const Common::Rect &bounds) const;
+
+	/**
+	 * The number of bytes updating a rectangle sends, with pixels of the
+	 * given size.
+	 *
+	 * @param lineWidth When not 0, the whole lines of this many pixels
+	 *                  covered by the rectangle are updated, for targets
+	 *                  which cannot update part of a line.
+	 */
+	static uint getUploadSize(const Common::Rect &r, uint bytesPerPixel, uint lineWidth = 0);
+
+	/**
+	 * The number of bytes updating the rectangles of a plan sends.
+	 */
+	static uint getUploadSize(const Common::Array<Common::Rect> &plan, uint bytesPerPixel, uint lineWidth = 0);
+
+private:
+	uint _maxRects;
+	int _mergeCost;
+
+	bool _allDirty;
+	Common::Array<Common::Rect> _rects;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -37,7 +37,7 @@
 #include "common/singleton.h"
 #include "common/stream.h"
 #include "common/memstream.h"
-#include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "common/ptr.h"
 #include "common/compression/unzip.h"
 
@@ -179,7 +179,7 @@ private:
 	};
 
 	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
-	typedef Common::HashMap<uint32, Glyph> GlyphCache;
+	typedef Common::FlatHashMap<uint32, Glyph> GlyphCache;
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
@@ -67,6 +67,8 @@ void Context::reset() {
 	packedPixelsSupported = false;
 	packedDepthStencilSupported = false;
 	unpackSubImageSupported = false;
+	pixelBufferObjectSupported = false;
+	mapBufferRangeSupported = false;
 	OESDepth24 = false;
 	textureEdgeClampSupported = false;
 	textureBorderClampSupported = false;
@@ -169,6 +171,7 @@ void Context::initialize(ContextType contextType) {
 
 	bool EXTFramebufferMultisample = false;
 	bool EXTFramebufferBlit = false;
+	bool ARBPixelBufferObject = false;
 
 	Common::StringTokenizer tokenizer(extString, " ");
 	while (!tokenizer.empty()) {
@@ -186,6 +189,10 @@ void Context::initialize(ContextType contextType) {
 			packedDepthStencilSupported = true;
 		} else if (token == "GL_EXT_unpack_subimage") {
 			unpackSubImageSupported = true;
+		} else if (token == "GL_ARB_pixel_buffer_object") {
+			ARBPixelBufferObject = true;
+		} else if (token == "GL_ARB_map_buffer_range") {
+			mapBufferRangeSupported = true;
 		} else if (token == "GL_EXT_framebuffer_multisample") {
 			EXTFramebufferMultisample = true;
 		} else if (token == "GL_EXT_framebuffer_blit") {
@@ -234,6 +241,12 @@ void Context::initialize(ContextType contextType) {
 		// No border clamping in GLES2
 		textureMirrorRepeatSupported = true;
 		// TODO: textureMaxLevelSupported with GLES3
+		// GLES3 has pixel buffer objects, buffer mapping and unpack sub-image support
+		if (isGLVersionOrHigher(3, 0)) {
+			pixelBufferObjectSupported = true;
+			mapBufferRangeSupported = true;
+			unpackSubImageSupported = true;
+		}
 		debug(5, "OpenGL: GLES2 context initialized");
 	} else if (type == kContextGLES) {
 		// GLES doesn't support shaders natively
@@ -276,6 +289,15 @@ void Context::initialize(ContextType contextType) {
 		if (isGLVersionOrHigher(1, 4)) {
 			textureMirrorRepeatSupported = true;
 		}
+		// OpenGL 2.1 adds pixel buffer object support. Before, the extension
+		// needs the buffer objects of OpenGL 1.5.
+		if (isGLVersionOrHigher(2, 1) || (ARBPixelBufferObject && isGLVersionOrHigher(1, 5))) {
+			pixelBufferObjectSupported = true;
+		}
+		// OpenGL 3.0 adds buffer range mapping support
+		if (isGLVersionOrHigher(3, 0)) {
+			mapBufferRangeSupported = true;
+		}
 		debug(5, "OpenGL: GL context initialized");
 	} else {
 		warning("OpenGL: Unknown context initialized");
@@ -301,6 +323,8 @@ void Context::initialize(ContextType contextType) {
 	debug(5, "OpenGL: Packed pixels support: %d", packedPixelsSupported);
 	debug(5, "OpenGL: Packed depth stencil support: %d", packedDepthStencilSupported);
 	debug(5, "OpenGL: Unpack subimage support: %d", unpackSubImageSupported);
+	debug(5, "OpenGL: Pixel buffer object support: %d", pixelBufferObjectSupported);
+	debug(5, "OpenGL: Map buffer range support: %d", mapBufferRangeSupported);
 	debug(5, "OpenGL: OpenGL ES depth 24 support: %d", OESDepth24);
 	debug(5, "OpenGL: Texture edge clamping support: %d", textureEdgeClampSupported);
 	debug(5, "OpenGL: Texture border clamping support: %d", textureBorderClampSupported);
@@ -105,6 +105,12 @@ public:
 	/** Whether specifying a pitch when uploading to textures is available or not */
 	bool unpackSubImageSupported;
 
+	/** Whether uploading to textures from pixel buffer objects is available or not */
+	bool pixelBufferObjectSupported;
+
+	/** Whether mapping a range of a buffer object is available or not */
+	bool mapBufferRangeSupported;
+
 	/** Whether depth component 24 is supported or not */
 	bool OESDepth24;
 
@@ -84,6 +84,11 @@
 		#define GL_MAX_SAMPLES 0x8D57
 	#endif
 
+	#if !defined(GL_PIXEL_UNPACK_BUFFER)
+		// GLES3 pixel buffer objects, used when the context has them
+		#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+	#endif
+
 	#if !defined(GL_STACK_OVERFLOW_KHR)
 		#define GL_STACK_OVERFLOW_KHR 0x0503
 	#endif
@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace {
+
+/** Pattern bits of 8 pixels for one neighbour, see neighbourSSE2() */
+static FORCEINLINE __m256i neighbourAVX2(__m256i w5, __m256i yuv5, const uint32 *pixels, const uint32 *yuv, __m256i bit) {
+	const __m256i w = _mm256_loadu_si256((const __m256i *)pixels);
+	const __m256i y = _mm256_loadu_si256((const __m256i *)yuv);
+
+	const __m256i absDiff = _mm256_or_si256(_mm256_subs_epu8(yuv5, y), _mm256_subs_epu8(y, yuv5));
+	const __m256i over = _mm256_subs_epu8(absDiff, _mm256_set1_epi32(0x00300706));
+	const __m256i similar = _mm256_or_si256(_mm256_cmpeq_epi32(over, _mm256_setzero_si256()), _mm256_cmpeq_epi32(w5, w));
+	return _mm256_andnot_si256(similar, bit);
+}
+
+} // End of anonymous namespace
+
+void HQScaler::computePatternsAVX2(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns) {
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m256i w5 = _mm256_loadu_si256((const __m256i *)(pixels[1] + x));
+		const __m256i yuv5 = _mm256_loadu_si256((const __m256i *)(yuv[1] + x));
+
+		__m256i pattern = neighbourAVX2(w5, yuv5, pixels[0] + x - 1, yuv[0] + x - 1, _mm256_set1_epi32(0x0001));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[0] + x,     yuv[0] + x,     _mm256_set1_epi32(0x0002)));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[0] + x + 1, yuv[0] + x + 1, _mm256_set1_epi32(0x0004)));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[1] + x - 1, yuv[1] + x - 1, _mm256_set1_epi32(0x0008)));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[1] + x + 1, yuv[1] + x + 1, _mm256_set1_epi32(0x0010)));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[2] + x - 1, yuv[2] + x - 1, _mm256_set1_epi32(0x0020)));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[2] + x,     yuv[2] + x,     _mm256_set1_epi32(0x0040)));
+		pattern = _mm256_or_si256(pattern, neighbourAVX2(w5, yuv5, pixels[2] + x + 1, yuv[2] + x + 1, _mm256_set1_epi32(0x0080)));
+		_mm256_storeu_si256((__m256i *)(patterns + x), pattern);
+	}
+
+	if (x < width) {
+		const uint32 *tailPixels[3] = { pixels[0] + x, pixels[1] + x, pixels[2] + x };
+		const uint32 *tailYuv[3] = { yuv[0] + x, yuv[1] + x, yuv[2] + x };
+		computePatternsGeneric(tailPixels, tailYuv, width - x, patterns + x);
+	}
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
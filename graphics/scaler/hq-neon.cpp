@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/scaler/hq.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace {
+
+/** Pattern bits of 4 pixels for one neighbour, see neighbourSSE2() */
+static inline uint32x4_t neighbourNEON(uint32x4_t w5, uint8x16_t yuv5, const uint32 *pixels, const uint32 *yuv, uint32x4_t bit) {
+	const uint32x4_t w = vld1q_u32((const uint32_t *)pixels);
+	const uint8x16_t y = vreinterpretq_u8_u32(vld1q_u32((const uint32_t *)yuv));
+
+	const uint8x16_t over = vqsubq_u8(vabdq_u8(yuv5, y), vreinterpretq_u8_u32(vdupq_n_u32(0x00300706)));
+	const uint32x4_t similar = vorrq_u32(vceqq_u32(vreinterpretq_u32_u8(over), vdupq_n_u32(0)), vceqq_u32(w5, w));
+	return vbicq_u32(bit, similar);
+}
+
+} // End of anonymous namespace
+
+void HQScaler::computePatternsNEON(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns) {
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const uint32x4_t w5 = vld1q_u32((const uint32_t *)(pixels[1] + x));
+		const uint8x16_t yuv5 = vreinterpretq_u8_u32(vld1q_u32((const uint32_t *)(yuv[1] + x)));
+
+		uint32x4_t pattern = neighbourNEON(w5, yuv5, pixels[0] + x - 1, yuv[0] + x - 1, vdupq_n_u32(0x0001));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[0] + x,     yuv[0] + x,     vdupq_n_u32(0x0002)));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[0] + x + 1, yuv[0] + x + 1, vdupq_n_u32(0x0004)));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[1] + x - 1, yuv[1] + x - 1, vdupq_n_u32(0x0008)));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[1] + x + 1, yuv[1] + x + 1, vdupq_n_u32(0x0010)));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[2] + x - 1, yuv[2] + x - 1, vdupq_n_u32(0x0020)));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[2] + x,     yuv[2] + x,     vdupq_n_u32(0x0040)));
+		pattern = vorrq_u32(pattern, neighbourNEON(w5, yuv5, pixels[2] + x + 1, yuv[2] + x + 1, vdupq_n_u32(0x0080)));
+		vst1q_u32((uint32_t *)(patterns + x), pattern);
+	}
+
+	if (x < width) {
+		const uint32 *tailPixels[3] = { pixels[0] + x, pixels[1] + x, pixels[2] + x };
+		const uint32 *tailYuv[3] = { yuv[0] + x, yuv[1] + x, yuv[2] + x };
+		computePatternsGeneric(tailPixels, tailYuv, width - x, patterns + x);
+	}
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
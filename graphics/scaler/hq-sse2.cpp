@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif // __GNUC__
+
+namespace {
+
+/**
+ * Pattern bits of 4 pixels for one neighbour: set when the neighbour differs
+ * from the pixel and one of its YUV components differs by more than the
+ * thresholds.
+ */
+static inline __m128i neighbourSSE2(__m128i w5, __m128i yuv5, const uint32 *pixels, const uint32 *yuv, __m128i bit) {
+	const __m128i w = _mm_loadu_si128((const __m128i *)pixels);
+	const __m128i y = _mm_loadu_si128((const __m128i *)yuv);
+
+	// The components are packed as 0x00YYUUVV, so the unsigned saturated
+	// byte differences give the absolute differences of all of them at once
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(yuv5, y), _mm_subs_epu8(y, yuv5));
+	const __m128i over = _mm_subs_epu8(absDiff, _mm_set1_epi32(0x00300706));
+	const __m128i similar = _mm_or_si128(_mm_cmpeq_epi32(over, _mm_setzero_si128()), _mm_cmpeq_epi32(w5, w));
+	return _mm_andnot_si128(similar, bit);
+}
+
+} // End of anonymous namespace
+
+void HQScaler::computePatternsSSE2(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns) {
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const __m128i w5 = _mm_loadu_si128((const __m128i *)(pixels[1] + x));
+		const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(yuv[1] + x));
+
+		__m128i pattern = neighbourSSE2(w5, yuv5, pixels[0] + x - 1, yuv[0] + x - 1, _mm_set1_epi32(0x0001));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[0] + x,     yuv[0] + x,     _mm_set1_epi32(0x0002)));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[0] + x + 1, yuv[0] + x + 1, _mm_set1_epi32(0x0004)));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[1] + x - 1, yuv[1] + x - 1, _mm_set1_epi32(0x0008)));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[1] + x + 1, yuv[1] + x + 1, _mm_set1_epi32(0x0010)));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[2] + x - 1, yuv[2] + x - 1, _mm_set1_epi32(0x0020)));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[2] + x,     yuv[2] + x,     _mm_set1_epi32(0x0040)));
+		pattern = _mm_or_si128(pattern, neighbourSSE2(w5, yuv5, pixels[2] + x + 1, yuv[2] + x + 1, _mm_set1_epi32(0x0080)));
+		_mm_storeu_si128((__m128i *)(patterns + x), pattern);
+	}
+
+	if (x < width) {
+		const uint32 *tailPixels[3] = { pixels[0] + x, pixels[1] + x, pixels[2] + x };
+		const uint32 *tailYuv[3] = { yuv[0] + x, yuv[1] + x, yuv[2] + x };
+		computePatternsGeneric(tailPixels, tailYuv, width - x, patterns + x);
+	}
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
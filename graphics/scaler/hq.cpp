@@ -21,6 +21,8 @@
 #include "graphics/scaler/hq.h"
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
+#include "common/array.h"
+#include "common/system.h"
 
 // RGB-to-YUV lookup table
 
@@ -193,13 +195,90 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Three rows of source pixels and their YUV values, with one more pixel on
+ * each side, used to compute the similarity patterns of the middle row.
+ */
+template<typename ColorMask>
+class HQPatternRows {
+	typedef typename ColorMask::PixelType Pixel;
+
+public:
+	HQPatternRows(int width, const uint32 *RGBtoYUV, HQScaler::PatternFunc patternFunc) :
+		_width(width), _RGBtoYUV(RGBtoYUV), _computePatterns(patternFunc), _buffer((width + 2) * 6 + width) {
+		for (int i = 0; i < 3; ++i) {
+			_pixels[i] = &_buffer[(width + 2) * i + 1];
+			_yuv[i] = &_buffer[(width + 2) * (3 + i) + 1];
+		}
+		_patterns = &_buffer[(width + 2) * 6];
+	}
+
+	/**
+	 * Compute the patterns of the row starting at p. The rows are expected
+	 * one after the other, so that the two upper rows can be reused.
+	 */
+	const uint32 *computePatterns(const Pixel *p, uint32 nextlineSrc, bool firstRow) {
+		if (firstRow) {
+			load(0, p - nextlineSrc);
+			load(1, p);
+		} else {
+			uint32 *pixels = _pixels[0], *yuv = _yuv[0];
+			_pixels[0] = _pixels[1];
+			_pixels[1] = _pixels[2];
+			_pixels[2] = pixels;
+			_yuv[0] = _yuv[1];
+			_yuv[1] = _yuv[2];
+			_yuv[2] = yuv;
+		}
+		load(2, p + nextlineSrc);
+
+		_computePatterns(_pixels, _yuv, _width, _patterns);
+		return _patterns;
+	}
+
+private:
+	void load(int row, const Pixel *p) {
+		uint32 *pixels = _pixels[row], *yuv = _yuv[row];
+		for (int x = -1; x <= _width; ++x) {
+			const uint32 w = p[x];
+			pixels[x] = w;
+			yuv[x] = sizeof(Pixel) == 2 ? _RGBtoYUV[w] : ConvertYUV<ColorMask>(w, _RGBtoYUV);
+		}
+	}
+
+	const int _width;
+	const uint32 *_RGBtoYUV;
+	HQScaler::PatternFunc _computePatterns;
+	Common::Array<uint32> _buffer;
+	uint32 *_pixels[3];
+	uint32 *_yuv[3];
+	uint32 *_patterns;
+};
+
+void HQScaler::computePatternsGeneric(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns) {
+	for (int x = 0; x < width; ++x) {
+		const uint32 w5 = pixels[1][x];
+		const int yuv5 = yuv[1][x];
+		uint32 pattern = 0;
+		if (w5 != pixels[0][x - 1] && diffYUV(yuv5, yuv[0][x - 1])) pattern |= 0x0001;
+		if (w5 != pixels[0][x]     && diffYUV(yuv5, yuv[0][x]))     pattern |= 0x0002;
+		if (w5 != pixels[0][x + 1] && diffYUV(yuv5, yuv[0][x + 1])) pattern |= 0x0004;
+		if (w5 != pixels[1][x - 1] && diffYUV(yuv5, yuv[1][x - 1])) pattern |= 0x0008;
+		if (w5 != pixels[1][x + 1] && diffYUV(yuv5, yuv[1][x + 1])) pattern |= 0x0010;
+		if (w5 != pixels[2][x - 1] && diffYUV(yuv5, yuv[2][x - 1])) pattern |= 0x0020;
+		if (w5 != pixels[2][x]     && diffYUV(yuv5, yuv[2][x]))     pattern |= 0x0040;
+		if (w5 != pixels[2][x + 1] && diffYUV(yuv5, yuv[2][x + 1])) pattern |= 0x0080;
+		patterns[x] = pattern;
+	}
+}
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (https://web.archive.org/web/20090204033742/http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQScaler::PatternFunc computePatterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,7 +300,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	HQPatternRows<ColorMask> rows(width, RGBtoYUV, computePatterns);
+	bool firstRow = true;
+
 	while (height--) {
+		const uint32 *patterns = rows.computePatterns(p, nextlineSrc, firstRow);
+		firstRow = false;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -238,16 +323,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const uint32 pattern = patterns[width - tmpWidth - 1];
 
 			switch (pattern) {
 			case 0:
@@ -2116,7 +2192,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQScaler::PatternFunc computePatterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,7 +2215,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	HQPatternRows<ColorMask> rows(width, RGBtoYUV, computePatterns);
+	bool firstRow = true;
+
 	while (height--) {
+		const uint32 *patterns = rows.computePatterns(p, nextlineSrc, firstRow);
+		firstRow = false;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2156,16 +2238,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const uint32 pattern = patterns[width - tmpWidth - 1];
 
 			switch (pattern) {
 			case 0:
@@ -4947,6 +5020,8 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	}
 }
 
+HQScaler::PatternFunc HQScaler::patternFunc = nullptr;
+
 HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 #ifdef USE_NASM
 	_hqx_params(nullptr),
@@ -4954,6 +5029,23 @@ HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 	_RGBtoYUV(nullptr) {
 	_factor = 2;
 
+	if (!patternFunc) {
+		PatternFunc func = computePatternsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system && g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			func = computePatternsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system && g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			func = computePatternsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system && g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			func = computePatternsAVX2;
+#endif
+		patternFunc = func;
+	}
+
 	if (format.bytesPerPixel == 2) {
 		initLUT(format);
 	} else {
@@ -4987,19 +5079,19 @@ void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, patternFunc);
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, patternFunc);
 }
 
 void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, patternFunc);
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, patternFunc);
 }
 #endif
 
@@ -5007,15 +5099,15 @@ void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ2x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, patternFunc);
 		} else {
 			HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, patternFunc);
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, patternFunc);
 	}
 }
 
@@ -5023,15 +5115,15 @@ void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ3x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, patternFunc);
 		} else {
 			HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, patternFunc);
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, patternFunc);
 	}
 }
 
@@ -33,6 +33,42 @@ public:
 	~HQScaler();
 	uint increaseFactor() override;
 	uint decreaseFactor() override;
+#ifndef USE_NASM
+	bool canScaleInBands() const override { return true; }
+#endif
+
+	/**
+	 * Compute the similarity patterns of a row of pixels. Bit n of a pattern
+	 * is set when the n-th neighbour of the pixel (left to right, then top to
+	 * bottom, skipping the pixel itself) differs from it, both in value and
+	 * in YUV beyond the HQ thresholds.
+	 *
+	 * @param pixels   The rows above, at and below the pixels, as 32-bit values.
+	 * @param yuv      The YUV values of the same pixels.
+	 * @param width    The number of pixels. Index -1 and width of each row
+	 *                 must be readable.
+	 * @param patterns Receives one pattern per pixel.
+	 */
+	typedef void (*PatternFunc)(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns);
+
+	static void computePatternsGeneric(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns);
+#ifdef SCUMMVM_NEON
+	static void computePatternsNEON(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void computePatternsSSE2(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void computePatternsAVX2(const uint32 *const *pixels, const uint32 *const *yuv, int width, uint32 *patterns);
+#endif
+
+	/**
+	 * The pattern function used by all the HQ scalers. It is selected from
+	 * the CPU features when the first HQ scaler is created, unless it is
+	 * already set.
+	 */
+	static PatternFunc patternFunc;
+
 protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) override;
@@ -19,6 +19,7 @@
  */
 
 #include "graphics/scalerplugin.h"
+#include "common/threadpool.h"
 
 namespace {
 /**
@@ -53,10 +54,42 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
 	} else {
-		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		const uint count = getBandCount(height);
+		if (count > 1) {
+			BandParams params = { this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, count };
+			scaleInBands(params);
+		} else {
+			scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		}
 	}
 }
 
+void Scaler::BandParams::getBand(uint index, int &top, int &bandHeight) const {
+	top = height * index / count;
+	bandHeight = height * (index + 1) / count - top;
+}
+
+uint Scaler::getBandCount(int height) const {
+	if (!_threadPool || !canScaleInBands())
+		return 1;
+
+	return CLIP<uint>(height / kMinBandHeight, 1, _threadPool->getThreadCount());
+}
+
+void Scaler::scaleInBands(const BandParams &params) {
+	_threadPool->run(scaleBand, const_cast<BandParams *>(&params), params.count);
+}
+
+void Scaler::scaleBand(void *param, uint index) {
+	const BandParams &params = *(const BandParams *)param;
+	int top, bandHeight;
+	params.getBand(index, top, bandHeight);
+
+	params.scaler->scaleIntern(params.srcPtr + top * params.srcPitch, params.srcPitch,
+	                           params.dstPtr + top * params.scaler->_factor * params.dstPitch, params.dstPitch,
+	                           params.width, bandHeight, params.x, params.y + top);
+}
+
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
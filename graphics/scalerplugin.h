@@ -25,9 +25,13 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class ThreadPool;
+}
+
 class Scaler {
 public:
-	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
+	Scaler(const Graphics::PixelFormat &format) : _format(format), _threadPool(nullptr) {}
 	virtual ~Scaler() {}
 
 	/**
@@ -94,15 +98,71 @@ public:
 		assert(0);
 	}
 
+	/**
+	 * Set the worker threads used to scale large rects, or nullptr to scale
+	 * on the calling thread only. The pool is not owned by the scaler.
+	 *
+	 * It is only used by scalers which return true in canScaleInBands().
+	 */
+	void setThreadPool(Common::ThreadPool *pool) { _threadPool = pool; }
+
+	/**
+	 * Whether the scaler can scale horizontal bands of a rect at the same
+	 * time, on different threads, with the same result as scaling the whole
+	 * rect. This means scaleIntern() only reads the source around the band,
+	 * and writes nothing but the destination rows of the band.
+	 */
+	virtual bool canScaleInBands() const { return false; }
+
 protected:
+	enum {
+		/** Minimal number of source rows in a band */
+		kMinBandHeight = 16
+	};
+
+	/**
+	 * Parameters of a rect scaled in bands, for the tasks of the thread pool.
+	 */
+	struct BandParams {
+		Scaler *scaler;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width, height;
+		int x, y;
+		uint count;
+
+		/**
+		 * Compute the rows of a band, relative to the top of the rect.
+		 */
+		void getBand(uint index, int &top, int &bandHeight) const;
+	};
+
 	/**
 	 * @see scale
 	 */
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Scale a rect split in params.count bands, on the thread pool. The
+	 * default implementation runs scaleIntern() on each band.
+	 */
+	virtual void scaleInBands(const BandParams &params);
+
+	/**
+	 * The number of bands to split a rect of the given height into. 1 means
+	 * the rect is scaled on the calling thread.
+	 */
+	uint getBandCount(int height) const;
+
 	uint _factor;
 	Graphics::PixelFormat _format;
+	Common::ThreadPool *_threadPool;
+
+private:
+	static void scaleBand(void *param, uint index);
 };
 
 /**
@@ -210,6 +270,12 @@ class ScalerManager : public Common::Singleton<ScalerManager> {
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 
+	ScalerManager();
+	~ScalerManager();
+
+	Common::ThreadPool *_threadPool;
+	bool _threadPoolCreated;
+
 public:
 	const PluginList &getPlugins() const;
 
@@ -239,6 +305,13 @@ public:
 	 * Returns whether the supplied mode is one of the old gfx-modes.
 	 */
 	bool isOldGraphicsSetting(const Common::String &gfxMode);
+
+	/**
+	 * The worker threads shared by the scalers, created on first use from
+	 * the scaler_threads setting. Returns nullptr when the scalers should
+	 * only run on the calling thread.
+	 */
+	Common::ThreadPool *getThreadPool();
 };
 
 /** Convenience shortcut for accessing singleton */
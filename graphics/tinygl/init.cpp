@@ -32,6 +32,7 @@
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
+#include "graphics/tinygl/ztiles.h"
 
 namespace TinyGL {
 
@@ -93,11 +94,23 @@ namespace TinyGL {
 
 GLContext *gl_ctx;
 
+#ifdef USE_THREADS
+static thread_local GLContext *gl_thread_ctx = nullptr;
+#else
+static GLContext *gl_thread_ctx = nullptr;
+#endif
+
 GLContext *gl_get_context() {
+	if (gl_thread_ctx)
+		return gl_thread_ctx;
 	assert(gl_ctx);
 	return gl_ctx;
 }
 
+void gl_set_thread_context(GLContext *context) {
+	gl_thread_ctx = context;
+}
+
 ContextHandle *createContext(int screenW, int screenH, Graphics::PixelFormat pixelFormat, int textureSize,
 							 bool enableStencilBuffer, bool dirtyRectsEnable, uint32 drawCallMemorySize) {
 	gl_ctx = GLContextArray::instance().createContext();
@@ -353,11 +366,21 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[1].initialize(drawCallMemorySize);
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
+	_frameCache = nullptr;
+	_cachedDrawCallCount = 0;
+	_stableDrawCallCount = 0;
+	_tileRenderer = nullptr;
+	_copyDrawCallVertices = false;
 
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
 void GLContext::deinit() {
+	delete _tileRenderer;
+	_tileRenderer = nullptr;
+	delete _frameCache;
+	_frameCache = nullptr;
+
 	disposeDrawCallLists();
 	disposeResources();
 
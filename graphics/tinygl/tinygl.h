@@ -37,6 +37,11 @@ ContextHandle *createContext(int screenW, int screenH, Graphics::PixelFormat pix
 void destroyContext();
 void destroyContext(ContextHandle *handle);
 void setContext(ContextHandle *handle);
+// Set the number of threads running the draw calls of the current context
+// in presentBuffer(), including the calling one. 0 picks one per hardware
+// thread, and 1 or less runs them on the calling thread only. Call it
+// between frames.
+void setRenderThreadCount(int numThreads);
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
 void getSurfaceRef(Graphics::Surface &surface);
@@ -50,15 +50,29 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	else
 		_sbuf = nullptr;
 
+	_ownsBuffers = true;
+
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
 
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
+
+	// The span functions only write 32-bit pixels with 8-bit components
+	const bool spanFormat = _pbufBpp == 4 && _pbufFormat.rBits() == 8 && _pbufFormat.gBits() == 8 &&
+	                        _pbufFormat.bBits() == 8 && (_pbufFormat.aBits() == 0 || _pbufFormat.aBits() == 8);
+	_spanFunc = spanFormat ? getSpanFunc() : nullptr;
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer *target) {
+	*this = *target;
+	_ownsBuffers = false;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
@@ -181,6 +195,21 @@ void FrameBuffer::clearRegion(int x, int y, int w, int h, bool clearZ, int z,
 	}
 }
 
+void FrameBuffer::copyRegion(const FrameBuffer &src, const Common::Rect &rect) {
+	Common::Rect area = rect;
+	area.clip(Common::Rect(_pbufWidth, _pbufHeight));
+	if (area.isEmpty())
+		return;
+
+	const int w = area.width();
+	for (int y = area.top; y < area.bottom; y++) {
+		memcpy(_pbuf + y * _pbufPitch + area.left * _pbufBpp, src._pbuf + y * _pbufPitch + area.left * _pbufBpp, w * _pbufBpp);
+		memcpy(_zbuf + y * _pbufWidth + area.left, src._zbuf + y * _pbufWidth + area.left, w * sizeof(uint));
+		if (_sbuf && src._sbuf)
+			memcpy(_sbuf + y * _pbufWidth + area.left, src._sbuf + y * _pbufWidth + area.left, w);
+	}
+}
+
 inline static void blitPixel(uint8 offset, uint *from_z, uint *to_z, uint z_length, byte *from_color, byte *to_color, uint color_length) {
 	const uint d = from_z[offset];
 	if (d > to_z[offset]) {
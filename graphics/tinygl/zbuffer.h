@@ -31,6 +31,7 @@
 #include "graphics/surface.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 
 #include "common/rect.h"
 
@@ -104,6 +105,9 @@ struct ZBufferPoint {
 
 struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
+	// Frame buffer with a copy of the state of another one, drawing into its
+	// buffers. The buffers stay owned by the other frame buffer.
+	explicit FrameBuffer(const FrameBuffer *target);
 	~FrameBuffer();
 
 	Graphics::PixelFormat getPixelFormat() {
@@ -134,6 +138,10 @@ struct FrameBuffer {
 		return _zbuf;
 	}
 
+	bool hasStencilBuffer() {
+		return _sbuf != nullptr;
+	}
+
 	Graphics::Surface *copyFromFrameBuffer(const Graphics::PixelFormat &dstFormat) {
 		Graphics::Surface tmp;
 		tmp.init(_pbufWidth, _pbufHeight, _pbufPitch, _pbuf, _pbufFormat);
@@ -372,6 +380,13 @@ private:
 	template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 	void putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx);
 
+	bool canDrawSpans(bool blending) const {
+		return _spanFunc && (!blending || (isSpanBlendFactor(_sourceBlendingFactor) && isSpanBlendFactor(_destinationBlendingFactor)));
+	}
+
+	template <bool kEnableScissor>
+	FORCEINLINE void drawSpan(SpanArgs &args, int pixel, uint *pz, int x, const uint32 *texels, int count,
+	                          uint &z, uint &r, uint &g, uint &b, uint &a);
 
 	template <bool kEnableAlphaTest>
 	FORCEINLINE void writePixel(int pixel, int value) {
@@ -567,6 +582,9 @@ public:
 	           bool clearStencil, int stencilValue);
 	void clearRegion(int x, int y, int w, int h, bool clearZ, int z,
 	                 bool clearColor, int r, int g, int b, bool clearStencil, int stencilValue);
+	// Copy the color, depth and stencil of an area from a frame buffer of the
+	// same size and format
+	void copyRegion(const FrameBuffer &src, const Common::Rect &rect);
 
 	void setScissorRectangle(const Common::Rect &rect) {
 		_clipRectangle = rect;
@@ -750,6 +768,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -760,6 +779,8 @@ private:
 
 	const TexelBuffer *_currentTexture;
 	uint _wrapS, _wrapT;
+	// nullptr when the spans are drawn pixel by pixel
+	SpanFunc _spanFunc;
 	bool _blendingEnabled;
 	int _sourceBlendingFactor;
 	int _destinationBlendingFactor;
@@ -22,6 +22,7 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/ztiles.h"
 
 #include "common/debug.h"
 #include "common/math.h"
@@ -113,37 +114,9 @@ static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<Dirt
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
-void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas) {
-	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+static void _mergeDirtyRectangles(Common::List<DirtyRectangle> &rectangles) {
 	typedef Common::List<DirtyRectangle>::iterator RectangleIterator;
 
-	Common::List<DirtyRectangle> rectangles;
-
-	DrawCallIterator itFrame = _drawCallsQueue.begin();
-	DrawCallIterator endFrame = _drawCallsQueue.end();
-	DrawCallIterator itPrevFrame = _previousFrameDrawCallsQueue.begin();
-	DrawCallIterator endPrevFrame = _previousFrameDrawCallsQueue.end();
-
-	// Compare draw calls.
-	for ( ; itPrevFrame != endPrevFrame && itFrame != endFrame;
-		++itPrevFrame, ++itFrame) {
-			const DrawCall &currentCall = **itFrame;
-			const DrawCall &previousCall = **itPrevFrame;
-
-			if (previousCall != currentCall) {
-				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
-				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
-			}
-	}
-
-	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
-		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
-	}
-
-	for ( ; itFrame != endFrame; ++itFrame) {
-		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
-	}
-
 	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
 	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
 		(*it).rectangle.right++;
@@ -182,32 +155,133 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 			}
 		}
 	}
+}
+
+void GLContext::executeDrawCalls(Common::List<DrawCall *>::const_iterator begin, Common::List<DrawCall *>::const_iterator end,
+                                 const Common::List<Common::Rect> &areas) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::List<Common::Rect>::const_iterator RectangleIterator;
+
+	Common::List<DrawCall *> drawCalls;
+	for (DrawCallIterator it = begin; it != end; ++it)
+		drawCalls.push_back(*it);
+
+	if (_tileRenderer && _tileRenderer->execute(drawCalls, areas))
+		return;
+
+	for (DrawCallIterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		for (RectangleIterator itRect = areas.begin(); itRect != areas.end(); ++itRect) {
+			if (itRect->intersects(drawCallRegion)) {
+				(*it)->execute(*itRect, true);
+			}
+		}
+	}
+}
+
+void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::List<DirtyRectangle>::iterator RectangleIterator;
+
+	Common::List<DirtyRectangle> rectangles;
+
+	DrawCallIterator itFrame = _drawCallsQueue.begin();
+	DrawCallIterator endFrame = _drawCallsQueue.end();
+	DrawCallIterator itPrevFrame = _previousFrameDrawCallsQueue.begin();
+	DrawCallIterator endPrevFrame = _previousFrameDrawCallsQueue.end();
+
+	// Compare draw calls.
+	int stableCount = 0;
+	bool stable = true;
+	for ( ; itPrevFrame != endPrevFrame && itFrame != endFrame;
+		++itPrevFrame, ++itFrame) {
+			const DrawCall &currentCall = **itFrame;
+			const DrawCall &previousCall = **itPrevFrame;
+
+			if (previousCall != currentCall) {
+				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
+				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
+				stable = false;
+			} else if (stable) {
+				stableCount++;
+			}
+	}
+
+	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
+		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
+	}
+
+	for ( ; itFrame != endFrame; ++itFrame) {
+		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
+	}
+
+	// The frame cache stays valid while the frames start with the draw calls
+	// it was made from. Otherwise, it is made again from the leading draw
+	// calls once they are the same over two frames, so that it is not made
+	// every frame while they keep changing. Selection needs every draw call
+	// to run.
+	int cachedCount = 0;
+	bool fillCache = false;
+	if (render_mode == TGL_SELECT) {
+		stableCount = 0;
+	} else if (_frameCache && _cachedDrawCallCount > 0 && stableCount >= _cachedDrawCallCount) {
+		cachedCount = _cachedDrawCallCount;
+	} else if (stableCount > 0 && stableCount == _stableDrawCallCount) {
+		cachedCount = stableCount;
+		fillCache = true;
+	}
+	_cachedDrawCallCount = 0;
+	_stableDrawCallCount = stableCount;
+
+	DrawCallIterator firstUncached = _drawCallsQueue.begin();
+	for (int i = 0; i < cachedCount; i++)
+		++firstUncached;
+
+	// The pixels which the draw calls after the cached ones touch are needed
+	// to fill the cache, as they differ between the cache and the frame buffer.
+	if (fillCache) {
+		for (DrawCallIterator it = firstUncached; it != endFrame; ++it) {
+			_appendDirtyRectangle(**it, rectangles, 0, 255, 0);
+		}
+	}
+
+	_mergeDirtyRectangles(rectangles);
 
 	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
 		(*it1).rectangle.clip(renderRect);
 	}
 
-	if (!rectangles.empty()) {
-		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-			dirtyAreas.push_back((*itRect).rectangle);
-		}
+	Common::List<Common::Rect> areas;
+	for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+		dirtyAreas.push_back((*itRect).rectangle);
+		areas.push_back((*itRect).rectangle);
+	}
 
-		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
-				}
-			}
+	// Execute draw calls.
+	if (fillCache) {
+		if (!_frameCache) {
+			_frameCache = new FrameBuffer(fb->getPixelBufferWidth(), fb->getPixelBufferHeight(),
+			                              fb->getPixelFormat(), fb->hasStencilBuffer());
 		}
+		if (!areas.empty())
+			executeDrawCalls(_drawCallsQueue.begin(), firstUncached, areas);
+		_frameCache->copyRegion(*fb, Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
+		_cachedDrawCallCount = cachedCount;
+	} else if (cachedCount > 0) {
+		for (Common::List<Common::Rect>::const_iterator itRect = areas.begin(); itRect != areas.end(); ++itRect)
+			fb->copyRegion(*_frameCache, *itRect);
+		_cachedDrawCallCount = cachedCount;
+	}
+
+	if (!areas.empty()) {
+		executeDrawCalls(firstUncached, endFrame, areas);
 
 		if (_debugRectsEnabled) {
 			// Draw debug rectangles.
 			// Note: white rectangles are rectangle that contained other rectangles
 			// blue rectangles are rectangle merged from other rectangles
 			// red rectangles are original dirty rects
+			// green rectangles are redrawn to fill the frame cache
 
 			fb->enableBlending(false);
 			fb->enableAlphaTest(false);
@@ -240,8 +314,13 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
+	Common::List<Common::Rect> areas;
+	areas.push_back(dirtyAreas.back());
+	const bool executed = _tileRenderer && _tileRenderer->execute(_drawCallsQueue, areas);
+
 	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
+		if (!executed)
+			(*it)->execute(true);
 		delete *it;
 	}
 
@@ -295,7 +374,7 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
 	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	if (c->computesDirtyRegions()) {
 		computeDirtyRegion();
 	}
 }
@@ -345,7 +424,20 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	if (c->_copyDrawCallVertices) {
+		// Clipping and rasterizing write to the vertices, so work on a copy
+		if (_vertexCount > c->vertex_max) {
+			c->vertex_max = _vertexCount;
+			c->vertex = (GLVertex *)gl_realloc(c->vertex, sizeof(GLVertex) * c->vertex_max);
+			if (!c->vertex) {
+				error("unable to allocate GLVertex array.");
+			}
+			prevVertex = c->vertex;
+		}
+		memcpy(c->vertex, _vertex, sizeof(GLVertex) * _vertexCount);
+	} else {
+		c->vertex = _vertex;
+	}
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
@@ -573,7 +665,7 @@ BlittingDrawCall::BlittingDrawCall(BlitImage *image, const BlitTransform &transf
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (gl_get_context()->_enableDirtyRectangles) {
+	if (gl_get_context()->computesDirtyRegions()) {
 		computeDirtyRegion();
 	}
 }
@@ -613,6 +705,16 @@ void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool resto
 	Internal::tglBlitResetScissorRect();
 }
 
+bool BlittingDrawCall::canBeSplit() const {
+	if (_mode != BlitMode_Regular)
+		return true;
+
+	// Clipping the top of vertically flipped blits moves them, and scaled and
+	// rotated blits do not follow the clipping rectangle exactly.
+	const bool disableTransform = _transform._destinationRectangle.width() == 0 && _transform._destinationRectangle.height() == 0 && _transform._rotation == 0;
+	return disableTransform && !_transform._flipVertically;
+}
+
 BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
 	BlittingState state;
 	TinyGL::GLContext *c = gl_get_context();
@@ -690,7 +792,7 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	  _rValue(rValue), _gValue(gValue), _bValue(bValue), _clearStencilBuffer(clearStencilBuffer),
 	  _stencilValue(stencilValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->computesDirtyRegions()) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -57,6 +57,9 @@ public:
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
+	// Whether executing the draw call over the parts of an area, one after the
+	// other, gives the same pixels as executing it over the whole area.
+	virtual bool canBeSplit() const { return true; }
 protected:
 	Common::Rect _dirtyRegion;
 private:
@@ -168,6 +171,7 @@ public:
 	bool operator==(const BlittingDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual bool canBeSplit() const;
 
 	BlittingMode getBlittingMode() const { return _mode; }
 
@@ -275,6 +275,7 @@ private:
 };
 
 struct GLContext;
+class TileRenderer;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -463,6 +464,25 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Color, depth and stencil after the first _cachedDrawCallCount draw
+	// calls, which the last frames have in common. The dirty areas are
+	// restored from it, and only the draw calls after these are run again.
+	FrameBuffer *_frameCache;
+	int _cachedDrawCallCount;
+	// Number of leading draw calls the last frame had in common with the one
+	// before it
+	int _stableDrawCallCount;
+
+	// Runs the draw calls on several threads, when enabled
+	TileRenderer *_tileRenderer;
+	// Set on the contexts of the tile renderer, which run the same draw calls
+	// at the same time
+	bool _copyDrawCallVertices;
+
+	bool computesDirtyRegions() const {
+		return _enableDirtyRectangles || _tileRenderer;
+	}
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -518,6 +538,8 @@ public:
 	void disposeDrawCallLists();
 
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
+	void executeDrawCalls(Common::List<DrawCall *>::const_iterator begin, Common::List<DrawCall *>::const_iterator end,
+	                      const Common::List<Common::Rect> &areas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
 
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
@@ -551,6 +573,8 @@ public:
 
 extern GLContext *gl_ctx;
 GLContext *gl_get_context();
+// Override the current context on the calling thread only, or restore it with nullptr
+void gl_set_thread_context(GLContext *context);
 
 #define VERTEX_ARRAY    0x0001
 #define COLOR_ARRAY     0x0002
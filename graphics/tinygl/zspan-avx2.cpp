@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+/** Lanes of 8 pixels where the depth test passes, see testDepthSSE2() */
+static FORCEINLINE __m256i testDepthAVX2(int func, __m256i z, __m256i depth) {
+	const __m256i bias = _mm256_set1_epi32((int)0x80000000);
+	const __m256i zs = _mm256_xor_si256(z, bias);
+	const __m256i ds = _mm256_xor_si256(depth, bias);
+	const __m256i ones = _mm256_set1_epi32(-1);
+	switch (func) {
+	case TGL_LESS:
+		return _mm256_cmpgt_epi32(zs, ds);
+	case TGL_EQUAL:
+		return _mm256_cmpeq_epi32(z, depth);
+	case TGL_LEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(ds, zs), ones);
+	case TGL_GREATER:
+		return _mm256_cmpgt_epi32(ds, zs);
+	case TGL_NOTEQUAL:
+		return _mm256_xor_si256(_mm256_cmpeq_epi32(z, depth), ones);
+	case TGL_GEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(zs, ds), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm256_setzero_si256();
+	}
+}
+
+/** See roundDepthSSE2() */
+static FORCEINLINE __m256i roundDepthAVX2(__m256i z) {
+	const __m256 high = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(z, 16)), _mm256_set1_ps(65536.0f));
+	const __m256 f = _mm256_add_ps(high, _mm256_cvtepi32_ps(_mm256_and_si256(z, _mm256_set1_epi32(0xFFFF))));
+	const __m256 over = _mm256_cmp_ps(f, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+	const __m256i result = _mm256_cvttps_epi32(_mm256_sub_ps(f, _mm256_and_ps(over, _mm256_set1_ps(2147483648.0f))));
+	return _mm256_xor_si256(result, _mm256_and_si256(_mm256_castps_si256(over), _mm256_set1_epi32((int)0x80000000)));
+}
+
+/** See modulateSSE2() */
+static FORCEINLINE __m256i modulateAVX2(__m256i texel, __m256i color) {
+	return _mm256_srli_epi32(_mm256_mullo_epi16(texel, _mm256_and_si256(_mm256_srli_epi32(color, 8), _mm256_set1_epi32(0xFFFF))), 8);
+}
+
+static FORCEINLINE __m256i applyFactorAVX2(int factor, __m256i value, __m256i alpha) {
+	switch (factor) {
+	case TGL_ZERO:
+		return _mm256_setzero_si256();
+	case TGL_SRC_ALPHA:
+		return _mm256_srli_epi32(_mm256_mullo_epi16(value, alpha), 8);
+	case TGL_ONE_MINUS_SRC_ALPHA:
+		return _mm256_srli_epi32(_mm256_mullo_epi16(value, _mm256_sub_epi32(_mm256_set1_epi32(255), alpha)), 8);
+	default:
+		return value;
+	}
+}
+
+static FORCEINLINE __m256i blendAVX2(const SpanArgs &args, __m256i src, __m256i dst, __m256i alpha, __m128i shift) {
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	const __m256i d = _mm256_and_si256(_mm256_srl_epi32(dst, shift), mask);
+	const __m256i sum = _mm256_add_epi32(applyFactorAVX2(args.sfactor, src, alpha), applyFactorAVX2(args.dfactor, d, alpha));
+	return _mm256_min_epi16(sum, mask);
+}
+
+void drawSpanAVX2(const SpanArgs &args) {
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	const __m128i rShift = _mm_cvtsi32_si128(args.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(args.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(args.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(args.aShift);
+	const __m256i alphaFill = args.hasAlpha ? _mm256_sll_epi32(mask, aShift) : _mm256_setzero_si256();
+	const __m256i first = _mm256_set1_epi32(args.first - 1);
+	const __m256i last = _mm256_set1_epi32(args.last);
+
+	__m256i z = _mm256_setr_epi32(args.z, args.z + args.dzdx, args.z + 2 * args.dzdx, args.z + 3 * args.dzdx,
+	                              args.z + 4 * args.dzdx, args.z + 5 * args.dzdx, args.z + 6 * args.dzdx, args.z + 7 * args.dzdx);
+	__m256i r = _mm256_setr_epi32(args.r, args.r + args.drdx, args.r + 2 * args.drdx, args.r + 3 * args.drdx,
+	                              args.r + 4 * args.drdx, args.r + 5 * args.drdx, args.r + 6 * args.drdx, args.r + 7 * args.drdx);
+	__m256i g = _mm256_setr_epi32(args.g, args.g + args.dgdx, args.g + 2 * args.dgdx, args.g + 3 * args.dgdx,
+	                              args.g + 4 * args.dgdx, args.g + 5 * args.dgdx, args.g + 6 * args.dgdx, args.g + 7 * args.dgdx);
+	__m256i b = _mm256_setr_epi32(args.b, args.b + args.dbdx, args.b + 2 * args.dbdx, args.b + 3 * args.dbdx,
+	                              args.b + 4 * args.dbdx, args.b + 5 * args.dbdx, args.b + 6 * args.dbdx, args.b + 7 * args.dbdx);
+	__m256i a = _mm256_setr_epi32(args.a, args.a + args.dadx, args.a + 2 * args.dadx, args.a + 3 * args.dadx,
+	                              args.a + 4 * args.dadx, args.a + 5 * args.dadx, args.a + 6 * args.dadx, args.a + 7 * args.dadx);
+	const __m256i dz = _mm256_set1_epi32(8 * args.dzdx);
+	const __m256i dr = _mm256_set1_epi32(8 * args.drdx);
+	const __m256i dg = _mm256_set1_epi32(8 * args.dgdx);
+	const __m256i db = _mm256_set1_epi32(8 * args.dbdx);
+	const __m256i da = _mm256_set1_epi32(8 * args.dadx);
+
+	int i = 0;
+	for (; i + 8 <= args.count; i += 8) {
+		const __m256i index = _mm256_add_epi32(_mm256_set1_epi32(i), lanes);
+		__m256i write = _mm256_and_si256(_mm256_cmpgt_epi32(index, first), _mm256_cmpgt_epi32(last, index));
+		__m256i depth = _mm256_setzero_si256();
+		if (args.depthTest || args.depthWrite)
+			depth = _mm256_loadu_si256((const __m256i *)(args.depths + i));
+		if (args.depthTest)
+			write = _mm256_and_si256(write, testDepthAVX2(args.depthFunc, z, depth));
+
+		if (_mm256_movemask_epi8(write)) {
+			__m256i cA, cR, cG, cB;
+			if (args.texels) {
+				const __m256i texel = _mm256_loadu_si256((const __m256i *)(args.texels + i));
+				cA = modulateAVX2(_mm256_srli_epi32(texel, 24), a);
+				cR = modulateAVX2(_mm256_and_si256(_mm256_srli_epi32(texel, 16), mask), r);
+				cG = modulateAVX2(_mm256_and_si256(_mm256_srli_epi32(texel, 8), mask), g);
+				cB = modulateAVX2(_mm256_and_si256(texel, mask), b);
+			} else {
+				cA = _mm256_and_si256(_mm256_srli_epi32(a, 8), mask);
+				cR = _mm256_and_si256(_mm256_srli_epi32(r, 8), mask);
+				cG = _mm256_and_si256(_mm256_srli_epi32(g, 8), mask);
+				cB = _mm256_and_si256(_mm256_srli_epi32(b, 8), mask);
+			}
+
+			if (args.depthWrite) {
+				depth = _mm256_or_si256(_mm256_and_si256(write, roundDepthAVX2(z)), _mm256_andnot_si256(write, depth));
+				_mm256_storeu_si256((__m256i *)(args.depths + i), depth);
+			}
+
+			const __m256i dst = _mm256_loadu_si256((const __m256i *)(args.pixels + i));
+			__m256i color;
+			if (!args.blending) {
+				color = _mm256_or_si256(_mm256_sll_epi32(cR, rShift), _mm256_or_si256(_mm256_sll_epi32(cG, gShift), _mm256_sll_epi32(cB, bShift)));
+				if (args.hasAlpha)
+					color = _mm256_or_si256(color, _mm256_sll_epi32(cA, aShift));
+			} else {
+				color = _mm256_or_si256(alphaFill, _mm256_sll_epi32(blendAVX2(args, cR, dst, cA, rShift), rShift));
+				color = _mm256_or_si256(color, _mm256_sll_epi32(blendAVX2(args, cG, dst, cA, gShift), gShift));
+				color = _mm256_or_si256(color, _mm256_sll_epi32(blendAVX2(args, cB, dst, cA, bShift), bShift));
+			}
+			color = _mm256_or_si256(_mm256_and_si256(write, color), _mm256_andnot_si256(write, dst));
+			_mm256_storeu_si256((__m256i *)(args.pixels + i), color);
+		}
+
+		z = _mm256_add_epi32(z, dz);
+		r = _mm256_add_epi32(r, dr);
+		g = _mm256_add_epi32(g, dg);
+		b = _mm256_add_epi32(b, db);
+		a = _mm256_add_epi32(a, da);
+	}
+
+	if (i < args.count)
+		drawSpanGeneric(advanceSpan(args, i));
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
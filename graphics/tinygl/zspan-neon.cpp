@@ -0,0 +1,173 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace TinyGL {
+
+/** Lanes of 4 pixels where the depth test passes */
+static inline uint32x4_t testDepthNEON(int func, uint32x4_t z, uint32x4_t depth) {
+	switch (func) {
+	case TGL_LESS:
+		return vcltq_u32(depth, z);
+	case TGL_EQUAL:
+		return vceqq_u32(depth, z);
+	case TGL_LEQUAL:
+		return vcleq_u32(depth, z);
+	case TGL_GREATER:
+		return vcgtq_u32(depth, z);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_u32(depth, z));
+	case TGL_GEQUAL:
+		return vcgeq_u32(depth, z);
+	case TGL_ALWAYS:
+		return vdupq_n_u32(0xFFFFFFFF);
+	default:
+		return vdupq_n_u32(0);
+	}
+}
+
+static inline uint32x4_t applyFactorNEON(int factor, uint32x4_t value, uint32x4_t alpha) {
+	switch (factor) {
+	case TGL_ZERO:
+		return vdupq_n_u32(0);
+	case TGL_SRC_ALPHA:
+		return vshrq_n_u32(vmulq_u32(value, alpha), 8);
+	case TGL_ONE_MINUS_SRC_ALPHA:
+		return vshrq_n_u32(vmulq_u32(value, vsubq_u32(vdupq_n_u32(255), alpha)), 8);
+	default:
+		return value;
+	}
+}
+
+static inline uint32x4_t blendNEON(const SpanArgs &args, uint32x4_t src, uint32x4_t dst, uint32x4_t alpha, int shift) {
+	const uint32x4_t d = vandq_u32(vshlq_u32(dst, vdupq_n_s32(-shift)), vdupq_n_u32(0xFF));
+	const uint32x4_t sum = vaddq_u32(applyFactorNEON(args.sfactor, src, alpha), applyFactorNEON(args.dfactor, d, alpha));
+	return vshlq_u32(vminq_u32(sum, vdupq_n_u32(0xFF)), vdupq_n_s32(shift));
+}
+
+static inline uint32x4_t rampNEON(uint value, int step) {
+	const uint32 values[4] = { value, value + step, value + 2 * step, value + 3 * step };
+	return vld1q_u32(values);
+}
+
+void drawSpanNEON(const SpanArgs &args) {
+	const int32 laneValues[4] = { 0, 1, 2, 3 };
+	const int32x4_t lanes = vld1q_s32(laneValues);
+	const uint32x4_t mask = vdupq_n_u32(0xFF);
+	const int32x4_t rShift = vdupq_n_s32(args.rShift);
+	const int32x4_t gShift = vdupq_n_s32(args.gShift);
+	const int32x4_t bShift = vdupq_n_s32(args.bShift);
+	const int32x4_t aShift = vdupq_n_s32(args.aShift);
+	const uint32x4_t alphaFill = vdupq_n_u32(args.hasAlpha ? 0xFFu << args.aShift : 0);
+	const int32x4_t first = vdupq_n_s32(args.first);
+	const int32x4_t last = vdupq_n_s32(args.last);
+
+	uint32x4_t z = rampNEON(args.z, args.dzdx);
+	uint32x4_t r = rampNEON(args.r, args.drdx);
+	uint32x4_t g = rampNEON(args.g, args.dgdx);
+	uint32x4_t b = rampNEON(args.b, args.dbdx);
+	uint32x4_t a = rampNEON(args.a, args.dadx);
+	const uint32x4_t dz = vdupq_n_u32(4 * args.dzdx);
+	const uint32x4_t dr = vdupq_n_u32(4 * args.drdx);
+	const uint32x4_t dg = vdupq_n_u32(4 * args.dgdx);
+	const uint32x4_t db = vdupq_n_u32(4 * args.dbdx);
+	const uint32x4_t da = vdupq_n_u32(4 * args.dadx);
+
+	int i = 0;
+	for (; i + 4 <= args.count; i += 4) {
+		const int32x4_t index = vaddq_s32(vdupq_n_s32(i), lanes);
+		uint32x4_t write = vandq_u32(vcgeq_s32(index, first), vcltq_s32(index, last));
+		uint32x4_t depth = vdupq_n_u32(0);
+		if (args.depthTest || args.depthWrite)
+			depth = vld1q_u32((const uint32_t *)(args.depths + i));
+		if (args.depthTest)
+			write = vandq_u32(write, testDepthNEON(args.depthFunc, z, depth));
+
+		const uint32x2_t any = vorr_u32(vget_low_u32(write), vget_high_u32(write));
+		if (vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) {
+			uint32x4_t cA, cR, cG, cB;
+			if (args.texels) {
+				const uint32x4_t texel = vld1q_u32((const uint32_t *)(args.texels + i));
+				cA = vandq_u32(vshrq_n_u32(vmulq_u32(vshrq_n_u32(texel, 24), vshrq_n_u32(a, 8)), 8), mask);
+				cR = vandq_u32(vshrq_n_u32(vmulq_u32(vandq_u32(vshrq_n_u32(texel, 16), mask), vshrq_n_u32(r, 8)), 8), mask);
+				cG = vandq_u32(vshrq_n_u32(vmulq_u32(vandq_u32(vshrq_n_u32(texel, 8), mask), vshrq_n_u32(g, 8)), 8), mask);
+				cB = vandq_u32(vshrq_n_u32(vmulq_u32(vandq_u32(texel, mask), vshrq_n_u32(b, 8)), 8), mask);
+			} else {
+				cA = vandq_u32(vshrq_n_u32(a, 8), mask);
+				cR = vandq_u32(vshrq_n_u32(r, 8), mask);
+				cG = vandq_u32(vshrq_n_u32(g, 8), mask);
+				cB = vandq_u32(vshrq_n_u32(b, 8), mask);
+			}
+
+			if (args.depthWrite) {
+				depth = vbslq_u32(write, vcvtq_u32_f32(vcvtq_f32_u32(z)), depth);
+				vst1q_u32((uint32_t *)(args.depths + i), depth);
+			}
+
+			const uint32x4_t dst = vld1q_u32((const uint32_t *)(args.pixels + i));
+			uint32x4_t color;
+			if (!args.blending) {
+				color = vorrq_u32(vshlq_u32(cR, rShift), vorrq_u32(vshlq_u32(cG, gShift), vshlq_u32(cB, bShift)));
+				if (args.hasAlpha)
+					color = vorrq_u32(color, vshlq_u32(cA, aShift));
+			} else {
+				color = vorrq_u32(alphaFill, blendNEON(args, cR, dst, cA, args.rShift));
+				color = vorrq_u32(color, blendNEON(args, cG, dst, cA, args.gShift));
+				color = vorrq_u32(color, blendNEON(args, cB, dst, cA, args.bShift));
+			}
+			vst1q_u32((uint32_t *)(args.pixels + i), vbslq_u32(write, color, dst));
+		}
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	if (i < args.count)
+		drawSpanGeneric(advanceSpan(args, i));
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace TinyGL {
+
+/** Lanes where the depth test passes, with unsigned compares made from the signed ones */
+static FORCEINLINE __m128i testDepthSSE2(int func, __m128i z, __m128i depth) {
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i zs = _mm_xor_si128(z, bias);
+	const __m128i ds = _mm_xor_si128(depth, bias);
+	const __m128i ones = _mm_set1_epi32(-1);
+	switch (func) {
+	case TGL_LESS:
+		return _mm_cmpgt_epi32(zs, ds);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(z, depth);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(ds, zs), ones);
+	case TGL_GREATER:
+		return _mm_cmpgt_epi32(ds, zs);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(z, depth), ones);
+	case TGL_GEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(zs, ds), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+/** (uint)(float)z, over the whole range of z */
+static FORCEINLINE __m128i roundDepthSSE2(__m128i z) {
+	const __m128 high = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(z, 16)), _mm_set1_ps(65536.0f));
+	const __m128 f = _mm_add_ps(high, _mm_cvtepi32_ps(_mm_and_si128(z, _mm_set1_epi32(0xFFFF))));
+	const __m128 over = _mm_cmpge_ps(f, _mm_set1_ps(2147483648.0f));
+	const __m128i result = _mm_cvttps_epi32(_mm_sub_ps(f, _mm_and_ps(over, _mm_set1_ps(2147483648.0f))));
+	return _mm_xor_si128(result, _mm_and_si128(_mm_castps_si128(over), _mm_set1_epi32((int)0x80000000)));
+}
+
+/** Texel component times the top bits of the color, both below 2^16 */
+static FORCEINLINE __m128i modulateSSE2(__m128i texel, __m128i color) {
+	return _mm_srli_epi32(_mm_mullo_epi16(texel, _mm_and_si128(_mm_srli_epi32(color, 8), _mm_set1_epi32(0xFFFF))), 8);
+}
+
+static FORCEINLINE __m128i applyFactorSSE2(int factor, __m128i value, __m128i alpha) {
+	switch (factor) {
+	case TGL_ZERO:
+		return _mm_setzero_si128();
+	case TGL_SRC_ALPHA:
+		return _mm_srli_epi32(_mm_mullo_epi16(value, alpha), 8);
+	case TGL_ONE_MINUS_SRC_ALPHA:
+		return _mm_srli_epi32(_mm_mullo_epi16(value, _mm_sub_epi32(_mm_set1_epi32(255), alpha)), 8);
+	default:
+		return value;
+	}
+}
+
+static FORCEINLINE __m128i blendSSE2(const SpanArgs &args, __m128i src, __m128i dst, __m128i alpha, __m128i shift) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i d = _mm_and_si128(_mm_srl_epi32(dst, shift), mask);
+	const __m128i sum = _mm_add_epi32(applyFactorSSE2(args.sfactor, src, alpha), applyFactorSSE2(args.dfactor, d, alpha));
+	// Both halves of the lanes are positive 16-bit values
+	return _mm_min_epi16(sum, mask);
+}
+
+void drawSpanSSE2(const SpanArgs &args) {
+	const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i rShift = _mm_cvtsi32_si128(args.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(args.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(args.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(args.aShift);
+	const __m128i alphaFill = args.hasAlpha ? _mm_sll_epi32(mask, aShift) : _mm_setzero_si128();
+	const __m128i first = _mm_set1_epi32(args.first - 1);
+	const __m128i last = _mm_set1_epi32(args.last);
+
+	__m128i z = _mm_setr_epi32(args.z, args.z + args.dzdx, args.z + 2 * args.dzdx, args.z + 3 * args.dzdx);
+	__m128i r = _mm_setr_epi32(args.r, args.r + args.drdx, args.r + 2 * args.drdx, args.r + 3 * args.drdx);
+	__m128i g = _mm_setr_epi32(args.g, args.g + args.dgdx, args.g + 2 * args.dgdx, args.g + 3 * args.dgdx);
+	__m128i b = _mm_setr_epi32(args.b, args.b + args.dbdx, args.b + 2 * args.dbdx, args.b + 3 * args.dbdx);
+	__m128i a = _mm_setr_epi32(args.a, args.a + args.dadx, args.a + 2 * args.dadx, args.a + 3 * args.dadx);
+	const __m128i dz = _mm_set1_epi32(4 * args.dzdx);
+	const __m128i dr = _mm_set1_epi32(4 * args.drdx);
+	const __m128i dg = _mm_set1_epi32(4 * args.dgdx);
+	const __m128i db = _mm_set1_epi32(4 * args.dbdx);
+	const __m128i da = _mm_set1_epi32(4 * args.dadx);
+
+	int i = 0;
+	for (; i + 4 <= args.count; i += 4) {
+		const __m128i index = _mm_add_epi32(_mm_set1_epi32(i), lanes);
+		__m128i write = _mm_and_si128(_mm_cmpgt_epi32(index, first), _mm_cmplt_epi32(index, last));
+		__m128i depth = _mm_setzero_si128();
+		if (args.depthTest || args.depthWrite)
+			depth = _mm_loadu_si128((const __m128i *)(args.depths + i));
+		if (args.depthTest)
+			write = _mm_and_si128(write, testDepthSSE2(args.depthFunc, z, depth));
+
+		if (_mm_movemask_epi8(write)) {
+			__m128i cA, cR, cG, cB;
+			if (args.texels) {
+				const __m128i texel = _mm_loadu_si128((const __m128i *)(args.texels + i));
+				cA = modulateSSE2(_mm_srli_epi32(texel, 24), a);
+				cR = modulateSSE2(_mm_and_si128(_mm_srli_epi32(texel, 16), mask), r);
+				cG = modulateSSE2(_mm_and_si128(_mm_srli_epi32(texel, 8), mask), g);
+				cB = modulateSSE2(_mm_and_si128(texel, mask), b);
+			} else {
+				cA = _mm_and_si128(_mm_srli_epi32(a, 8), mask);
+				cR = _mm_and_si128(_mm_srli_epi32(r, 8), mask);
+				cG = _mm_and_si128(_mm_srli_epi32(g, 8), mask);
+				cB = _mm_and_si128(_mm_srli_epi32(b, 8), mask);
+			}
+
+			if (args.depthWrite) {
+				depth = _mm_or_si128(_mm_and_si128(write, roundDepthSSE2(z)), _mm_andnot_si128(write, depth));
+				_mm_storeu_si128((__m128i *)(args.depths + i), depth);
+			}
+
+			const __m128i dst = _mm_loadu_si128((const __m128i *)(args.pixels + i));
+			__m128i color;
+			if (!args.blending) {
+				color = _mm_or_si128(_mm_sll_epi32(cR, rShift), _mm_or_si128(_mm_sll_epi32(cG, gShift), _mm_sll_epi32(cB, bShift)));
+				if (args.hasAlpha)
+					color = _mm_or_si128(color, _mm_sll_epi32(cA, aShift));
+			} else {
+				color = _mm_or_si128(alphaFill, _mm_sll_epi32(blendSSE2(args, cR, dst, cA, rShift), rShift));
+				color = _mm_or_si128(color, _mm_sll_epi32(blendSSE2(args, cG, dst, cA, gShift), gShift));
+				color = _mm_or_si128(color, _mm_sll_epi32(blendSSE2(args, cB, dst, cA, bShift), bShift));
+			}
+			color = _mm_or_si128(_mm_and_si128(write, color), _mm_andnot_si128(write, dst));
+			_mm_storeu_si128((__m128i *)(args.pixels + i), color);
+		}
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	if (i < args.count)
+		drawSpanGeneric(advanceSpan(args, i));
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
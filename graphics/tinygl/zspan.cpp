@@ -0,0 +1,158 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+static inline bool testDepth(int func, uint z, uint depth) {
+	switch (func) {
+	case TGL_LESS:
+		return depth < z;
+	case TGL_EQUAL:
+		return depth == z;
+	case TGL_LEQUAL:
+		return depth <= z;
+	case TGL_GREATER:
+		return depth > z;
+	case TGL_NOTEQUAL:
+		return depth != z;
+	case TGL_GEQUAL:
+		return depth >= z;
+	case TGL_ALWAYS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static inline uint applyFactor(int factor, uint value, uint alpha) {
+	switch (factor) {
+	case TGL_ZERO:
+		return 0;
+	case TGL_SRC_ALPHA:
+		return (value * alpha) >> 8;
+	case TGL_ONE_MINUS_SRC_ALPHA:
+		return (value * (255 - alpha)) >> 8;
+	default:
+		return value;
+	}
+}
+
+void drawSpanGeneric(const SpanArgs &args) {
+	uint z = args.z, r = args.r, g = args.g, b = args.b, a = args.a;
+	for (int i = 0; i < args.count; i++, z += args.dzdx, r += args.drdx, g += args.dgdx, b += args.dbdx, a += args.dadx) {
+		if (i < args.first || i >= args.last)
+			continue;
+		if (args.depthTest && !testDepth(args.depthFunc, z, args.depths[i]))
+			continue;
+
+		uint cA, cR, cG, cB;
+		if (args.texels) {
+			const uint32 texel = args.texels[i];
+			cA = (((texel >> 24) * (a >> 8)) >> 8) & 0xFF;
+			cR = ((((texel >> 16) & 0xFF) * (r >> 8)) >> 8) & 0xFF;
+			cG = ((((texel >> 8) & 0xFF) * (g >> 8)) >> 8) & 0xFF;
+			cB = (((texel & 0xFF) * (b >> 8)) >> 8) & 0xFF;
+		} else {
+			cA = (a >> 8) & 0xFF;
+			cR = (r >> 8) & 0xFF;
+			cG = (g >> 8) & 0xFF;
+			cB = (b >> 8) & 0xFF;
+		}
+
+		// The depth goes through a float, as in FrameBuffer::writePixel()
+		if (args.depthWrite)
+			args.depths[i] = (uint)(float)z;
+
+		if (!args.blending) {
+			args.pixels[i] = (args.hasAlpha ? cA << args.aShift : 0) |
+			                 (cR << args.rShift) | (cG << args.gShift) | (cB << args.bShift);
+			continue;
+		}
+
+		const uint32 dst = args.pixels[i];
+		const uint dR = (dst >> args.rShift) & 0xFF;
+		const uint dG = (dst >> args.gShift) & 0xFF;
+		const uint dB = (dst >> args.bShift) & 0xFF;
+		const uint fR = MIN<uint>(applyFactor(args.sfactor, cR, cA) + applyFactor(args.dfactor, dR, cA), 255);
+		const uint fG = MIN<uint>(applyFactor(args.sfactor, cG, cA) + applyFactor(args.dfactor, dG, cA), 255);
+		const uint fB = MIN<uint>(applyFactor(args.sfactor, cB, cA) + applyFactor(args.dfactor, dB, cA), 255);
+		args.pixels[i] = (args.hasAlpha ? 0xFFu << args.aShift : 0) |
+		                 (fR << args.rShift) | (fG << args.gShift) | (fB << args.bShift);
+	}
+}
+
+bool isSpanBlendFactor(int factor) {
+	return factor == TGL_ZERO || factor == TGL_ONE || factor == TGL_SRC_ALPHA || factor == TGL_ONE_MINUS_SRC_ALPHA;
+}
+
+SpanArgs advanceSpan(const SpanArgs &args, int count) {
+	SpanArgs rest = args;
+	rest.pixels += count;
+	rest.depths += count;
+	if (rest.texels)
+		rest.texels += count;
+	rest.count -= count;
+	rest.first -= count;
+	rest.last -= count;
+	rest.z += count * args.dzdx;
+	rest.r += count * args.drdx;
+	rest.g += count * args.dgdx;
+	rest.b += count * args.dbdx;
+	rest.a += count * args.dadx;
+	return rest;
+}
+
+static SpanFunc spanFunc = nullptr;
+static bool spanFuncSet = false;
+
+SpanFunc getSpanFunc() {
+	// Without an OSystem, the CPU features are unknown, so draw pixel by pixel
+	// until there is one
+	if (!spanFuncSet && g_system) {
+		SpanFunc func = nullptr;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			func = drawSpanNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			func = drawSpanSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			func = drawSpanAVX2;
+#endif
+		setSpanFunc(func);
+	}
+	return spanFunc;
+}
+
+void setSpanFunc(SpanFunc func) {
+	spanFunc = func;
+	spanFuncSet = true;
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+// A horizontal run of pixels of a triangle, drawn in one go into a 32-bit
+// color buffer with 8-bit components. The span functions give the same
+// pixels as FrameBuffer::putPixelNoTexture() and putPixelTexture(), without
+// fog, alpha test or stencil.
+struct SpanArgs {
+	uint32 *pixels;
+	uint *depths;
+	// One texel per pixel, as (a << 24) | (r << 16) | (g << 8) | b, modulated
+	// by the interpolated color. nullptr for untextured triangles.
+	const uint32 *texels;
+	int count;
+	// Pixels outside of [first, last) are scissored
+	int first, last;
+
+	// Interpolated values at the first pixel, and their steps. The colors
+	// are in the fixed point format of ZBufferPoint.
+	uint z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+
+	// State of the triangle
+	bool depthTest;
+	bool depthWrite;
+	int depthFunc;
+	bool blending;
+	int sfactor, dfactor;
+	byte rShift, gShift, bShift, aShift;
+	bool hasAlpha;
+};
+
+typedef void (*SpanFunc)(const SpanArgs &args);
+
+void drawSpanGeneric(const SpanArgs &args);
+#ifdef SCUMMVM_NEON
+void drawSpanNEON(const SpanArgs &args);
+#endif
+#ifdef SCUMMVM_SSE2
+void drawSpanSSE2(const SpanArgs &args);
+#endif
+#ifdef SCUMMVM_AVX2
+void drawSpanAVX2(const SpanArgs &args);
+#endif
+
+// Whether the span functions implement the given blending factor
+bool isSpanBlendFactor(int factor);
+
+// Skip the first pixels of a span, for the kernels which leave the end of
+// a span to drawSpanGeneric()
+SpanArgs advanceSpan(const SpanArgs &args, int count);
+
+// The span function of new frame buffers. Unless set, it is picked from the
+// CPU features the first time it is asked for, and is nullptr when there is
+// no vector unit: the rasterizer then draws the spans pixel by pixel.
+SpanFunc getSpanFunc();
+void setSpanFunc(SpanFunc func);
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/ztiles.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zdirtyrect.h"
+#include "graphics/tinygl/zgl.h"
+
+namespace TinyGL {
+
+TileRenderer::TileRenderer(GLContext *context, uint numThreads) : _context(context), _pool(numThreads) {
+	const int width = context->fb->getPixelBufferWidth();
+	const int height = context->fb->getPixelBufferHeight();
+	for (int top = 0; top < height; top += kTileHeight) {
+		Tile tile;
+		tile.rect = Common::Rect(0, top, width, MIN(top + kTileHeight, height));
+
+		// Only the fields used to execute draw calls are set, the others are zeroed
+		tile.context = new GLContext();
+		tile.context->vertex_max = POLYGON_MAX_VERTEX;
+		tile.context->vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+		tile.context->_copyDrawCallVertices = true;
+		// Scales the texture coordinates of the vertices made by clipping
+		tile.context->_textureSize = context->_textureSize;
+
+		_tiles.push_back(tile);
+	}
+}
+
+TileRenderer::~TileRenderer() {
+	for (uint i = 0; i < _tiles.size(); i++) {
+		gl_free(_tiles[i].context->vertex);
+		delete _tiles[i].context;
+	}
+}
+
+bool TileRenderer::execute(const Common::List<DrawCall *> &drawCalls, const Common::List<Common::Rect> &areas) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::List<Common::Rect>::const_iterator RectangleIterator;
+
+	// Selection writes to the selection buffer of the context
+	if (_context->render_mode == TGL_SELECT)
+		return false;
+
+	for (DrawCallIterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		if (!(*it)->canBeSplit())
+			return false;
+	}
+
+	for (uint i = 0; i < _tiles.size(); i++) {
+		Tile &tile = _tiles[i];
+		tile.areas.clear();
+		tile.drawCalls.clear();
+		for (RectangleIterator it = areas.begin(); it != areas.end(); ++it) {
+			if (it->intersects(tile.rect))
+				tile.areas.push_back(it->findIntersectingRect(tile.rect));
+		}
+	}
+
+	// Bin the draw calls
+	for (DrawCallIterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		const Common::Rect region = (*it)->getDirtyRegion();
+		if (region.isEmpty())
+			continue;
+
+		const uint first = MAX<int>(region.top, 0) / kTileHeight;
+		const uint last = MIN<uint>((region.bottom - 1) / kTileHeight, _tiles.size() - 1);
+		for (uint i = first; i <= last; i++) {
+			Tile &tile = _tiles[i];
+			for (uint j = 0; j < tile.areas.size(); j++) {
+				if (tile.areas[j].intersects(region)) {
+					tile.drawCalls.push_back(*it);
+					break;
+				}
+			}
+		}
+	}
+
+	for (uint i = 0; i < _tiles.size(); i++)
+		prepareContext(_tiles[i].context);
+
+	_pool.run(executeTile, this, _tiles.size());
+
+	for (uint i = 0; i < _tiles.size(); i++) {
+		delete _tiles[i].context->fb;
+		_tiles[i].context->fb = nullptr;
+	}
+
+	return true;
+}
+
+void TileRenderer::prepareContext(GLContext *tileContext) const {
+	tileContext->fb = new FrameBuffer(_context->fb);
+	tileContext->renderRect = _context->renderRect;
+	tileContext->_scissorRect = _context->renderRect;
+
+	// Draw calls do not record these, and read them from the context
+	tileContext->current_cull_face = _context->current_cull_face;
+	tileContext->render_mode = _context->render_mode;
+	tileContext->vertex_n = _context->vertex_n;
+	tileContext->_profilingEnabled = _context->_profilingEnabled;
+}
+
+void TileRenderer::executeTile(void *param, uint index) {
+	const Tile &tile = ((const TileRenderer *)param)->_tiles[index];
+	if (tile.drawCalls.empty())
+		return;
+
+	gl_set_thread_context(tile.context);
+	for (uint i = 0; i < tile.drawCalls.size(); i++) {
+		const DrawCall *drawCall = tile.drawCalls[i];
+		const Common::Rect region = drawCall->getDirtyRegion();
+		for (uint j = 0; j < tile.areas.size(); j++) {
+			if (tile.areas[j].intersects(region))
+				drawCall->execute(tile.areas[j], false);
+		}
+	}
+	gl_set_thread_context(nullptr);
+}
+
+void setRenderThreadCount(int numThreads) {
+	GLContext *c = gl_get_context();
+	delete c->_tileRenderer;
+	c->_tileRenderer = nullptr;
+
+	if (numThreads == 0)
+		numThreads = Common::ThreadPool::getHardwareThreadCount();
+	if (numThreads > 1)
+		c->_tileRenderer = new TileRenderer(c, numThreads);
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZTILES_H
+#define GRAPHICS_TINYGL_ZTILES_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+#include "common/threadpool.h"
+
+namespace TinyGL {
+
+struct GLContext;
+struct FrameBuffer;
+class DrawCall;
+
+// Runs the draw calls of a frame on several threads.
+//
+// The frame buffer is split in tiles spanning its whole width, so that the
+// scanline rasterizer can skip the rows outside of a tile. Each draw call is
+// binned in the tiles its dirty region covers, and each tile runs its draw
+// calls in order, scissored to the tile, with a context of its own. The
+// tiles share the color, depth and stencil buffers of the frame buffer.
+class TileRenderer {
+public:
+	static const int kTileHeight = 32;
+
+	TileRenderer(GLContext *context, uint numThreads);
+	~TileRenderer();
+
+	uint getThreadCount() const { return _pool.getThreadCount(); }
+
+	// Execute the draw calls over the given areas of the frame buffer. The
+	// state of the context is left untouched.
+	//
+	// Returns false, without executing anything, when a draw call cannot be
+	// split over the tiles. The caller then executes the frame itself.
+	bool execute(const Common::List<DrawCall *> &drawCalls, const Common::List<Common::Rect> &areas);
+
+private:
+	struct Tile {
+		Common::Rect rect;
+		GLContext *context;
+		Common::Array<Common::Rect> areas;
+		Common::Array<const DrawCall *> drawCalls;
+	};
+
+	static void executeTile(void *param, uint index);
+	void prepareContext(GLContext *tileContext) const;
+
+	GLContext *_context;
+	Common::ThreadPool _pool;
+	Common::Array<Tile> _tiles;
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -39,29 +39,26 @@ void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
                                     int &dzdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
                                     uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
+	// Discarded pixels still step the interpolated values
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
-		return;
-	}
-	if (kStencilEnabled) {
-		bool stencilResult = stencilTest(ps[_a]);
-		if (!stencilResult) {
-			stencilOp(false, true, ps + _a);
-			return;
-		}
-	}
-	bool depthTestResult;
-	if (kDepthTestEnabled) {
-		depthTestResult = compareDepth(z, pz[_a]);
+		// scissored
+	} else if (kStencilEnabled && !stencilTest(ps[_a])) {
+		stencilOp(false, true, ps + _a);
 	} else {
-		depthTestResult = true;
-	}
-	if (kStencilEnabled) {
-		stencilOp(true, depthTestResult, ps + _a);
-	}
-	if (depthTestResult) {
-		writePixel<kEnableAlphaTest, kEnableBlending, kDepthWrite, kFogMode>
-		          (fbOffset + _a, a >> (ZB_POINT_ALPHA_BITS - 8), r >> (ZB_POINT_RED_BITS - 8), g >> (ZB_POINT_GREEN_BITS - 8), b >> (ZB_POINT_BLUE_BITS - 8),
-		          z, fog, fog_r, fog_g, fog_b);
+		bool depthTestResult;
+		if (kDepthTestEnabled) {
+			depthTestResult = compareDepth(z, pz[_a]);
+		} else {
+			depthTestResult = true;
+		}
+		if (kStencilEnabled) {
+			stencilOp(true, depthTestResult, ps + _a);
+		}
+		if (depthTestResult) {
+			writePixel<kEnableAlphaTest, kEnableBlending, kDepthWrite, kFogMode>
+			          (fbOffset + _a, a >> (ZB_POINT_ALPHA_BITS - 8), r >> (ZB_POINT_RED_BITS - 8), g >> (ZB_POINT_GREEN_BITS - 8), b >> (ZB_POINT_BLUE_BITS - 8),
+			          z, fog, fog_r, fog_g, fog_b);
+		}
 	}
 	z += dzdx;
 	if (kFogMode) {
@@ -82,39 +79,36 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
                                   uint &r, uint &g, uint &b, uint &a,
                                   int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
                                   uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
+	// Discarded pixels still step the interpolated values
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
-		return;
-	}
-	if (kStencilEnabled) {
-		bool stencilResult = stencilTest(ps[_a]);
-		if (!stencilResult) {
-			stencilOp(false, true, ps + _a);
-			return;
-		}
-	}
-	bool depthTestResult;
-	if (kDepthTestEnabled) {
-		depthTestResult = compareDepth(z, pz[_a]);
+		// scissored
+	} else if (kStencilEnabled && !stencilTest(ps[_a])) {
+		stencilOp(false, true, ps + _a);
 	} else {
-		depthTestResult = true;
-	}
-	if (kStencilEnabled) {
-		stencilOp(true, depthTestResult, ps + _a);
-	}
-	if (depthTestResult) {
-		uint8 c_a, c_r, c_g, c_b;
-		texture->getARGBAt(wrap_s, wrap_t, s, t, c_a, c_r, c_g, c_b);
-		if (kLightsMode) {
-			uint l_a = (a >> (ZB_POINT_ALPHA_BITS - 8));
-			uint l_r = (r >> (ZB_POINT_RED_BITS - 8));
-			uint l_g = (g >> (ZB_POINT_GREEN_BITS - 8));
-			uint l_b = (b >> (ZB_POINT_BLUE_BITS - 8));
-			c_a = (c_a * l_a) >> (ZB_POINT_ALPHA_BITS - 8);
-			c_r = (c_r * l_r) >> (ZB_POINT_RED_BITS - 8);
-			c_g = (c_g * l_g) >> (ZB_POINT_GREEN_BITS - 8);
-			c_b = (c_b * l_b) >> (ZB_POINT_BLUE_BITS - 8);
+		bool depthTestResult;
+		if (kDepthTestEnabled) {
+			depthTestResult = compareDepth(z, pz[_a]);
+		} else {
+			depthTestResult = true;
+		}
+		if (kStencilEnabled) {
+			stencilOp(true, depthTestResult, ps + _a);
+		}
+		if (depthTestResult) {
+			uint8 c_a, c_r, c_g, c_b;
+			texture->getARGBAt(wrap_s, wrap_t, s, t, c_a, c_r, c_g, c_b);
+			if (kLightsMode) {
+				uint l_a = (a >> (ZB_POINT_ALPHA_BITS - 8));
+				uint l_r = (r >> (ZB_POINT_RED_BITS - 8));
+				uint l_g = (g >> (ZB_POINT_GREEN_BITS - 8));
+				uint l_b = (b >> (ZB_POINT_BLUE_BITS - 8));
+				c_a = (c_a * l_a) >> (ZB_POINT_ALPHA_BITS - 8);
+				c_r = (c_r * l_r) >> (ZB_POINT_RED_BITS - 8);
+				c_g = (c_g * l_g) >> (ZB_POINT_GREEN_BITS - 8);
+				c_b = (c_b * l_b) >> (ZB_POINT_BLUE_BITS - 8);
+			}
+			writePixel<kEnableAlphaTest, kEnableBlending, kDepthWrite, kFogMode>(fbOffset + _a, c_a, c_r, c_g, c_b, z, fog, fog_r, fog_g, fog_b);
 		}
-		writePixel<kEnableAlphaTest, kEnableBlending, kDepthWrite, kFogMode>(fbOffset + _a, c_a, c_r, c_g, c_b, z, fog, fog_r, fog_g, fog_b);
 	}
 	z += dzdx;
 	s += dsdx;
@@ -132,31 +126,63 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
 
 template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx) {
+	// Discarded pixels still step the interpolated values
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
-		return;
-	}
-	if (kStencilEnabled) {
-		bool stencilResult = stencilTest(ps[_a]);
-		if (!stencilResult) {
-			stencilOp(false, true, ps + _a);
-			return;
-		}
-	}
-	bool depthTestResult;
-	if (kDepthTestEnabled) {
-		depthTestResult = compareDepth(z, pz[_a]);
+		// scissored
+	} else if (kStencilEnabled && !stencilTest(ps[_a])) {
+		stencilOp(false, true, ps + _a);
 	} else {
-		depthTestResult = true;
-	}
-	if (kStencilEnabled) {
-		stencilOp(true, depthTestResult, ps + _a);
-	}
-	if (kDepthWrite && depthTestResult) {
-		pz[_a] = z;
+		bool depthTestResult;
+		if (kDepthTestEnabled) {
+			depthTestResult = compareDepth(z, pz[_a]);
+		} else {
+			depthTestResult = true;
+		}
+		if (kStencilEnabled) {
+			stencilOp(true, depthTestResult, ps + _a);
+		}
+		if (kDepthWrite && depthTestResult) {
+			pz[_a] = z;
+		}
 	}
 	z += dzdx;
 }
 
+template <bool kEnableScissor>
+void FrameBuffer::drawSpan(SpanArgs &args, int pixel, uint *pz, int x, const uint32 *texels, int count,
+                           uint &z, uint &r, uint &g, uint &b, uint &a) {
+	if (count <= 0)
+		return;
+	args.pixels = (uint32 *)_pbuf + pixel;
+	args.depths = pz;
+	args.texels = texels;
+	args.count = count;
+	args.first = kEnableScissor ? _clipRectangle.left - x : 0;
+	args.last = kEnableScissor ? _clipRectangle.right - x : count;
+	args.z = z;
+	args.r = r;
+	args.g = g;
+	args.b = b;
+	args.a = a;
+	_spanFunc(args);
+	z += count * args.dzdx;
+	r += count * args.drdx;
+	g += count * args.dgdx;
+	b += count * args.dbdx;
+	a += count * args.dadx;
+}
+
+static FORCEINLINE void fetchTexels(const TexelBuffer *texture, uint wrapS, uint wrapT, int s, int t, int dsdx, int dtdx,
+                                    uint32 *texels, int count) {
+	for (int i = 0; i < count; i++) {
+		uint8 a, r, g, b;
+		texture->getARGBAt(wrapS, wrapT, s, t, a, r, g, b);
+		texels[i] = ((uint32)a << 24) | (r << 16) | (g << 8) | b;
+		s += dsdx;
+		t += dtdx;
+	}
+}
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode,
           bool kDepthWrite, bool kFogMode, bool kAlphaTestEnabled, bool kEnableScissor,
           bool kBlendingEnabled, bool kStencilEnabled, bool kDepthTestEnabled>
@@ -207,6 +233,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	// the scissor rectangle may only keep a band of rows, as in the tile renderer
+	if (kEnableScissor && (p2->y < _clipRectangle.top || p0->y >= _clipRectangle.bottom))
+		return;
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -325,6 +355,29 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// The span function draws the common triangles several pixels at a time
+	SpanArgs spans;
+	const bool useSpans = kInterpRGB && kInterpZ && !kFogMode && !kAlphaTestEnabled && !kStencilEnabled &&
+	                      canDrawSpans(kBlendingEnabled);
+	if (useSpans) {
+		spans.dzdx = dzdx;
+		spans.drdx = kSmoothMode ? drdx : 0;
+		spans.dgdx = kSmoothMode ? dgdx : 0;
+		spans.dbdx = kSmoothMode ? dbdx : 0;
+		spans.dadx = kSmoothMode ? dadx : 0;
+		spans.depthTest = kDepthTestEnabled && _depthTestEnabled;
+		spans.depthWrite = kDepthWrite;
+		spans.depthFunc = _depthFunc;
+		spans.blending = kBlendingEnabled;
+		spans.sfactor = _sourceBlendingFactor;
+		spans.dfactor = _destinationBlendingFactor;
+		spans.rShift = _pbufFormat.rShift;
+		spans.gShift = _pbufFormat.gShift;
+		spans.bShift = _pbufFormat.bShift;
+		spans.aShift = _pbufFormat.aShift;
+		spans.hasAlpha = _pbufFormat.aBits() != 0;
+	}
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -424,7 +477,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// the whole line is scissored, only step the edges
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -483,37 +538,41 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
-				while (n >= 3) {
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 2, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 3, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					pp += 4;
-					if (kInterpZ) {
-						pz += 4;
-					}
-					if (kStencilEnabled) {
-						ps += 4;
-					}
-					n -= 4;
-					x += 4;
-				}
-				while (n >= 0) {
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					pp += 1;
-					if (kInterpZ) {
-						pz += 1;
+				if (useSpans) {
+					drawSpan<kEnableScissor>(spans, pp, pz, x, nullptr, n + 1, z, r, g, b, a);
+				} else {
+					while (n >= 3) {
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 2, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 3, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						pp += 4;
+						if (kInterpZ) {
+							pz += 4;
+						}
+						if (kStencilEnabled) {
+							ps += 4;
+						}
+						n -= 4;
+						x += 4;
 					}
-					if (kStencilEnabled) {
-						ps += 1;
+					while (n >= 0) {
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						pp += 1;
+						if (kInterpZ) {
+							pz += 1;
+						}
+						if (kStencilEnabled) {
+							ps += 1;
+						}
+						n -= 1;
+						x += 1;
 					}
-					n -= 1;
-					x += 1;
 				}
 			} else if (kInterpST || kInterpSTZ) {
 				uint *pz;
@@ -557,9 +616,15 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					if (useSpans) {
+						uint32 texels[NB_INTERP];
+						fetchTexels(texture, _wrapS, _wrapT, s, t, dsdx, dtdx, texels, NB_INTERP);
+						drawSpan<kEnableScissor>(spans, pp, pz, x, texels, NB_INTERP, z, r, g, b, a);
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -584,18 +649,24 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
 				}
 
-				while (n >= 0) {
-					putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					pp += 1;
-					if (kInterpZ) {
-						pz += 1;
-					}
-					if (kStencilEnabled) {
-						ps += 1;
+				if (useSpans) {
+					uint32 texels[NB_INTERP];
+					fetchTexels(texture, _wrapS, _wrapT, s, t, dsdx, dtdx, texels, n + 1);
+					drawSpan<kEnableScissor>(spans, pp, pz, x, texels, n + 1, z, r, g, b, a);
+				} else {
+					while (n >= 0) {
+						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+						               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						pp += 1;
+						if (kInterpZ) {
+							pz += 1;
+						}
+						if (kStencilEnabled) {
+							ps += 1;
+						}
+						n -= 1;
+						x += 1;
 					}
-					n -= 1;
-					x += 1;
 				}
 			}
 
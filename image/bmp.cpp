@@ -21,6 +21,8 @@
 
 #include "image/bmp.h"
 
+#include "common/memstream.h"
+#include "common/span.h"
 #include "common/stream.h"
 #include "common/substream.h"
 #include "common/textconsole.h"
@@ -144,6 +146,16 @@ bool BitmapDecoder::loadStream(Common::SeekableReadStream &stream) {
 	if (imageSize == 0)
 		imageSize = stream.size() - imageOffset;
 
+	// Decode the frame data in place when the stream has it in memory, rather
+	// than through a substream seeking the parent stream for every read
+	stream.seek(imageOffset);
+	Common::Span<const byte> frameData = stream.tryGetContiguousView(imageSize);
+	if (frameData) {
+		Common::MemoryReadStream frameStream(frameData.data(), frameData.size());
+		_surface = _codec->decodeFrame(frameStream);
+		return true;
+	}
+
 	// Grab the frame data
 	Common::SeekableSubReadStream subStream(&stream, imageOffset, imageOffset + imageSize);
 
@@ -35,6 +35,71 @@
 
 namespace Image {
 
+namespace {
+
+/**
+ * Reader for the image data, which goes through the data in place when the
+ * stream has it in memory, rather than through a virtual call per byte.
+ */
+class PCXDataReader {
+public:
+	explicit PCXDataReader(Common::SeekableReadStream &stream) : _stream(stream), _end(nullptr) {
+		const uint32 size = stream.size() - stream.pos();
+		_ptr = stream.getContiguousData(size);
+		if (_ptr)
+			_end = _ptr + size;
+	}
+
+	~PCXDataReader() {
+		// Leave the stream right after the data which was used
+		if (_ptr)
+			_stream.seek(_ptr - _end, SEEK_CUR);
+	}
+
+	byte readByte() {
+		if (!_ptr)
+			return _stream.readByte();
+		return _ptr < _end ? *_ptr++ : 0;
+	}
+
+	void read(byte *dst, uint32 size) {
+		if (!_ptr) {
+			_stream.read(dst, size);
+			return;
+		}
+		size = MIN<uint32>(size, _end - _ptr);
+		memcpy(dst, _ptr, size);
+		_ptr += size;
+	}
+
+private:
+	Common::SeekableReadStream &_stream;
+	const byte *_ptr;
+	const byte *_end;
+};
+
+void decodeRLE(PCXDataReader &src, byte *dst, uint32 bytesPerscanLine, bool compressed) {
+	uint32 i = 0;
+	byte run, value;
+
+	if (compressed) {
+		while (i < bytesPerscanLine) {
+			run = 1;
+			value = src.readByte();
+			if (value >= 0xc0) {
+				run = value & 0x3f;
+				value = src.readByte();
+			}
+			while (i < bytesPerscanLine && run--)
+				dst[i++] = value;
+		}
+	} else {
+		src.read(dst, bytesPerscanLine);
+	}
+}
+
+} // End of anonymous namespace
+
 PCXDecoder::PCXDecoder() {
 	_surface = 0;
 	_palette = 0;
@@ -110,6 +175,7 @@ bool PCXDecoder::loadStream(Common::SeekableReadStream &stream) {
 
 	_surface = new Graphics::Surface();
 
+	PCXDataReader src(stream);
 	byte *scanLine = new byte[bytesPerscanLine];
 	byte *dst;
 	int x, y;
@@ -121,7 +187,7 @@ bool PCXDecoder::loadStream(Common::SeekableReadStream &stream) {
 		_paletteColorCount = 0;
 
 		for (y = 0; y < height; y++) {
-			decodeRLE(stream, scanLine, bytesPerscanLine, compressed);
+			decodeRLE(src, scanLine, bytesPerscanLine, compressed);
 
 			for (x = 0; x < width; x++) {
 				byte b = scanLine[x];
@@ -139,12 +205,12 @@ bool PCXDecoder::loadStream(Common::SeekableReadStream &stream) {
 		_paletteColorCount = 16;
 
 		for (y = 0; y < height; y++, dst += _surface->pitch) {
-			decodeRLE(stream, scanLine, bytesPerscanLine, compressed);
+			decodeRLE(src, scanLine, bytesPerscanLine, compressed);
 			memcpy(dst, scanLine, width);
 		}
 
 		if (version == 5) {
-			if (stream.readByte() != 12) {
+			if (src.readByte() != 12) {
 				warning("Expected a palette after the PCX image data");
 				delete[] scanLine;
 				return false;
@@ -154,9 +220,9 @@ bool PCXDecoder::loadStream(Common::SeekableReadStream &stream) {
 			delete[] _palette;
 			_palette = new byte[256 * 3];
 			for (uint16 i = 0; i < 256; i++) {
-				_palette[i * 3 + 0] = stream.readByte();
-				_palette[i * 3 + 1] = stream.readByte();
-				_palette[i * 3 + 2] = stream.readByte();
+				_palette[i * 3 + 0] = src.readByte();
+				_palette[i * 3 + 1] = src.readByte();
+				_palette[i * 3 + 2] = src.readByte();
 			}
 
 			_paletteColorCount = 256;
@@ -167,7 +233,7 @@ bool PCXDecoder::loadStream(Common::SeekableReadStream &stream) {
 		_paletteColorCount = 16;
 
 		for (y = 0; y < height; y++, dst += _surface->pitch) {
-			decodeRLE(stream, scanLine, bytesPerscanLine, compressed);
+			decodeRLE(src, scanLine, bytesPerscanLine, compressed);
 
 			for (x = 0; x < width; x++) {
 				int m = 0x80 >> (x & 7), v = 0;
@@ -190,24 +256,4 @@ bool PCXDecoder::loadStream(Common::SeekableReadStream &stream) {
 	return true;
 }
 
-void PCXDecoder::decodeRLE(Common::SeekableReadStream &stream, byte *dst, uint32 bytesPerscanLine, bool compressed) {
-	uint32 i = 0;
-	byte run, value;
-
-	if (compressed) {
-		while (i < bytesPerscanLine) {
-			run = 1;
-			value = stream.readByte();
-			if (value >= 0xc0) {
-				run = value & 0x3f;
-				value = stream.readByte();
-			}
-			while (i < bytesPerscanLine && run--)
-				dst[i++] = value;
-		}
-	} else {
-		stream.read(dst, bytesPerscanLine);
-	}
-}
-
 } // End of namespace Image
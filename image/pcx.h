@@ -60,8 +60,6 @@ public:
 	uint16 getPaletteColorCount() const { return _paletteColorCount; }
 
 private:
-	void decodeRLE(Common::SeekableReadStream &stream, byte *dst, uint32 bytesPerScanline, bool compressed);
-
 	Graphics::Surface *_surface;
 	byte *_palette;
 	uint16 _paletteColorCount;
@@ -0,0 +1,212 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/effects.h"
+#include "audio/mixer_intern.h"
+#include "audio/mixer_simd.h"
+#include "audio/decoders/raw.h"
+
+#include "../null_osystem.h"
+
+class AudioEffectsTestSuite : public CxxTest::TestSuite
+{
+	/** A constant stereo stream at 12000, long enough for the tests */
+	static Audio::AudioStream *makeSteadyStream() {
+		const uint frames = 22050;
+		int16 *data = (int16 *)malloc(frames * 2 * sizeof(int16));
+		for (uint i = 0; i < frames * 2; ++i)
+			data[i] = 12000;
+
+		byte flags = Audio::FLAG_16BITS | Audio::FLAG_STEREO;
+#ifdef SCUMM_LITTLE_ENDIAN
+		flags |= Audio::FLAG_LITTLE_ENDIAN;
+#endif
+		return Audio::makeRawStream((byte *)data, frames * 2 * sizeof(int16), 22050, flags);
+	}
+
+	static void playSteadyStream(Audio::Mixer &mixer, Audio::Mixer::SoundType type, Audio::SoundHandle *handle) {
+		mixer.playStream(type, handle, makeSteadyStream());
+	}
+
+	static int getPeak(const int16 *samples, uint frames) {
+		int peak = 0;
+		for (uint i = 0; i < frames * 2; ++i)
+			peak = MAX<int>(peak, ABS(samples[i]));
+		return peak;
+	}
+
+public:
+	void test_limiter_ceiling() {
+		Audio::LimiterEffect limiter(30000, 5, 50);
+		limiter.prepare(44100, true);
+
+		// A loud square wave with isolated spikes way above the 16-bit range
+		int32 block[2048 * 2];
+		for (int i = 0; i < 2048; ++i) {
+			const int32 value = (i % 300 == 0) ? 90000 : ((i & 64) ? 40000 : -40000);
+			block[i * 2] = value;
+			block[i * 2 + 1] = -value / 2;
+		}
+
+		for (int n = 0; n < 4; ++n) {
+			int32 copy[2048 * 2];
+			memcpy(copy, block, sizeof(block));
+			limiter.process(copy, 2048);
+
+			for (int i = 0; i < 2048 * 2; ++i)
+				TS_ASSERT_LESS_THAN_EQUALS(ABS(copy[i]), 30000);
+		}
+	}
+
+	void test_limiter_random() {
+		// Short windows, where the sliding minimum fills up
+		const uint rates[] = { 8000, 11025, 44100 };
+		for (uint r = 0; r < ARRAYSIZE(rates); ++r) {
+			Audio::LimiterEffect limiter(32000, 1, 20);
+			limiter.prepare(rates[r], true);
+
+			uint32 seed = 12345 + r;
+			int32 block[1000 * 2];
+			for (int n = 0; n < 20; ++n) {
+				for (int i = 0; i < 1000 * 2; ++i) {
+					seed = seed * 1103515245 + 12345;
+					block[i] = (int32)((seed >> 8) % 400001) - 200000;
+				}
+				limiter.process(block, 1000);
+
+				for (int i = 0; i < 1000 * 2; ++i)
+					TS_ASSERT_LESS_THAN_EQUALS(ABS(block[i]), 32000);
+			}
+		}
+	}
+
+	void test_limiter_decaying_bursts() {
+		Audio::LimiterEffect limiter(32000, 1, 20);
+		limiter.prepare(32000, false);
+
+		// Falling peaks make the required gain rise on every frame, which
+		// fills the sliding minimum, until the next burst starts
+		int32 block[4096];
+		int32 value = 0;
+		for (int i = 0; i < 4096; ++i) {
+			if (i % 37 == 0)
+				value = 60000 + (i * 7919) % 400000;
+			value = (int32)((int64)value * 95 / 100);
+			block[i] = value;
+		}
+		limiter.process(block, 4096);
+
+		for (int i = 0; i < 4096; ++i)
+			TS_ASSERT_LESS_THAN_EQUALS(ABS(block[i]), 32000);
+	}
+
+	void test_limiter_transparent() {
+		Audio::LimiterEffect limiter(30000, 1, 50);
+		limiter.prepare(8000, false);
+
+		// Quiet signals only get delayed by the lookahead
+		int32 block[256];
+		for (int i = 0; i < 256; ++i)
+			block[i] = (i * 37) % 2000 - 1000;
+
+		int32 out[256];
+		memcpy(out, block, sizeof(block));
+		limiter.process(out, 256);
+
+		const int delay = 8 - 1;
+		for (int i = delay; i < 256; ++i)
+			TS_ASSERT_EQUALS(out[i], block[i - delay]);
+	}
+
+	void test_mixer_effects() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Audio::mixAccumulate = Audio::mixAccumulateGeneric;
+		Audio::mixSaturate = Audio::mixSaturateGeneric;
+
+		Audio::MixerImpl mixer(22050, true);
+		mixer.setReady(true);
+
+		Audio::SoundHandle first, second;
+		playSteadyStream(mixer, Audio::Mixer::kSFXSoundType, &first);
+		playSteadyStream(mixer, Audio::Mixer::kSFXSoundType, &second);
+
+		int16 out[1024 * 2];
+		mixer.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT_EQUALS(getPeak(out, 1024), 24000);
+
+		// The channel effect only limits its channel. The limiters delay
+		// their input, so the end of the blocks is checked.
+		mixer.addChannelEffect(first, new Audio::LimiterEffect(4000, 1, 50));
+		mixer.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT_LESS_THAN_EQUALS(getPeak(out + 512 * 2, 512), 12000 + 4000);
+		TS_ASSERT_LESS_THAN(12000 + 3500, getPeak(out + 512 * 2, 512));
+
+		// The bus effect limits the sum of the channels of its type
+		mixer.addSoundTypeEffect(Audio::Mixer::kSFXSoundType, new Audio::LimiterEffect(10000, 1, 50));
+		mixer.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT_LESS_THAN_EQUALS(getPeak(out, 1024), 16000);
+		TS_ASSERT_LESS_THAN_EQUALS(getPeak(out + 512 * 2, 512), 10000);
+		TS_ASSERT_LESS_THAN(9500, getPeak(out + 512 * 2, 512));
+
+		// Other sound types do not go through the bus
+		mixer.stopHandle(first);
+		mixer.stopHandle(second);
+		Audio::SoundHandle music;
+		playSteadyStream(mixer, Audio::Mixer::kMusicSoundType, &music);
+		mixer.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT_EQUALS(getPeak(out + 512 * 2, 512), 12000);
+
+		// Effects for a stopped sound are dropped
+		mixer.addChannelEffect(first, new Audio::LimiterEffect(4000, 1, 50));
+		mixer.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT_EQUALS(getPeak(out, 1024), 12000);
+
+		mixer.stopAll();
+		mixer.clearSoundTypeEffects(Audio::Mixer::kSFXSoundType);
+#endif
+	}
+
+	void test_biquad_lowpass() {
+		Audio::BiquadFilterEffect filter(Audio::BiquadFilterEffect::kLowPass, 1000.0f);
+		filter.prepare(44100, false);
+
+		// DC passes
+		int32 dc[4096];
+		for (int i = 0; i < 4096; ++i)
+			dc[i] = 10000;
+		filter.process(dc, 4096);
+		TS_ASSERT_DELTA(dc[4095], 10000, 2);
+
+		// The Nyquist frequency does not
+		filter.reset();
+		int32 nyquist[4096];
+		for (int i = 0; i < 4096; ++i)
+			nyquist[i] = (i & 1) ? 10000 : -10000;
+		filter.process(nyquist, 4096);
+		TS_ASSERT_LESS_THAN(ABS(nyquist[4095]), 50);
+	}
+
+	void test_reverb_tail() {
+		Audio::SchroederReverbEffect reverb;
+		reverb.prepare(22050, true);
+
+		int32 block[4096 * 2];
+		memset(block, 0, sizeof(block));
+		block[0] = block[1] = 20000;
+		reverb.process(block, 4096);
+
+		// The impulse is passed through, followed by echoes
+		TS_ASSERT_EQUALS(block[0], 20000);
+		bool hasTail = false;
+		for (int i = 1000 * 2; i < 4096 * 2; ++i)
+			hasTail |= (block[i] != 0);
+		TS_ASSERT(hasTail);
+
+		// Nothing in, nothing out after a reset
+		reverb.reset();
+		memset(block, 0, sizeof(block));
+		reverb.process(block, 4096);
+		for (int i = 0; i < 4096 * 2; ++i)
+			TS_ASSERT_EQUALS(block[i], 0);
+	}
+};
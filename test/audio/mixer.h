@@ -0,0 +1,81 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/mixer_simd.h"
+
+#include "../instrset_detect.h"
+
+class MixerKernelTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kNumSamples = 1027
+	};
+
+	static void fillSource(int16 *src) {
+		for (int i = 0; i < kNumSamples; ++i)
+			src[i] = (int16)((i * 7919) ^ 0x5a5a);
+	}
+
+	static void checkKernels(Audio::MixAccumulateFunc accumulate, Audio::MixSaturateFunc saturate) {
+		int16 src[kNumSamples];
+		fillSource(src);
+
+		int32 expected[kNumSamples], result[kNumSamples];
+		for (int i = 0; i < kNumSamples; ++i)
+			expected[i] = result[i] = i * 31 - 16000;
+
+		// Accumulate twice so that the sum leaves the 16-bit range
+		for (int n = 0; n < 2; ++n) {
+			Audio::mixAccumulateGeneric(expected, src, kNumSamples, 200, Audio::Mixer::kMaxMixerVolume);
+			accumulate(result, src, kNumSamples, 200, Audio::Mixer::kMaxMixerVolume);
+		}
+		TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(expected)), 0);
+
+		int16 expectedOut[kNumSamples], resultOut[kNumSamples];
+		Audio::mixSaturateGeneric(expectedOut, expected, kNumSamples);
+		saturate(resultOut, result, kNumSamples);
+		TS_ASSERT_EQUALS(memcmp(expectedOut, resultOut, sizeof(expectedOut)), 0);
+	}
+
+public:
+	void test_accumulate_then_saturate() {
+		// Two channels that cancel each other must not clip on their own
+		int16 loud[4] = { 30000, -30000, 30000, -30000 };
+		int16 inverted[4] = { -30000, 30000, -30000, 30000 };
+		int32 acc[4] = { 0, 0, 0, 0 };
+		int16 out[4];
+
+		Audio::mixAccumulateGeneric(acc, loud, 4, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::mixAccumulateGeneric(acc, loud, 4, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::mixAccumulateGeneric(acc, inverted, 4, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::mixSaturateGeneric(out, acc, 4);
+
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT_EQUALS(out[i], loud[i]);
+	}
+
+	void test_balance() {
+		int16 src[2] = { 1000, 1000 };
+		int32 acc[2] = { 0, 0 };
+
+		Audio::mixAccumulateGeneric(acc, src, 2, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume / 2);
+		TS_ASSERT_EQUALS(acc[0], 1000);
+		TS_ASSERT_EQUALS(acc[1], 500);
+	}
+
+	void test_simd_kernels() {
+#ifdef SCUMMVM_NEON
+		checkKernels(Audio::mixAccumulateNEON, Audio::mixSaturateNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernels(Audio::mixAccumulateSSE2, Audio::mixSaturateSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernels(Audio::mixAccumulateAVX2, Audio::mixSaturateAVX2);
+#endif
+		checkKernels(Audio::mixAccumulateGeneric, Audio::mixSaturateGeneric);
+	}
+};
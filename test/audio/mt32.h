@@ -0,0 +1,269 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_MT32EMU
+#include "audio/softsynth/mt32/File.h"
+#include "audio/softsynth/mt32/ROMInfo.h"
+#include "audio/softsynth/mt32/Synth.h"
+#endif
+
+#include "common/array.h"
+#include "common/threadpool.h"
+
+class MT32TestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_MT32EMU
+private:
+	enum {
+		kRate = 32000,
+		kNumSamples = kRate / 2,
+		kMaxChunk = 700,
+		kRenderThreads = 4,
+
+		kControlROMSize = 64 * 1024,
+		kPCMROMSize = 512 * 1024,
+		kTimbreSize = 246
+	};
+
+	struct LCG {
+		uint32 state;
+
+		LCG() : state(12345) {}
+
+		uint8 next() {
+			state = state * 1103515245 + 12345;
+			return (state >> 16) & 0xff;
+		}
+	};
+
+	/**
+	 * ROM images laid out like the MT-32 v1.07 ones, with made up timbres
+	 * and PCM samples, so that the test doesn't need the real ROMs.
+	 */
+	struct SyntheticROMs {
+		Common::Array<byte> controlData;
+		Common::Array<byte> pcmData;
+		MT32Emu::ArrayFile *controlFile;
+		MT32Emu::ArrayFile *pcmFile;
+		MT32Emu::ROMInfo *controlInfo;
+		MT32Emu::ROMInfo *pcmInfo;
+		const MT32Emu::ROMImage *controlImage;
+		const MT32Emu::ROMImage *pcmImage;
+
+		SyntheticROMs() {
+			LCG rnd;
+
+			controlData.resize(kControlROMSize);
+			memset(controlData.data(), 0, kControlROMSize);
+			byte *rom = controlData.data();
+
+			// Maximum values of the parameters
+			static const byte rhythmMax[4] = { 94, 100, 14, 1 };
+			static const byte patchMax[16] = { 3, 63, 48, 100, 24, 3, 1, 0, 100, 14 };
+			static const byte systemMax[23] = { 127, 3, 7, 7, 32, 32, 32, 32, 32, 32, 32, 32, 32, 16, 16, 16, 16, 16, 16, 16, 16, 16, 100 };
+			static const byte timbreMax[72] = {
+				127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 12, 12, 15, 1,
+				96, 100, 16, 1, 1, 127, 100, 14,
+				10, 100, 4, 100, 100, 100, 100, 100, 100, 100, 100, 100,
+				100, 100, 100,
+				100, 30, 14, 127, 14, 100, 100, 4, 4, 100, 100, 100, 100, 100, 100, 100, 100, 100,
+				100, 100, 127, 12, 127, 12, 4, 4, 100, 100, 100, 100, 100, 100, 100, 100, 100
+			};
+			memcpy(rom + 0x523C, rhythmMax, sizeof(rhythmMax));
+			memcpy(rom + 0x5248, patchMax, sizeof(patchMax));
+			memcpy(rom + 0x5258, systemMax, sizeof(systemMax));
+			memcpy(rom + 0x51F4, timbreMax, sizeof(timbreMax));
+
+			// PCM waves of 2 to 16 KiB, half of them looped
+			for (uint i = 0; i < 128; ++i) {
+				byte *entry = rom + 0x3000 + i * 4;
+				entry[0] = (i * 7) % 120;
+				entry[1] = ((i % 4) << 4) | ((i & 1) ? 0x80 : 0) | 1;
+				entry[2] = rnd.next();
+				entry[3] = 0x80 + (rnd.next() & 0x3f);
+			}
+
+			// Melodic timbres of groups A and B, then the rhythm timbres
+			for (uint i = 0; i < 64; ++i) {
+				const uint16 addressA = 0x8080 + i * kTimbreSize;
+				WRITE_LE_UINT16(rom + 0x8000 + i * 2, addressA);
+				makeTimbre(rnd, rom + addressA, timbreMax, false);
+
+				const uint16 addressB = 0xC080 + i * kTimbreSize;
+				WRITE_LE_UINT16(rom + 0xC000 + i * 2, addressB - 0x4000);
+				makeTimbre(rnd, rom + addressB, timbreMax, false);
+			}
+			for (uint i = 0; i < 30; ++i) {
+				const uint16 address = 0x3300 + i * kTimbreSize;
+				WRITE_LE_UINT16(rom + 0x3200 + i * 2, address);
+				makeTimbre(rnd, rom + address, timbreMax, true);
+			}
+
+			for (uint i = 0; i < 85; ++i) {
+				byte *entry = rom + 0x73FE + i * 4;
+				entry[0] = 64 + i % 30;
+				entry[1] = 100;
+				entry[2] = i % 15;
+				entry[3] = 1;
+			}
+
+			static const byte reserve[9] = { 3, 10, 6, 4, 3, 0, 0, 0, 6 };
+			static const byte pan[9] = { 7, 2, 12, 4, 10, 7, 0, 14, 7 };
+			static const byte programs[8] = { 0, 68, 48, 95, 78, 41, 3, 110 };
+			memcpy(rom + 0x57B1, reserve, sizeof(reserve));
+			memcpy(rom + 0x57CC, pan, sizeof(pan));
+			memcpy(rom + 0x57BA, programs, sizeof(programs));
+
+			pcmData.resize(kPCMROMSize);
+			for (uint i = 0; i < kPCMROMSize; ++i)
+				pcmData[i] = rnd.next();
+
+			controlFile = new MT32Emu::ArrayFile(controlData.data(), controlData.size());
+			pcmFile = new MT32Emu::ArrayFile(pcmData.data(), pcmData.size());
+
+			MT32Emu::ROMInfo control = { kControlROMSize, controlFile->getSHA1(), MT32Emu::ROMInfo::Control, "ctrl_mt32_1_07", "Test Control", MT32Emu::ROMInfo::Full, NULL };
+			MT32Emu::ROMInfo pcm = { kPCMROMSize, pcmFile->getSHA1(), MT32Emu::ROMInfo::PCM, "pcm_mt32", "Test PCM", MT32Emu::ROMInfo::Full, NULL };
+			controlInfo = new MT32Emu::ROMInfo(control);
+			pcmInfo = new MT32Emu::ROMInfo(pcm);
+
+			const MT32Emu::ROMInfo *controlInfos[] = { controlInfo, NULL };
+			const MT32Emu::ROMInfo *pcmInfos[] = { pcmInfo, NULL };
+			controlImage = MT32Emu::ROMImage::makeROMImage(controlFile, controlInfos);
+			pcmImage = MT32Emu::ROMImage::makeROMImage(pcmFile, pcmInfos);
+		}
+
+		~SyntheticROMs() {
+			MT32Emu::ROMImage::freeROMImage(controlImage);
+			MT32Emu::ROMImage::freeROMImage(pcmImage);
+			delete controlInfo;
+			delete pcmInfo;
+			delete controlFile;
+			delete pcmFile;
+		}
+
+		static void makeTimbre(LCG &rnd, byte *timbre, const byte *max, bool rhythm) {
+			for (uint i = 0; i < 10; ++i)
+				timbre[i] = 'A' + rnd.next() % 26;
+			for (uint i = 10; i < 14; ++i)
+				timbre[i] = rnd.next() % (max[i] + 1);
+			// Rhythm timbres are stored without their muted partials
+			timbre[12] = rhythm ? 15 : 1 + rnd.next() % 15;
+
+			for (uint partial = 0; partial < 4; ++partial) {
+				byte *param = timbre + 14 + partial * 58;
+				for (uint i = 0; i < 58; ++i)
+					param[i] = rnd.next() % (max[14 + i] + 1);
+				// Keep the partials audible, and their pitch envelope shallow
+				param[41] = 60 + rnd.next() % 41;
+				param[8] = rnd.next() % 4;
+			}
+		}
+	};
+
+	struct RenderBatch {
+		MT32Emu::ParallelJob job;
+		void *jobData;
+	};
+
+	static void runRenderJob(void *param, uint index) {
+		const RenderBatch *batch = (const RenderBatch *)param;
+		batch->job(batch->jobData, index);
+	}
+
+	struct PoolRunner {
+		Common::ThreadPool *pool;
+		uint calls;
+	};
+
+	static void runRenderJobs(void *runnerData, MT32Emu::ParallelJob job, void *jobData, MT32Emu::Bit32u jobCount) {
+		PoolRunner *runner = (PoolRunner *)runnerData;
+		RenderBatch batch = { job, jobData };
+		runner->pool->run(runRenderJob, &batch, jobCount);
+		++runner->calls;
+	}
+
+	/**
+	 * Play a fixed random MIDI stream on all the parts, and render it in
+	 * chunks of varying size.
+	 */
+	template<typename Sample>
+	static void render(const SyntheticROMs &roms, MT32Emu::RendererType rendererType, PoolRunner *runner, Common::Array<Sample> &output) {
+		MT32Emu::Synth synth;
+		synth.selectRendererType(rendererType);
+		if (runner)
+			synth.setParallelRunner(runRenderJobs, runner, kRenderThreads);
+		TS_ASSERT(synth.open(*roms.controlImage, *roms.pcmImage));
+
+		LCG rnd;
+		const uint32 step = kRate / 100;
+		uint32 time = 0;
+
+		output.resize(kNumSamples * 2);
+		uint32 pos = 0;
+		while (pos < kNumSamples) {
+			// Queue the events of the next chunk
+			const uint32 chunk = MIN<uint32>(1 + rnd.next() * kMaxChunk / 256, kNumSamples - pos);
+			while (time < pos + chunk) {
+				const uint8 channel = 1 + rnd.next() % 9;
+				const uint8 note = 36 + rnd.next() % 48;
+				const uint8 velocity = 40 + rnd.next() % 88;
+				const uint8 event = rnd.next() % 8;
+				if (event == 0 && channel != 9)
+					synth.playMsg(0xC0 | channel | (rnd.next() & 0x7f) << 8, time);
+				else if (event == 1)
+					synth.playMsg(0xE0 | channel | (rnd.next() & 0x7f) << 16, time);
+				else if (event < 5)
+					synth.playMsg(0x80 | channel | note << 8, time);
+				else
+					synth.playMsg(0x90 | channel | note << 8 | velocity << 16, time);
+				time += step;
+			}
+
+			synth.render(&output[pos * 2], chunk);
+			pos += chunk;
+		}
+
+		synth.close();
+	}
+
+	template<typename Sample>
+	void checkParallelMatchesSerial(MT32Emu::RendererType rendererType) {
+		SyntheticROMs roms;
+		TS_ASSERT(roms.controlImage && roms.pcmImage);
+		if (!roms.controlImage || !roms.pcmImage)
+			return;
+
+		Common::Array<Sample> serial;
+		render(roms, rendererType, nullptr, serial);
+
+		bool silent = true;
+		for (uint i = 0; i < serial.size() && silent; ++i)
+			silent = serial[i] == 0;
+		TS_ASSERT(!silent);
+
+		// Without thread support, the pool runs the jobs one after the other
+		Common::ThreadPool pool(kRenderThreads);
+		PoolRunner runner = { &pool, 0 };
+		Common::Array<Sample> parallel;
+		render(roms, rendererType, &runner, parallel);
+		TS_ASSERT_LESS_THAN(0u, runner.calls);
+
+		TS_ASSERT_EQUALS(serial.size(), parallel.size());
+		TS_ASSERT_SAME_DATA(serial.data(), parallel.data(), serial.size() * sizeof(Sample));
+	}
+#endif // USE_MT32EMU
+
+public:
+	void test_parallel_render_int() {
+#ifdef USE_MT32EMU
+		checkParallelMatchesSerial<MT32Emu::Bit16s>(MT32Emu::RendererType_BIT16S);
+#endif
+	}
+
+	void test_parallel_render_float() {
+#ifdef USE_MT32EMU
+		checkParallelMatchesSerial<float>(MT32Emu::RendererType_FLOAT);
+#endif
+	}
+};
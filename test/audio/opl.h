@@ -0,0 +1,319 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "audio/softsynth/opl/dbopl.h"
+#include "audio/softsynth/opl/mame.h"
+#include "audio/softsynth/opl/nuked.h"
+
+#include "../instrset_detect.h"
+#include "../null_osystem.h"
+
+#include <math.h>
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class OPLTestSuite : public CxxTest::TestSuite
+{
+#ifndef DISABLE_DOSBOX_OPL
+private:
+	enum {
+		kRate = 44100,
+		kBlockSize = 512
+	};
+
+	struct TraceEvent {
+		uint32 sample;
+		uint16 reg;
+		uint8 val;
+	};
+
+	typedef Common::Array<TraceEvent> Trace;
+
+	struct LCG {
+		uint32 state;
+
+		LCG() : state(12345) {}
+
+		uint8 next() {
+			state = state * 1103515245 + 12345;
+			return (state >> 16) & 0xff;
+		}
+	};
+
+	static void addWrite(Trace &trace, uint32 sample, uint16 reg, uint8 val) {
+		TraceEvent event = { sample, reg, val };
+		trace.push_back(event);
+	}
+
+	/**
+	 * Build a fixed register write trace, playing short notes with random
+	 * instruments on every channel. This covers all envelope states, the
+	 * vibrato and tremolo, all waveforms and, for OPL3, the 4-op modes.
+	 */
+	static void buildTrace(Trace &trace, bool opl3, uint numSamples) {
+		LCG rnd;
+		const uint numChannels = opl3 ? 18 : 9;
+
+		addWrite(trace, 0, 0x01, 0x20);
+		if (opl3) {
+			addWrite(trace, 0, 0x105, 0x01);
+			addWrite(trace, 0, 0x104, 0x2d);
+		}
+
+		uint8 keyOn[18];
+		memset(keyOn, 0, sizeof(keyOn));
+
+		const uint32 step = kRate / 40;
+		for (uint32 sample = 0; sample < numSamples; sample += step) {
+			const uint ch = rnd.next() % numChannels;
+			const uint16 bank = (ch >= 9) ? 0x100 : 0;
+			const uint chan = ch % 9;
+			const uint16 slot = (chan / 3) * 8 + chan % 3;
+
+			// Release the note playing on the channel before changing the instrument
+			if (keyOn[ch])
+				addWrite(trace, sample, bank | (0xB0 + chan), keyOn[ch] & ~0x20);
+
+			for (uint op = 0; op < 2; ++op) {
+				const uint16 base = bank | (slot + op * 3);
+				addWrite(trace, sample, base + 0x20, rnd.next());
+				addWrite(trace, sample, base + 0x40, rnd.next() & 0x9f);
+				addWrite(trace, sample, base + 0x60, rnd.next() | 0x11);
+				addWrite(trace, sample, base + 0x80, rnd.next());
+				addWrite(trace, sample, base + 0xE0, rnd.next() & (opl3 ? 7 : 3));
+			}
+			addWrite(trace, sample, bank | (0xC0 + chan), (opl3 ? 0x30 : 0) | (rnd.next() & 0x0f));
+			addWrite(trace, sample, bank | (0xA0 + chan), rnd.next());
+			keyOn[ch] = 0x20 | (rnd.next() & 0x1f);
+			addWrite(trace, sample, bank | (0xB0 + chan), keyOn[ch]);
+
+			// Change the vibrato and tremolo depth and the percussion mode every now and then
+			if ((sample / step) % 16 == 15)
+				addWrite(trace, sample, 0xBD, rnd.next());
+		}
+	}
+
+	static void renderDBOPL(const Trace &trace, bool opl3, uint numSamples, bool batched, OPL::DOSBox::DBOPL::RampHandler ramp, int32 *output) {
+		OPL::DOSBox::DBOPL::InitTables();
+		OPL::DOSBox::DBOPL::Chip *chip = new OPL::DOSBox::DBOPL::Chip();
+		chip->Setup(kRate);
+		chip->batchMode = batched;
+		chip->rampHandler = ramp;
+
+		uint32 pos = 0;
+		uint event = 0;
+		while (pos < numSamples) {
+			while (event < trace.size() && trace[event].sample <= pos) {
+				chip->WriteReg(trace[event].reg, trace[event].val);
+				++event;
+			}
+
+			uint32 todo = MIN<uint32>(numSamples - pos, kBlockSize);
+			if (event < trace.size())
+				todo = MIN<uint32>(todo, trace[event].sample - pos);
+
+			if (opl3)
+				chip->GenerateBlock3(todo, output + pos * 2);
+			else
+				chip->GenerateBlock2(todo, output + pos);
+			pos += todo;
+		}
+
+		delete chip;
+	}
+
+	static void checkBatched(const Trace &trace, bool opl3, uint numSamples, OPL::DOSBox::DBOPL::RampHandler ramp) {
+		const uint numValues = numSamples * (opl3 ? 2 : 1);
+		int32 *expected = new int32[numValues];
+		int32 *result = new int32[numValues];
+
+		renderDBOPL(trace, opl3, numSamples, false, &OPL::DOSBox::DBOPL::RampGeneric, expected);
+		renderDBOPL(trace, opl3, numSamples, true, ramp, result);
+		TS_ASSERT_EQUALS(memcmp(expected, result, numValues * sizeof(int32)), 0);
+
+		delete[] expected;
+		delete[] result;
+	}
+
+	static void checkRamp(OPL::DOSBox::DBOPL::RampHandler ramp) {
+		static const uint32 starts[] = { 0, 0x00ffffff, 0xfffff000, 0x12345678 };
+		static const uint32 steps[] = { 0, 1, 0x00abcdef, 0x7fffffff };
+
+		OPL::DOSBox::DBOPL::Bit32u expected[37], result[37];
+		for (int i = 0; i < ARRAYSIZE(starts); ++i) {
+			for (int j = 0; j < ARRAYSIZE(steps); ++j) {
+				OPL::DOSBox::DBOPL::RampGeneric(expected, starts[i], steps[j], 18, 100, ARRAYSIZE(expected));
+				ramp(result, starts[i], steps[j], 18, 100, ARRAYSIZE(result));
+				TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(expected)), 0);
+			}
+		}
+	}
+
+#endif // !DISABLE_DOSBOX_OPL
+
+public:
+	void test_dbopl_batched_matches_serial() {
+#ifndef DISABLE_DOSBOX_OPL
+		const uint numSamples = kRate * 3;
+
+		for (int opl3 = 0; opl3 < 2; ++opl3) {
+			Trace trace;
+			buildTrace(trace, opl3, numSamples);
+
+			checkBatched(trace, opl3, numSamples, &OPL::DOSBox::DBOPL::RampGeneric);
+#ifdef SCUMMVM_NEON
+			checkBatched(trace, opl3, numSamples, &OPL::DOSBox::DBOPL::RampNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+			if (instrset_detect() >= 2)
+				checkBatched(trace, opl3, numSamples, &OPL::DOSBox::DBOPL::RampSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+			if (instrset_detect() >= 8)
+				checkBatched(trace, opl3, numSamples, &OPL::DOSBox::DBOPL::RampAVX2);
+#endif
+		}
+#endif
+	}
+
+	void test_dbopl_ramp_simd() {
+#ifndef DISABLE_DOSBOX_OPL
+#ifdef SCUMMVM_NEON
+		checkRamp(&OPL::DOSBox::DBOPL::RampNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkRamp(&OPL::DOSBox::DBOPL::RampSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkRamp(&OPL::DOSBox::DBOPL::RampAVX2);
+#endif
+#endif
+	}
+
+	void test_opl_benchmark() {
+#if BENCHMARK_TIME && !defined(DISABLE_DOSBOX_OPL)
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const uint numSamples = kRate * 60;
+#else
+		const uint numSamples = kRate * 2;
+#endif
+
+		Trace trace;
+		buildTrace(trace, false, numSamples);
+
+		OPL::DOSBox::DBOPL::RampHandler ramp = &OPL::DOSBox::DBOPL::RampGeneric;
+#ifdef SCUMMVM_NEON
+		ramp = &OPL::DOSBox::DBOPL::RampNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			ramp = &OPL::DOSBox::DBOPL::RampSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			ramp = &OPL::DOSBox::DBOPL::RampAVX2;
+#endif
+
+		int32 *dbOutput = new int32[numSamples];
+		int16 *mameOutput = new int16[numSamples];
+		int16 *nukedOutput = new int16[numSamples * 2];
+
+		uint32 start = g_system->getMillis();
+		renderDBOPL(trace, false, numSamples, false, &OPL::DOSBox::DBOPL::RampGeneric, dbOutput);
+		const uint32 dbTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		renderDBOPL(trace, false, numSamples, true, ramp, dbOutput);
+		const uint32 dbBatchedTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		OPL::MAME::FM_OPL *mame = OPL::MAME::makeAdLibOPL(kRate);
+		renderTrace(trace, numSamples, mame, mameOutput);
+		OPL::MAME::OPLDestroy(mame);
+		const uint32 mameTime = g_system->getMillis() - start;
+
+#ifndef DISABLE_NUKED_OPL
+		start = g_system->getMillis();
+		OPL::NUKED::opl3_chip *nuked = new OPL::NUKED::opl3_chip();
+		OPL::NUKED::OPL3_Reset(nuked, kRate);
+		renderTrace(trace, numSamples, nuked, nukedOutput);
+		delete nuked;
+		const uint32 nukedTime = g_system->getMillis() - start;
+#endif
+
+		debug("DOSBox OPL: %f samples per second\n", numSamples * 1000.0 / MAX<uint32>(dbTime, 1));
+		debug("DOSBox OPL (batched): %f samples per second\n", numSamples * 1000.0 / MAX<uint32>(dbBatchedTime, 1));
+		debug("MAME OPL: %f samples per second\n", numSamples * 1000.0 / MAX<uint32>(mameTime, 1));
+#ifndef DISABLE_NUKED_OPL
+		debug("Nuked OPL: %f samples per second\n", numSamples * 1000.0 / MAX<uint32>(nukedTime, 1));
+
+		// Nuked OPL is the reference for accuracy
+		double dbError = 0.0, mameError = 0.0, nukedPower = 0.0;
+		for (uint i = 0; i < numSamples; ++i) {
+			const double ref = nukedOutput[i * 2];
+			dbError += (CLIP<int32>(dbOutput[i], -32768, 32767) - ref) * (CLIP<int32>(dbOutput[i], -32768, 32767) - ref);
+			mameError += (mameOutput[i] - ref) * (mameOutput[i] - ref);
+			nukedPower += ref * ref;
+		}
+		debug("RMS level of Nuked OPL: %f\n", sqrt(nukedPower / numSamples));
+		debug("RMS difference to Nuked OPL: DOSBox %f, MAME %f\n", sqrt(dbError / numSamples), sqrt(mameError / numSamples));
+#endif
+
+		delete[] dbOutput;
+		delete[] mameOutput;
+		delete[] nukedOutput;
+#endif
+	}
+
+#ifndef DISABLE_DOSBOX_OPL
+private:
+	static void renderTrace(const Trace &trace, uint numSamples, OPL::MAME::FM_OPL *chip, int16 *output) {
+		uint32 pos = 0;
+		uint event = 0;
+		while (pos < numSamples) {
+			while (event < trace.size() && trace[event].sample <= pos) {
+				OPL::MAME::OPLWriteReg(chip, trace[event].reg, trace[event].val);
+				++event;
+			}
+
+			uint32 todo = MIN<uint32>(numSamples - pos, kBlockSize);
+			if (event < trace.size())
+				todo = MIN<uint32>(todo, trace[event].sample - pos);
+
+			OPL::MAME::YM3812UpdateOne(chip, output + pos, todo);
+			pos += todo;
+		}
+	}
+
+#ifndef DISABLE_NUKED_OPL
+	static void renderTrace(const Trace &trace, uint numSamples, OPL::NUKED::opl3_chip *chip, int16 *output) {
+		uint32 pos = 0;
+		uint event = 0;
+		while (pos < numSamples) {
+			while (event < trace.size() && trace[event].sample <= pos) {
+				OPL::NUKED::OPL3_WriteReg(chip, trace[event].reg, trace[event].val);
+				++event;
+			}
+
+			uint32 todo = MIN<uint32>(numSamples - pos, kBlockSize);
+			if (event < trace.size())
+				todo = MIN<uint32>(todo, trace[event].sample - pos);
+
+			OPL::NUKED::OPL3_GenerateStream(chip, output + pos * 2, todo);
+			pos += todo;
+		}
+	}
+#endif
+#endif // !DISABLE_DOSBOX_OPL
+};
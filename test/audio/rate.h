@@ -0,0 +1,99 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+
+#include "helper.h"
+#include "../instrset_detect.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	static Audio::SeekableAudioStream *createConstantStream(const int sampleRate, const int numSamples, const int16 value) {
+		int16 *data = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; ++i)
+			WRITE_LE_UINT16(&data[i], value);
+
+		Common::SeekableReadStream *s = new Common::MemoryReadStream((const byte *)data, numSamples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(s, sampleRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+public:
+	void setUp() {
+		// Don't rely on OSystem for the CPU feature detection
+		Audio::firDotProduct = Audio::firDotProductGeneric;
+	}
+
+	void test_polyphase_dc_gain() {
+		// A constant input has to come out at the same level once the
+		// filter has settled, for upsampling as well as downsampling.
+		static const uint rates[][2] = { { 11025, 48000 }, { 22050, 44100 }, { 48000, 22050 } };
+
+		for (int r = 0; r < ARRAYSIZE(rates); ++r) {
+			Audio::SeekableAudioStream *s = createConstantStream(rates[r][0], rates[r][0], 10000);
+			Audio::RateConverter *conv = Audio::makePolyphaseRateConverter(rates[r][0], rates[r][1], false, false, false);
+
+			const int numOut = rates[r][1] / 2;
+			int16 *out = new int16[numOut];
+			memset(out, 0, numOut * sizeof(int16));
+
+			TS_ASSERT_EQUALS(conv->convert(*s, out, numOut, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), numOut);
+			for (int i = 1000; i < numOut; ++i)
+				TS_ASSERT_DELTA(out[i], 10000, 2);
+
+			delete[] out;
+			delete conv;
+			delete s;
+		}
+	}
+
+	void test_polyphase_same_rate_is_copy() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(22050, 1, &sine, true, true);
+		Audio::RateConverter *conv = Audio::makePolyphaseRateConverter(22050, 22050, true, true, false);
+
+		int16 *out = new int16[22050 * 2];
+		memset(out, 0, 22050 * 2 * sizeof(int16));
+
+		// Drain the whole stream, including the tail of the filter window
+		int total = 0;
+		while (!s->endOfStream() || conv->needsDraining()) {
+			int res = conv->convert(*s, out + total * 2, 22050 - total, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			if (res == 0)
+				break;
+			total += res;
+		}
+
+		TS_ASSERT_EQUALS(total, 22050);
+		TS_ASSERT_EQUALS(memcmp(sine, out, 22050 * 2 * sizeof(int16)), 0);
+
+		delete[] out;
+		delete[] sine;
+		delete conv;
+		delete s;
+	}
+
+	void test_fir_dot_product_simd() {
+		int16 samples[Audio::kPolyphaseTaps], coeffs[Audio::kPolyphaseTaps];
+		for (int i = 0; i < Audio::kPolyphaseTaps; ++i) {
+			samples[i] = (int16)((i * 7919) ^ 0x5a5a);
+			coeffs[i] = (int16)(((i * 104729) & 0x3fff) - 0x2000);
+		}
+
+		const int32 expected = Audio::firDotProductGeneric(samples, coeffs);
+#ifdef SCUMMVM_NEON
+		TS_ASSERT_EQUALS(Audio::firDotProductNEON(samples, coeffs), expected);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			TS_ASSERT_EQUALS(Audio::firDotProductSSE2(samples, coeffs), expected);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			TS_ASSERT_EQUALS(Audio::firDotProductAVX2(samples, coeffs), expected);
+#endif
+		(void)expected;
+	}
+};
@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/synthtrace.h"
+
+#include "common/memstream.h"
+
+namespace {
+
+class RecordingOPL : public OPL::OPL {
+public:
+	bool init() override { return true; }
+	void reset() override { writes.push_back(-1); }
+	void write(int a, int v) override { writes.push_back((a << 8) | v); }
+	byte read(int a) override { return 0; }
+	void writeReg(int r, int v) override { writes.push_back(0x1000000 | (r << 8) | v); }
+	void setCallbackFrequency(int timerFrequency) override { frequency = timerFrequency; }
+
+	Common::Array<int> writes;
+	int frequency = 0;
+
+protected:
+	void startCallbacks(int timerFrequency) override {}
+	void stopCallbacks() override {}
+};
+
+bool roundTrip(Audio::SynthTraceWriter &writer, Audio::SynthTracePlayer &player) {
+	Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+	if (!writer.save(out))
+		return false;
+	Common::MemoryReadStream in(out.getData(), out.size());
+	return player.load(in);
+}
+
+} // End of anonymous namespace
+
+class SynthTraceTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_midi_round_trip() {
+		Audio::SynthTraceWriter writer(Audio::kSynthTraceMidi);
+		writer.midiBaseTempo(1000);
+		writer.midiSend(0x7F3C90);
+		writer.tick();
+		writer.tick();
+		writer.tick();
+		writer.midiSend(0x05C1);
+		const byte sysEx[] = { 0x41, 0x10, 0x16, 0x12 };
+		writer.midiSysEx(sysEx, sizeof(sysEx));
+		for (int i = 0; i < 200; ++i)
+			writer.tick();
+		writer.midiStopAllNotes(true);
+
+		Audio::SynthTracePlayer player;
+		TS_ASSERT(roundTrip(writer, player));
+		TS_ASSERT_EQUALS(player.getDevice(), Audio::kSynthTraceMidi);
+		TS_ASSERT_EQUALS(player.getLength(), 203000u);
+
+		// MIDI drivers need the music plugins, so only follow the position
+		player.playMidi(nullptr, 0);
+		TS_ASSERT(!player.isFinished());
+		player.playMidi(nullptr, 202999);
+		TS_ASSERT(!player.isFinished());
+
+		// Multi-byte tick deltas
+		player.playMidi(nullptr, 203000);
+		TS_ASSERT(player.isFinished());
+
+		player.rewind();
+		TS_ASSERT(!player.isFinished());
+	}
+
+	void test_opl_round_trip() {
+		Audio::SynthTraceWriter writer(Audio::kSynthTraceOPL, OPL::Config::kOpl3);
+		writer.oplReset();
+		writer.oplWriteReg(0x1BD, 0x20);
+		writer.oplCallbackFrequency(70);
+		writer.tick();
+		writer.oplWrite(0x388, 0xB0);
+		writer.tick();
+		writer.tick();
+		writer.oplWrite(0x389, 0x31);
+
+		Audio::SynthTracePlayer player;
+		TS_ASSERT(roundTrip(writer, player));
+		TS_ASSERT_EQUALS(player.getDevice(), Audio::kSynthTraceOPL);
+		TS_ASSERT_EQUALS(player.getOplType(), OPL::Config::kOpl3);
+		TS_ASSERT_EQUALS(player.getLength(), 3u);
+		TS_ASSERT_EQUALS(player.getCallbackFrequency(), (int)OPL::OPL::kDefaultCallbackFrequency);
+
+		RecordingOPL opl;
+		player.playOPLTick(&opl);
+		TS_ASSERT_EQUALS(opl.writes.size(), 2u);
+		TS_ASSERT_EQUALS(opl.writes[0], -1);
+		TS_ASSERT_EQUALS(opl.writes[1], 0x101BD20);
+		TS_ASSERT_EQUALS(opl.frequency, 70);
+		TS_ASSERT_EQUALS(player.getCallbackFrequency(), 70);
+
+		player.playOPLTick(&opl);
+		TS_ASSERT_EQUALS(opl.writes.size(), 3u);
+		TS_ASSERT_EQUALS(opl.writes[2], 0x388B0);
+
+		player.playOPLTick(&opl);
+		TS_ASSERT_EQUALS(opl.writes.size(), 3u);
+		TS_ASSERT(!player.isFinished());
+
+		player.playOPLTick(&opl);
+		TS_ASSERT_EQUALS(opl.writes.size(), 4u);
+		TS_ASSERT_EQUALS(opl.writes[3], 0x38931);
+		TS_ASSERT(player.isFinished());
+	}
+
+	void test_invalid_traces() {
+		Audio::SynthTraceWriter writer(Audio::kSynthTraceMidi);
+		writer.midiBaseTempo(1000);
+		const byte sysEx[16] = { 0 };
+		writer.midiSysEx(sysEx, sizeof(sysEx));
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		TS_ASSERT(writer.save(out));
+
+		Audio::SynthTracePlayer player;
+		Common::MemoryReadStream complete(out.getData(), out.size());
+		TS_ASSERT(player.load(complete));
+
+		// Cut in the middle of the SysEx data
+		Common::MemoryReadStream truncated(out.getData(), out.size() - 4);
+		TS_ASSERT(!player.load(truncated));
+		TS_ASSERT(player.isFinished());
+
+		const byte garbage[] = { 'S', 'T', 'R', 'X', 1, 0, 0 };
+		Common::MemoryReadStream wrongTag(garbage, sizeof(garbage));
+		TS_ASSERT(!player.load(wrongTag));
+	}
+};
@@ -0,0 +1,41 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+
+#include "../../null_osystem.h"
+#include "../../temp_files.h"
+
+class PosixFSNodeTestSuite : public CxxTest::TestSuite {
+public:
+	void test_clone() {
+#if TEMP_FILES_ARE_AVAILABLE
+		Common::install_null_g_system();
+
+		const Common::String dir = Common::makeTempDirectory("fsnode-clone");
+		Common::createTempDirectory(dir + "/sub");
+		Common::writeTempFile(dir + "/file.dat", "data", 4);
+
+		Common::FSNode file(Common::Path(dir + "/file.dat", '/'));
+		Common::FSNode sub(Common::Path(dir + "/sub", '/'));
+		TS_ASSERT(file.exists());
+		TS_ASSERT(sub.isDirectory());
+
+		// The clones keep what the nodes knew, the file system is not
+		// checked again
+		Common::removeTempFile(dir + "/file.dat");
+		Common::removeTempFile(dir + "/sub");
+		Common::FSNode fileClone = file.clone();
+		Common::FSNode subClone = sub.clone();
+		TS_ASSERT(!fileClone.isDirectory());
+		TS_ASSERT(subClone.isDirectory());
+		TS_ASSERT_EQUALS(fileClone.getPath(), file.getPath());
+		TS_ASSERT_EQUALS(fileClone.getName(), "file.dat");
+		TS_ASSERT_EQUALS(subClone.getPath(), sub.getPath());
+
+		// Nodes created from the path do check it
+		TS_ASSERT(!Common::FSNode(sub.getPath()).isDirectory());
+
+		TS_ASSERT(!Common::FSNode().clone().exists());
+#endif
+	}
+};
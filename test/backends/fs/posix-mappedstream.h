@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/ptr.h"
+
+#include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mappedstream.h"
+
+#include "../../null_osystem.h"
+#include "../../temp_files.h"
+
+class PosixMappedStreamTestSuite : public CxxTest::TestSuite {
+	// Above the size from which POSIXFilesystemNode::createReadStream() maps files
+	static const uint32 kBigSize = 300 * 1024;
+
+	static Common::String writeFile(const char *dirName, const char *name, uint32 size) {
+		const Common::String path = Common::makeTempDirectory(dirName) + "/" + name;
+		byte *data = new byte[size];
+		for (uint32 i = 0; i < size; ++i)
+			data[i] = (byte)(i * 7 + (i >> 8));
+		Common::writeTempFile(path, data, size);
+		delete[] data;
+		return path;
+	}
+
+	static void checkContents(Common::SeekableReadStream &stream, uint32 size) {
+		TS_ASSERT_EQUALS(stream.size(), (int64)size);
+
+		byte buffer[16];
+		TS_ASSERT(stream.seek(1000));
+		TS_ASSERT_EQUALS(stream.read(buffer, sizeof(buffer)), sizeof(buffer));
+		for (uint32 i = 0; i < sizeof(buffer); ++i)
+			TS_ASSERT_EQUALS(buffer[i], (byte)((1000 + i) * 7 + ((1000 + i) >> 8)));
+		TS_ASSERT(!stream.eos());
+	}
+
+public:
+	void test_mapped() {
+#if TEMP_FILES_ARE_AVAILABLE && defined(HAS_MMAP)
+		const Common::String path = writeFile("mappedstream", "big.dat", kBigSize);
+		Common::ScopedPtr<PosixMappedReadStream> stream(PosixMappedReadStream::makeFromPath(path, kBigSize));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		checkContents(*stream, kBigSize);
+
+		// Reading the end stops at the end of the file
+		byte buffer[16];
+		TS_ASSERT(stream->seek(-4, SEEK_END));
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 4u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+
+		// Seeking past the end is allowed, and reading there gives nothing
+		TS_ASSERT(stream->seek(kBigSize + 100));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->pos(), (int64)kBigSize + 100);
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 0u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+
+		// Seeking clears the end of stream, but not before the start
+		TS_ASSERT(!stream->seek(-1));
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->getSpan().size(), kBigSize);
+		TS_ASSERT_EQUALS(stream->getSpan()[1000], (byte)(1000 * 7 + (1000 >> 8)));
+
+		// The file system node maps big files
+		Common::install_null_g_system();
+		Common::ScopedPtr<Common::SeekableReadStream> nodeStream(Common::FSNode(Common::Path(path, '/')).createReadStream());
+		TS_ASSERT(dynamic_cast<PosixMappedReadStream *>(nodeStream.get()));
+		if (nodeStream)
+			checkContents(*nodeStream, kBigSize);
+#endif
+	}
+
+	void test_fallback() {
+#if TEMP_FILES_ARE_AVAILABLE && defined(HAS_MMAP)
+		const uint32 smallSize = 4096;
+		const Common::String path = writeFile("mappedfallback", "small.dat", smallSize);
+
+		// Files below the minimum size, directories and missing files are
+		// not mapped
+		TS_ASSERT(!PosixMappedReadStream::makeFromPath(path, smallSize + 1));
+		TS_ASSERT(!PosixMappedReadStream::makeFromPath(Common::makeTempDirectory("mappedfallbackdir"), 0));
+		TS_ASSERT(!PosixMappedReadStream::makeFromPath(path + ".missing", 0));
+
+		// The file system node then reads them through stdio
+		Common::install_null_g_system();
+		Common::ScopedPtr<Common::SeekableReadStream> stream(Common::FSNode(Common::Path(path, '/')).createReadStream());
+		TS_ASSERT(dynamic_cast<PosixIoStream *>(stream.get()));
+		if (stream)
+			checkContents(*stream, smallSize);
+#endif
+	}
+};
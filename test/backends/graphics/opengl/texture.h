@@ -0,0 +1,224 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/graphics/opengl/texture.h"
+#include "graphics/opengl/context.h"
+
+/**
+ * GL functions which record the uploads of the textures instead of making
+ * them, put in place of the ones GLAD loads from a context.
+ */
+namespace TextureUploadStubs {
+
+struct Upload {
+	Common::Rect area;
+	GLint rowLength;
+	bool fromBuffer;
+	uint32 firstPixel;
+	uint32 lastPixel;
+};
+
+static Common::Array<Upload> uploads;
+static Common::Array<byte> buffer;
+static GLuint boundBuffer = 0;
+static GLint rowLength = 0;
+static GLuint nextName = 1;
+static uint bufferDataCalls = 0;
+static uint mapCalls = 0;
+
+static void GLAD_API_PTR genNames(GLsizei n, GLuint *names) {
+	for (GLsizei i = 0; i < n; ++i)
+		names[i] = nextName++;
+}
+
+static void GLAD_API_PTR deleteNames(GLsizei n, const GLuint *names) {
+}
+
+static void GLAD_API_PTR bindTexture(GLenum target, GLuint texture) {
+}
+
+static void GLAD_API_PTR texParameteri(GLenum target, GLenum pname, GLint param) {
+}
+
+static void GLAD_API_PTR pixelStorei(GLenum pname, GLint param) {
+	if (pname == GL_UNPACK_ROW_LENGTH)
+		rowLength = param;
+}
+
+static void GLAD_API_PTR texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                    GLint border, GLenum format, GLenum type, const void *pixels) {
+}
+
+static void GLAD_API_PTR texSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+                                       GLenum format, GLenum type, const void *pixels) {
+	Upload upload;
+	upload.area = Common::Rect(x, y, x + width, y + height);
+	upload.rowLength = rowLength;
+	upload.fromBuffer = boundBuffer != 0;
+
+	// Pixels are 32 bits in these tests
+	const byte *data = boundBuffer ? &buffer[(size_t)pixels] : (const byte *)pixels;
+	const GLint pitch = (rowLength ? rowLength : width) * 4;
+	upload.firstPixel = READ_UINT32(data);
+	upload.lastPixel = READ_UINT32(data + (height - 1) * pitch + (width - 1) * 4);
+	uploads.push_back(upload);
+}
+
+static void GLAD_API_PTR bindBuffer(GLenum target, GLuint name) {
+	boundBuffer = name;
+}
+
+static void GLAD_API_PTR bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+	buffer.resize(size);
+	if (data)
+		memcpy(buffer.begin(), data, size);
+	bufferDataCalls++;
+}
+
+static void *GLAD_API_PTR mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+	mapCalls++;
+	return &buffer[offset];
+}
+
+static GLboolean GLAD_API_PTR unmapBuffer(GLenum target) {
+	return GL_TRUE;
+}
+
+static GLenum GLAD_API_PTR getError() {
+	return GL_NO_ERROR;
+}
+
+} // End of namespace TextureUploadStubs
+
+class OpenGLTextureTestSuite : public CxxTest::TestSuite {
+	/**
+	 * A 640x480 texture, with two opposite corners changed since the last
+	 * upload. The last row of a corner has another color than the others.
+	 */
+	class CornersTexture {
+	public:
+		CornersTexture()
+			: _texture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)) {
+			_texture.allocate(640, 480);
+			_texture.fill(0);
+			_texture.updateGLTexture();
+			TextureUploadStubs::uploads.clear();
+			OpenGL::GLTexture::resetUploadedBytes();
+
+			_texture.fill(Common::Rect(0, 0, 16, 8), 0x11111111);
+			_texture.fill(Common::Rect(0, 7, 16, 8), 0x33333333);
+			_texture.fill(Common::Rect(624, 472, 640, 480), 0x22222222);
+			_texture.fill(Common::Rect(624, 479, 640, 480), 0x44444444);
+			_texture.updateGLTexture();
+		}
+
+	private:
+		OpenGL::Texture _texture;
+	};
+
+	static void checkCorners() {
+		const Common::Array<TextureUploadStubs::Upload> &uploads = TextureUploadStubs::uploads;
+		TS_ASSERT_EQUALS(uploads.size(), 2u);
+		if (uploads.size() != 2)
+			return;
+
+		TS_ASSERT_EQUALS(uploads[0].area, Common::Rect(0, 0, 16, 8));
+		TS_ASSERT_EQUALS(uploads[0].firstPixel, 0x11111111u);
+		TS_ASSERT_EQUALS(uploads[0].lastPixel, 0x33333333u);
+		TS_ASSERT_EQUALS(uploads[1].area, Common::Rect(624, 472, 640, 480));
+		TS_ASSERT_EQUALS(uploads[1].firstPixel, 0x22222222u);
+		TS_ASSERT_EQUALS(uploads[1].lastPixel, 0x44444444u);
+
+		// The corners themselves, rather than their bounding box
+		TS_ASSERT_EQUALS(OpenGL::GLTexture::getUploadedBytes(), 2u * 16 * 8 * 4);
+	}
+
+public:
+	void setUp() override {
+		glad_glGenTextures = TextureUploadStubs::genNames;
+		glad_glDeleteTextures = TextureUploadStubs::deleteNames;
+		glad_glBindTexture = TextureUploadStubs::bindTexture;
+		glad_glTexParameteri = TextureUploadStubs::texParameteri;
+		glad_glPixelStorei = TextureUploadStubs::pixelStorei;
+		glad_glTexImage2D = TextureUploadStubs::texImage2D;
+		glad_glTexSubImage2D = TextureUploadStubs::texSubImage2D;
+		glad_glGenBuffers = TextureUploadStubs::genNames;
+		glad_glDeleteBuffers = TextureUploadStubs::deleteNames;
+		glad_glBindBuffer = TextureUploadStubs::bindBuffer;
+		glad_glBufferData = TextureUploadStubs::bufferData;
+		glad_glMapBufferRange = TextureUploadStubs::mapBufferRange;
+		glad_glUnmapBuffer = TextureUploadStubs::unmapBuffer;
+		glad_glGetError = TextureUploadStubs::getError;
+
+		OpenGLContext.reset();
+		OpenGLContext.type = OpenGL::kContextGL;
+		OpenGLContext.NPOTSupported = true;
+		OpenGLContext.textureEdgeClampSupported = true;
+
+		TextureUploadStubs::bufferDataCalls = 0;
+		TextureUploadStubs::mapCalls = 0;
+	}
+
+	void tearDown() override {
+		OpenGLContext.reset();
+	}
+
+	void test_upload_mapped_pixel_buffer() {
+		OpenGLContext.unpackSubImageSupported = true;
+		OpenGLContext.pixelBufferObjectSupported = true;
+		OpenGLContext.mapBufferRangeSupported = true;
+		CornersTexture texture;
+		checkCorners();
+
+		// The rows are packed in the buffer
+		TS_ASSERT_EQUALS(TextureUploadStubs::mapCalls, 2u);
+		TS_ASSERT_EQUALS(TextureUploadStubs::buffer.size(), 16u * 8 * 4);
+		for (uint i = 0; i < TextureUploadStubs::uploads.size(); ++i) {
+			TS_ASSERT(TextureUploadStubs::uploads[i].fromBuffer);
+			TS_ASSERT_EQUALS(TextureUploadStubs::uploads[i].rowLength, 0);
+		}
+	}
+
+	void test_upload_pitched_pixel_buffer() {
+		OpenGLContext.unpackSubImageSupported = true;
+		OpenGLContext.pixelBufferObjectSupported = true;
+		CornersTexture texture;
+		checkCorners();
+
+		// Without mapping, the rows are copied with the pitch of the surface
+		TS_ASSERT_EQUALS(TextureUploadStubs::mapCalls, 0u);
+		TS_ASSERT_EQUALS(TextureUploadStubs::buffer.size(), 7u * 640 * 4 + 16 * 4);
+		for (uint i = 0; i < TextureUploadStubs::uploads.size(); ++i) {
+			TS_ASSERT(TextureUploadStubs::uploads[i].fromBuffer);
+			TS_ASSERT_EQUALS(TextureUploadStubs::uploads[i].rowLength, 640);
+		}
+		TS_ASSERT_EQUALS(TextureUploadStubs::rowLength, 0);
+	}
+
+	void test_upload_unpack_subimage() {
+		OpenGLContext.unpackSubImageSupported = true;
+		CornersTexture texture;
+		checkCorners();
+
+		TS_ASSERT_EQUALS(TextureUploadStubs::bufferDataCalls, 0u);
+		for (uint i = 0; i < TextureUploadStubs::uploads.size(); ++i) {
+			TS_ASSERT(!TextureUploadStubs::uploads[i].fromBuffer);
+			TS_ASSERT_EQUALS(TextureUploadStubs::uploads[i].rowLength, 640);
+		}
+		TS_ASSERT_EQUALS(TextureUploadStubs::rowLength, 0);
+	}
+
+	void test_upload_whole_lines() {
+		// Without a pitch for the uploads, as with OpenGL ES 1.0
+		CornersTexture texture;
+		const Common::Array<TextureUploadStubs::Upload> &uploads = TextureUploadStubs::uploads;
+		TS_ASSERT_EQUALS(uploads.size(), 2u);
+		if (uploads.size() != 2)
+			return;
+
+		TS_ASSERT_EQUALS(uploads[0].area, Common::Rect(0, 0, 640, 8));
+		TS_ASSERT_EQUALS(uploads[0].firstPixel, 0x11111111u);
+		TS_ASSERT_EQUALS(uploads[1].area, Common::Rect(0, 472, 640, 480));
+		TS_ASSERT_EQUALS(uploads[1].lastPixel, 0x44444444u);
+		TS_ASSERT_EQUALS(OpenGL::GLTexture::getUploadedBytes(), 2u * 640 * 8 * 4);
+	}
+};
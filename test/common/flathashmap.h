@@ -0,0 +1,228 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringMap;
+
+	struct LCG {
+		uint32 state;
+
+		LCG() : state(1234) {}
+
+		uint32 next() {
+			state = state * 1103515245 + 12345;
+			return state >> 8;
+		}
+	};
+
+	/** Insert @p count keys, look each of them up and miss as many, then erase them. */
+	template<class Map>
+	static uint32 benchmarkInts(uint count, uint32 &checksum) {
+		const uint32 start = g_system->getMillis();
+		Map map;
+		for (uint i = 0; i < count; ++i)
+			map[i * 7919] = i;
+		for (uint pass = 0; pass < 4; ++pass) {
+			for (uint i = 0; i < count; ++i) {
+				checksum += map.getValOrDefault(i * 7919);
+				checksum += map.contains(i * 7919 + 1);
+			}
+		}
+		for (uint i = 0; i < count; ++i)
+			map.erase(i * 7919);
+		return g_system->getMillis() - start;
+	}
+
+	template<class Map>
+	static uint32 benchmarkStrings(const Common::Array<Common::String> &keys, uint32 &checksum) {
+		const uint32 start = g_system->getMillis();
+		Map map;
+		for (uint i = 0; i < keys.size(); ++i)
+			map[keys[i]] = keys[i];
+		for (uint pass = 0; pass < 4; ++pass) {
+			for (uint i = 0; i < keys.size(); ++i)
+				checksum += map.getValOrDefault(keys[i]).size();
+		}
+		for (uint i = 0; i < keys.size(); ++i)
+			map.erase(keys[i]);
+		return g_system->getMillis() - start;
+	}
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		StringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT(!container2.contains("foo"));
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		StringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(1);
+		container.erase(2);
+		container.erase(container.find(3));
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container.setVal(1, -1);
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+		TS_ASSERT_EQUALS(containerRef.getVal(1), -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+		TS_ASSERT_EQUALS(containerRef.size(), 2u);
+
+		int val = 0;
+		TS_ASSERT(containerRef.tryGetVal(0, val));
+		TS_ASSERT_EQUALS(val, 17);
+		TS_ASSERT(!containerRef.tryGetVal(2, val));
+	}
+
+	void test_iterator_copy() {
+		Common::FlatHashMap<int, int> map1;
+		for (int i = 0; i < 100; ++i)
+			map1[i * 3] = i;
+		for (int i = 0; i < 100; i += 2)
+			map1.erase(i * 3);
+
+		Common::FlatHashMap<int, int> map2;
+		map2[5] = 5;
+		map2 = map1;
+		map1.clear();
+		TS_ASSERT_EQUALS(map2.size(), 50u);
+
+		int count = 0, sum = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator it = map2.begin(); it != map2.end(); ++it) {
+			TS_ASSERT_EQUALS(it->_key, it->_value * 3);
+			sum += it->_value;
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, 50);
+		TS_ASSERT_EQUALS(sum, 2500);
+
+		// Erasing while iterating must visit each remaining node once
+		for (Common::FlatHashMap<int, int>::iterator it = map2.begin(); it != map2.end(); ++it) {
+			if (it->_value % 3 == 0)
+				map2.erase(it);
+		}
+		TS_ASSERT_EQUALS(map2.size(), 33u);
+		TS_ASSERT(!map2.contains(9));
+		TS_ASSERT(map2.contains(3));
+	}
+
+	void test_against_hashmap() {
+		// Random inserts and erases, with a lot of tombstones, must keep both
+		// maps in sync
+		Common::HashMap<uint32, uint32> reference;
+		Common::FlatHashMap<uint32, uint32> map;
+		LCG rnd;
+		for (uint i = 0; i < 20000; ++i) {
+			const uint32 key = rnd.next() % 1500;
+			if (rnd.next() % 3 == 0) {
+				reference.erase(key);
+				map.erase(key);
+			} else {
+				reference[key] = i;
+				map[key] = i;
+			}
+		}
+
+		TS_ASSERT_EQUALS(map.size(), reference.size());
+		for (Common::HashMap<uint32, uint32>::const_iterator it = reference.begin(); it != reference.end(); ++it)
+			TS_ASSERT_EQUALS(map.getValOrDefault(it->_key, 0xFFFFFFFF), it->_value);
+		for (Common::FlatHashMap<uint32, uint32>::const_iterator it = map.begin(); it != map.end(); ++it)
+			TS_ASSERT(reference.contains(it->_key));
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const uint count = 2000000;
+#else
+		const uint count = 200000;
+#endif
+
+		uint32 checksum = 0, flatChecksum = 0;
+		const uint32 intTime = benchmarkInts<Common::HashMap<uint32, uint32> >(count, checksum);
+		const uint32 flatIntTime = benchmarkInts<Common::FlatHashMap<uint32, uint32> >(count, flatChecksum);
+		TS_ASSERT_EQUALS(checksum, flatChecksum);
+
+		LCG rnd;
+		Common::Array<Common::String> keys;
+		for (uint i = 0; i < count / 4; ++i)
+			keys.push_back(Common::String::format("dir%u/File%08X.dat", i % 37, rnd.next()));
+
+		checksum = flatChecksum = 0;
+		const uint32 strTime = benchmarkStrings<Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >(keys, checksum);
+		const uint32 flatStrTime = benchmarkStrings<StringMap>(keys, flatChecksum);
+		TS_ASSERT_EQUALS(checksum, flatChecksum);
+
+		debug("HashMap<uint32>: %u ms, FlatHashMap<uint32>: %u ms\n", intTime, flatIntTime);
+		debug("HashMap<String>: %u ms, FlatHashMap<String>: %u ms\n", strTime, flatStrTime);
+#endif
+	}
+};
@@ -0,0 +1,146 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+
+#include "../temp_files.h"
+
+class FSDirectoryTestSuite : public CxxTest::TestSuite {
+#if TEMP_FILES_ARE_AVAILABLE
+	Common::TempCacheDirectories _temp;
+
+	void setUpTree(const char *name) {
+		_temp.setUp(name);
+
+		Common::createTempDirectory(_temp.dir + "/a");
+		Common::createTempDirectory(_temp.dir + "/b");
+		addFile("a/one.txt");
+		addFile("b/two.txt");
+
+		// The index only trusts directories changed before they were listed
+		touch("a", _temp.past);
+		touch("b", _temp.past);
+		touch("", _temp.past);
+	}
+
+	void tearDown() override {
+		_temp.tearDown();
+	}
+
+	void addFile(const char *name) {
+		Common::writeTempFile(_temp.dir + "/" + name, name, strlen(name));
+	}
+
+	void touch(const char *dir, int64 time) {
+		Common::setTempFileTime(*dir ? _temp.dir + "/" + dir : _temp.dir, time);
+	}
+
+	bool hasFile(const char *name) {
+		Common::FSDirectory dir(Common::Path(_temp.dir, '/'), 2);
+		return dir.hasFile(name);
+	}
+
+	Common::FSList listIndexFiles() {
+		Common::FSList list;
+		Common::FSNode(Common::Path(_temp.cache, '/')).getChildren(list, Common::FSNode::kListFilesOnly);
+		return list;
+	}
+
+	/** Damage the single index file, see Common::damageTempFile() */
+	void damageIndex(uint32 keep, bool flip) {
+		Common::FSList list = listIndexFiles();
+		TS_ASSERT_EQUALS(list.size(), 1u);
+		if (list.size() == 1)
+			Common::damageTempFile(list[0].getPath().toString('/'), keep, flip);
+	}
+#endif
+
+public:
+	void test_index_reused() {
+#if TEMP_FILES_ARE_AVAILABLE
+		setUpTree("fsindex-reused");
+		TS_ASSERT(hasFile("a/one.txt"));
+		TS_ASSERT(hasFile("b/two.txt"));
+		TS_ASSERT_EQUALS(listIndexFiles().size(), 1u);
+
+		// With the same time, the listing comes from the index, which does
+		// not know about the new file
+		addFile("a/three.txt");
+		touch("a", _temp.past);
+		TS_ASSERT(!hasFile("a/three.txt"));
+		TS_ASSERT(hasFile("a/one.txt"));
+#endif
+	}
+
+	void test_index_invalidated() {
+#if TEMP_FILES_ARE_AVAILABLE
+		setUpTree("fsindex-invalidated");
+		TS_ASSERT(hasFile("a/one.txt"));
+
+		addFile("a/three.txt");
+		touch("a", _temp.past + 10);
+		TS_ASSERT(hasFile("a/three.txt"));
+
+		Common::removeTempFile(_temp.dir + "/b/two.txt");
+		touch("b", _temp.past + 10);
+		TS_ASSERT(!hasFile("b/two.txt"));
+		TS_ASSERT(hasFile("a/three.txt"));
+#endif
+	}
+
+	void test_index_changed_when_read() {
+#if TEMP_FILES_ARE_AVAILABLE
+		setUpTree("fsindex-changed-when-read");
+
+		// A time ahead of the clock stands for a directory changed in the
+		// second it was read, which can change again without a new time
+		const int64 future = Common::getTempFileNow() + 100;
+		touch("a", future);
+		TS_ASSERT(hasFile("a/one.txt"));
+
+		// Neither the later change nor a later save of the index make the
+		// listing trustworthy
+		addFile("a/three.txt");
+		touch("a", future);
+		Common::FSList list = listIndexFiles();
+		TS_ASSERT_EQUALS(list.size(), 1u);
+		if (list.size() == 1)
+			Common::setTempFileTime(list[0].getPath().toString('/'), future + 100);
+		TS_ASSERT(hasFile("a/three.txt"));
+#endif
+	}
+
+	void test_index_damaged() {
+#if TEMP_FILES_ARE_AVAILABLE
+		setUpTree("fsindex-damaged");
+		TS_ASSERT(hasFile("a/one.txt"));
+
+		// A stale index would hide the new files
+		addFile("a/three.txt");
+		touch("a", _temp.past);
+		damageIndex(0xFFFFFFFF, true);
+		TS_ASSERT(hasFile("a/three.txt"));
+
+		addFile("b/four.txt");
+		touch("b", _temp.past);
+		damageIndex(20, false);
+		TS_ASSERT(hasFile("b/four.txt"));
+#endif
+	}
+
+	void test_index_bounded() {
+#if TEMP_FILES_ARE_AVAILABLE
+		setUpTree("fsindex-bounded");
+		for (int i = 0; i < 100; ++i) {
+			const Common::String root = _temp.dir + Common::String::format("/a/tree%d", i);
+			Common::createTempDirectory(root);
+			Common::createTempDirectory(root + "/sub");
+			Common::writeTempFile(root + "/sub/file", "file", 4);
+			Common::setTempFileTime(root, _temp.past);
+			Common::FSDirectory dir(Common::Path(root, '/'), 2);
+			TS_ASSERT(dir.hasFile("sub/file"));
+		}
+
+		TS_ASSERT_LESS_THAN_EQUALS(listIndexFiles().size(), 32u);
+#endif
+	}
+};
@@ -0,0 +1,131 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/compression/deflate.h"
+#include "common/compression/lz4.h"
+
+class LZ4TestSuite : public CxxTest::TestSuite {
+	/** Write stream appending to an array which outlives it */
+	class ArrayWriteStream : public Common::WriteStream {
+	public:
+		ArrayWriteStream(Common::Array<byte> &data) : _data(data) {}
+
+		uint32 write(const void *dataPtr, uint32 dataSize) override {
+			const byte *p = (const byte *)dataPtr;
+			for (uint32 i = 0; i < dataSize; ++i)
+				_data.push_back(p[i]);
+			return dataSize;
+		}
+
+		int64 pos() const override { return _data.size(); }
+
+	private:
+		Common::Array<byte> &_data;
+	};
+
+	static Common::Array<byte> compress(const Common::Array<byte> &data) {
+		Common::Array<byte> compressed;
+		Common::WriteStream *stream = Common::wrapLZ4WriteStream(new ArrayWriteStream(compressed));
+		// Odd chunk sizes, so that writes straddle the blocks
+		for (uint i = 0; i < data.size(); i += 1000)
+			stream->write(&data[i], MIN<uint>(1000, data.size() - i));
+		stream->finalize();
+		TS_ASSERT(!stream->err());
+		TS_ASSERT_EQUALS(stream->pos(), (int64)data.size());
+		delete stream;
+		return compressed;
+	}
+
+	/** Text which compresses well, with a stretch of noise in between */
+	static Common::Array<byte> makeData(uint size) {
+		Common::Array<byte> data;
+		uint32 state = 1234;
+		for (uint i = 0; i < size; ++i) {
+			state = state * 1103515245 + 12345;
+			if (i > size / 3 && i < size / 2)
+				data.push_back(state >> 24);
+			else
+				data.push_back("Lorem ipsum dolor sit amet, "[(i + i / 301) % 28]);
+		}
+		return data;
+	}
+
+public:
+	void test_round_trip() {
+		const uint sizes[] = { 0, 1, 12, 13, 100, 65536, 65537, 300000 };
+		for (uint i = 0; i < ARRAYSIZE(sizes); ++i) {
+			const Common::Array<byte> data = makeData(sizes[i]);
+			const Common::Array<byte> compressed = compress(data);
+			if (sizes[i] >= 65536)
+				TS_ASSERT_LESS_THAN(compressed.size(), data.size());
+
+			// Saved games go through wrapCompressedReadStream()
+			Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(new Common::MemoryReadStream(compressed.data(), compressed.size()));
+			TS_ASSERT(stream);
+			if (!stream)
+				continue;
+			TS_ASSERT_EQUALS(stream->size(), (int64)data.size());
+			Common::Array<byte> decompressed(data.size() + 1);
+			TS_ASSERT_EQUALS(stream->read(decompressed.data(), decompressed.size()), data.size());
+			if (data.size())
+				TS_ASSERT_SAME_DATA(decompressed.data(), data.data(), data.size());
+			delete stream;
+		}
+	}
+
+	void test_reference_frame() {
+		// Written by the lz4 command line tool, with the content size and
+		// the block checksums
+		static const byte frame[] = {
+			0x04, 0x22, 0x4d, 0x18, 0x7c, 0x40, 0x70, 0x02, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x0f, 0x5e, 0x00, 0x00, 0x00, 0xf1, 0x17, 0x6c, 0x69, 0x6e,
+			0x65, 0x20, 0x30, 0x3a, 0x20, 0x74, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69,
+			0x63, 0x6b, 0x20, 0x62, 0x72, 0x6f, 0x77, 0x6e, 0x20, 0x66, 0x6f, 0x78,
+			0x20, 0x6a, 0x75, 0x6d, 0x70, 0x73, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x1f,
+			0x00, 0x91, 0x6c, 0x61, 0x7a, 0x79, 0x20, 0x64, 0x6f, 0x67, 0x0a, 0x34,
+			0x00, 0x1f, 0x31, 0x34, 0x00, 0x20, 0x1f, 0x32, 0x34, 0x00, 0x20, 0x1f,
+			0x33, 0x34, 0x00, 0x20, 0x1f, 0x34, 0x34, 0x00, 0x20, 0x1f, 0x35, 0x34,
+			0x00, 0x20, 0x1f, 0x36, 0x34, 0x00, 0x1b, 0x0f, 0x6c, 0x01, 0xec, 0x50,
+			0x20, 0x64, 0x6f, 0x67, 0x0a, 0xc2, 0xa6, 0xa9, 0xe8, 0x00, 0x00, 0x00,
+			0x00, 0x10, 0xe9, 0x33, 0x75
+		};
+
+		Common::String expected;
+		for (uint i = 0; i < 12; ++i)
+			expected += Common::String::format("line %u: the quick brown fox jumps over the lazy dog\n", i % 7);
+
+		Common::MemoryReadStream source(frame, sizeof(frame));
+		TS_ASSERT(Common::isLZ4Stream(&source));
+		Common::SeekableReadStream *stream = Common::wrapLZ4ReadStream(&source, DisposeAfterUse::NO);
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		TS_ASSERT_EQUALS(stream->size(), (int64)expected.size());
+		Common::Array<byte> decompressed(expected.size());
+		stream->read(decompressed.data(), decompressed.size());
+		TS_ASSERT_SAME_DATA(decompressed.data(), expected.c_str(), expected.size());
+		delete stream;
+	}
+
+	void test_corrupted() {
+		const Common::Array<byte> data = makeData(100000);
+		Common::Array<byte> compressed = compress(data);
+
+		// The content checksum catches the damage
+		compressed[compressed.size() / 2] ^= 0x10;
+		Common::MemoryReadStream source(compressed.data(), compressed.size());
+		TS_ASSERT(!Common::wrapLZ4ReadStream(&source, DisposeAfterUse::NO));
+
+		// So does the header checksum
+		compressed = compress(data);
+		compressed[5] ^= 0x01;
+		Common::MemoryReadStream source2(compressed.data(), compressed.size());
+		TS_ASSERT(!Common::wrapLZ4ReadStream(&source2, DisposeAfterUse::NO));
+
+		// A truncated frame is rejected
+		compressed = compress(data);
+		Common::MemoryReadStream source3(compressed.data(), compressed.size() - 10);
+		TS_ASSERT(!Common::wrapLZ4ReadStream(&source3, DisposeAfterUse::NO));
+	}
+};
@@ -417,6 +417,57 @@ class PathTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(map.size(), 2u);
 	}
 
+	void test_pathkey() {
+		Common::Path p3("parent/dir/xn--Sound Manager 3.1  SoundLib-lba84k/Sound");
+		Common::Path p4("parent:dir:Sound Manager 3.1 / SoundLib:Sound", ':');
+		Common::Path p5("PARENT/DIR/Sound Manager 3.1 : SoundLib/SOUND");
+		Common::Path p6("parent/dir/Sound Manager 3.1 / SoundLib/Sound");
+
+		// The keys must agree with equalsIgnoreCaseAndMac
+		TS_ASSERT_EQUALS(Common::PathKey(p3), Common::PathKey(p4));
+		TS_ASSERT_EQUALS(Common::PathKey(p3), Common::PathKey(p5));
+		TS_ASSERT(p3.equalsIgnoreCaseAndMac(p5));
+		TS_ASSERT_DIFFERS(Common::PathKey(p3), Common::PathKey(p6));
+		TS_ASSERT(!p3.equalsIgnoreCaseAndMac(p6));
+		TS_ASSERT_EQUALS(Common::PathKey(p5).getIdentifier(), "parent/dir/sound manager 3.1 : soundlib/sound");
+		TS_ASSERT_EQUALS(Common::PathKey(p5).getPath(), p5);
+		TS_ASSERT_EQUALS(Common::PathKey(Common::Path()), Common::PathKey());
+		TS_ASSERT_DIFFERS(Common::PathKey(Common::Path("a/b")), Common::PathKey(Common::Path("ab")));
+
+		typedef Common::HashMap<Common::PathKey, bool, Common::PathKey::Hash, Common::PathKey::EqualTo> TestPathMap;
+		TestPathMap map;
+		map.setVal(p3, false);
+		map.setVal(p4, false);
+		map.setVal(p5, false);
+		TS_ASSERT_EQUALS(map.size(), 1u);
+		map.setVal(p6, false);
+		TS_ASSERT_EQUALS(map.size(), 2u);
+		TS_ASSERT(map.contains(Common::Path("parent/DIR/sound MANAGER 3.1 : soundlib/Sound")));
+	}
+
+	void test_ignorecasepathkey() {
+		Common::Path p3("parent/dir/xn--Sound Manager 3.1  SoundLib-lba84k/Sound");
+		Common::Path p5("PARENT/DIR/Sound Manager 3.1 : SoundLib/SOUND");
+		Common::Path p7("Parent/Dir/XN--SOUND MANAGER 3.1  SOUNDLIB-LBA84K/sound");
+
+		// The keys must agree with equalsIgnoreCase
+		TS_ASSERT_EQUALS(Common::IgnoreCasePathKey(p3), Common::IgnoreCasePathKey(p7));
+		TS_ASSERT(p3.equalsIgnoreCase(p7));
+		TS_ASSERT_DIFFERS(Common::IgnoreCasePathKey(p3), Common::IgnoreCasePathKey(p5));
+		TS_ASSERT(!p3.equalsIgnoreCase(p5));
+		TS_ASSERT_EQUALS(Common::IgnoreCasePathKey(p7).getPath(), p7);
+		TS_ASSERT_DIFFERS(Common::IgnoreCasePathKey(Common::Path("a/b")), Common::IgnoreCasePathKey(Common::Path("a|b")));
+
+		typedef Common::HashMap<Common::IgnoreCasePathKey, bool, Common::PathKey::Hash, Common::PathKey::EqualTo> TestPathMap;
+		TestPathMap map;
+		map.setVal(p3, false);
+		map.setVal(p7, false);
+		TS_ASSERT_EQUALS(map.size(), 1u);
+		map.setVal(p5, false);
+		TS_ASSERT_EQUALS(map.size(), 2u);
+		TS_ASSERT(map.contains(Common::Path("parent/DIR/sound MANAGER 3.1 : soundlib/Sound")));
+	}
+
 	void test_lowerupper() {
 		Common::Path p2(TEST_PATH);
 		p2.toUppercase();
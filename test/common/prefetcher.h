@@ -0,0 +1,180 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+class PrefetcherTestSuite : public CxxTest::TestSuite {
+	/** Archive over strings, counting the members it opens */
+	class StringArchive : public Common::Archive {
+	public:
+		StringArchive(bool background) : _background(background), _opened(0) {}
+
+		void addMember(const Common::Path &path, const Common::String &contents) {
+			_members[path] = contents;
+		}
+
+		uint getOpenedCount() const { return _opened; }
+
+		bool hasFile(const Common::Path &path) const override {
+			return _members.contains(path);
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			for (MemberMap::const_iterator it = _members.begin(); it != _members.end(); ++it)
+				list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(it->_key, *this)));
+			return _members.size();
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+			if (!hasFile(path))
+				return Common::ArchiveMemberPtr();
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+			MemberMap::const_iterator it = _members.find(path);
+			if (it == _members.end())
+				return nullptr;
+			_opened++;
+			return new Common::MemoryReadStream((const byte *)it->_value.c_str(), it->_value.size());
+		}
+
+		bool canReadMembersInBackground() const override { return _background; }
+
+	private:
+		typedef Common::HashMap<Common::Path, Common::String, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> MemberMap;
+
+		MemberMap _members;
+		bool _background;
+		mutable uint _opened;
+	};
+
+	static Common::String readAll(Common::SeekableReadStream *stream) {
+		Common::String contents;
+		if (!stream)
+			return contents;
+		while (true) {
+			const byte b = stream->readByte();
+			if (stream->eos())
+				break;
+			contents += (char)b;
+		}
+		delete stream;
+		return contents;
+	}
+
+	public:
+	void test_prefetch() {
+		StringArchive archive(true);
+		archive.addMember("room1.dat", "first room");
+		archive.addMember("room2.dat", "second room");
+
+		Common::SearchSet set;
+		set.add("strings", &archive, 0, false);
+		set.prefetch("room1.dat");
+		set.prefetch("room1.dat");
+		set.prefetch("missing.dat");
+		set.waitForPrefetches();
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 1u);
+
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room1.dat")), "first room");
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 1u);
+
+		// Taken members are not kept around
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room1.dat")), "first room");
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 2u);
+
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room2.dat")), "second room");
+		TS_ASSERT(!set.createReadStreamForMember("missing.dat"));
+	}
+
+	void test_prefetch_ignores_case() {
+		StringArchive archive(true);
+		archive.addMember("room1.dat", "first room");
+
+		// Members are found the way the search set finds them
+		Common::SearchSet set;
+		set.add("strings", &archive, 0, false);
+		set.prefetch("ROOM1.DAT");
+		set.prefetch("Room1.dat");
+		set.waitForPrefetches();
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 1u);
+
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room1.dat")), "first room");
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 1u);
+	}
+
+	void test_prefetch_foreground_archive() {
+		StringArchive archive(false);
+		archive.addMember("room1.dat", "first room");
+
+		Common::SearchSet set;
+		set.add("strings", &archive, 0, false);
+		set.prefetch("room1.dat");
+		set.waitForPrefetches();
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 0u);
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room1.dat")), "first room");
+	}
+
+	void test_prefetch_limit() {
+		StringArchive archive(true);
+		archive.addMember("a.dat", "aaaaaa");
+		archive.addMember("b.dat", "bbbbbb");
+		archive.addMember("big.dat", "this does not fit");
+
+		Common::SearchSet set;
+		set.add("strings", &archive, 0, false);
+		set.setPrefetchCacheSize(10);
+		set.prefetch("a.dat");
+		set.prefetch("b.dat");
+		set.prefetch("big.dat");
+		set.waitForPrefetches();
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 3u);
+
+		// The oldest member was dropped to make room for the next one
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("b.dat")), "bbbbbb");
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 3u);
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("a.dat")), "aaaaaa");
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("big.dat")), "this does not fit");
+		TS_ASSERT_EQUALS(archive.getOpenedCount(), 5u);
+	}
+
+	void test_prefetch_temporary_paths() {
+		// Names longer than the storage inside a string, so that their
+		// buffers are reference counted
+		StringArchive archive(true);
+		for (int i = 0; i < 32; ++i)
+			archive.addMember(Common::Path(Common::String::format("a/rather/long/directory/name/member%02d.dat", i)), Common::String::format("contents of the member %02d", i));
+
+		Common::SearchSet set;
+		set.add("strings", &archive, 0, false);
+		for (int round = 0; round < 50; ++round) {
+			// The paths are destroyed while the worker reads the members
+			for (int i = 0; i < 32; ++i)
+				set.prefetch(Common::Path(Common::String::format("a/rather/long/directory/name/member%02d.dat", i)));
+
+			for (int i = round % 2; i < 32; i += 2) {
+				Common::SeekableReadStream *stream = set.createReadStreamForMember(Common::Path(Common::String::format("a/rather/long/directory/name/member%02d.dat", i)));
+				TS_ASSERT_EQUALS(readAll(stream), Common::String::format("contents of the member %02d", i));
+			}
+		}
+		set.waitForPrefetches();
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("a/rather/long/directory/name/member07.dat")), "contents of the member 07");
+	}
+
+	void test_prefetch_dropped_by_add() {
+		StringArchive archive(true), patches(true);
+		archive.addMember("room1.dat", "first room");
+		patches.addMember("room1.dat", "patched room");
+
+		Common::SearchSet set;
+		set.add("strings", &archive, 0, false);
+		set.prefetch("room1.dat");
+		set.add("patches", &patches, 1, false);
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room1.dat")), "patched room");
+
+		set.prefetch("room1.dat");
+		set.remove("patches");
+		TS_ASSERT_EQUALS(readAll(set.createReadStreamForMember("room1.dat")), "first room");
+	}
+};
@@ -70,4 +70,19 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_contiguous_data() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+
+		ssrs.seek(1);
+		TS_ASSERT_EQUALS(ssrs.getContiguousData(4), contents + 3);
+		TS_ASSERT_EQUALS(ssrs.pos(), 5);
+
+		// Past the end of the substream, even if the parent has enough data
+		TS_ASSERT(!ssrs.getContiguousData(2));
+		TS_ASSERT_EQUALS(ssrs.pos(), 5);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 7);
+	}
 };
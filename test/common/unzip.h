@@ -0,0 +1,169 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/compression/unzip.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	enum {
+		// Big enough to be streamed, and spanning several inflate windows
+		kMemberSize = 700 * 1000,
+		kMethodStore = 0,
+		kMethodDeflate = 8
+	};
+
+	struct Member {
+		const char *name;
+		uint16 method;
+		uint32 offset;
+		uint32 compressedSize;
+	};
+
+	Common::Array<byte> _contents;
+
+	/**
+	 * Deflate data made of stored blocks only, which every inflater accepts
+	 * without the test needing a compressor.
+	 */
+	static void writeStoredBlocks(Common::WriteStream &out, const Common::Array<byte> &data) {
+		uint32 pos = 0;
+		do {
+			const uint16 len = MIN<uint32>(data.size() - pos, 0xFFFF);
+			out.writeByte(pos + len == data.size() ? 1 : 0);
+			out.writeUint16LE(len);
+			out.writeUint16LE(~len);
+			out.write(data.data() + pos, len);
+			pos += len;
+		} while (pos < data.size());
+	}
+
+	Common::Archive *makeArchive() {
+		Member members[] = {
+			{ "stored.bin", kMethodStore, 0, 0 },
+			{ "deflated.bin", kMethodDeflate, 0, 0 }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		for (uint i = 0; i < ARRAYSIZE(members); ++i) {
+			Member &m = members[i];
+			m.offset = zip.pos();
+
+			Common::MemoryWriteStreamDynamic data(DisposeAfterUse::YES);
+			if (m.method == kMethodStore)
+				data.write(_contents.data(), _contents.size());
+			else
+				writeStoredBlocks(data, _contents);
+			m.compressedSize = data.size();
+
+			// CRCs are left at 0, they are not checked for streamed members
+			zip.writeUint32LE(0x04034b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(m.method);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(m.compressedSize);
+			zip.writeUint32LE(_contents.size());
+			zip.writeUint16LE(strlen(m.name));
+			zip.writeUint16LE(0);
+			zip.write(m.name, strlen(m.name));
+			zip.write(data.getData(), data.size());
+		}
+
+		const uint32 centralDir = zip.pos();
+		for (uint i = 0; i < ARRAYSIZE(members); ++i) {
+			const Member &m = members[i];
+			zip.writeUint32LE(0x02014b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(m.method);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(m.compressedSize);
+			zip.writeUint32LE(_contents.size());
+			zip.writeUint16LE(strlen(m.name));
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(m.offset);
+			zip.write(m.name, strlen(m.name));
+		}
+		const uint32 centralDirSize = zip.pos() - centralDir;
+
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(ARRAYSIZE(members));
+		zip.writeUint16LE(ARRAYSIZE(members));
+		zip.writeUint32LE(centralDirSize);
+		zip.writeUint32LE(centralDir);
+		zip.writeUint16LE(0);
+
+		return Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES));
+	}
+
+	/** Read the member at random places, going back and forth */
+	void checkMember(Common::SeekableReadStream *stream) {
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		TS_ASSERT_EQUALS(stream->size(), (int64)_contents.size());
+
+		Common::Array<byte> buffer(100 * 1000);
+		uint32 state = 99;
+		for (uint i = 0; i < 40; ++i) {
+			state = state * 1103515245 + 12345;
+			const uint32 pos = (state >> 4) % _contents.size();
+			const uint32 size = MIN<uint32>((state >> 12) % buffer.size(), _contents.size() - pos);
+			TS_ASSERT(stream->seek(pos));
+			TS_ASSERT_EQUALS(stream->read(buffer.data(), size), size);
+			TS_ASSERT_SAME_DATA(buffer.data(), _contents.data() + pos, size);
+		}
+
+		// Reading past the end sets eos
+		TS_ASSERT(stream->seek(-10, SEEK_END));
+		TS_ASSERT_EQUALS(stream->read(buffer.data(), 20), 10u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+	}
+
+public:
+	void setUp() {
+		_contents.resize(kMemberSize);
+		uint32 state = 7;
+		for (uint i = 0; i < _contents.size(); ++i) {
+			state = state * 1103515245 + 12345;
+			_contents[i] = state >> 16;
+		}
+	}
+
+	void test_stored_member() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+		TS_ASSERT(archive);
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive->createReadStreamForMember("stored.bin"));
+		checkMember(stream.get());
+	}
+
+	void test_deflated_member() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+		TS_ASSERT(archive);
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive->createReadStreamForMember("deflated.bin"));
+		checkMember(stream.get());
+	}
+
+	void test_member_outlives_archive() {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive());
+		TS_ASSERT(archive);
+		Common::ScopedPtr<Common::SeekableReadStream> stored(archive->createReadStreamForMember("stored.bin"));
+		Common::ScopedPtr<Common::SeekableReadStream> deflated(archive->createReadStreamForMember("deflated.bin"));
+		archive.reset();
+
+		checkMember(stored.get());
+		checkMember(deflated.get());
+	}
+};
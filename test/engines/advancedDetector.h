@@ -0,0 +1,144 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "engines/advancedDetector.h"
+
+#include "../temp_files.h"
+
+class AdvancedDetectorCacheTestSuite : public CxxTest::TestSuite {
+#if TEMP_FILES_ARE_AVAILABLE
+	Common::TempCacheDirectories _temp;
+
+	void tearDown() override {
+		_temp.tearDown();
+	}
+
+	Common::FSNode writeFile(const char *name, const char *contents, int64 time) {
+		const Common::String path = _temp.dir + "/" + name;
+		Common::writeTempFile(path, contents, strlen(contents));
+		Common::setTempFileTime(path, time);
+		return Common::FSNode(Common::Path(path, '/'));
+	}
+
+	/** Hash a file the way the detector does, through the persistent cache of a new run */
+	static FileProperties getProperties(const Common::FSNode &node, bool &fromCache) {
+		AdvancedDetectorCacheManager cache;
+		const Common::String key = "f:" + node.getPath().toString('/') + "::5000";
+
+		FileProperties props;
+		fromCache = cache.getPersistentProperties(key, node, props);
+		if (!fromCache) {
+			Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+			props.size = stream->size();
+			props.md5 = Common::computeStreamMD5AsString(*stream, 5000);
+			cache.setPersistentProperties(key, node, props);
+			cache.flush();
+		}
+		return props;
+	}
+
+	static Common::String getMD5(const char *contents) {
+		Common::MemoryReadStream stream((const byte *)contents, strlen(contents));
+		return Common::computeStreamMD5AsString(stream);
+	}
+
+	/**
+	 * Damage the cache, see Common::damageTempFile(). The end of the file is
+	 * the MD5 of the last entry.
+	 */
+	void damageCache(uint32 keep, bool flip) {
+		Common::damageTempFile(getCachePath(), keep, flip);
+	}
+
+	Common::String getCachePath() const {
+		return _temp.cache + "/detection-md5.dat";
+	}
+#endif
+
+public:
+	void test_hit_needs_same_size_and_time() {
+#if TEMP_FILES_ARE_AVAILABLE
+		_temp.setUp("admd5-hit");
+		bool fromCache;
+
+		Common::FSNode node = writeFile("game.dat", "game data", _temp.past);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("game data"));
+		TS_ASSERT(!fromCache);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("game data"));
+		TS_ASSERT(fromCache);
+
+		// Another time
+		node = writeFile("game.dat", "game data", _temp.past + 10);
+		getProperties(node, fromCache);
+		TS_ASSERT(!fromCache);
+
+		// Another size, at the time of the cache entry
+		node = writeFile("game.dat", "more game data", _temp.past + 10);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("more game data"));
+		TS_ASSERT(!fromCache);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).size, 14);
+		TS_ASSERT(fromCache);
+#endif
+	}
+
+	void test_changed_file_rehashed() {
+#if TEMP_FILES_ARE_AVAILABLE
+		_temp.setUp("admd5-changed");
+		bool fromCache;
+
+		Common::FSNode node = writeFile("game.dat", "version 1", _temp.past);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("version 1"));
+
+		node = writeFile("game.dat", "version 2", _temp.past + 10);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("version 2"));
+		TS_ASSERT(!fromCache);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("version 2"));
+		TS_ASSERT(fromCache);
+#endif
+	}
+
+	void test_changed_when_hashed() {
+#if TEMP_FILES_ARE_AVAILABLE
+		_temp.setUp("admd5-changed-when-hashed");
+		bool fromCache;
+
+		// A time ahead of the clock stands for a file changed in the second
+		// it was hashed, which can change again without a new time
+		const int64 future = Common::getTempFileNow() + 100;
+		Common::FSNode node = writeFile("game.dat", "version 1", future);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("version 1"));
+
+		// Neither the later change nor a later save of the cache make the
+		// entry trustworthy
+		node = writeFile("game.dat", "version 2", future);
+		Common::setTempFileTime(getCachePath(), future + 100);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("version 2"));
+		TS_ASSERT(!fromCache);
+#endif
+	}
+
+	void test_damaged_cache_ignored() {
+#if TEMP_FILES_ARE_AVAILABLE
+		_temp.setUp("admd5-damaged");
+		bool fromCache;
+
+		Common::FSNode node = writeFile("game.dat", "game data", _temp.past);
+		getProperties(node, fromCache);
+
+		damageCache(0xFFFFFFFF, true);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("game data"));
+		TS_ASSERT(!fromCache);
+
+		damageCache(20, false);
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("game data"));
+		TS_ASSERT(!fromCache);
+
+		// The cache written again is used
+		TS_ASSERT_EQUALS(getProperties(node, fromCache).md5, getMD5("game data"));
+		TS_ASSERT(fromCache);
+#endif
+	}
+};
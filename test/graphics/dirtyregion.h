@@ -0,0 +1,167 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyregion.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+	static bool isCovered(const Graphics::DirtyRegion &region, const Common::Rect &r) {
+		for (int y = r.top; y < r.bottom; ++y) {
+			for (int x = r.left; x < r.right; ++x) {
+				bool found = false;
+				for (uint i = 0; i < region.getRects().size(); ++i) {
+					if (region.getRects()[i].contains(x, y)) {
+						found = true;
+						break;
+					}
+				}
+				if (!found)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	static bool hasOverlaps(const Graphics::DirtyRegion &region) {
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		for (uint i = 0; i < rects.size(); ++i) {
+			for (uint j = i + 1; j < rects.size(); ++j) {
+				if (rects[i].intersects(rects[j]))
+					return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	void test_empty() {
+		Graphics::DirtyRegion region;
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(5, 5, 5, 10));
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(5, 5, 10, 10));
+		TS_ASSERT(!region.isEmpty());
+
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+	}
+
+	void test_merge() {
+		Graphics::DirtyRegion region(8, 16);
+
+		// Overlapping rects are always merged
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.addRect(Common::Rect(5, 5, 15, 15));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 15, 15));
+
+		// Far rects are kept apart
+		region.addRect(Common::Rect(100, 100, 110, 110));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		TS_ASSERT_EQUALS(region.getArea(), 15u * 15u + 10u * 10u);
+		TS_ASSERT_EQUALS(region.getBoundingBox(), Common::Rect(0, 0, 110, 110));
+
+		// Close rects are merged, as is the rect the merged one reaches
+		region.addRect(Common::Rect(15, 0, 16, 15));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		TS_ASSERT(isCovered(region, Common::Rect(0, 0, 16, 15)));
+	}
+
+	void test_bounded() {
+		Graphics::DirtyRegion region(4, 0);
+
+		Common::Array<Common::Rect> added;
+		uint seed = 1;
+		for (int i = 0; i < 200; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const int x = (seed >> 8) % 300;
+			const int y = (seed >> 16) % 200;
+			const Common::Rect r(x, y, x + 1 + (seed % 17), y + 1 + ((seed >> 4) % 13));
+			added.push_back(r);
+			region.addRect(r);
+
+			TS_ASSERT_LESS_THAN_EQUALS(region.getRects().size(), 4u);
+			TS_ASSERT(!hasOverlaps(region));
+		}
+
+		for (uint i = 0; i < added.size(); ++i)
+			TS_ASSERT(isCovered(region, added[i]));
+	}
+
+	void test_tiles() {
+		Graphics::DirtyRegion region(8, 0);
+		region.addRect(Common::Rect(10, 10, 20, 20));
+		region.addRect(Common::Rect(64, 0, 65, 1));
+
+		TS_ASSERT(region.isTileDirty(0, 0, 16, 16));
+		TS_ASSERT(region.isTileDirty(1, 1, 16, 16));
+		TS_ASSERT(!region.isTileDirty(2, 0, 16, 16));
+		TS_ASSERT(region.isTileDirty(4, 0, 16, 16));
+
+		Common::BitArray tiles(5 * 2);
+		region.getDirtyTiles(16, 16, 5, 2, tiles);
+		for (uint row = 0; row < 2; ++row) {
+			for (uint column = 0; column < 5; ++column)
+				TS_ASSERT_EQUALS(tiles.get(row * 5 + column), region.isTileDirty(column, row, 16, 16));
+		}
+
+		region.markAll();
+		TS_ASSERT(region.isTileDirty(3, 1, 16, 16));
+		region.getDirtyTiles(16, 16, 5, 2, tiles);
+		TS_ASSERT(tiles.get(8));
+	}
+
+	void test_upload_plan() {
+		const Common::Rect bounds(320, 200);
+		Graphics::DirtyRegion region(8, 64);
+
+		TS_ASSERT(region.getUploadPlan(bounds).empty());
+
+		// A cursor sized update only uploads the cursor
+		region.addRect(Common::Rect(100, 100, 116, 116));
+		region.addRect(Common::Rect(300, 180, 330, 210));
+		Common::Array<Common::Rect> plan = region.getUploadPlan(bounds);
+		TS_ASSERT_EQUALS(plan.size(), 2u);
+		TS_ASSERT_EQUALS(plan[0], Common::Rect(100, 100, 116, 116));
+		TS_ASSERT_EQUALS(plan[1], Common::Rect(300, 180, 320, 200));
+
+		// Once clipped, the rects are cheaper to upload as one
+		region.clear();
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.addRect(Common::Rect(-50, 12, 10, 22));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		plan = region.getUploadPlan(bounds);
+		TS_ASSERT_EQUALS(plan.size(), 1u);
+		TS_ASSERT_EQUALS(plan[0], Common::Rect(0, 0, 10, 22));
+
+		region.markAll();
+		plan = region.getUploadPlan(bounds);
+		TS_ASSERT_EQUALS(plan.size(), 1u);
+		TS_ASSERT_EQUALS(plan[0], bounds);
+	}
+
+	void test_upload_size() {
+		// The limits of the OpenGL surfaces, which count their uploads the
+		// same way
+		const Common::Rect bounds(640, 480);
+		Graphics::DirtyRegion region(8, 64 * 64);
+
+		// Opposite corners upload far less than their bounding box
+		region.addRect(Common::Rect(0, 0, 16, 16));
+		region.addRect(Common::Rect(624, 464, 640, 480));
+		const Common::Array<Common::Rect> plan = region.getUploadPlan(bounds);
+		TS_ASSERT_EQUALS(plan.size(), 2u);
+		TS_ASSERT_EQUALS(Graphics::DirtyRegion::getUploadSize(plan, 4), 2u * 16 * 16 * 4);
+		TS_ASSERT_EQUALS(Graphics::DirtyRegion::getUploadSize(region.getBoundingBox(), 4), 640u * 480 * 4);
+
+		// Without uploads of part of a line, whole lines are counted
+		TS_ASSERT_EQUALS(Graphics::DirtyRegion::getUploadSize(plan, 4, 640), 2u * 16 * 640 * 4);
+
+		// Close rects are uploaded as one, for a few more bytes
+		region.clear();
+		region.addRect(Common::Rect(100, 100, 132, 132));
+		region.addRect(Common::Rect(140, 100, 172, 132));
+		TS_ASSERT_EQUALS(region.getUploadPlan(bounds).size(), 1u);
+		TS_ASSERT_EQUALS(Graphics::DirtyRegion::getUploadSize(region.getUploadPlan(bounds), 2), 72u * 32 * 2);
+	}
+};
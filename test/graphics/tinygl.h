@@ -0,0 +1,250 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "test/instrset_detect.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 120;
+	static const int kHeight = 100;
+
+	static Graphics::PixelFormat getFormat() {
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24);
+	}
+
+	/** Draw a frame touching several tiles, and return a copy of the frame buffer */
+	static Graphics::Surface *renderFrame(bool dirtyRects, int threads) {
+		TinyGL::createContext(kWidth, kHeight, getFormat(), 64, true, dirtyRects);
+		TinyGL::setRenderThreadCount(threads);
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrthof(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		// Overlapping smooth triangles, sorted by the depth test
+		tglEnable(TGL_DEPTH_TEST);
+		tglBegin(TGL_TRIANGLES);
+		tglColor3f(1.0f, 0.0f, 0.0f);
+		tglVertex3f(5, 3, 0.5f);
+		tglColor3f(0.0f, 1.0f, 0.0f);
+		tglVertex3f(110, 40, -0.5f);
+		tglColor3f(0.0f, 0.0f, 1.0f);
+		tglVertex3f(20, 97, 0.0f);
+
+		tglColor3f(1.0f, 1.0f, 0.0f);
+		tglVertex3f(100, 5, -0.2f);
+		tglColor3f(0.0f, 1.0f, 1.0f);
+		tglVertex3f(115, 90, 0.8f);
+		tglColor3f(1.0f, 0.0f, 1.0f);
+		tglVertex3f(10, 60, 0.1f);
+		tglEnd();
+
+		// A textured, blended quad, partly outside of the frame
+		byte texels[8 * 8 * 4];
+		for (int i = 0; i < 8 * 8; i++) {
+			texels[i * 4 + 0] = i * 4;
+			texels[i * 4 + 1] = 255 - i * 4;
+			texels[i * 4 + 2] = (i & 1) ? 255 : 0;
+			texels[i * 4 + 3] = 128 + i;
+		}
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_NEAREST);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_NEAREST);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 8, 8, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		tglDisable(TGL_DEPTH_TEST);
+		tglEnable(TGL_TEXTURE_2D);
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+		tglBegin(TGL_QUADS);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(-10, 20, 0.0f);
+		tglTexCoord2f(0.0f, 1.0f);
+		tglVertex3f(-10, 80, 0.0f);
+		tglTexCoord2f(1.0f, 1.0f);
+		tglVertex3f(70, 130, 0.0f);
+		tglTexCoord2f(1.0f, 0.0f);
+		tglVertex3f(70, 30, 0.0f);
+		tglEnd();
+
+		// The same texture in perspective, lit by smooth colors and blended
+		// over the depth-tested triangles
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1, 1, -1, 1, 1, 10);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglEnable(TGL_DEPTH_TEST);
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 0.5f, 0.5f, 0.8f);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(-1.5f, -0.5f, -1.5f);
+		tglColor4f(0.5f, 1.0f, 0.5f, 0.6f);
+		tglTexCoord2f(0.0f, 1.0f);
+		tglVertex3f(-0.5f, 0.8f, -6.0f);
+		tglColor4f(0.5f, 0.5f, 1.0f, 1.0f);
+		tglTexCoord2f(1.0f, 1.0f);
+		tglVertex3f(2.0f, 0.8f, -6.0f);
+		tglColor4f(1.0f, 1.0f, 1.0f, 0.4f);
+		tglTexCoord2f(1.0f, 0.0f);
+		tglVertex3f(1.5f, -0.9f, -1.5f);
+		tglEnd();
+		tglDisable(TGL_DEPTH_TEST);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrthof(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_BLEND);
+
+		tglBegin(TGL_LINES);
+		tglColor3f(1.0f, 1.0f, 1.0f);
+		tglVertex3f(0, 99, 0.0f);
+		tglVertex3f(119, 0, 0.0f);
+		tglEnd();
+
+		// A blit crossing a tile boundary
+		Graphics::Surface image;
+		image.create(20, 40, getFormat());
+		for (int y = 0; y < image.h; y++) {
+			for (int x = 0; x < image.w; x++)
+				image.setPixel(x, y, getFormat().ARGBToColor(x < 10 ? 255 : 0, x * 12, y * 6, 200));
+		}
+		TinyGL::BlitImage *blitImage = tglGenBlitImage();
+		tglUploadBlitImage(blitImage, image, 0, false);
+		image.free();
+		tglBlit(blitImage, 90, 50);
+		tglDeleteBlitImage(blitImage);
+
+		TinyGL::presentBuffer();
+
+		Graphics::Surface *frame = TinyGL::copyFromFrameBuffer(getFormat());
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext();
+		return frame;
+	}
+
+	static const int kAnimationFrames = 9;
+
+	/**
+	 * Draw frames of a static scene with a moving triangle in front, whose
+	 * background changes for one frame, and return copies of the frame buffer
+	 */
+	static void renderAnimation(bool dirtyRects, int threads, Graphics::Surface **frames) {
+		TinyGL::createContext(kWidth, kHeight, getFormat(), 64, true, dirtyRects);
+		TinyGL::setRenderThreadCount(threads);
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrthof(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+
+		for (int frame = 0; frame < kAnimationFrames; frame++) {
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+			tglEnable(TGL_DEPTH_TEST);
+			tglBegin(TGL_TRIANGLES);
+			tglColor3f(1.0f, 0.0f, 0.0f);
+			tglVertex3f(5, 3, 0.5f);
+			tglColor3f(0.0f, 1.0f, 0.0f);
+			tglVertex3f(110, 40, -0.5f);
+			tglColor3f(0.0f, 0.0f, 1.0f);
+			tglVertex3f(20, 97, 0.0f);
+			tglEnd();
+
+			tglBegin(TGL_TRIANGLES);
+			tglColor3f(frame == 4 ? 0.5f : 1.0f, 1.0f, 0.0f);
+			tglVertex3f(100, 5, -0.2f);
+			tglColor3f(0.0f, 1.0f, 1.0f);
+			tglVertex3f(115, 90, 0.8f);
+			tglColor3f(1.0f, 0.0f, 1.0f);
+			tglVertex3f(10, 60, 0.1f);
+			tglEnd();
+
+			// Blended over the background, and sorted with it by the depth test
+			tglEnable(TGL_BLEND);
+			tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			tglBegin(TGL_TRIANGLES);
+			tglColor4f(1.0f, 1.0f, 1.0f, 0.5f);
+			tglVertex3f(10 + frame * 8, 30, 0.0f);
+			tglVertex3f(40 + frame * 8, 35, 0.0f);
+			tglVertex3f(20 + frame * 8, 70, 0.0f);
+			tglEnd();
+			tglDisable(TGL_BLEND);
+			tglDisable(TGL_DEPTH_TEST);
+
+			TinyGL::presentBuffer();
+			frames[frame] = TinyGL::copyFromFrameBuffer(getFormat());
+		}
+
+		TinyGL::destroyContext();
+	}
+
+	static void compareFrames(Graphics::Surface *expected, Graphics::Surface *actual) {
+		TS_ASSERT_EQUALS(expected->w, actual->w);
+		TS_ASSERT_EQUALS(expected->h, actual->h);
+		for (int y = 0; y < expected->h; y++)
+			TS_ASSERT_SAME_DATA(expected->getBasePtr(0, y), actual->getBasePtr(0, y), expected->w * expected->format.bytesPerPixel);
+
+		expected->free();
+		delete expected;
+		actual->free();
+		delete actual;
+	}
+
+public:
+	void test_tiles_match_serial() {
+		TinyGL::setSpanFunc(TinyGL::drawSpanGeneric);
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++)
+			compareFrames(renderFrame(dirtyRects, 1), renderFrame(dirtyRects, 4));
+	}
+
+	void test_frame_cache_matches_redraw() {
+		TinyGL::setSpanFunc(TinyGL::drawSpanGeneric);
+		for (int threads = 1; threads <= 4; threads += 3) {
+			Graphics::Surface *expected[kAnimationFrames];
+			Graphics::Surface *actual[kAnimationFrames];
+			renderAnimation(false, 1, expected);
+			renderAnimation(true, threads, actual);
+			for (int i = 0; i < kAnimationFrames; i++)
+				compareFrames(expected[i], actual[i]);
+		}
+	}
+
+	void test_spans_match_pixels() {
+		TinyGL::SpanFunc funcs[4];
+		int count = 0;
+		funcs[count++] = TinyGL::drawSpanGeneric;
+#ifdef SCUMMVM_NEON
+		funcs[count++] = TinyGL::drawSpanNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs[count++] = TinyGL::drawSpanSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs[count++] = TinyGL::drawSpanAVX2;
+#endif
+
+		for (int i = 0; i < count; i++) {
+			TinyGL::setSpanFunc(nullptr);
+			Graphics::Surface *expected = renderFrame(true, 1);
+			TinyGL::setSpanFunc(funcs[i]);
+			compareFrames(expected, renderFrame(true, 1));
+		}
+	}
+};
@@ -0,0 +1,275 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "common/array.h"
+#include "graphics/blit.h"
+#include "graphics/blit/blit-convert.h"
+#include "graphics/pixelformat.h"
+
+class CrossBlitTestSuite : public CxxTest::TestSuite {
+	enum {
+		// Odd sizes, so that the SIMD kernels also go through their tails
+		kWidth = 37,
+		kHeight = 5,
+		kSrcPadding = 3,
+		kDstPadding = 5,
+		kMaskPadding = 2
+	};
+
+	struct LCG {
+		uint32 state;
+
+		LCG() : state(4321) {}
+
+		uint32 next() {
+			state = state * 1103515245 + 12345;
+			return state;
+		}
+	};
+
+	struct KernelSet {
+		const char *name;
+		Graphics::CrossBlitKernels kernels;
+	};
+
+	Common::Array<KernelSet> _kernelSets;
+
+	static uint32 readPixel(const byte *p, uint bytesPerPixel) {
+		return bytesPerPixel == 1 ? *p : bytesPerPixel == 2 ? *(const uint16 *)p : *(const uint32 *)p;
+	}
+
+	static void writePixel(byte *p, uint bytesPerPixel, uint32 color) {
+		if (bytesPerPixel == 2)
+			*(uint16 *)p = color;
+		else
+			*(uint32 *)p = color;
+	}
+
+	/** Pixels with a few duplicates, so that the key is hit more than once */
+	static void fill(Common::Array<byte> &buffer, uint bytesPerPixel, LCG &rnd) {
+		for (uint i = 0; i < buffer.size(); i += bytesPerPixel) {
+			const uint32 color = (rnd.next() % 5 == 0) ? 0x12345678 : rnd.next() ^ (rnd.next() << 16);
+			if (bytesPerPixel == 1)
+				buffer[i] = color >> 8;
+			else
+				writePixel(&buffer[i], bytesPerPixel, color);
+		}
+	}
+
+	static void fillMask(Common::Array<byte> &mask, LCG &rnd) {
+		for (uint i = 0; i < mask.size(); ++i)
+			mask[i] = (rnd.next() & 0x100) ? (rnd.next() >> 8) | 1 : 0;
+	}
+
+public:
+	void setUp() {
+		_kernelSets.clear();
+
+		KernelSet generic = { "generic", {} };
+		Graphics::setupCrossBlitKernelsGeneric(generic.kernels);
+		_kernelSets.push_back(generic);
+
+#ifdef SCUMMVM_NEON
+		KernelSet neon = generic;
+		neon.name = "NEON";
+		Graphics::setupCrossBlitKernelsNEON(neon.kernels);
+		_kernelSets.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			KernelSet sse2 = generic;
+			sse2.name = "SSE2";
+			Graphics::setupCrossBlitKernelsSSE2(sse2.kernels);
+			_kernelSets.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			KernelSet avx2 = generic;
+			avx2.name = "AVX2";
+			Graphics::setupCrossBlitKernelsAVX2(avx2.kernels);
+			_kernelSets.push_back(avx2);
+		}
+#endif
+	}
+
+	/**
+	 * Run a kernel of each set, and compare the result with the conversion
+	 * through PixelFormat, pixel by pixel.
+	 */
+	void checkConvert(const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+		const uint srcPitch = (kWidth + kSrcPadding) * srcFmt.bytesPerPixel;
+		const uint dstPitch = (kWidth + kDstPadding) * dstFmt.bytesPerPixel;
+		const uint maskPitch = kWidth + kMaskPadding;
+
+		LCG rnd;
+		Common::Array<byte> src(srcPitch * kHeight), mask(maskPitch * kHeight), initial(dstPitch * kHeight);
+		fill(src, srcFmt.bytesPerPixel, rnd);
+		fillMask(mask, rnd);
+		fill(initial, dstFmt.bytesPerPixel, rnd);
+		const uint32 key = readPixel(&src[srcFmt.bytesPerPixel * 3], srcFmt.bytesPerPixel);
+
+		for (int mode = 0; mode < Graphics::kCrossBlitModeCount; ++mode) {
+			Common::Array<byte> expected(initial);
+			for (uint y = 0; y < kHeight; ++y) {
+				for (uint x = 0; x < kWidth; ++x) {
+					const uint32 color = readPixel(&src[y * srcPitch + x * srcFmt.bytesPerPixel], srcFmt.bytesPerPixel);
+					if (mode == Graphics::kCrossBlitKey && color == key)
+						continue;
+					if (mode == Graphics::kCrossBlitMask && !mask[y * maskPitch + x])
+						continue;
+					byte a, r, g, b;
+					srcFmt.colorToARGB(color, a, r, g, b);
+					writePixel(&expected[y * dstPitch + x * dstFmt.bytesPerPixel], dstFmt.bytesPerPixel, dstFmt.ARGBToColor(a, r, g, b));
+				}
+			}
+
+			for (uint i = 0; i < _kernelSets.size(); ++i) {
+				Common::Array<byte> dst(initial);
+				const Graphics::CrossBlitKernels &kernels = _kernelSets[i].kernels;
+
+				Graphics::CrossBlitArgs args;
+				memset(&args, 0, sizeof(args));
+				args.dst = dst.data();
+				args.src = src.data();
+				args.mask = mode == Graphics::kCrossBlitMask ? mask.data() : nullptr;
+				args.dstPitch = dstPitch;
+				args.srcPitch = srcPitch;
+				args.maskPitch = maskPitch;
+				args.w = kWidth;
+				args.h = kHeight;
+				args.key = key;
+				Graphics::CrossBlitChannels &ch = args.channels;
+				ch.srcShift[0] = srcFmt.rShift;
+				ch.srcShift[1] = srcFmt.gShift;
+				ch.srcShift[2] = srcFmt.bShift;
+				ch.srcShift[3] = srcFmt.aShift;
+				ch.dstShift[0] = dstFmt.rShift;
+				ch.dstShift[1] = dstFmt.gShift;
+				ch.dstShift[2] = dstFmt.bShift;
+				ch.dstShift[3] = dstFmt.aShift;
+				ch.copyAlpha = srcFmt.aBits() == 8 && dstFmt.aBits() == 8;
+				ch.dstFill = (srcFmt.aBits() == 0 && dstFmt.aBits() == 8) ? (0xFFu << dstFmt.aShift) : 0;
+
+				if (srcFmt.bytesPerPixel == 4 && dstFmt.bytesPerPixel == 4)
+					kernels.convert32To32[mode](args);
+				else if (srcFmt.bytesPerPixel == 2)
+					kernels.convert16To32[mode](args);
+				else
+					kernels.convert32To16[mode](args);
+
+				TSM_ASSERT_SAME_DATA(_kernelSets[i].name, expected.data(), dst.data(), dst.size());
+			}
+		}
+	}
+
+	void checkMap(uint bytesPerPixel) {
+		const uint srcPitch = kWidth + kSrcPadding;
+		const uint dstPitch = (kWidth + kDstPadding) * bytesPerPixel;
+		const uint maskPitch = kWidth + kMaskPadding;
+
+		LCG rnd;
+		Common::Array<byte> src(srcPitch * kHeight), mask(maskPitch * kHeight), initial(dstPitch * kHeight);
+		fill(src, 1, rnd);
+		fillMask(mask, rnd);
+		fill(initial, bytesPerPixel, rnd);
+		uint32 map[256];
+		for (uint i = 0; i < 256; ++i)
+			map[i] = bytesPerPixel == 2 ? rnd.next() & 0xFFFF : rnd.next();
+		const uint32 key = src[3];
+
+		for (int mode = 0; mode < Graphics::kCrossBlitModeCount; ++mode) {
+			Common::Array<byte> expected(initial);
+			for (uint y = 0; y < kHeight; ++y) {
+				for (uint x = 0; x < kWidth; ++x) {
+					const byte color = src[y * srcPitch + x];
+					if (mode == Graphics::kCrossBlitKey && color == key)
+						continue;
+					if (mode == Graphics::kCrossBlitMask && !mask[y * maskPitch + x])
+						continue;
+					writePixel(&expected[y * dstPitch + x * bytesPerPixel], bytesPerPixel, map[color]);
+				}
+			}
+
+			for (uint i = 0; i < _kernelSets.size(); ++i) {
+				Common::Array<byte> dst(initial);
+
+				Graphics::CrossBlitArgs args;
+				memset(&args, 0, sizeof(args));
+				args.dst = dst.data();
+				args.src = src.data();
+				args.mask = mode == Graphics::kCrossBlitMask ? mask.data() : nullptr;
+				args.dstPitch = dstPitch;
+				args.srcPitch = srcPitch;
+				args.maskPitch = maskPitch;
+				args.w = kWidth;
+				args.h = kHeight;
+				args.key = key;
+				args.map = map;
+
+				if (bytesPerPixel == 2)
+					_kernelSets[i].kernels.map8To16[mode](args);
+				else
+					_kernelSets[i].kernels.map8To32[mode](args);
+
+				TSM_ASSERT_SAME_DATA(_kernelSets[i].name, expected.data(), dst.data(), dst.size());
+			}
+		}
+	}
+
+	void test_convert_32_to_32() {
+		const Graphics::PixelFormat argb(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const Graphics::PixelFormat abgr(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		const Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::PixelFormat xrgb(4, 8, 8, 8, 0, 16, 8, 0, 0);
+		const Graphics::PixelFormat xbgr(4, 8, 8, 8, 0, 0, 8, 16, 0);
+
+		checkConvert(abgr, argb);
+		checkConvert(rgba, argb);
+		checkConvert(argb, rgba);
+		checkConvert(argb, xrgb);
+		checkConvert(xbgr, argb);
+		checkConvert(xbgr, xrgb);
+	}
+
+	void test_convert_16_to_32() {
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat bgr565(2, 5, 6, 5, 0, 0, 5, 11, 0);
+
+		checkConvert(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), rgb565);
+		checkConvert(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), rgb565);
+		checkConvert(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), bgr565);
+	}
+
+	void test_convert_32_to_16() {
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat bgr565(2, 5, 6, 5, 0, 0, 5, 11, 0);
+
+		checkConvert(rgb565, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		checkConvert(rgb565, Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+		checkConvert(bgr565, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+	}
+
+	void test_map() {
+		checkMap(2);
+		checkMap(4);
+	}
+
+	void test_crossblit_in_place() {
+		// Overlapping conversions must keep going through the generic path
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat argb(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		LCG rnd;
+		Common::Array<byte> buffer(kWidth * 4), copy(kWidth * 2), expected(kWidth * 4);
+		fill(copy, 2, rnd);
+		memcpy(buffer.data(), copy.data(), copy.size());
+		for (uint x = 0; x < kWidth; ++x) {
+			byte a, r, g, b;
+			rgb565.colorToARGB(readPixel(&copy[x * 2], 2), a, r, g, b);
+			writePixel(&expected[x * 4], 4, argb.ARGBToColor(a, r, g, b));
+		}
+		TS_ASSERT(Graphics::crossBlit(buffer.data(), buffer.data(), kWidth * 4, kWidth * 2, kWidth, 1, argb, rgb565));
+		TS_ASSERT_SAME_DATA(expected.data(), buffer.data(), buffer.size());
+	}
+};
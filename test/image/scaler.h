@@ -0,0 +1,214 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/threadpool.h"
+
+#include "graphics/scalerplugin.h"
+#ifdef USE_SCALERS
+#include "graphics/scaler/sai.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#endif
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 53,
+		kHeight = 100,
+		kPadding = 2,
+		kThreads = 4
+	};
+
+	/**
+	 * Blocks of a few colors with some noise, so that the scalers find edges
+	 * to smooth.
+	 */
+	static void fillSource(Common::Array<byte> &buffer, uint pitch, const Graphics::PixelFormat &format) {
+		uint32 state = 1234;
+		for (uint y = 0; y < kHeight + 2 * kPadding; ++y) {
+			for (uint x = 0; x < kWidth + 2 * kPadding; ++x) {
+				state = state * 1103515245 + 12345;
+				uint block = (x / 5 + y / 3) % 4;
+				if ((state >> 16) % 7 == 0)
+					block = (state >> 8) % 4;
+				const uint32 color = format.RGBToColor(block * 80, 255 - block * 60, (block & 1) * 200);
+				byte *p = &buffer[y * pitch + x * format.bytesPerPixel];
+				if (format.bytesPerPixel == 2)
+					*(uint16 *)p = color;
+				else
+					*(uint32 *)p = color;
+			}
+		}
+	}
+
+	/**
+	 * Scale the same rect with and without the thread pool, and compare the
+	 * output.
+	 */
+	static void checkBands(Scaler &scaler, const Graphics::PixelFormat &format, uint factor) {
+		TS_ASSERT(scaler.canScaleInBands());
+		scaler.setFactor(factor);
+
+		const uint srcPitch = (kWidth + 2 * kPadding) * format.bytesPerPixel;
+		const uint dstPitch = kWidth * factor * format.bytesPerPixel;
+		Common::Array<byte> src(srcPitch * (kHeight + 2 * kPadding));
+		fillSource(src, srcPitch, format);
+		const byte *srcPtr = &src[kPadding * srcPitch + kPadding * format.bytesPerPixel];
+
+		Common::Array<byte> serial(dstPitch * kHeight * factor, 0), parallel(dstPitch * kHeight * factor, 0x55);
+		scaler.setThreadPool(nullptr);
+		scaler.scale(srcPtr, srcPitch, serial.data(), dstPitch, kWidth, kHeight, 0, 0);
+
+		Common::ThreadPool pool(kThreads);
+		scaler.setThreadPool(&pool);
+		scaler.scale(srcPtr, srcPitch, parallel.data(), dstPitch, kWidth, kHeight, 0, 0);
+		scaler.setThreadPool(nullptr);
+
+		TS_ASSERT_SAME_DATA(serial.data(), parallel.data(), serial.size());
+	}
+
+	/**
+	 * Soft gradients, hard edges and some noise, so that HQ goes through
+	 * most of its patterns.
+	 */
+	static void fillGolden(Common::Array<byte> &buffer, uint w, uint h, const Graphics::PixelFormat &format) {
+		static const byte palette[5][3] = {
+			{ 20, 30, 40 }, { 200, 40, 40 }, { 40, 200, 60 }, { 230, 230, 210 }, { 90, 60, 160 }
+		};
+
+		uint32 state = 42;
+		for (uint y = 0; y < h; ++y) {
+			for (uint x = 0; x < w; ++x) {
+				state = state * 1103515245 + 12345;
+				const byte *c = palette[(x / 4 + y / 3 + (x * y) / 29) % 5];
+				const int shade = ((x + 2 * y) & 7) * 3 - 10;
+				uint32 color = format.RGBToColor(CLIP(c[0] + shade, 0, 255), CLIP(c[1] + shade, 0, 255), CLIP(c[2] - shade, 0, 255));
+				if ((state >> 16) % 11 == 0)
+					color = format.RGBToColor(state >> 8, state >> 13, state >> 19);
+				byte *p = &buffer[(y * w + x) * format.bytesPerPixel];
+				if (format.bytesPerPixel == 2)
+					*(uint16 *)p = color;
+				else
+					*(uint32 *)p = color;
+			}
+		}
+	}
+
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+	static Common::String scaleGolden(const Graphics::PixelFormat &format, uint factor) {
+		const uint w = 61, h = 37;
+		const uint srcW = w + 2, srcH = h + 2;
+		const uint srcPitch = srcW * format.bytesPerPixel;
+		const uint dstPitch = w * factor * format.bytesPerPixel;
+
+		Common::Array<byte> src(srcPitch * srcH), dst(dstPitch * h * factor, 0);
+		fillGolden(src, srcW, srcH, format);
+
+		HQScaler hq(format);
+		hq.setFactor(factor);
+		hq.scale(&src[srcPitch + format.bytesPerPixel], srcPitch, dst.data(), dstPitch, w, h, 0, 0);
+
+		Common::MemoryReadStream stream(dst.data(), dst.size());
+		return Common::computeStreamMD5AsString(stream);
+	}
+#endif
+
+public:
+	/**
+	 * Compare the output of the HQ scalers with each pattern function against
+	 * the output of the scalers before the patterns were vectorized.
+	 */
+	void test_hq_golden() {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		static const char *const golden[ARRAYSIZE(formats)][2] = {
+			{ "81520882381c5bd52296131d95102e7e", "6850784ee1cc8fba3d156865ab4cbe64" },
+			{ "423fe2cfeebfede9e12e8386b170203e", "811d0fd2a09ea116814b9760cfd08f9e" },
+			{ "03f19ba886f542cf619b837950c64106", "e35c8e5efd604578c515a3a892c1ccec" },
+			{ "06550140ec2ac5b84d35e2fb696d9433", "6527c911892e6c7beb237d6dcab9572b" },
+			{ "8589ef6004ad06ba89fa12bb87640c07", "95058d5f8374e6d46fcc1431d3c847e1" }
+		};
+
+		struct PatternFuncEntry {
+			const char *name;
+			HQScaler::PatternFunc func;
+		};
+		Common::Array<PatternFuncEntry> funcs;
+		PatternFuncEntry generic = { "generic", HQScaler::computePatternsGeneric };
+		funcs.push_back(generic);
+#ifdef SCUMMVM_NEON
+		PatternFuncEntry neon = { "NEON", HQScaler::computePatternsNEON };
+		funcs.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			PatternFuncEntry sse2 = { "SSE2", HQScaler::computePatternsSSE2 };
+			funcs.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			PatternFuncEntry avx2 = { "AVX2", HQScaler::computePatternsAVX2 };
+			funcs.push_back(avx2);
+		}
+#endif
+
+		const HQScaler::PatternFunc oldFunc = HQScaler::patternFunc;
+		for (uint f = 0; f < funcs.size(); ++f) {
+			HQScaler::patternFunc = funcs[f].func;
+			for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+				for (uint factor = 2; factor <= 3; ++factor)
+					TSM_ASSERT_EQUALS(funcs[f].name, scaleGolden(formats[i], factor), golden[i][factor - 2]);
+			}
+		}
+		HQScaler::patternFunc = oldFunc;
+#endif
+	}
+
+	void test_sai_bands() {
+#ifdef USE_SCALERS
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			SAIScaler sai(formats[i]);
+			checkBands(sai, formats[i], 2);
+			SuperSAIScaler superSai(formats[i]);
+			checkBands(superSai, formats[i], 2);
+			SuperEagleScaler superEagle(formats[i]);
+			checkBands(superEagle, formats[i], 2);
+		}
+#endif
+	}
+
+	void test_hq_bands() {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS) && !defined(USE_NASM)
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+		// Do not let the scaler pick the pattern function from the CPU features,
+		// as the test backend is not initialized
+		const HQScaler::PatternFunc oldFunc = HQScaler::patternFunc;
+		if (!oldFunc)
+			HQScaler::patternFunc = HQScaler::computePatternsGeneric;
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			HQScaler hq(formats[i]);
+			checkBands(hq, formats[i], 2);
+			checkBands(hq, formats[i], 3);
+		}
+		HQScaler::patternFunc = oldFunc;
+#endif
+	}
+};
@@ -9,10 +9,13 @@ TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(sr
 TEST_LIBS    :=
 
 ifdef POSIX
+TESTS += $(srcdir)/test/backends/fs/*.h
 TEST_LIBS += test/null_osystem.o \
+	test/temp_files.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mappedstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o
@@ -28,8 +31,32 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
+# The GL functions loaded by GLAD are replaced by stubs
+ifdef USE_OPENGL
+ifdef USE_GLAD
+TESTS += $(srcdir)/test/backends/graphics/opengl/*.h
+TEST_LIBS += backends/graphics/opengl/texture.o \
+	backends/graphics/opengl/framebuffer.o \
+	backends/graphics/opengl/shader.o \
+	backends/graphics/opengl/pipelines/clut8.o \
+	backends/graphics/opengl/pipelines/pipeline.o \
+	backends/graphics/opengl/pipelines/shader.o
+endif
+endif
+
+ifdef USE_MT32EMU
+TEST_LIBS += audio/softsynth/mt32/libmt32.a
+endif
+
 TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
+TESTS += $(srcdir)/test/engines/advancedDetector.h $(srcdir)/test/graphics/dirtyregion.h
+TEST_LIBS += engines/advancedDetectorCache.o
+
+ifdef USE_TINYGL
+	TESTS += $(srcdir)/test/graphics/tinygl.h
+endif
+
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
@@ -81,8 +108,9 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o test/temp_files.o
 	-rmdir test/engine-data
+	-$(RM) -r test-temp
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 	$(MKDIR) test/engine-data
@@ -0,0 +1,107 @@
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "temp_files.h"
+#include "null_osystem.h"
+
+#if defined(POSIX)
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/config-manager.h"
+
+static void removeTree(const Common::String &path) {
+	DIR *dir = opendir(path.c_str());
+	if (!dir) {
+		unlink(path.c_str());
+		return;
+	}
+
+	struct dirent *entry;
+	while ((entry = readdir(dir)) != nullptr) {
+		if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+			continue;
+		removeTree(path + "/" + entry->d_name);
+	}
+	closedir(dir);
+	rmdir(path.c_str());
+}
+
+Common::String Common::makeTempDirectory(const char *name) {
+	char cwd[4096];
+	if (!getcwd(cwd, sizeof(cwd)))
+		return String();
+
+	const String parent = String(cwd) + "/test-temp";
+	mkdir(parent.c_str(), 0755);
+
+	const String path = parent + "/" + name;
+	removeTree(path);
+	mkdir(path.c_str(), 0755);
+	return path;
+}
+
+void Common::writeTempFile(const String &path, const void *data, uint32 size) {
+	FILE *file = fopen(path.c_str(), "wb");
+	if (!file)
+		return;
+	fwrite(data, 1, size, file);
+	fclose(file);
+}
+
+void Common::removeTempFile(const String &path) {
+	removeTree(path);
+}
+
+void Common::createTempDirectory(const String &path) {
+	mkdir(path.c_str(), 0755);
+}
+
+void Common::setTempFileTime(const String &path, int64 time) {
+	struct timeval times[2];
+	times[0].tv_sec = times[1].tv_sec = time;
+	times[0].tv_usec = times[1].tv_usec = 0;
+	utimes(path.c_str(), times);
+}
+
+int64 Common::getTempFileNow() {
+	return ::time(nullptr);
+}
+
+void Common::damageTempFile(const String &path, uint32 keep, bool flip) {
+	FILE *file = fopen(path.c_str(), "rb");
+	if (!file)
+		return;
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	byte *data = new byte[size];
+	const size_t read = fread(data, 1, size, file);
+	fclose(file);
+
+	if (flip && read >= 2)
+		data[read - 2] ^= 0x20;
+	writeTempFile(path, data, MIN<uint32>(keep, read));
+	delete[] data;
+}
+
+void Common::TempCacheDirectories::setUp(const char *name) {
+	install_null_g_system();
+
+	dir = makeTempDirectory(name);
+	cache = makeTempDirectory((String(name) + "-cache").c_str());
+	ConfMan.setPath("cachepath", Path(cache, '/'), ConfigManager::kApplicationDomain);
+
+	past = getTempFileNow() - 100;
+}
+
+void Common::TempCacheDirectories::tearDown() {
+	ConfMan.removeKey("cachepath", ConfigManager::kApplicationDomain);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TEST_TEMP_FILES
+#define TEST_TEMP_FILES 1
+
+#include "../common/str.h"
+
+namespace Common {
+#if defined(POSIX)
+/**
+ * Create an empty directory for a test below the current directory,
+ * removing what a previous run left in it.
+ *
+ * @return The absolute path of the directory.
+ */
+String makeTempDirectory(const char *name);
+
+void writeTempFile(const String &path, const void *data, uint32 size);
+void removeTempFile(const String &path);
+void createTempDirectory(const String &path);
+
+/** Set the modification time of a file or directory, in seconds since the epoch */
+void setTempFileTime(const String &path, int64 time);
+
+/** The current time, in seconds since the epoch */
+int64 getTempFileNow();
+
+/**
+ * Rewrite a file, keeping the given number of bytes, and flipping a bit of
+ * its second last byte
+ */
+void damageTempFile(const String &path, uint32 keep, bool flip);
+
+/**
+ * The directories of a test of the files kept in the cache directory: one
+ * for the files which are cached, and one set as the cache path.
+ */
+struct TempCacheDirectories {
+	String dir;
+	String cache;
+
+	/** A time long before now, for the files the caches can trust */
+	int64 past;
+
+	/** Create the directories, and install the null OSystem for the configuration */
+	void setUp(const char *name);
+
+	/** Remove the cache path from the configuration */
+	void tearDown();
+};
+#define TEMP_FILES_ARE_AVAILABLE 1
+#else
+#define TEMP_FILES_ARE_AVAILABLE 0
+#endif
+}
+#endif